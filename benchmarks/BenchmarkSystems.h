@@ -0,0 +1,88 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef OILAB_BENCHMARKSYSTEMS_H
+#define OILAB_BENCHMARKSYSTEMS_H
+
+#include <LatticeModule.h>
+#include <GbMesoStateEnsemble.h>
+#include <map>
+#include <memory>
+#include <numbers>
+
+namespace gbLAB {
+
+    //! FCC lattice of copper (lattice constant in Angstrom)
+    inline Eigen::Matrix3d fccBasis(const double& a0= 3.615)
+    {
+        Eigen::Matrix3d A;
+        A << 0.0, 0.5, 0.5,
+             0.5, 0.0, 0.5,
+             0.5, 0.5, 0.0;
+        return a0*A;
+    }
+
+    /*!
+     * The \f$\Sigma 29\f$ [0-10](2 0 -5) tilt GB of testMonteCarlo and its mesostate ensemble.
+     * Members refer to each other, so instances are neither copied nor moved.
+     */
+    struct Sigma29Ensemble
+    {
+        const Eigen::Vector3d axis;
+        const Eigen::AngleAxisd halfRotation;
+        const Lattice<3> latticeA;
+        const Lattice<3> latticeB;
+        const BiCrystal<3> bc;
+        const Gb<3> gb;
+        const ReciprocalLatticeVector<3> axisA;
+        std::vector<LatticeVector<3>> cslVectors;
+        const GbMesoStateEnsemble<3> ensemble;
+
+        Sigma29Ensemble(const int& periodScaling, const int& axisScaling, const double& bScaling) :
+        /* init */ axis(0,-1,0)
+        /* init */,halfRotation(43.60282*std::numbers::pi/180/2,axis.normalized())
+        /* init */,latticeA(fccBasis(),halfRotation.matrix())
+        /* init */,latticeB(fccBasis(),halfRotation.matrix().transpose())
+        /* init */,bc(latticeA,latticeB,false)
+        /* init */,gb(bc,latticeA.reciprocalLatticeDirection(halfRotation.matrix()*Eigen::Vector3d(2,0,5)))
+        /* init */,axisA(latticeA.reciprocalLatticeDirection(axis).reciprocalLatticeVector())
+        /* init */,cslVectors(getCslVectors(gb,axis,axisA,periodScaling,axisScaling))
+        /* init */,ensemble(gb,axisA,cslVectors,bScaling)
+        {}
+
+        Sigma29Ensemble(const Sigma29Ensemble&) = delete;
+
+        static std::vector<LatticeVector<3>> getCslVectors(const Gb<3>& gb,
+                                                           const Eigen::Vector3d& axis,
+                                                           const ReciprocalLatticeVector<3>& axisA,
+                                                           const int& periodScaling,
+                                                           const int& axisScaling)
+        {
+            // source: https://openkim.org/id/EAM_Dynamo_MishinMehlPapaconstantopoulos_2001_Cu__MO_346334655118_005
+            const double c11= 169.9281940954852/160.2176621;
+            const double c12= 122.65063014404001/160.2176621;
+            GbMaterialTensors::lambda= c12;
+            GbMaterialTensors::mu= (c11-c12)/2;
+
+            const LatticeVector<3> axisC(gb.bc.getLatticeDirectionInC(gb.bc.A.latticeDirection(axis).latticeVector()).latticeVector());
+            std::vector<LatticeVector<3>> output;
+            output.push_back(gb.bc.csl.latticeDirection(gb.nA.cartesian()).latticeVector());
+            output.push_back(periodScaling*gb.getPeriodVector(axisA));
+            output.push_back(axisScaling*axisC);
+            return output;
+        }
+
+        //! Ensembles are expensive to build, so each scaling is built once per process
+        static const Sigma29Ensemble& get(const int& periodScaling, const int& axisScaling, const double& bScaling= 2.0)
+        {
+            static std::map<std::tuple<int,int,double>,std::unique_ptr<Sigma29Ensemble>> ensembles;
+            auto& ensemble= ensembles[std::make_tuple(periodScaling,axisScaling,bScaling)];
+            if(!ensemble)
+                ensemble= std::make_unique<Sigma29Ensemble>(periodScaling,axisScaling,bScaling);
+            return *ensemble;
+        }
+    };
+}
+#endif //OILAB_BENCHMARKSYSTEMS_H
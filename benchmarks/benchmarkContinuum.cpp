@@ -0,0 +1,49 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <BenchmarkSystems.h>
+
+using namespace gbLAB;
+
+/*!
+ * Construction of a mesostate, and hence of its GbContinuum, for \f$\Sigma 29\f$ ensembles whose
+ * GB period and axis lengths are scaled by the two arguments. The grid size and the number of atoms
+ * are reported as counters. With "cold" caches, the thread-local kernels of GbContinuum are rebuilt in
+ * every iteration (first mesostate of a run); otherwise they are reused (a Monte Carlo step).
+ */
+static void BM_GbContinuum(benchmark::State& state, const bool& cold)
+{
+    const auto& system(Sigma29Ensemble::get(state.range(0),state.range(1)));
+    const auto& ensemble(system.ensemble);
+
+    // a few single-site proposals away from the empty state; randomized states
+    // are rarely admissible and take too long to find
+    seedRandom(0);
+    auto constraints(ensemble.initializeState());
+    for (int i=0; i<4; ++i)
+        constraints= ensemble.sampleNewState(constraints,false);
+
+    GbContinuum<3>::reset();
+    const GbMesoState<3> mesoState(ensemble.constructMesoState(constraints));
+    for (auto _ : state)
+    {
+        if (cold)
+        {
+            state.PauseTiming();
+            GbContinuum<3>::reset();
+            state.ResumeTiming();
+        }
+        GbMesoState<3> temp(ensemble.constructMesoState(constraints));
+        benchmark::DoNotOptimize(temp.b.data());
+    }
+    GbContinuum<3>::reset();
+
+    state.counters["grid"]= mesoState.n[0]*mesoState.n[1];
+    state.counters["atoms"]= ensemble.bicrystalConfig.size();
+    state.counters["constraints"]= mesoState.xuPairs.size();
+}
+BENCHMARK_CAPTURE(BM_GbContinuum, cold, true)->ArgsProduct({{1,2},{1,2}})->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_GbContinuum, warm, false)->ArgsProduct({{1,2},{1,2}})->Unit(benchmark::kMillisecond);
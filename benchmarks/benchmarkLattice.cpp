@@ -0,0 +1,153 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <BenchmarkSystems.h>
+#include <RLLL.h>
+#include <SmithDecomposition.h>
+#include <FFT.h>
+#include <random>
+
+using namespace gbLAB;
+
+/*! RLLL reduction of the FCC basis sheared by a unimodular matrix with entries of order k^2 */
+static void BM_RLLL(benchmark::State& state)
+{
+    const long long k= state.range(0);
+    Eigen::Matrix3d U1, U2;
+    U1 << 1, k, 0,
+          0, 1, k,
+          0, 0, 1;
+    U2 << 1, 0, 0,
+          k, 1, 0,
+          0, k, 1;
+    const Eigen::MatrixXd B0(fccBasis()*U1*U2);
+    for (auto _ : state)
+    {
+        RLLL rlll(B0,0.75);
+        benchmark::DoNotOptimize(rlll.reducedBasis().data());
+    }
+}
+BENCHMARK(BM_RLLL)->RangeMultiplier(2)->Range(1,64);
+
+/*! Smith decomposition of random non-singular integer matrices with entries in [-n,n] */
+static void BM_SmithDecomposition(benchmark::State& state)
+{
+    using MatrixNi= Eigen::Matrix<long long int,3,3>;
+    const long long n= state.range(0);
+    std::mt19937_64 generator(0);
+    std::uniform_int_distribution<long long int> distribution(-n,n);
+    std::vector<MatrixNi> matrices;
+    while (matrices.size()<64)
+    {
+        const MatrixNi A(MatrixNi::NullaryExpr([&](){ return distribution(generator); }));
+        if (A.cast<double>().determinant()!=0)
+            matrices.push_back(A);
+    }
+
+    size_t i= 0;
+    for (auto _ : state)
+    {
+        SmithDecomposition<3> sd(matrices[i++ % matrices.size()]);
+        benchmark::DoNotOptimize(sd.matrixD().data());
+    }
+}
+BENCHMARK(BM_SmithDecomposition)->RangeMultiplier(4)->Range(4,4096);
+
+/*! Rotations about [001] of the FCC lattice that result in a CSL, keyed by \f$\Sigma\f$ */
+static const std::map<LatticeCore<3>::IntScalarType,Eigen::Matrix3d>& coincidentRotations001()
+{
+    static const std::map<LatticeCore<3>::IntScalarType,Eigen::Matrix3d> rotations([](){
+        const Lattice<3> lattice(fccBasis());
+        std::map<LatticeCore<3>::IntScalarType,Eigen::Matrix3d> output;
+        for (const auto& rotation : lattice.generateCoincidentLattices(lattice.reciprocalLatticeDirection(Eigen::Vector3d(0,0,1)),100,100))
+        {
+            try
+            {
+                const BiCrystal<3> bc(lattice,Lattice<3>(lattice.latticeBasis,rotation),false);
+                output.emplace(bc.sigma,rotation);
+            }
+            catch(std::runtime_error&)
+            {}
+        }
+        return output;
+    }());
+    return rotations;
+}
+
+/*! BiCrystal construction for [001] tilt bicrystals with \f$\Sigma\f$ close to the argument */
+static void BM_BiCrystal(benchmark::State& state)
+{
+    const auto& rotations(coincidentRotations001());
+    auto iter= rotations.lower_bound(state.range(0));
+    if (iter==rotations.end())
+    {
+        state.SkipWithError("no coincident rotation with the requested sigma");
+        return;
+    }
+    const Lattice<3> A(fccBasis());
+    const Lattice<3> B(fccBasis(),iter->second);
+    for (auto _ : state)
+    {
+        BiCrystal<3> bc(A,B,false);
+        benchmark::DoNotOptimize(bc.sigma);
+    }
+    state.counters["sigma"]= iter->first;
+}
+BENCHMARK(BM_BiCrystal)->Arg(5)->Arg(17)->Arg(37)->Arg(65)->Arg(97);
+
+/*! Lattice points in an n x n x n box of FCC unit cells */
+static void BM_LatticeBox(benchmark::State& state)
+{
+    const Lattice<3> lattice(fccBasis(1.0));
+    const int n= state.range(0);
+    std::vector<LatticeVector<3>> boxVectors;
+    for (int i=0; i<3; ++i)
+        boxVectors.push_back(lattice.latticeVector(n*Eigen::Vector3d::Unit(i)));
+
+    size_t points= 0;
+    for (auto _ : state)
+    {
+        const auto output= lattice.box(boxVectors);
+        points+= output.size();
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetItemsProcessed(points);
+}
+BENCHMARK(BM_LatticeBox)->RangeMultiplier(2)->Range(4,64)->Unit(benchmark::kMillisecond);
+
+/*! Search for coincident rotations about [111] as a function of the CSL size bound N */
+static void BM_GenerateCoincidentLattices(benchmark::State& state)
+{
+    const Lattice<3> lattice(fccBasis());
+    const auto rd(lattice.reciprocalLatticeDirection(Eigen::Vector3d(1,1,1)));
+    size_t rotations= 0;
+    for (auto _ : state)
+    {
+        const auto output= lattice.generateCoincidentLattices(rd,100,state.range(0));
+        rotations= output.size();
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.counters["rotations"]= rotations;
+}
+BENCHMARK(BM_GenerateCoincidentLattices)->RangeMultiplier(2)->Range(25,200)->Unit(benchmark::kMillisecond);
+
+template<int dim>
+static void BM_FFT(benchmark::State& state)
+{
+    const Eigen::Index n= state.range(0);
+    std::array<Eigen::Index,dim> dimensions;
+    dimensions.fill(n);
+    Eigen::Tensor<FFT::dcomplex,dim> in(dimensions), out(dimensions);
+    in.setRandom();
+    for (auto _ : state)
+    {
+        FFT::fft(in,out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations()*in.size());
+}
+BENCHMARK(BM_FFT<2>)->RangeMultiplier(2)->Range(16,512);
+BENCHMARK(BM_FFT<3>)->RangeMultiplier(2)->Range(8,64);
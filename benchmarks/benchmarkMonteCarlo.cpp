@@ -0,0 +1,41 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <BenchmarkSystems.h>
+#include <MonteCarlo.h>
+#include <CanonicalTP.h>
+
+using namespace gbLAB;
+
+/*!
+ * One step of a canonical Monte Carlo walk on the \f$\Sigma 29\f$ ensemble. LAMMPS is replaced
+ * by an evaluator that derives the energy from the mesostate, so the step measures proposal,
+ * mesostate construction and acceptance only.
+ */
+static void BM_MonteCarloStep(benchmark::State& state)
+{
+    using CanonicalTPType= CanonicalTP<XTuplet,GbMesoState<3>>;
+    const auto& ensemble(Sigma29Ensemble::get(1,1).ensemble);
+
+    const EnergyEvaluator<GbMesoState<3>> evaluator([](const GbMesoState<3>& mesoState){
+        double energy= 0.0;
+        for (const auto& [x,u] : mesoState.xuPairs)
+            energy+= u.squaredNorm();
+        return std::make_pair(static_cast<double>(mesoState.bs.size()),energy);
+    });
+    CanonicalTPType canonicalTP(evaluator,1.0,std::make_shared<StateEnergyStore<XTuplet>>());
+    // start from the empty state: the seeded constructor starts from a randomized
+    // state, and admissible ones are rarely found
+    MonteCarlo<XTuplet,GbMesoState<3>,GbMesoStateEnsemble<3>,CanonicalTPType> mc(ensemble,canonicalTP,ensemble.initializeState());
+    mc.seed(0);
+    // the first step builds the thread-local kernels of GbContinuum
+    mc.evolve(1);
+
+    for (auto _ : state)
+        mc.evolve(1);
+    GbContinuum<3>::reset();
+}
+BENCHMARK(BM_MonteCarloStep)->Unit(benchmark::kMillisecond);
@@ -13,6 +13,7 @@ namespace pyoilab{
         bind_ReciprocalLatticeVector<2>(m);
         bind_ReciprocalLatticeDirection<2>(m);
         bind_BiCrystal<2>(m);
+        bind_Gb<2>(m);
 
         // Dimension 3
         bind_Lattice<3>(m);
@@ -21,5 +22,10 @@ namespace pyoilab{
         bind_ReciprocalLatticeVector<3>(m);
         bind_ReciprocalLatticeDirection<3>(m);
         bind_BiCrystal<3>(m);
+        bind_Gb<3>(m);
+
+        // Mesostates and their Monte Carlo sampling (dimension 3 only)
+        bind_GbMesoStates(m);
+        bind_MonteCarloDrivers(m);
     }
 }
\ No newline at end of file
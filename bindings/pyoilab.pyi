@@ -4,18 +4,72 @@ Python bindings for the oILAB C++ library
 from __future__ import annotations
 import numpy
 import typing
-__all__ = ['Lattice2D', 'Lattice3D', 'LatticeDirection2D', 'LatticeDirection3D', 'LatticeVector2D', 'LatticeVector3D', 'ReciprocalLatticeDirection2D', 'ReciprocalLatticeDirection3D', 'ReciprocalLatticeVector2D', 'ReciprocalLatticeVector3D']
+__all__ = ['CanonicalTP', 'Gb2D', 'Gb3D', 'GbMaterialTensors', 'GbMesoState3D', 'GbMesoStateEnsemble3D', 'GbShifts3D', 'LammpsEnergyEvaluator', 'LandauWangTP', 'Lattice2D', 'Lattice3D', 'LatticeDirection2D', 'LatticeDirection3D', 'LatticeVector2D', 'LatticeVector3D', 'MonteCarloCanonical', 'MonteCarloLandauWang', 'ReciprocalLatticeDirection2D', 'ReciprocalLatticeDirection3D', 'ReciprocalLatticeVector2D', 'ReciprocalLatticeVector3D', 'StateEnergyStore']
+class Gb2D:
+    def __init__(self, bc: ..., n: ReciprocalLatticeDirection2D) -> None:
+        ...
+    def bc(self) -> ...:
+        ...
+    def box(self, boxVectors: list[LatticeVector2D], orthogonality: float, dsclFactor: int, filename: str = '', orient: bool = False, format: str = 'xyz') -> list[LatticeVector2D]:
+        ...
+    def getPeriodVector(self, axis: ReciprocalLatticeVector2D) -> LatticeVector2D:
+        ...
+    def stepHeight(self, d: LatticeVector2D) -> float:
+        ...
+    def stepHeightA(self, d: LatticeVector2D) -> float:
+        ...
+    def stepHeightB(self, d: LatticeVector2D) -> float:
+        ...
+    @property
+    def nA(self) -> ReciprocalLatticeDirection2D:
+        ...
+    @property
+    def nB(self) -> ReciprocalLatticeDirection2D:
+        ...
+class Gb3D:
+    def __init__(self, bc: ..., n: ReciprocalLatticeDirection3D) -> None:
+        ...
+    def bc(self) -> ...:
+        ...
+    def box(self, boxVectors: list[LatticeVector3D], orthogonality: float, dsclFactor: int, filename: str = '', orient: bool = False, format: str = 'xyz') -> list[LatticeVector3D]:
+        ...
+    def getPeriodVector(self, axis: ReciprocalLatticeVector3D) -> LatticeVector3D:
+        ...
+    def stepHeight(self, d: LatticeVector3D) -> float:
+        ...
+    def stepHeightA(self, d: LatticeVector3D) -> float:
+        ...
+    def stepHeightB(self, d: LatticeVector3D) -> float:
+        ...
+    @property
+    def nA(self) -> ReciprocalLatticeDirection3D:
+        ...
+    @property
+    def nB(self) -> ReciprocalLatticeDirection3D:
+        ...
 class Lattice2D:
     def __init__(self, A: numpy.ndarray[numpy.float64[2, 2]], Q: numpy.ndarray[numpy.float64[2, 2]] = ...) -> None:
         ...
-    def box(self, boxVectors: list[...], filename: str = '') -> list[...]:
+    def box(self, boxVectors: list[...], filename: str = '', format: str = 'xyz') -> list[...]:
         ...
+    def box_array(self, boxVectors: list[...]) -> numpy.ndarray[numpy.int64]:
+        """
+        Integer coordinates of the lattice points in the box, as an (N,2) int64 array
+        """
+    def cartesian(self, integerCoordinates: numpy.ndarray[numpy.int64]) -> numpy.ndarray[numpy.float64]:
+        """
+        Cartesian coordinates, as an (N,2) array, of lattice vectors given by an (N,2) array of integer coordinates
+        """
     def generateCoincidentLattices(self, maxStrain: float, maxDen: float = 50, N: int = 30) -> list[numpy.ndarray[numpy.float64[2, 2]]]:
         ...
     def interPlanarSpacing(self, arg0: ...) -> float:
         ...
     def latticeVector(self, arg0: numpy.ndarray[numpy.float64[2, 1]]) -> ...:
         ...
+    def latticeVectors(self, cartesianCoordinates: numpy.ndarray[numpy.float64]) -> numpy.ndarray[numpy.int64]:
+        """
+        Integer coordinates, as an (N,2) int64 array, of lattice vectors given by an (N,2) array of cartesian coordinates
+        """
     @property
     def F(self) -> numpy.ndarray[numpy.float64[2, 2]]:
         ...
@@ -28,14 +82,26 @@ class Lattice2D:
 class Lattice3D:
     def __init__(self, A: numpy.ndarray[numpy.float64[3, 3]], Q: numpy.ndarray[numpy.float64[3, 3]] = ...) -> None:
         ...
-    def box(self, boxVectors: list[...], filename: str = '') -> list[...]:
+    def box(self, boxVectors: list[...], filename: str = '', format: str = 'xyz') -> list[...]:
         ...
+    def box_array(self, boxVectors: list[...]) -> numpy.ndarray[numpy.int64]:
+        """
+        Integer coordinates of the lattice points in the box, as an (N,3) int64 array
+        """
+    def cartesian(self, integerCoordinates: numpy.ndarray[numpy.int64]) -> numpy.ndarray[numpy.float64]:
+        """
+        Cartesian coordinates, as an (N,3) array, of lattice vectors given by an (N,3) array of integer coordinates
+        """
     def generateCoincidentLattices(self, rd: ..., maxDen: float = 100, N: int = 100) -> list[numpy.ndarray[numpy.float64[3, 3]]]:
         ...
     def interPlanarSpacing(self, arg0: ...) -> float:
         ...
     def latticeVector(self, arg0: numpy.ndarray[numpy.float64[3, 1]]) -> ...:
         ...
+    def latticeVectors(self, cartesianCoordinates: numpy.ndarray[numpy.float64]) -> numpy.ndarray[numpy.int64]:
+        """
+        Integer coordinates, as an (N,3) int64 array, of lattice vectors given by an (N,3) array of cartesian coordinates
+        """
     @property
     def F(self) -> numpy.ndarray[numpy.float64[3, 3]]:
         ...
@@ -319,3 +385,172 @@ class ReciprocalLatticeVector3D:
         ...
     def integerCoordinates(self) -> numpy.ndarray[numpy.int64[3, 1]]:
         ...
+class GbMaterialTensors:
+    lambda_: typing.ClassVar[float]
+    mu: typing.ClassVar[float]
+class GbShifts3D:
+    def __init__(self, gb: Gb3D, axis: ReciprocalLatticeVector3D, gbCslVectors: list[LatticeVector3D], bhalfMax: float = 1.0) -> None:
+        ...
+    @property
+    def bShiftPairs(self) -> list[tuple[LatticeVector3D, numpy.ndarray[numpy.float64[3, 1]]]]:
+        """
+        List of (DSCL translation b, Cartesian CSL shift s) pairs
+        """
+    @property
+    def gbCslVectors(self) -> list[LatticeVector3D]:
+        ...
+class GbMesoState3D:
+    @staticmethod
+    def reset() -> None:
+        """
+        Clears the (thread-local) caches of the continuum model of the calling thread
+        """
+    def box(self, filename: str, format: str = 'xyz') -> None:
+        ...
+    def densityEnergy(self, lmpLocation: str, potentialName: str, relax: bool = False) -> tuple[float, float]:
+        """
+        Runs LAMMPS on the mesostate and returns (density, energy)
+        """
+    def surrogateDensityEnergy(self, sigma: float = 0.0) -> tuple[float, float]:
+        """
+        Returns (number of atoms, Gaussian-overlap energy surrogate) of the unrelaxed mesostate, without LAMMPS
+        """
+    @property
+    def gbDomain(self) -> numpy.ndarray[numpy.float64[3, 2]]:
+        ...
+class GbMesoStateEnsemble3D(GbShifts3D):
+    def __init__(self, gb: Gb3D, axis: ReciprocalLatticeVector3D, ensembleCslVectors: list[LatticeVector3D], bhalfMax: float = 1.0) -> None:
+        ...
+    @property
+    def numberOfSymmetryOperations(self) -> int:
+        ...
+    def canonicalState(self, state: tuple[int, ...]) -> tuple[int, ...]:
+        ...
+    def collectMesoStateOrbits(self, filename: str = '') -> dict[tuple[int, ...], tuple[GbMesoState3D, int]]:
+        """
+        Dictionary of (mesostate, multiplicity) keyed by the canonical signature of each symmetry orbit
+        """
+    def collectMesoStates(self, filename: str = '') -> dict[tuple[int, ...], GbMesoState3D]:
+        """
+        Dictionary of all admissible mesostates keyed by their signature
+        """
+    def constructMesoState(self, state: tuple[int, ...]) -> GbMesoState3D:
+        ...
+    def forEachMesoState(self, callback: typing.Callable[[tuple[int, ...], GbMesoState3D], None], parallel: bool = True) -> int:
+        """
+        Calls callback(signature, mesostate) for every admissible mesostate without storing them, and returns their number. Mesostates are constructed in parallel; the callback itself runs under the GIL.
+        """
+    def forEachMesoStateOrbit(self, callback: typing.Callable[[tuple[int, ...], int, GbMesoState3D], None], parallel: bool = True) -> int:
+        """
+        Calls callback(signature, multiplicity, mesostate) for one mesostate per symmetry orbit, and returns the number of orbits.
+        """
+    def initializeState(self) -> tuple[int, ...]:
+        ...
+    def multiplicity(self, state: tuple[int, ...]) -> int:
+        ...
+    def sampleNewState(self, state: tuple[int, ...], randomize: bool = False) -> tuple[int, ...]:
+        ...
+class LammpsEnergyEvaluator:
+    lmpLocation: str
+    potentialName: str
+    def __call__(self, mesoState: GbMesoState3D) -> tuple[float, float]:
+        ...
+    def __init__(self, lmpLocation: str, potentialName: str) -> None:
+        ...
+class StateEnergyStore:
+    def __init__(self, logFilename: str = '') -> None:
+        ...
+    def __len__(self) -> int:
+        ...
+    def filename(self) -> str:
+        ...
+    def find(self, state: tuple[int, ...]) -> tuple[float, float] | None:
+        ...
+    def importText(self, filename: str) -> int:
+        ...
+    def insert(self, state: tuple[int, ...], density: float, energy: float) -> bool:
+        ...
+    def refresh(self) -> int:
+        ...
+class CanonicalTP:
+    temperature: float
+    @typing.overload
+    def __init__(self, energyEvaluator: LammpsEnergyEvaluator | typing.Callable[[GbMesoState3D], tuple[float, float]], temperature: float, stateEnergyStore: StateEnergyStore | None = None, filename: str = '') -> None:
+        ...
+    @typing.overload
+    def __init__(self, lmpLocation: str, potentialName: str, temperature: float, stateEnergyStore: StateEnergyStore | None = None, filename: str = '') -> None:
+        ...
+    def seed(self, seed: int, stream: int = 0) -> None:
+        ...
+    @property
+    def stateEnergyStore(self) -> StateEnergyStore:
+        ...
+class LandauWangTP:
+    def __init__(self, energyLimits: tuple[float, float, int], densityLimits: tuple[float, float, int], energyEvaluator: LammpsEnergyEvaluator | typing.Callable[[GbMesoState3D], tuple[float, float]], stateEnergyStore: StateEnergyStore | None = None) -> None:
+        """
+        energyLimits and densityLimits are (min, max, number of bins)
+        """
+    def seed(self, seed: int, stream: int = 0) -> None:
+        ...
+    def writeTheta(self, filename: str) -> None:
+        ...
+    @property
+    def mask(self) -> numpy.ndarray[bool]:
+        ...
+    @property
+    def theta(self) -> numpy.ndarray[numpy.float64]:
+        ...
+class MonteCarloCanonical:
+    currentState: tuple[int, ...]
+    @typing.overload
+    def __init__(self, ensemble: GbMesoStateEnsemble3D, transitionProbability: CanonicalTP, seed: int, stream: int = 0) -> None:
+        ...
+    @typing.overload
+    def __init__(self, ensemble: GbMesoStateEnsemble3D, transitionProbability: CanonicalTP, state: tuple[int, ...]) -> None:
+        ...
+    def checkpoint(self, filename: str, everySteps: int, everySeconds: float = 0.0) -> None:
+        """
+        Makes evolve write a checkpoint every everySteps steps and, if everySeconds is positive, every everySeconds seconds
+        """
+    def evolve(self, maxIterations: int) -> None:
+        ...
+    def pipeline(self, constructionThreads: int, evaluationThreads: int, depth: int) -> None:
+        """
+        Makes evolve construct and evaluate up to depth speculative proposals ahead of time; depth=0 restores the serial evolve
+        """
+    def restore(self, filename: str) -> None:
+        ...
+    def save(self, filename: str) -> None:
+        ...
+    def seed(self, seed: int, stream: int = 0) -> None:
+        ...
+    @property
+    def step(self) -> int:
+        ...
+class MonteCarloLandauWang:
+    currentState: tuple[int, ...]
+    @typing.overload
+    def __init__(self, ensemble: GbMesoStateEnsemble3D, transitionProbability: LandauWangTP, seed: int, stream: int = 0) -> None:
+        ...
+    @typing.overload
+    def __init__(self, ensemble: GbMesoStateEnsemble3D, transitionProbability: LandauWangTP, state: tuple[int, ...]) -> None:
+        ...
+    def checkpoint(self, filename: str, everySteps: int, everySeconds: float = 0.0) -> None:
+        """
+        Makes evolve write a checkpoint every everySteps steps and, if everySeconds is positive, every everySeconds seconds
+        """
+    def evolve(self, maxIterations: int) -> None:
+        ...
+    def pipeline(self, constructionThreads: int, evaluationThreads: int, depth: int) -> None:
+        """
+        Makes evolve construct and evaluate up to depth speculative proposals ahead of time; depth=0 restores the serial evolve
+        """
+    def restore(self, filename: str) -> None:
+        ...
+    def save(self, filename: str) -> None:
+        ...
+    def seed(self, seed: int, stream: int = 0) -> None:
+        ...
+    @property
+    def step(self) -> int:
+        ...
@@ -47,10 +47,11 @@ int main(int argc, char** argv)
             
         case 3:
         {
-            const auto A(TextFileParser("bicrystal_3d.txt").readMatrix<double,3,3>("A",true));
-            const auto R1(TextFileParser("bicrystal_3d.txt").readMatrix<double,3,3>("R1",true));
-            const auto R2(TextFileParser("bicrystal_3d.txt").readMatrix<double,3,3>("R2",true));
-            const auto misAxis(TextFileParser("bicrystal_3d.txt").readMatrix<double,3,1>("misAxis",true));
+            const TextFileParser parser("bicrystal_3d.txt");
+            const auto A(parser.readMatrix<double,3,3>("A",true));
+            const auto R1(parser.readMatrix<double,3,3>("R1",true));
+            const auto R2(parser.readMatrix<double,3,3>("R2",true));
+            const auto misAxis(parser.readMatrix<double,3,1>("misAxis",true));
 
 
             Lattice<3> L1(A,R1);
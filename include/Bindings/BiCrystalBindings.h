@@ -8,12 +8,14 @@
 #include <pybind11/pybind11.h>
 #include <LatticeModule.h>
 #include <pybind11/stl.h>
+#include <NumpyBindings.h>
 namespace py = pybind11;
 
 namespace pyoilab {
     template<int dim>
     void bind_BiCrystal(py::module_ &m) {
         using PyLatticeVector = PyLatticeVector<dim>;
+        using PyLatticeDirection = PyLatticeDirection<dim>;
         using BiCrystal = gbLAB::BiCrystal<dim>;
         using Lattice = gbLAB::Lattice<dim>;
         using LatticeVector = gbLAB::LatticeVector<dim>;
@@ -38,7 +40,8 @@ namespace pyoilab {
                           const double& orthogonality,
                           const int& dsclFactor,
                           std::string filename,
-                          bool orient){
+                          bool orient,
+                          const std::string& format){
             std::vector<LatticeVector> boxLatticeVectors;
             for(const auto& v : boxPyLatticeVectors)
                 boxLatticeVectors.push_back(v.lv);
@@ -46,13 +49,67 @@ namespace pyoilab {
                                           orthogonality,
                                           dsclFactor,
                                           filename,
-                                          orient);
+                                          orient,
+                                          gbLAB::configurationFormat(format));
 
             std::vector<PyLatticeVector> pyLatticeVectors;
             for(const auto& v : latticeVectors)
                 pyLatticeVectors.push_back(PyLatticeVector(v));
             return pyLatticeVectors;
-        }, py::arg("boxVectors"), py::arg("orthogonality"), py::arg("dsclFactor"), py::arg("filename")="", py::arg("orient")=false);
+        }, py::arg("boxVectors"), py::arg("orthogonality"), py::arg("dsclFactor"), py::arg("filename")="", py::arg("orient")=false, py::arg("format")="xyz");
+        cls.def("box_array", [](const BiCrystal& self,
+                                std::vector<PyLatticeVector>& boxPyLatticeVectors,
+                                const double& orthogonality,
+                                const int& dsclFactor,
+                                std::string filename,
+                                bool orient,
+                                const std::string& format){
+            std::vector<LatticeVector> boxLatticeVectors;
+            for(const auto& v : boxPyLatticeVectors)
+                boxLatticeVectors.push_back(v.lv);
+            const gbLAB::ConfigurationFormat configurationFormat(gbLAB::configurationFormat(format));
+
+            Eigen::Matrix<long long int,dim,Eigen::Dynamic> coordinates;
+            std::vector<std::int8_t> latticeIDs;
+            {
+                py::gil_scoped_release release;
+                const auto latticeVectors= self.box(boxLatticeVectors,
+                                                    orthogonality,
+                                                    dsclFactor,
+                                                    filename,
+                                                    orient,
+                                                    configurationFormat);
+                const std::array<const Lattice*,4> lattices{&self.A,&self.B,&self.csl,&self.dscl};
+                coordinates.resize(dim,latticeVectors.size());
+                latticeIDs.resize(latticeVectors.size());
+                for(size_t i=0; i<latticeVectors.size(); ++i)
+                {
+                    coordinates.col(i)= latticeVectors[i];
+                    latticeIDs[i]= std::find(lattices.begin(),lattices.end(),&latticeVectors[i].lattice)-lattices.begin();
+                }
+            }
+            const py::ssize_t n= latticeIDs.size();
+            return py::make_tuple(toNumpy(std::move(coordinates)),
+                                  toNumpy(std::move(latticeIDs),{n}));
+        }, py::arg("boxVectors"), py::arg("orthogonality"), py::arg("dsclFactor"), py::arg("filename")="", py::arg("orient")=false, py::arg("format")="xyz",
+        "Bicrystal box as a tuple of (N,dim) int64 integer coordinates and (N,) int8 lattice ids (0: A, 1: B, 2: CSL, 3: DSCL)");
+        // GBs refer to the bicrystal that generated them, so it is kept alive by each of them
+        cls.def("generateGrainBoundaries",[](py::object pySelf, const PyLatticeDirection& d, int div){
+            const BiCrystal& self= pySelf.cast<const BiCrystal&>();
+            auto gbs= [&](){
+                py::gil_scoped_release release;
+                return self.generateGrainBoundaries(d.ld,div);
+            }();
+            py::dict output;
+            for(auto& [key,gb] : gbs)
+            {
+                py::object pyGb(py::cast(std::move(gb)));
+                py::detail::keep_alive_impl(pyGb, pySelf);
+                output[py::int_(key)]= pyGb;
+            }
+            return output;
+        }, py::arg("d"), py::arg("div")=30,
+        "Tilt GBs about the axis d, keyed by an integer that orders them by inclination angle");
         cls.def("getLatticeDirectionInC",[](const BiCrystal& self, const PyLatticeVector& v){
             return PyLatticeDirection(self.getLatticeDirectionInC(v.lv));
         });
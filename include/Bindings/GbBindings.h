@@ -0,0 +1,79 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef OILAB_GB_BINDINGS_H
+#define OILAB_GB_BINDINGS_H
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <LatticeModule.h>
+namespace py = pybind11;
+
+namespace pyoilab {
+    template<int dim>
+    void bind_Gb(py::module_ &m) {
+        using PyLatticeVector = PyLatticeVector<dim>;
+        using PyReciprocalLatticeVector = PyReciprocalLatticeVector<dim>;
+        using PyReciprocalLatticeDirection = PyReciprocalLatticeDirection<dim>;
+        using BiCrystal = gbLAB::BiCrystal<dim>;
+        using Gb = gbLAB::Gb<dim>;
+        using LatticeVector = gbLAB::LatticeVector<dim>;
+
+        py::class_<Gb> cls(m, ("Gb" + std::to_string(dim) + "D").c_str());
+        // a Gb holds a reference to its bicrystal
+        cls.def(py::init([](const BiCrystal& bc, const PyReciprocalLatticeDirection& n){
+                    return Gb(bc,n.rld);
+                }), py::arg("bc"), py::arg("n"), py::keep_alive<1,2>());
+        cls.def("bc",[](const Gb& self) -> const BiCrystal& {
+            return self.bc;
+        }, py::return_value_policy::reference_internal);
+        cls.def_property_readonly("nA",[](const Gb& self){
+            return PyReciprocalLatticeDirection(self.nA);
+        });
+        cls.def_property_readonly("nB",[](const Gb& self){
+            return PyReciprocalLatticeDirection(self.nB);
+        });
+        cls.def("stepHeightA",[](const Gb& self, const PyLatticeVector& d){
+            return self.stepHeightA(d.lv);
+        }, py::arg("d"));
+        cls.def("stepHeightB",[](const Gb& self, const PyLatticeVector& d){
+            return self.stepHeightB(d.lv);
+        }, py::arg("d"));
+        cls.def("stepHeight",[](const Gb& self, const PyLatticeVector& d){
+            return self.stepHeight(d.lv);
+        }, py::arg("d"));
+        cls.def("getPeriodVector",[](const Gb& self, const PyReciprocalLatticeVector& axis){
+            return PyLatticeVector(self.getPeriodVector(axis.rlv));
+        }, py::arg("axis"));
+        cls.def("box", [](const Gb& self,
+                          std::vector<PyLatticeVector>& boxPyLatticeVectors,
+                          const double& orthogonality,
+                          const int& dsclFactor,
+                          std::string filename,
+                          bool orient,
+                          const std::string& format){
+            std::vector<LatticeVector> boxLatticeVectors;
+            for(const auto& v : boxPyLatticeVectors)
+                boxLatticeVectors.push_back(v.lv);
+            const gbLAB::ConfigurationFormat configurationFormat(gbLAB::configurationFormat(format));
+
+            const auto latticeVectors= [&](){
+                py::gil_scoped_release release;
+                return self.box(boxLatticeVectors,
+                                orthogonality,
+                                dsclFactor,
+                                filename,
+                                orient,
+                                configurationFormat);
+            }();
+
+            std::vector<PyLatticeVector> pyLatticeVectors;
+            for(const auto& v : latticeVectors)
+                pyLatticeVectors.push_back(PyLatticeVector(v));
+            return pyLatticeVectors;
+        }, py::arg("boxVectors"), py::arg("orthogonality"), py::arg("dsclFactor"), py::arg("filename")="", py::arg("orient")=false, py::arg("format")="xyz");
+    }
+}
+#endif //OILAB_GB_BINDINGS_H
@@ -0,0 +1,197 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef OILAB_GBMESOSTATE_BINDINGS_H
+#define OILAB_GBMESOSTATE_BINDINGS_H
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <pybind11/functional.h>
+#include <pybind11/eigen.h>
+#include <LatticeModule.h>
+#include <GbMaterialTensors.h>
+#include <GbShifts.h>
+#include <GbMesoState.h>
+#include <GbMesoStateEnsemble.h>
+#include <OrderedTuplet.h>
+namespace py = pybind11;
+
+namespace pyoilab {
+
+    //! Mesostate signatures are exchanged with Python as tuples of ints
+    inline py::tuple toTuple(const gbLAB::XTuplet& state)
+    {
+        py::tuple output(state.size());
+        for(Eigen::Index i=0; i<state.size(); ++i)
+            output[i]= py::int_(state(i));
+        return output;
+    }
+
+    inline gbLAB::XTuplet toXTuplet(const std::vector<int>& state)
+    {
+        gbLAB::XTuplet output(state.size());
+        for(size_t i=0; i<state.size(); ++i)
+            output(i)= state[i];
+        return output;
+    }
+
+    inline void bind_GbMesoStates(py::module_ &m) {
+        constexpr int dim= 3;
+        using PyLatticeVector = PyLatticeVector<dim>;
+        using PyReciprocalLatticeVector = PyReciprocalLatticeVector<dim>;
+        using Gb = gbLAB::Gb<dim>;
+        using GbShifts = gbLAB::GbShifts<dim>;
+        using GbMesoState = gbLAB::GbMesoState<dim>;
+        using GbMesoStateEnsemble = gbLAB::GbMesoStateEnsemble<dim>;
+        using LatticeVector = gbLAB::LatticeVector<dim>;
+        using XTuplet = gbLAB::XTuplet;
+
+        auto toLatticeVectors= [](const std::vector<PyLatticeVector>& pyLatticeVectors){
+            std::vector<LatticeVector> latticeVectors;
+            for(const auto& v : pyLatticeVectors)
+                latticeVectors.push_back(v.lv);
+            return latticeVectors;
+        };
+
+        py::class_<gbLAB::GbMaterialTensors>(m, "GbMaterialTensors")
+                .def_readwrite_static("lambda_", &gbLAB::GbMaterialTensors::lambda)
+                .def_readwrite_static("mu", &gbLAB::GbMaterialTensors::mu);
+
+        // GbShifts holds references to the GB and to the tilt axis
+        py::class_<GbShifts> shifts(m, "GbShifts3D");
+        shifts.def(py::init([toLatticeVectors](const Gb& gb,
+                                               const PyReciprocalLatticeVector& axis,
+                                               const std::vector<PyLatticeVector>& gbCslVectors,
+                                               const double& bhalfMax){
+                       const auto latticeVectors= toLatticeVectors(gbCslVectors);
+                       py::gil_scoped_release release;
+                       return new GbShifts(gb,axis.rlv,latticeVectors,bhalfMax);
+                   }), py::arg("gb"), py::arg("axis"), py::arg("gbCslVectors"), py::arg("bhalfMax")=1.0,
+                   py::keep_alive<1,2>(), py::keep_alive<1,3>());
+        shifts.def_property_readonly("gbCslVectors",[](const GbShifts& self){
+            std::vector<PyLatticeVector> output;
+            for(const auto& v : self.gbCslVectors)
+                output.push_back(PyLatticeVector(v));
+            return output;
+        });
+        shifts.def_property_readonly("bShiftPairs",[](const GbShifts& self){
+            std::vector<std::pair<PyLatticeVector,Eigen::Vector3d>> output;
+            for(const auto& [b,s] : self.bShiftPairs)
+                output.emplace_back(PyLatticeVector(b),s);
+            return output;
+        }, "List of (DSCL translation b, Cartesian CSL shift s) pairs");
+
+        // A mesostate refers to the ensemble that constructed it
+        py::class_<GbMesoState> mesoState(m, "GbMesoState3D");
+        mesoState.def_readonly("gbDomain",&GbMesoState::gbDomain);
+        mesoState.def("box",[](const GbMesoState& self, const std::string& filename, const std::string& format){
+            const gbLAB::ConfigurationFormat configurationFormat(gbLAB::configurationFormat(format));
+            py::gil_scoped_release release;
+            self.box(filename,configurationFormat);
+        }, py::arg("filename"), py::arg("format")="xyz");
+        mesoState.def("densityEnergy",[](const GbMesoState& self,
+                                         const std::string& lmpLocation,
+                                         const std::string& potentialName,
+                                         bool relax){
+            py::gil_scoped_release release;
+            const auto output= self.densityEnergy(lmpLocation,potentialName,relax);
+            return std::make_pair(std::get<0>(output),std::get<1>(output));
+        }, py::arg("lmpLocation"), py::arg("potentialName"), py::arg("relax")=false,
+        "Runs LAMMPS on the mesostate and returns (density, energy)");
+        mesoState.def("surrogateDensityEnergy",[](const GbMesoState& self, const double& sigma){
+            py::gil_scoped_release release;
+            const auto output= self.surrogateDensityEnergy({},sigma);
+            return std::make_pair(std::get<0>(output),std::get<1>(output));
+        }, py::arg("sigma")=0.0,
+        "Returns (number of atoms, Gaussian-overlap energy surrogate) of the unrelaxed mesostate, without LAMMPS");
+        mesoState.def_static("reset",&GbMesoState::reset,
+                             "Clears the (thread-local) caches of the continuum model of the calling thread");
+
+        py::class_<GbMesoStateEnsemble, GbShifts> ensemble(m, "GbMesoStateEnsemble3D");
+        ensemble.def(py::init([toLatticeVectors](const Gb& gb,
+                                                 const PyReciprocalLatticeVector& axis,
+                                                 const std::vector<PyLatticeVector>& ensembleCslVectors,
+                                                 const double& bhalfMax){
+                         auto latticeVectors= toLatticeVectors(ensembleCslVectors);
+                         py::gil_scoped_release release;
+                         return new GbMesoStateEnsemble(gb,axis.rlv,latticeVectors,bhalfMax);
+                     }), py::arg("gb"), py::arg("axis"), py::arg("ensembleCslVectors"), py::arg("bhalfMax")=1.0,
+                     py::keep_alive<1,2>(), py::keep_alive<1,3>());
+        ensemble.def("initializeState",[](const GbMesoStateEnsemble& self){
+            return toTuple(self.initializeState());
+        });
+        ensemble.def("sampleNewState",[](const GbMesoStateEnsemble& self, const std::vector<int>& state, bool randomize){
+            return toTuple(self.sampleNewState(toXTuplet(state),randomize));
+        }, py::arg("state"), py::arg("randomize")=false);
+        ensemble.def("constructMesoState",[](const GbMesoStateEnsemble& self, const std::vector<int>& state){
+            const XTuplet constraints(toXTuplet(state));
+            py::gil_scoped_release release;
+            return self.constructMesoState(constraints);
+        }, py::arg("state"), py::keep_alive<0,1>());
+        ensemble.def("collectMesoStates",[](py::object pySelf, const std::string& filename){
+            const GbMesoStateEnsemble& self= pySelf.cast<const GbMesoStateEnsemble&>();
+            auto mesoStates= [&](){
+                py::gil_scoped_release release;
+                return self.collectMesoStates(filename);
+            }();
+            py::dict output;
+            for(auto& [constraints,mesoState] : mesoStates)
+            {
+                py::object pyMesoState(py::cast(std::move(mesoState)));
+                py::detail::keep_alive_impl(pyMesoState,pySelf);
+                output[toTuple(constraints)]= pyMesoState;
+            }
+            return output;
+        }, py::arg("filename")="", "Dictionary of all admissible mesostates keyed by their signature");
+        ensemble.def("forEachMesoState",[](py::object pySelf, const py::function& callback, bool parallel){
+            const GbMesoStateEnsemble& self= pySelf.cast<const GbMesoStateEnsemble&>();
+            py::gil_scoped_release release;
+            return self.forEachMesoState([&](const XTuplet& constraints, const GbMesoState& mesoState){
+                py::gil_scoped_acquire acquire;
+                py::object pyMesoState(py::cast(mesoState));
+                py::detail::keep_alive_impl(pyMesoState,pySelf);
+                callback(toTuple(constraints),pyMesoState);
+            },parallel);
+        }, py::arg("callback"), py::arg("parallel")=true,
+        "Calls callback(signature, mesostate) for every admissible mesostate without storing them, and returns their number. "
+        "Mesostates are constructed in parallel; the callback itself runs under the GIL.");
+        ensemble.def("forEachMesoStateOrbit",[](py::object pySelf, const py::function& callback, bool parallel){
+            const GbMesoStateEnsemble& self= pySelf.cast<const GbMesoStateEnsemble&>();
+            py::gil_scoped_release release;
+            return self.forEachMesoStateOrbit([&](const XTuplet& constraints, const int& multiplicity, const GbMesoState& mesoState){
+                py::gil_scoped_acquire acquire;
+                py::object pyMesoState(py::cast(mesoState));
+                py::detail::keep_alive_impl(pyMesoState,pySelf);
+                callback(toTuple(constraints),multiplicity,pyMesoState);
+            },parallel);
+        }, py::arg("callback"), py::arg("parallel")=true,
+        "Calls callback(signature, multiplicity, mesostate) for one mesostate per symmetry orbit, and returns the number of orbits.");
+        ensemble.def("collectMesoStateOrbits",[](py::object pySelf, const std::string& filename){
+            const GbMesoStateEnsemble& self= pySelf.cast<const GbMesoStateEnsemble&>();
+            auto mesoStates= [&](){
+                py::gil_scoped_release release;
+                return self.collectMesoStateOrbits(filename);
+            }();
+            py::dict output;
+            for(auto& [constraints,mesoStateMultiplicity] : mesoStates)
+            {
+                py::object pyMesoState(py::cast(std::move(mesoStateMultiplicity.first)));
+                py::detail::keep_alive_impl(pyMesoState,pySelf);
+                output[toTuple(constraints)]= py::make_tuple(pyMesoState,mesoStateMultiplicity.second);
+            }
+            return output;
+        }, py::arg("filename")="", "Dictionary of (mesostate, multiplicity) keyed by the canonical signature of each symmetry orbit");
+        ensemble.def("canonicalState",[](const GbMesoStateEnsemble& self, const std::vector<int>& state){
+            return toTuple(self.canonicalState(toXTuplet(state)));
+        }, py::arg("state"));
+        ensemble.def("multiplicity",[](const GbMesoStateEnsemble& self, const std::vector<int>& state){
+            return self.multiplicity(toXTuplet(state));
+        }, py::arg("state"));
+        ensemble.def_property_readonly("numberOfSymmetryOperations",[](const GbMesoStateEnsemble& self){
+            return self.symmetry.size();
+        });
+    }
+}
+#endif //OILAB_GBMESOSTATE_BINDINGS_H
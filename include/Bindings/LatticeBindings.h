@@ -8,6 +8,7 @@
 #include <pybind11/pybind11.h>
 #include <LatticeModule.h>
 #include <pybind11/stl.h>
+#include <NumpyBindings.h>
 namespace py = pybind11;
 
 namespace pyoilab {
@@ -34,17 +35,54 @@ namespace pyoilab {
             .def("latticeVector", [](const Lattice &lattice, const VectorDimD &p) {
                 return PyLatticeVector(lattice.latticeVector(p));
             })
-            .def("box",[](const Lattice& lattice, const std::vector<PyLatticeVector>& boxPyLatticeVectors, const std::string& filename){
+            .def("box",[](const Lattice& lattice, const std::vector<PyLatticeVector>& boxPyLatticeVectors, const std::string& filename, const std::string& format){
                 std::vector<LatticeVector> boxLatticeVectors;
                 for(const auto& v : boxPyLatticeVectors)
                     boxLatticeVectors.push_back(v.lv);
-                auto latticeVectors= lattice.box(boxLatticeVectors,filename);
+                auto latticeVectors= lattice.box(boxLatticeVectors,filename,gbLAB::configurationFormat(format));
 
                 std::vector<PyLatticeVector> pyLatticeVectors;
                 for(const auto& v : latticeVectors)
                     pyLatticeVectors.push_back(PyLatticeVector(v));
                 return pyLatticeVectors;
-            }, py::arg("boxVectors"),py::arg("filename")="");
+            }, py::arg("boxVectors"),py::arg("filename")="",py::arg("format")="xyz");
+        cls.def("box_array",[](const Lattice& lattice, const std::vector<PyLatticeVector>& boxPyLatticeVectors){
+                std::vector<LatticeVector> boxLatticeVectors;
+                for(const auto& v : boxPyLatticeVectors)
+                    boxLatticeVectors.push_back(v.lv);
+                Eigen::Matrix<long long int,dim,Eigen::Dynamic> coordinates;
+                {
+                    py::gil_scoped_release release;
+                    coordinates= lattice.boxCoordinates(boxLatticeVectors);
+                }
+                return toNumpy(std::move(coordinates));
+            }, py::arg("boxVectors"),
+            "Integer coordinates of the lattice points in the box, as an (N,dim) int64 array");
+        cls.def("cartesian",[](const Lattice& lattice, const NumpyArray<long long int>& integerCoordinates){
+                const auto x(asMatrix<dim>(integerCoordinates,"integerCoordinates"));
+                Eigen::Matrix<double,dim,Eigen::Dynamic> output;
+                {
+                    py::gil_scoped_release release;
+                    output= lattice.latticeBasis*x.template cast<double>();
+                }
+                return toNumpy(std::move(output));
+            }, py::arg("integerCoordinates"),
+            "Cartesian coordinates, as an (N,dim) array, of lattice vectors given by an (N,dim) array of integer coordinates");
+        cls.def("latticeVectors",[](const Lattice& lattice, const NumpyArray<double>& cartesianCoordinates){
+                const auto x(asMatrix<dim>(cartesianCoordinates,"cartesianCoordinates"));
+                Eigen::Matrix<long long int,dim,Eigen::Dynamic> output(dim,x.cols());
+                {
+                    py::gil_scoped_release release;
+                    const Eigen::Matrix<double,dim,Eigen::Dynamic> nd(lattice.reciprocalBasis.transpose()*x);
+                    const Eigen::Matrix<double,dim,Eigen::Dynamic> rd(nd.array().round());
+                    Eigen::Index i;
+                    if(x.cols()>0 && (nd-rd).colwise().norm().maxCoeff(&i)>gbLAB::LatticeCore<dim>::roundTol)
+                        throw std::runtime_error("Input vector "+std::to_string(i)+" is not a lattice vector");
+                    output= rd.template cast<long long int>();
+                }
+                return toNumpy(std::move(output));
+            }, py::arg("cartesianCoordinates"),
+            "Integer coordinates, as an (N,dim) int64 array, of lattice vectors given by an (N,dim) array of cartesian coordinates");
         if constexpr(dim==3) {
             cls.def("generateCoincidentLattices",
                  [](const Lattice &lattice, const PyReciprocalLatticeDirection& rd, const double& maxDen, const int& N) {
@@ -0,0 +1,169 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef OILAB_MONTECARLO_BINDINGS_H
+#define OILAB_MONTECARLO_BINDINGS_H
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <pybind11/eigen.h>
+#include <memory>
+#include <GbMesoStateBindings.h>
+#include <EnergyEvaluator.h>
+#include <StateEnergyStore.h>
+#include <CanonicalTP.h>
+#include <LandauWangTP.h>
+#include <MonteCarlo.h>
+namespace py = pybind11;
+
+namespace pyoilab {
+
+    /*!
+     * Energy evaluator that calls a Python callable f(mesostate) -> (density, energy).
+     * Transition probabilities run with the GIL released, so the GIL is acquired for
+     * every call and for the destruction of the callable.
+     */
+    template<typename SystemType>
+    class PyEnergyEvaluator
+    {
+        std::shared_ptr<py::function> function;
+
+    public:
+        explicit PyEnergyEvaluator(const py::function& f) :
+                function(new py::function(f),[](py::function* f){
+                    py::gil_scoped_acquire acquire;
+                    delete f;
+                })
+        {}
+
+        std::pair<double,double> operator()(const SystemType& system) const
+        {
+            py::gil_scoped_acquire acquire;
+            return (*function)(py::cast(system)).template cast<std::pair<double,double>>();
+        }
+    };
+
+    //! Accepts either a LammpsEnergyEvaluator or a Python callable
+    template<typename SystemType>
+    gbLAB::EnergyEvaluator<SystemType> toEnergyEvaluator(const py::object& evaluator)
+    {
+        if(py::isinstance<gbLAB::LammpsEnergyEvaluator<SystemType>>(evaluator))
+            return evaluator.cast<gbLAB::LammpsEnergyEvaluator<SystemType>>();
+        if(py::isinstance<py::function>(evaluator))
+            return PyEnergyEvaluator<SystemType>(evaluator.cast<py::function>());
+        throw std::invalid_argument("energyEvaluator must be a LammpsEnergyEvaluator or a callable returning (density, energy)");
+    }
+
+    template<typename StateType>
+    std::shared_ptr<gbLAB::StateEnergyStore<StateType>> toStateEnergyStore(const std::shared_ptr<gbLAB::StateEnergyStore<StateType>>& store)
+    {
+        return store ? store : std::make_shared<gbLAB::StateEnergyStore<StateType>>();
+    }
+
+    template<typename TransitionProbabilityType>
+    void bind_MonteCarlo(py::module_ &m, const std::string& name) {
+        using XTuplet = gbLAB::XTuplet;
+        using GbMesoState = gbLAB::GbMesoState<3>;
+        using GbMesoStateEnsemble = gbLAB::GbMesoStateEnsemble<3>;
+        using MonteCarlo = gbLAB::MonteCarlo<XTuplet,GbMesoState,GbMesoStateEnsemble,TransitionProbabilityType>;
+
+        // a walker refers to both its ensemble and its transition probability
+        py::class_<MonteCarlo> cls(m, name.c_str());
+        cls.def(py::init<const GbMesoStateEnsemble&, const TransitionProbabilityType&, const std::uint64_t&, const std::uint64_t&>(),
+                py::arg("ensemble"), py::arg("transitionProbability"), py::arg("seed"), py::arg("stream")=0,
+                py::keep_alive<1,2>(), py::keep_alive<1,3>());
+        cls.def(py::init([](const GbMesoStateEnsemble& ensemble, const TransitionProbabilityType& tp, const std::vector<int>& state){
+                    return new MonteCarlo(ensemble,tp,toXTuplet(state));
+                }), py::arg("ensemble"), py::arg("transitionProbability"), py::arg("state"),
+                py::keep_alive<1,2>(), py::keep_alive<1,3>());
+        cls.def("seed",&MonteCarlo::seed, py::arg("seed"), py::arg("stream")=0);
+        cls.def("evolve",&MonteCarlo::evolve, py::arg("maxIterations"),
+                py::call_guard<py::gil_scoped_release>());
+        cls.def_property("currentState",
+                         [](const MonteCarlo& self){ return toTuple(self.currentState); },
+                         [](MonteCarlo& self, const std::vector<int>& state){ self.currentState= toXTuplet(state); });
+        cls.def_readonly("step",&MonteCarlo::step);
+        cls.def("save",&MonteCarlo::save, py::arg("filename"));
+        cls.def("restore",&MonteCarlo::restore, py::arg("filename"));
+        cls.def("checkpoint",&MonteCarlo::checkpoint, py::arg("filename"), py::arg("everySteps"), py::arg("everySeconds")=0.0,
+                "Makes evolve write a checkpoint every everySteps steps and, if everySeconds is positive, every everySeconds seconds");
+        cls.def("pipeline",&MonteCarlo::pipeline, py::arg("constructionThreads"), py::arg("evaluationThreads"), py::arg("depth"),
+                "Makes evolve construct and evaluate up to depth speculative proposals ahead of time; depth=0 restores the serial evolve");
+    }
+
+    inline void bind_MonteCarloDrivers(py::module_ &m) {
+        using XTuplet = gbLAB::XTuplet;
+        using GbMesoState = gbLAB::GbMesoState<3>;
+        using StateEnergyStore = gbLAB::StateEnergyStore<XTuplet>;
+        using LammpsEnergyEvaluator = gbLAB::LammpsEnergyEvaluator<GbMesoState>;
+        using CanonicalTP = gbLAB::CanonicalTP<XTuplet,GbMesoState>;
+        using LandauWangTP = gbLAB::LandauWangTP<XTuplet,GbMesoState>;
+        using Limits = std::tuple<double,double,int>;
+
+        py::class_<LammpsEnergyEvaluator>(m, "LammpsEnergyEvaluator")
+                .def(py::init([](const std::string& lmpLocation, const std::string& potentialName){
+                         return LammpsEnergyEvaluator{lmpLocation,potentialName};
+                     }), py::arg("lmpLocation"), py::arg("potentialName"))
+                .def_readwrite("lmpLocation",&LammpsEnergyEvaluator::lmpLocation)
+                .def_readwrite("potentialName",&LammpsEnergyEvaluator::potentialName)
+                .def("__call__",&LammpsEnergyEvaluator::operator(), py::arg("mesoState"),
+                     py::call_guard<py::gil_scoped_release>());
+
+        py::class_<StateEnergyStore, std::shared_ptr<StateEnergyStore>>(m, "StateEnergyStore")
+                .def(py::init<const std::string&>(), py::arg("logFilename")="")
+                .def("find",[](const StateEnergyStore& self, const std::vector<int>& state){
+                    return self.find(toXTuplet(state));
+                }, py::arg("state"))
+                .def("insert",[](StateEnergyStore& self, const std::vector<int>& state, const double& density, const double& energy){
+                    return self.insert(toXTuplet(state),density,energy);
+                }, py::arg("state"), py::arg("density"), py::arg("energy"))
+                .def("importText",&StateEnergyStore::importText, py::arg("filename"))
+                .def("refresh",&StateEnergyStore::refresh)
+                .def("filename",&StateEnergyStore::filename)
+                .def("__len__",&StateEnergyStore::size);
+
+        py::class_<CanonicalTP> canonical(m, "CanonicalTP");
+        canonical.def(py::init([](const py::object& energyEvaluator,
+                                  const double& temperature,
+                                  const std::shared_ptr<StateEnergyStore>& store,
+                                  const std::string& filename){
+                          return new CanonicalTP(toEnergyEvaluator<GbMesoState>(energyEvaluator),
+                                                 temperature,
+                                                 toStateEnergyStore(store),
+                                                 filename);
+                      }), py::arg("energyEvaluator"), py::arg("temperature"), py::arg("stateEnergyStore")=nullptr, py::arg("filename")="");
+        canonical.def(py::init([](const std::string& lmpLocation,
+                                  const std::string& potentialName,
+                                  const double& temperature,
+                                  const std::shared_ptr<StateEnergyStore>& store,
+                                  const std::string& filename){
+                          return new CanonicalTP(lmpLocation,potentialName,temperature,toStateEnergyStore(store),filename);
+                      }), py::arg("lmpLocation"), py::arg("potentialName"), py::arg("temperature"),
+                      py::arg("stateEnergyStore")=nullptr, py::arg("filename")="");
+        canonical.def_readwrite("temperature",&CanonicalTP::temperature);
+        canonical.def_readonly("stateEnergyStore",&CanonicalTP::stateEnergyStore);
+        canonical.def("seed",&CanonicalTP::seed, py::arg("seed"), py::arg("stream")=0);
+
+        py::class_<LandauWangTP> landauWang(m, "LandauWangTP");
+        landauWang.def(py::init([](const Limits& energyLimits,
+                                   const Limits& densityLimits,
+                                   const py::object& energyEvaluator,
+                                   const std::shared_ptr<StateEnergyStore>& store){
+                           return new LandauWangTP(energyLimits,
+                                                   densityLimits,
+                                                   toEnergyEvaluator<GbMesoState>(energyEvaluator),
+                                                   toStateEnergyStore(store));
+                       }), py::arg("energyLimits"), py::arg("densityLimits"), py::arg("energyEvaluator"), py::arg("stateEnergyStore")=nullptr,
+                       "energyLimits and densityLimits are (min, max, number of bins)");
+        landauWang.def_readonly("theta",&LandauWangTP::theta);
+        landauWang.def_readonly("mask",&LandauWangTP::mask);
+        landauWang.def("writeTheta",&LandauWangTP::writeTheta, py::arg("filename"));
+        landauWang.def("seed",&LandauWangTP::seed, py::arg("seed"), py::arg("stream")=0);
+
+        bind_MonteCarlo<CanonicalTP>(m, "MonteCarloCanonical");
+        bind_MonteCarlo<LandauWangTP>(m, "MonteCarloLandauWang");
+    }
+}
+#endif //OILAB_MONTECARLO_BINDINGS_H
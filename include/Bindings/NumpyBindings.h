@@ -0,0 +1,58 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef OILAB_NUMPYBINDINGS_H
+#define OILAB_NUMPYBINDINGS_H
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <Eigen/Core>
+
+namespace py = pybind11;
+
+namespace pyoilab
+{
+    /*! Hands the storage of \p data to NumPy without copying. The data is moved to the heap, and the
+     *  returned array keeps it alive through a capsule.
+     */
+    template<typename T>
+    py::array_t<T> toNumpy(std::vector<T>&& data, const std::vector<py::ssize_t>& shape)
+    {
+        auto* owned= new std::vector<T>(std::move(data));
+        py::capsule owner(owned, [](void* p) { delete static_cast<std::vector<T>*>(p); });
+        return py::array_t<T>(shape, owned->data(), owner);
+    }
+
+    /*! Hands a dim x N column-major matrix to NumPy, without copying, as a C-contiguous (N,dim) array
+     *  (the two have the same memory layout).
+     */
+    template<typename T, int dim>
+    py::array_t<T> toNumpy(Eigen::Matrix<T,dim,Eigen::Dynamic>&& matrix)
+    {
+        auto* owned= new Eigen::Matrix<T,dim,Eigen::Dynamic>(std::move(matrix));
+        py::capsule owner(owned, [](void* p) { delete static_cast<Eigen::Matrix<T,dim,Eigen::Dynamic>*>(p); });
+        return py::array_t<T>(std::vector<py::ssize_t>{owned->cols(),dim}, owned->data(), owner);
+    }
+
+    //! Input (N,dim) array, converted to a C-contiguous array of T only if necessary
+    template<typename T>
+    using NumpyArray= py::array_t<T, py::array::c_style | py::array::forcecast>;
+
+    /*! Views a C-contiguous (N,dim) array as a dim x N column-major matrix, without copying.
+     *  Should be called with the GIL held.
+     */
+    template<int dim, typename T>
+    Eigen::Map<const Eigen::Matrix<T,dim,Eigen::Dynamic>> asMatrix(const NumpyArray<T>& array, const std::string& name)
+    {
+        if(array.ndim()!=2 || array.shape(1)!=dim)
+            throw std::invalid_argument(name+" should be an (N,"+std::to_string(dim)+") array.");
+        return Eigen::Map<const Eigen::Matrix<T,dim,Eigen::Dynamic>>(array.data(),dim,array.shape(0));
+    }
+}
+
+#endif //OILAB_NUMPYBINDINGS_H
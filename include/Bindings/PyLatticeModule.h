@@ -26,5 +26,8 @@ namespace pyoilab
 #include <ReciprocalLatticeVectorBindings.h>
 #include <ReciprocalLatticeDirectionBindings.h>
 #include <BiCrystalBindings.h>
+#include <GbBindings.h>
+#include <GbMesoStateBindings.h>
+#include <MonteCarloBindings.h>
 
 #endif //OILAB_PYLATTICEMODULE_H
@@ -0,0 +1,215 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef OILAB_CHECKPOINT_H
+#define OILAB_CHECKPOINT_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <Eigen/Dense>
+
+namespace gbLAB {
+
+    namespace CheckpointDetail
+    {
+        constexpr char magic[8]= {'O','I','L','A','B','C','K','P'};
+        constexpr std::uint32_t version= 1;
+
+        inline std::uint32_t checksum(const unsigned char* data, const size_t& n)
+        {
+            std::uint32_t h= 2166136261u;
+            for (size_t i=0; i<n; ++i)
+            {
+                h^= data[i];
+                h*= 16777619u;
+            }
+            return h;
+        }
+    }
+
+    /*!
+     * \brief Appends plain values, strings and Eigen matrices to a binary buffer.
+     *
+     * Values are stored in the byte order of the writing machine. The buffer is the payload
+     * of checkpoints (CheckpointWriter) and of the messages of WorkerProtocol.
+     */
+    class BinaryWriter
+    {
+    protected:
+        std::string payload;
+
+    public:
+        template<typename T>
+        std::enable_if_t<std::is_trivially_copyable_v<T>> write(const T& value)
+        {
+            payload.append(reinterpret_cast<const char*>(&value),sizeof(T));
+        }
+
+        void write(const std::string& value)
+        {
+            write(static_cast<std::uint64_t>(value.size()));
+            payload.append(value);
+        }
+
+        template<typename Scalar, int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+        void write(const Eigen::Matrix<Scalar,Rows,Cols,Options,MaxRows,MaxCols>& value)
+        {
+            static_assert(std::is_trivially_copyable_v<Scalar>);
+            write(static_cast<std::int64_t>(value.rows()));
+            write(static_cast<std::int64_t>(value.cols()));
+            payload.append(reinterpret_cast<const char*>(value.data()),value.size()*sizeof(Scalar));
+        }
+
+        //! Starts a section; the reader checks that sections are restored in the order they were saved
+        void section(const std::string& name)
+        {
+            write(name);
+        }
+
+        const std::string& data() const
+        {
+            return payload;
+        }
+    };
+
+    /*!
+     * \brief Reads the values appended by a BinaryWriter.
+     *
+     * Every read is bounds-checked; inconsistencies throw std::runtime_error.
+     */
+    class BinaryReader
+    {
+    protected:
+        std::string payload;
+        size_t position;
+
+        void read(void* data, const size_t& n)
+        {
+            if (position+n>payload.size())
+                throw std::runtime_error("BinaryReader: unexpected end of data.");
+            std::memcpy(data,payload.data()+position,n);
+            position+= n;
+        }
+
+    public:
+        BinaryReader() :
+        /* init */ position(0)
+        {}
+
+        explicit BinaryReader(const std::string& payload) :
+        /* init */ payload(payload),
+        /* init */ position(0)
+        {}
+
+        template<typename T>
+        std::enable_if_t<std::is_trivially_copyable_v<T>> read(T& value)
+        {
+            read(&value,sizeof(T));
+        }
+
+        void read(std::string& value)
+        {
+            std::uint64_t size;
+            read(size);
+            if (position+size>payload.size())
+                throw std::runtime_error("BinaryReader: unexpected end of data.");
+            value= payload.substr(position,size);
+            position+= size;
+        }
+
+        template<typename Scalar, int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+        void read(Eigen::Matrix<Scalar,Rows,Cols,Options,MaxRows,MaxCols>& value)
+        {
+            std::int64_t rows, cols;
+            read(rows);
+            read(cols);
+            if ((Rows!=Eigen::Dynamic && rows!=Rows) || (Cols!=Eigen::Dynamic && cols!=Cols) || rows<0 || cols<0)
+                throw std::runtime_error("BinaryReader: matrix size mismatch.");
+            value.resize(rows,cols);
+            read(value.data(),value.size()*sizeof(Scalar));
+        }
+
+        template<typename T>
+        T read()
+        {
+            T value;
+            read(value);
+            return value;
+        }
+
+        //! Reads the name of the next section, and throws if it is not \p name
+        void section(const std::string& name)
+        {
+            const std::string found(read<std::string>());
+            if (found!=name)
+                throw std::runtime_error("BinaryReader: expected section "+name+", found "+found+".");
+        }
+
+        bool atEnd() const
+        {
+            return position==payload.size();
+        }
+    };
+
+    /*!
+     * \brief Serializes the state of a run into a versioned binary checkpoint.
+     *
+     * Objects append named sections of plain values, strings and Eigen matrices
+     * to an in-memory buffer, which commit() writes to disk atomically: the file
+     * is written to a temporary name, flushed to the disk, and renamed over the
+     * target, so that a job killed while writing leaves the previous checkpoint intact.
+     *
+     * File layout: magic "OILABCKP", format version (uint32), payload size (uint64),
+     * payload, FNV-1a checksum of the payload (uint32).
+     */
+    class CheckpointWriter : public BinaryWriter
+    {
+    public:
+        //! Atomically replaces \p filename with the checkpoint
+        void commit(const std::string& filename) const;
+    };
+
+    /*!
+     * \brief Reads a checkpoint written by CheckpointWriter.
+     *
+     * The file is validated (magic, version and checksum) on construction.
+     */
+    class CheckpointReader : public BinaryReader
+    {
+    public:
+        explicit CheckpointReader(const std::string& filename)
+        {
+            std::ifstream file(filename,std::ios::binary);
+            if (!file)
+                throw std::runtime_error("CheckpointReader: cannot open "+filename+".");
+            const std::string contents((std::istreambuf_iterator<char>(file)),std::istreambuf_iterator<char>());
+
+            const size_t headerSize= sizeof(CheckpointDetail::magic)+sizeof(std::uint32_t)+sizeof(std::uint64_t);
+            if (contents.size()<headerSize+sizeof(std::uint32_t) ||
+                contents.compare(0,sizeof(CheckpointDetail::magic),CheckpointDetail::magic,sizeof(CheckpointDetail::magic))!=0)
+                throw std::runtime_error("CheckpointReader: "+filename+" is not a checkpoint.");
+
+            std::uint32_t version, sum;
+            std::uint64_t size;
+            std::memcpy(&version,contents.data()+sizeof(CheckpointDetail::magic),sizeof(version));
+            std::memcpy(&size,contents.data()+sizeof(CheckpointDetail::magic)+sizeof(version),sizeof(size));
+            if (version!=CheckpointDetail::version)
+                throw std::runtime_error("CheckpointReader: unsupported version "+std::to_string(version)+" of "+filename+".");
+            if (contents.size()!=headerSize+size+sizeof(sum))
+                throw std::runtime_error("CheckpointReader: "+filename+" is truncated.");
+            std::memcpy(&sum,contents.data()+headerSize+size,sizeof(sum));
+            if (sum!=CheckpointDetail::checksum(reinterpret_cast<const unsigned char*>(contents.data())+headerSize,size))
+                throw std::runtime_error("CheckpointReader: checksum mismatch in "+filename+".");
+            payload= contents.substr(headerSize,size);
+        }
+
+    };
+}
+#endif //OILAB_CHECKPOINT_H
@@ -0,0 +1,230 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef gbLAB_ConfigurationIO_h_
+#define gbLAB_ConfigurationIO_h_
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <Log.h>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <Eigen/Dense>
+
+namespace gbLAB
+{
+    /*! \brief File formats of atomic configurations written by the box() functions.
+     *
+     * - xyz: extended-XYZ text, readable by OVITO.
+     * - binary: a fixed-size header followed by the positions (3 x n float64, contiguous) and the
+     *   types (n int8), which can be memory-mapped by MappedConfiguration.
+     * - compressedBinary: binary with the position and type arrays compressed as one zstd block.
+     *   Requires oILAB to be built with USE_ZSTD.
+     */
+    enum class ConfigurationFormat {xyz, binary, compressedBinary};
+
+    //! Converts a format name ("xyz", "binary" or "bin", "zstd") to a ConfigurationFormat
+    inline ConfigurationFormat configurationFormat(const std::string& name)
+    {
+        if(name=="xyz")
+            return ConfigurationFormat::xyz;
+        else if(name=="binary" || name=="bin")
+            return ConfigurationFormat::binary;
+        else if(name=="zstd" || name=="zst")
+            return ConfigurationFormat::compressedBinary;
+        else
+            throw std::runtime_error("Unknown configuration format \""+name+"\". Use xyz, binary, or zstd.");
+    }
+
+    /*! \brief An atomic configuration: a (3D) box, its origin, and typed atomic positions.
+     *
+     * Two-dimensional configurations are stored with a zero third coordinate and a unit
+     * third box vector. The radius of an atom is a function of its type.
+     *
+     * Extended-XYZ files of bicrystals, GBs and mesostates carry the PBC, the origin and the
+     * radius of each atom. Those of Lattice::box have only the box and the typed positions,
+     * which is selected by \p extended= false.
+     */
+    struct Configuration
+    {
+        static constexpr int maxTypes= 8;
+
+        //! Box vectors as columns
+        Eigen::Matrix3d box;
+        Eigen::Vector3d origin;
+        std::array<bool,3> pbc;
+        std::array<double,maxTypes> radii;
+        Eigen::Matrix<double,3,Eigen::Dynamic> positions;
+        std::vector<std::int8_t> types;
+        bool extended;
+
+        explicit Configuration(const size_t& n=0) :
+        /* init */ box(Eigen::Matrix3d::Identity())
+        /* init */,origin(Eigen::Vector3d::Zero())
+        /* init */,pbc{false,true,true}
+        /* init */,radii{0.05,0.05,0.05,0.2,0.01,0.05,0.05,0.05}
+        /* init */,positions(3,n)
+        /* init */,types(n,1)
+        /* init */,extended(true)
+        {}
+
+        size_t size() const
+        {
+            return types.size();
+        }
+
+        double radius(const int& type) const
+        {
+            return (type>=0 && type<maxTypes)? radii[type] : 0.0;
+        }
+    };
+
+    namespace ConfigurationDetail
+    {
+        constexpr char magic[8]= {'O','I','L','A','B','C','F','G'};
+        constexpr std::uint32_t version= 1;
+        constexpr std::uint32_t compressedFlag= 1;
+
+        //! Header of a binary configuration file. Numbers are stored in the byte order of the writing machine.
+        struct Header
+        {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t flags;
+            std::uint64_t numberOfAtoms;
+            std::uint64_t payloadSize;
+            double box[9];
+            double origin[3];
+            double radii[Configuration::maxTypes];
+            std::uint8_t pbc[3];
+            std::uint8_t padding[5];
+        };
+        static_assert(sizeof(Header)%8==0, "The positions following the header should be 8-byte aligned.");
+
+        inline void appendNumber(std::string& s, const double& x)
+        {
+            char buffer[32];
+            const auto result= std::to_chars(buffer,buffer+sizeof(buffer),x);
+            s.append(buffer,result.ptr);
+        }
+
+        inline void appendNumber(std::string& s, const int& x)
+        {
+            char buffer[16];
+            const auto result= std::to_chars(buffer,buffer+sizeof(buffer),x);
+            s.append(buffer,result.ptr);
+        }
+
+        inline void skipSpaces(const char*& p, const char* end)
+        {
+            while(p<end && (*p==' ' || *p=='\t' || *p=='\r'))
+                ++p;
+        }
+
+        template<typename T>
+        bool parseNumber(const char*& p, const char* end, T& value)
+        {
+            skipSpaces(p,end);
+            const auto result= std::from_chars(p,end,value);
+            if(result.ec!=std::errc())
+                return false;
+            p= result.ptr;
+            return true;
+        }
+    }
+
+    /*! Writes \p configuration as extended-XYZ text. Numbers are formatted with std::to_chars
+     *  (shortest representation that reads back exactly), chunks of lines are formatted in
+     *  parallel when oILAB is built with OpenMP, and the file is written in large blocks
+     *  without flushing per line.
+     */
+    void writeExtendedXYZ(const std::string& filename, const Configuration& configuration);
+
+    /*! Writes \p configuration in the binary format (see ConfigurationDetail::Header), with the
+     *  position and type arrays optionally compressed as a single zstd block.
+     */
+    void writeBinaryConfiguration(const std::string& filename, const Configuration& configuration, const bool& compress=false);
+
+    //! Writes \p configuration to \p filename in the given \p format
+    void writeConfiguration(const std::string& filename,
+                            const Configuration& configuration,
+                            const ConfigurationFormat& format=ConfigurationFormat::xyz);
+
+    /*! \brief Read-only view of a binary configuration file.
+     *
+     * The file is memory-mapped on POSIX systems, and the positions and types of an uncompressed
+     * file are accessed in place without copying. On Windows the file is read into memory. A
+     * compressed payload is decompressed once on construction.
+     */
+    class MappedConfiguration
+    {
+        void* map;
+        size_t mapSize;
+        std::vector<char> fileData;
+        ConfigurationDetail::Header header;
+        std::vector<char> decompressed;
+        const double* positionData;
+        const std::int8_t* typeData;
+
+        void release();
+
+    public:
+        explicit MappedConfiguration(const std::string& filename);
+
+        MappedConfiguration(const MappedConfiguration&) = delete;
+        MappedConfiguration& operator=(const MappedConfiguration&) = delete;
+
+        ~MappedConfiguration();
+
+        //! Returns true if \p filename starts with the magic number of the binary format
+        static bool isBinary(const std::string& filename);
+
+        size_t size() const
+        {
+            return header.numberOfAtoms;
+        }
+
+        //! Positions (3 x size()) in place
+        Eigen::Map<const Eigen::Matrix<double,3,Eigen::Dynamic>> positions() const
+        {
+            return Eigen::Map<const Eigen::Matrix<double,3,Eigen::Dynamic>>(positionData,3,size());
+        }
+
+        //! Types (size()) in place
+        const std::int8_t* types() const
+        {
+            return typeData;
+        }
+
+        Eigen::Matrix3d box() const
+        {
+            return Eigen::Map<const Eigen::Matrix3d>(header.box);
+        }
+
+        Eigen::Vector3d origin() const
+        {
+            return Eigen::Map<const Eigen::Vector3d>(header.origin);
+        }
+
+        //! Copies the mapped data into a Configuration
+        Configuration configuration() const;
+    };
+
+    /*! Reads an extended-XYZ file written by writeExtendedXYZ (or by earlier versions of the
+     *  box() functions): lines "type x y z [radius]", with a Lattice header and optional origin and PBC.
+     */
+    Configuration readExtendedXYZ(const std::string& filename);
+
+    //! Reads a configuration file in any of the ConfigurationFormat formats
+    Configuration readConfiguration(const std::string& filename);
+}
+#endif
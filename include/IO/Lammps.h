@@ -12,6 +12,9 @@
 #include <cstdlib>
 #include <cmath>
 #include <sstream>
+#include <atomic>
+#include <Log.h>
+#include <Profiler.h>
 #ifdef _WIN32
     #include <io.h>
     #include <windows.h>
@@ -21,6 +24,7 @@
 #endif
 #include <Eigen/Eigen>
 #include <iomanip>
+#include <ConfigurationIO.h>
 
 std::tuple<Eigen::MatrixXd,
            Eigen::Matrix3d,
@@ -29,76 +33,30 @@ std::tuple<Eigen::MatrixXd,
     Eigen::MatrixXd atoms;
     Eigen::Matrix3d box;
     box.setZero();
-    Eigen::Vector<double,9> boxVectorized;
-    boxVectorized.setZero();
     Eigen::Vector3d origin;
     origin.setZero();
 
-    std::ifstream file(path);
-    if (!file.is_open()) {
-        std::cerr << "Error opening file for reading oilab config file: " << path << std::endl;
+    // extended-XYZ and binary configuration files are both accepted
+    gbLAB::Configuration configuration;
+    try {
+        configuration= gbLAB::readConfiguration(path);
+    }
+    catch (const std::runtime_error& e) {
+        OILAB_LOG(error,io) << "Error opening file for reading oilab config file: " << path << ": " << e.what();
+        return {atoms, box, origin};
     }
 
-    std::string line;
-    int number_atoms = 0;
-
-    int lineCount= 0;
-    int atomCount= 0;
-    int boxCount= -1;
-    int originCount= -1;
-
-    while (std::getline(file, line)) {
-        lineCount++;
-        std::stringstream ss(line);
-        std::string field;
-        std::vector<std::string> fields;
-
-        while (ss >> field) {
-            fields.push_back(field);
-        }
-
-        if (lineCount == 1) {
-            number_atoms = std::stoi(fields[0]);
-            atoms.resize(number_atoms,5);
-            atoms.setZero();
-        }
-        else if (lineCount == 2)
-        {
-            for (size_t i = 0; i < fields.size(); ++i) {
-                if (fields[i].find("Lattice=") != std::string::npos) {
-                    boxCount++;
-                    continue;
-                }
-                if (boxCount>=0 && boxCount<9) {
-                    boxVectorized(boxCount) = std::stod(fields[i]);
-                    boxCount++;
-                    continue;
-                }
-                if (fields[i].find("origin=") != std::string::npos)
-                {
-                    originCount++;
-                    continue;
-                }
-                if (originCount>-1 && originCount<3) {
-                    origin(originCount) = std::stod(fields[i]);
-                    originCount++;
-                    continue;
-                }
-            }
-        }
-        else if (lineCount > 2) {
-            // Reading atom data (type, x, y, z, radius)
-            Eigen::VectorXd atom_data(5);
-            int coordCount= 0;
-            for (const auto &field : fields) {
-                atom_data(coordCount)= std::stod(field);
-                coordCount++;
-            }
-            atoms.row(atomCount)= atom_data;
-            atomCount++;
-        }
+    // atom data: type, x, y, z, radius
+    const Eigen::Index number_atoms= configuration.size();
+    atoms.resize(number_atoms,5);
+    for (Eigen::Index i = 0; i < number_atoms; ++i) {
+        const int type= configuration.types[i];
+        atoms(i,0)= type;
+        atoms.block<1,3>(i,1)= configuration.positions.col(i).transpose();
+        atoms(i,4)= configuration.radius(type);
     }
-    box= boxVectorized.reshaped(3,3);
+    box= configuration.box;
+    origin= configuration.origin;
 
     return {atoms, box, origin};
 
@@ -113,7 +71,7 @@ void write_lammps_datafile(const std::string &filename,
 {
     std::ofstream file(filename);
     if (!file.is_open())
-        std::cerr << "Error opening file for writing lammps configuration file: " << filename << std::endl;
+        OILAB_LOG(error,io) << "Error opening file for writing lammps configuration file: " << filename;
 
     file << "# LAMMPS data file via write_data\n";
     file << "\n";
@@ -142,7 +100,7 @@ void write_lammps_input_script(const std::string &filename,
                                const std::string &output_dump_file) {
     std::ofstream file(filename);
     if (!file.is_open()) {
-        std::cerr << "Error opening file for writing lammps input script: " << filename << std::endl;
+        OILAB_LOG(error,io) << "Error opening file for writing lammps input script: " << filename;
         return;
     }
 
@@ -197,7 +155,7 @@ std::vector<std::vector<double>> read_python_outfile(const std::string &path) {
     std::vector<std::vector<double>> data;
     std::ifstream file(path);
     if (!file.is_open()) {
-        std::cerr << "Error opening file for reading lammps output: " << path << std::endl;
+        OILAB_LOG(error,io) << "Error opening file for reading lammps output: " << path;
         return data;
     }
 
@@ -241,16 +199,34 @@ std::vector<std::vector<double>> read_python_outfile(const std::string &path) {
 }
 
 
+/*!
+ * Tag of the scratch files written by the calling thread: the process id and an index that
+ * is distinct for every thread, including threads that are not managed by OpenMP (e.g. those
+ * of a gbLAB::ThreadPool), for which omp_get_thread_num() would always return 0. Processes
+ * sharing a working directory (e.g. the workers of a MesoStateCoordinator) therefore do not
+ * overwrite each other's files.
+ */
+inline std::string scratchTag()
+{
+    static std::atomic<int> numberOfThreads(0);
+    thread_local const std::string thread(std::to_string(numberOfThreads++));
+#ifdef _WIN32
+    return std::to_string(GetCurrentProcessId())+"_"+thread;
+#else
+    return std::to_string(getpid())+"_"+thread;
+#endif
+}
+
 std::pair<double, double> energy(const std::string& lammpsLocation,
                                  const std::string& oilabConfigFile,
                                  const std::string& potentialFile)
 {
     // Write data
-    std::string threadNumber= std::to_string(omp_get_thread_num());
-    std::string lammpsInputFile= "in"+  threadNumber +".find_energy";
-    std::string lammpsDataFile= "data" + threadNumber + ".lammps_input";
-    std::string lammpsDumpFile= "dump" + threadNumber + ".lammpsConfigs";
-    std::string outfile = "lmp_mesostate_energies" + threadNumber + ".txt";
+    const std::string tag= scratchTag();
+    std::string lammpsInputFile= "in"+ tag +".find_energy";
+    std::string lammpsDataFile= "data" + tag + ".lammps_input";
+    std::string lammpsDumpFile= "dump" + tag + ".lammpsConfigs";
+    std::string outfile = "lmp_mesostate_energies" + tag + ".txt";
 
     // Read data
     auto [atoms, box, origin] = read_oILAB_output(oilabConfigFile);
@@ -299,7 +275,10 @@ std::pair<double, double> energy(const std::string& lammpsLocation,
 
     // Run the LAMMPS script
     std::string command = lammpsLocation +" -in " + lammpsInputFile + " > /dev/null 2>&1";
-    std::system(command.c_str());
+    {
+        OILAB_PROFILE_SCOPE("LAMMPS process");
+        std::system(command.c_str());
+    }
 
     // Read energy
     auto data_energy = read_python_outfile(outfile);
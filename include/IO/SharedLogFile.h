@@ -0,0 +1,63 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef OILAB_SHAREDLOGFILE_H
+#define OILAB_SHAREDLOGFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace gbLAB {
+
+    /*!
+     * \brief A binary file appended to by several processes, serialized with advisory whole-file locks.
+     *
+     * Records are appended at the end of the file and read back at given offsets. The platform calls
+     * (flock, pread and ftruncate on POSIX systems, LockFileEx, ReadFile and SetEndOfFile on Windows)
+     * are confined to SharedLogFile.cpp. Errors throw std::runtime_error.
+     */
+    class SharedLogFile
+    {
+        const std::string filename;
+        //! File descriptor on POSIX systems, HANDLE on Windows
+        std::intptr_t handle;
+
+    public:
+        //! Shared (\p exclusive= false) or exclusive lock of a SharedLogFile, released on scope exit
+        class Lock
+        {
+            const SharedLogFile& file;
+        public:
+            Lock(const SharedLogFile& file, const bool& exclusive);
+            ~Lock();
+            Lock(const Lock&) = delete;
+            Lock& operator=(const Lock&) = delete;
+        };
+
+        //! Opens \p filename for reading and appending, creating it if needed
+        explicit SharedLogFile(const std::string& filename);
+        ~SharedLogFile();
+        SharedLogFile(const SharedLogFile&) = delete;
+        SharedLogFile& operator=(const SharedLogFile&) = delete;
+
+        std::uint64_t size() const;
+
+        //! Reads up to \p n bytes at \p offset; returns the number of bytes read
+        size_t read(const std::uint64_t& offset, void* data, const size_t& n) const;
+
+        //! Appends \p n bytes at the end of the file
+        void append(const void* data, const size_t& n);
+
+        //! Truncates the file to \p size bytes
+        void truncate(const std::uint64_t& size);
+
+        const std::string& name() const
+        {
+            return filename;
+        }
+    };
+}
+#endif //OILAB_SHAREDLOGFILE_H
@@ -10,15 +10,20 @@
 #ifndef model_TextFileParser_H_
 #define model_TextFileParser_H_
 
-//#include <filesystem>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
 #include <string>
-#include <fstream>
-#include <regex>
+#include <string_view>
+#include <sstream>
+#include <charconv>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <set>
-#include <regex>
+#include <algorithm>
 #include <Eigen/Dense>
 
 
@@ -122,158 +127,233 @@ struct StringToScalar<long double>
 };
 
 
-class TextFileParser : public std::ifstream
+/*! \brief Index of the "key=value;" entries of a text file.
+ *
+ * The file is read once with a single read of its whole content, and tokenised into a map from each key (with
+ * spaces removed) to the values and comments of all its entries, in file order. Values are
+ * std::string_view's into the file content owned by the index, and may span several lines
+ * up to the terminating ';'. Lines whose key is commented out with '#' are ignored.
+ */
+class TextFileIndex
+{
+    std::string content;
+
+public:
+
+    struct Entry
+    {
+        std::string_view value;
+        std::string_view comment;
+    };
+
+    const std::string fileName;
+    const std::filesystem::file_time_type modificationTime;
+    std::map<std::string,std::vector<Entry>,std::less<>> entries;
+
+    /**********************************************************************/
+    TextFileIndex(const std::string& _fileName, const std::uintmax_t& fileSize, const std::filesystem::file_time_type& fileTime) :
+    /* init */ content(fileSize,'\0')
+    /* init */,fileName(_fileName)
+    /* init */,modificationTime(fileTime)
+    {
+        std::ifstream file(fileName,std::ios::binary);
+        if(!file)
+        {
+            throw std::runtime_error("File "+fileName+" cannot be opened.");
+        }
+        file.read(content.data(),content.size());
+        content.resize(file.gcount());
+
+        const std::string_view text(content);
+        size_t lineBegin(0);
+        while(lineBegin<text.size())
+        {
+            size_t lineEnd(text.find('\n',lineBegin));
+            if(lineEnd==std::string_view::npos) lineEnd=text.size();
+            const std::string_view line(text.substr(lineBegin,lineEnd-lineBegin));
+            const size_t foundEqual(line.find('='));
+            const size_t foundPound(line.find('#'));
+            if(foundEqual!=std::string_view::npos && foundPound>foundEqual
+               && (foundPound==std::string_view::npos || line.find(';')<foundPound))
+            {
+                std::string key(line.substr(0,foundEqual));
+                key.erase(std::remove_if(key.begin(), key.end(), [](unsigned char x) { return std::isspace(x); }), key.end());
+                const size_t valueBegin(lineBegin+foundEqual+1);
+                const size_t foundSemiCol(text.find(';',valueBegin));
+                if(!key.empty() && foundSemiCol!=std::string_view::npos)
+                {
+                    size_t entryEnd(text.find('\n',foundSemiCol));
+                    if(entryEnd==std::string_view::npos) entryEnd=text.size();
+                    const std::string_view tail(text.substr(foundSemiCol+1,entryEnd-foundSemiCol-1));
+                    const size_t commentBegin(tail.find('#'));
+                    entries[key].push_back(Entry{text.substr(valueBegin,foundSemiCol-valueBegin),
+                                                 commentBegin==std::string_view::npos? std::string_view() : tail.substr(commentBegin)});
+                    lineEnd=entryEnd;
+                }
+            }
+            lineBegin=lineEnd+1;
+        }
+    }
+
+    TextFileIndex(const TextFileIndex&) = delete;
+    TextFileIndex& operator=(const TextFileIndex&) = delete;
+
+    /**********************************************************************/
+    bool isCurrent(const std::uintmax_t& fileSize, const std::filesystem::file_time_type& fileTime) const
+    {
+        return fileSize==content.size() && fileTime==modificationTime;
+    }
+};
+
+class TextFileParser
 {
     
     template <typename Scalar>
     using EigenMapType=Eigen::Map<const Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic>, 0, Eigen::Stride<Eigen::Dynamic,Eigen::Dynamic> >;
-    
+
+    std::shared_ptr<const TextFileIndex> index;
+
     /**********************************************************************/
-//    std::pair<std::string,std::string> readKey( const std::string& key
-//    //                               ,const bool& removeWitespaces=true
-//    )
-//    {
-//        this->seekg (0, this->beg); // reset the position of the next character at beginning for each read
-//    this->clear();
-//    this->seekg(0);
-//
-//        std::string line;
-//        std::string read;
-//        std::string comment;
-//        bool success(false);
-//
-//        while (std::getline(*this, line))
-//        {
-//            const size_t foundKey=line.find(key);
-//            const size_t foundEqual=line.find("=");
-//            const std::string keyRead(removeSpaces(line.substr(0,foundEqual)));
-//
-//            if(keyRead==key)
-//            {
-//                const size_t foundSemiCol=line.find(";");
-//                const size_t foundPound=line.find("#");
-//
-//                if(   foundKey!=std::string::npos
-//                   && foundEqual!=std::string::npos
-//                   && foundSemiCol!=std::string::npos
-//                   && foundKey<foundEqual
-//                   && foundEqual<foundSemiCol
-//                   && foundSemiCol<foundPound
-//                   )
-//                {
-//                    read=line.substr(foundEqual+1,foundSemiCol-foundEqual-1);
-//                    if(foundPound!=std::string::npos)
-//                    {
-//                        comment=line.substr(foundPound,line.size()-foundPound);
-//                    }
-//                    success=true;
-//                    break;
-//
-//                }
-//            }
-//        }
-//
-//        if(!success)
-//        {
-//            throw std::runtime_error("File "+fileName+" does not cointain line with format "+key+"=...;");
-//            //                std::cout<<"File "<<fileName<<" does not cointain line with format:\n"<< key <<"=...;\n EXITING"<<std::endl;
-//            //                exit(EXIT_FAILURE);
-//        }
-//
-//        //            if(removeWitespaces)
-//        //            {
-//        //                std::regex_replace( read, "\s", "" );
-//        //            }
-//        //            std::cout<<key<<"="<<read<<std::endl;
-//
-//        return std::make_pair(read,comment);
-//    }
-    
-    std::vector<std::pair<std::string,std::string>> readKey( const std::string& key)
+    /*! Returns the index of \p fileName, shared by all parsers of the same file, including
+     *  parsers created one after the other. The index is rebuilt when the size or the
+     *  modification time of the file changes. At most maxCachedFiles indices are kept; beyond
+     *  that, the least recently used one is evicted.
+     */
+    static std::shared_ptr<const TextFileIndex> getIndex(const std::string& fileName)
     {
-        this->clear();
-        this->seekg(0);
-        std::vector<std::pair<std::string,std::string>> returnVector;
-        std::string line;
+        std::error_code error;
+        const std::uintmax_t fileSize(std::filesystem::file_size(fileName,error));
+        const std::filesystem::file_time_type fileTime(error? std::filesystem::file_time_type() : std::filesystem::last_write_time(fileName,error));
+        if(error)
+        {
+            throw std::runtime_error("File "+fileName+" cannot be opened.");
+        }
 
-        while (std::getline(*this, line))
+        std::lock_guard<std::mutex> lock(cacheMutex());
+        auto& cache(indexCache());
+        static size_t lookups(0);
+        CachedIndex& cachedIndex(cache[fileName]);
+        cachedIndex.lastLookup=++lookups;
+        if(!cachedIndex.index || !cachedIndex.index->isCurrent(fileSize,fileTime))
         {
-            const size_t foundKey=line.find(key);
-            const size_t foundEqual=line.find("=");
-            
-            if(   foundKey!=std::string::npos
-               && foundEqual!=std::string::npos
-               && foundKey<foundEqual)
-            {
-                const std::string keyRead(removeSpaces(line.substr(0,foundEqual)));
+            cachedIndex.index=std::make_shared<const TextFileIndex>(fileName,fileSize,fileTime);
+        }
+        const std::shared_ptr<const TextFileIndex> output(cachedIndex.index);
+        if(cache.size()>maxCachedFiles)
+        {
+            cache.erase(std::min_element(cache.begin(),cache.end(),[](const auto& a, const auto& b)
+                                         {
+                                             return a.second.lastLookup<b.second.lastLookup;
+                                         }));
+        }
+        return output;
+    }
+
+    /**********************************************************************/
+    struct CachedIndex
+    {
+        std::shared_ptr<const TextFileIndex> index;
+        size_t lastLookup=0;
+    };
+
+    /**********************************************************************/
+    static std::map<std::string,CachedIndex>& indexCache()
+    {
+        static std::map<std::string,CachedIndex> cache;
+        return cache;
+    }
+
+    /**********************************************************************/
+    static std::mutex& cacheMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    /**********************************************************************/
+    const std::vector<TextFileIndex::Entry>& readKey(const std::string& key) const
+    {
+        const auto iter(index->entries.find(key));
+        if(iter==index->entries.end())
+        {
+            throw std::runtime_error("File "+fileName+" does not cointain line with format "+key+"=...;");
+        }
+        return iter->second;
+    }
 
-                if(keyRead==key)
+    /**********************************************************************/
+    template<typename Scalar>
+    static std::vector<Scalar> toArray(const std::string& key, const std::string_view& value)
+    {
+        std::vector<Scalar> array;
+        if constexpr (std::is_arithmetic_v<Scalar>)
+        {
+            const char* p(value.data());
+            const char* const end(value.data()+value.size());
+            while(true)
+            {
+                while(p<end && (std::isspace(static_cast<unsigned char>(*p)) || *p=='+')) ++p;
+                if(p==end) break;
+                Scalar temp(0);
+                auto result(std::from_chars(p,end,temp));
+                if constexpr (std::is_integral_v<Scalar>)
                 {
-                    
-                    
-                    const size_t foundSemiCol=line.find(";");
-                    const size_t foundPound=line.find("#");
-                                        
-                    if(   //foundKey!=std::string::npos
-                        foundEqual!=std::string::npos
-                       && foundSemiCol!=std::string::npos
-                       //&& foundKey<foundEqual
-                       && foundEqual<foundSemiCol
-                       && foundSemiCol<foundPound
-                       )
-                    {
-                        const std::string read(line.substr(foundEqual+1,foundSemiCol-foundEqual-1));
-
-                        if(foundPound!=std::string::npos)
-                        {
-                            const std::string comment(line.substr(foundPound,line.size()-foundPound));
-                            returnVector.emplace_back(read,comment);
-                        }
-                        else
-                        {
-                            returnVector.emplace_back(read,std::string());
-                        }
+                    if(result.ec==std::errc() && result.ptr<end && (*result.ptr=='.' || *result.ptr=='e' || *result.ptr=='E'))
+                    {// as with the former std::atoi-based parsing, a floating point value such as "3.0" is read as an integer (truncated toward zero)
+                        double floatingTemp(0.0);
+                        result=std::from_chars(p,end,floatingTemp);
+                        temp=static_cast<Scalar>(floatingTemp);
                     }
                 }
+                if(result.ec!=std::errc())
+                {
+                    throw std::runtime_error("Error in reading "+key+": cannot convert \""+std::string(value)+"\" to "+typeid(Scalar).name()+".");
+                }
+                array.push_back(temp);
+                p=result.ptr;
             }
         }
-        if(returnVector.size()==0)
+        else
         {
-            throw std::runtime_error("File "+fileName+" does not cointain line with format "+key+"=...;");
+            Scalar temp;
+            std::stringstream ss{std::string(value)};
+            while (ss >> temp)
+            {
+                array.push_back(temp);
+            }
         }
-
-        return returnVector;
+        return array;
     }
     
     
 public:
     
     const std::string fileName;
+
+    //! Largest number of files whose index is cached
+    static constexpr size_t maxCachedFiles=256;
     
     /**********************************************************************/
     TextFileParser(const std::string& _fileName) :
-    /* init */ std::ifstream(_fileName)
+    /* init */ index(getIndex(_fileName))
     /* init */,fileName(_fileName)
     {
-        if(!this->is_open())
-        {
-            throw std::runtime_error("File "+fileName+" cannot be opened.");
-            //                std::cout<<"File "<<fileName<<" cannot be opened. Exiting."<<std::endl;
-            //                exit(EXIT_FAILURE);
-        }
     }
-    
-//    TextFileParser(const std::filesystem::path& _fileName) :
-//    /* init */ std::ifstream(_fileName.string())
-//    /* init */,fileName(_fileName.string())
-//    {
-//        if(!this->is_open())
-//        {
-//            throw std::runtime_error("File "+fileName+" cannot be opened.");
-//            //                std::cout<<"File "<<fileName<<" cannot be opened. Exiting."<<std::endl;
-//            //                exit(EXIT_FAILURE);
-//        }
-//    }
+
+    /**********************************************************************/
+    //! Discards the cached indices of all files
+    static void clearCache()
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex());
+        indexCache().clear();
+    }
+
+    /**********************************************************************/
+    //! The index of the file, shared with the other parsers of the same file
+    const std::shared_ptr<const TextFileIndex>& fileIndex() const
+    {
+        return index;
+    }
     
     static std::string removeSpaces(std::string key)
     {
@@ -282,33 +362,42 @@ public:
     }
     
     /**********************************************************************/
-    std::string readString(const std::string& key,const bool&verbose=false)
+    std::string readString(const std::string& key,const bool&verbose=false) const
     {
-        const std::pair<std::string,std::string> strPair(readKey(key)[0]);
-        if(verbose) std::cout<<cyanColor<<key<<"="<<strPair.first<<" "<<strPair.second<<defaultColor<<std::endl;
-        return strPair.first;
+        const TextFileIndex::Entry& entry(readKey(key)[0]);
+        if(verbose) std::cout<<cyanColor<<key<<"="<<entry.value<<" "<<entry.comment<<defaultColor<<std::endl;
+        return std::string(entry.value);
     }
     
     /**********************************************************************/
-    std::vector<std::pair<std::string,std::string>> readStringVector(const std::string& key)
+    std::vector<std::pair<std::string,std::string>> readStringVector(const std::string& key) const
     {
-        return readKey(key);
+        std::vector<std::pair<std::string,std::string>> returnVector;
+        for(const auto& entry : readKey(key))
+        {
+            returnVector.emplace_back(entry.value,entry.comment);
+        }
+        return returnVector;
     }
     
     /**********************************************************************/
     template<typename Scalar>
-    Scalar readScalar(const std::string& key,const bool&verbose=false)
+    Scalar readScalar(const std::string& key,const bool&verbose=false) const
     {
         if(verbose) std::cout<<cyanColor<<key<<"="<<std::flush;
-        const std::pair<std::string,std::string> strPair(readKey(key)[0]);
-        const Scalar read(StringToScalar<Scalar>::toScalar(strPair.first));
-        if(verbose) std::cout<<read<<" "<<strPair.second<<defaultColor<<std::endl;
-        return read;
+        const TextFileIndex::Entry& entry(readKey(key)[0]);
+        const std::vector<Scalar> array(toArray<Scalar>(key,entry.value));
+        if(array.size()!=1)
+        {
+            throw std::runtime_error("Error in reading scalar "+key+": found "+std::to_string(array.size())+" values.");
+        }
+        if(verbose) std::cout<<array[0]<<" "<<entry.comment<<defaultColor<<std::endl;
+        return array[0];
     }
     
     /**********************************************************************/
     template<typename Scalar>
-    std::set<Scalar> readSet(const std::string& key,const bool&verbose=false)
+    std::set<Scalar> readSet(const std::string& key,const bool&verbose=false) const
     {
         std::vector<Scalar> tempV(readArray<Scalar>(key,false));
         std::set<Scalar> tempS;
@@ -331,84 +420,10 @@ public:
     
     /**********************************************************************/
     template<typename Scalar>
-    std::vector<Scalar> readArray(const std::string& key,const bool&verbose=false)
+    std::vector<Scalar> readArray(const std::string& key,const bool&verbose=false) const
     {
-//        this->seekg (0, this->beg); // reset the position of the next character at beginning for each read
-        this->clear();
-        this->seekg(0);
-        
-        std::string line;
-        std::string lines;
-        std::string comment;
-        std::vector<Scalar> array;
-        bool success=false;
-        
-        while (std::getline(*this, line))
-        {
-            
-            const size_t foundKey=line.find(key);
-            const size_t foundEqual=line.find("=");
-            
-            const std::string keyRead(removeSpaces(line.substr(0,foundEqual)));
-
-            if(keyRead==key)
-            {
-                size_t foundSemiCol=line.find(";");
-                size_t foundPound=line.find("#");
-                
-                if(   foundKey!=std::string::npos
-                   && foundEqual!=std::string::npos
-                   && foundKey<foundEqual
-                   && (foundPound==std::string::npos || foundPound>foundSemiCol)
-                   )
-                {
-                    lines+=line;
-                    foundSemiCol=line.find(";");
-                    
-                    if(   foundSemiCol!=std::string::npos
-                       && foundEqual<foundSemiCol)
-                    {
-                        success=true;
-                    }
-                    else
-                    {
-                        while(std::getline(*this, line))
-                        {
-                            lines+=(" "+line);
-                            foundSemiCol=lines.find(";");
-                            if(foundSemiCol!=std::string::npos && foundEqual<foundSemiCol)
-                            {
-                                success=true;
-                                break;
-                            }
-                        }
-                    }
-                    
-                    if(success)
-                    {
-                        foundPound=line.find("#");
-                        if(foundPound!=std::string::npos)
-                        {
-                            comment=lines.substr(foundPound,lines.size()-foundPound);
-                        }
-                        
-                        
-                        Scalar temp(0.0);
-                        std::stringstream ss(lines.substr(foundEqual+1,foundSemiCol-foundEqual-1));
-                        while (ss >> temp)
-                        {
-                            array.push_back(temp);
-                        }
-                        break;
-                    }
-                }
-            }
-        }
-        
-        if(!success)
-        {
-            throw std::runtime_error("File "+fileName+" does not cointain line with format "+key+"=...;");
-        }
+        const TextFileIndex::Entry& entry(readKey(key)[0]);
+        const std::vector<Scalar> array(toArray<Scalar>(key,entry.value));
         
         if(verbose)
         {
@@ -417,7 +432,7 @@ public:
             {
                 std::cout<<" "<<val;
             }
-            std::cout<<"; "<<comment<<defaultColor<<std::endl;
+            std::cout<<"; "<<entry.comment<<defaultColor<<std::endl;
             
         }
         
@@ -426,7 +441,7 @@ public:
     
     /**********************************************************************/
     template<typename Scalar>
-    Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> readMatrix(const std::string& key,const size_t& rows,const size_t& cols,const bool&verbose=false)
+    Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> readMatrix(const std::string& key,const size_t& rows,const size_t& cols,const bool&verbose=false) const
     {
         
         const std::vector<Scalar> array=readArray<Scalar>(key,false);
@@ -445,14 +460,14 @@ public:
     
     /**********************************************************************/
     template<typename Scalar,int rows,int cols>
-    Eigen::Matrix<Scalar,rows,cols> readMatrix(const std::string& key,const bool&verbose=false)
+    Eigen::Matrix<Scalar,rows,cols> readMatrix(const std::string& key,const bool&verbose=false) const
     {
         return  readMatrix<Scalar>(key,rows,cols,verbose);
     }
     
     /**********************************************************************/
     template<typename Scalar>
-    Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> readMatrixCols(const std::string& key,const size_t& cols,const bool&verbose=false)
+    Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> readMatrixCols(const std::string& key,const size_t& cols,const bool&verbose=false) const
     {
         
         const std::vector<Scalar> array=readArray<Scalar>(key,false);
@@ -471,7 +486,7 @@ public:
     
     /**********************************************************************/
     template<typename Scalar>
-    Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> readMatrixRows(const std::string& key,const size_t& rows,const bool&verbose=false)
+    Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> readMatrixRows(const std::string& key,const size_t& rows,const bool&verbose=false) const
     {
         
         const std::vector<Scalar> array=readArray<Scalar>(key,false);
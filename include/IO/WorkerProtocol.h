@@ -0,0 +1,144 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef OILAB_WORKERPROTOCOL_H
+#define OILAB_WORKERPROTOCOL_H
+
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <Checkpoint.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace gbLAB {
+
+    /*!
+     * \brief The messages exchanged by a MesoStateCoordinator and its workers (oilab-worker).
+     *
+     * Every message is a frame: magic "OILW" (uint32), message type (uint32), payload size (uint64),
+     * followed by a payload encoded with BinaryWriter. A worker connects to the coordinator and
+     * sends hello; the coordinator answers with setup, to which the worker replies ready (or failure).
+     * The coordinator then sends tasks, each answered by one result, and finally shutdown.
+     *
+     * | type     | payload                                                                                   |
+     * |----------|-------------------------------------------------------------------------------------------|
+     * | hello    | protocol version (uint32), process id (int64)                                             |
+     * | setup    | MesoStateWorkerSetup                                                                      |
+     * | ready    | number of (b,s) pairs of the ensemble (uint64)                                            |
+     * | failure  | error message (string)                                                                    |
+     * | task     | task id (uint64), number of states (uint64), states (XTuplet)                             |
+     * | result   | task id (uint64), number of states (uint64), per state: success (bool), density, energy (double), message (string) |
+     * | shutdown | empty                                                                                     |
+     *
+     * Payloads larger than maxMessageSize are rejected before anything is allocated for them.
+     */
+    namespace WorkerProtocol
+    {
+        constexpr std::uint32_t magic= 0x574c494f;
+        constexpr std::uint32_t version= 1;
+        //! Largest accepted payload, in bytes
+        constexpr std::uint64_t maxMessageSize= std::uint64_t(1) << 30;
+
+        enum class MessageType : std::uint32_t {hello=1, setup, ready, failure, task, result, shutdown};
+
+#ifdef MSG_NOSIGNAL
+        constexpr int sendFlags= MSG_NOSIGNAL;
+#else
+        constexpr int sendFlags= 0;
+#endif
+
+        /*! Keeps a write to a socket closed by the peer from raising SIGPIPE, so that it fails with EPIPE.
+         * Nothing is needed where send accepts MSG_NOSIGNAL; otherwise the socket is marked SO_NOSIGPIPE,
+         * or, as a last resort, SIGPIPE is ignored by the process.
+         */
+        inline void disableSigPipe([[maybe_unused]] const int& fd)
+        {
+#if defined(MSG_NOSIGNAL)
+#elif defined(SO_NOSIGPIPE)
+            const int on= 1;
+            ::setsockopt(fd,SOL_SOCKET,SO_NOSIGPIPE,&on,sizeof(on));
+#else
+            std::signal(SIGPIPE,SIG_IGN);
+#endif
+        }
+
+        //! Sends n bytes on a socket prepared with disableSigPipe
+        inline void sendAll(const int& fd, const char* data, size_t n)
+        {
+            while (n>0)
+            {
+                const ssize_t sent= ::send(fd,data,n,sendFlags);
+                if (sent<0)
+                {
+                    if (errno==EINTR) continue;
+                    throw std::runtime_error("WorkerProtocol: connection lost while sending.");
+                }
+                data+= sent;
+                n-= sent;
+            }
+        }
+
+        //! Returns false if the peer closed the connection before the first byte
+        inline bool receiveAll(const int& fd, char* data, size_t n)
+        {
+            const size_t total= n;
+            while (n>0)
+            {
+                const ssize_t received= ::recv(fd,data,n,0);
+                if (received<0 && errno==EINTR)
+                    continue;
+                if (received<=0)
+                {
+                    if (n==total)
+                        return false;
+                    throw std::runtime_error("WorkerProtocol: connection lost in the middle of a message.");
+                }
+                data+= received;
+                n-= received;
+            }
+            return true;
+        }
+
+        inline void send(const int& fd, const MessageType& type, const BinaryWriter& payload=BinaryWriter())
+        {
+            BinaryWriter frame;
+            frame.write(magic);
+            frame.write(type);
+            frame.write(static_cast<std::uint64_t>(payload.data().size()));
+            std::string message(frame.data());
+            message.append(payload.data());
+            sendAll(fd,message.data(),message.size());
+        }
+
+        /*!
+         * Receives the next message into \p type and \p payload. Returns false if the
+         * peer closed the connection, and throws if the frame is malformed or its payload
+         * exceeds maxMessageSize.
+         */
+        inline bool receive(const int& fd, MessageType& type, BinaryReader& payload)
+        {
+            char header[sizeof(std::uint32_t)+sizeof(MessageType)+sizeof(std::uint64_t)];
+            if (!receiveAll(fd,header,sizeof(header)))
+                return false;
+            BinaryReader frame(std::string(header,sizeof(header)));
+            if (frame.read<std::uint32_t>()!=magic)
+                throw std::runtime_error("WorkerProtocol: invalid message.");
+            frame.read(type);
+            const auto size= frame.read<std::uint64_t>();
+            if (size>maxMessageSize)
+                throw std::runtime_error("WorkerProtocol: message of "+std::to_string(size)+" bytes exceeds the limit.");
+            std::string data(size,'\0');
+            if (size>0 && !receiveAll(fd,data.data(),size))
+                throw std::runtime_error("WorkerProtocol: connection lost in the middle of a message.");
+            payload= BinaryReader(data);
+            return true;
+        }
+    }
+}
+#endif //OILAB_WORKERPROTOCOL_H
@@ -0,0 +1,111 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef gbLAB_BallEnumerator_h_
+#define gbLAB_BallEnumerator_h_
+
+#include <cmath>
+#include <stdexcept>
+#include <LatticeModule.h>
+#include <GramMatrix.h>
+#include <RLLL.h>
+
+namespace gbLAB
+{
+    /*! \brief Enumerates the lattice points \f$\textbf x\f$ (integer coordinates) with
+     * \f$|\textbf A\textbf x|\le r\f$, where \f$\textbf A\f$ is the lattice basis, using the
+     * Fincke-Pohst algorithm.
+     *
+     * The basis is first RLLL-reduced, \f$\textbf A\textbf U\f$, and the Gram matrix of the reduced basis
+     * is factored as \f$\textbf G=\textbf R^T\textbf R\f$. Writing \f$\textbf x=\textbf U\textbf y\f$,
+     * \f$|\textbf A\textbf x|^2=\sum_i R_{ii}^2\big(y_i+\sum_{j>i}R_{ij}y_j/R_{ii}\big)^2\f$, so the
+     * admissible values of \f$y_i\f$ form an interval whose center and half-width depend only on
+     * \f$y_{i+1},\dots,y_{dim-1}\f$. The points are generated level by level from the last index, and
+     * the work is proportional to the number of points in the ball rather than to the volume of a
+     * bounding box.
+     */
+    template<int dim>
+    class BallEnumerator
+    {
+        typedef typename LatticeCore<dim>::IntScalarType IntScalarType;
+        typedef typename LatticeCore<dim>::VectorDimI VectorDimI;
+        typedef typename LatticeCore<dim>::VectorDimD VectorDimD;
+        typedef typename LatticeCore<dim>::MatrixDimI MatrixDimI;
+        typedef typename LatticeCore<dim>::MatrixDimD MatrixDimD;
+
+        const double radiusSquared;
+        MatrixDimI U;
+        MatrixDimD R;
+
+        // residual(level) is r^2 minus the contribution of the indices above level
+        template<int level, typename VisitorType>
+        void visit(VectorDimI& y, const double& residual, VisitorType& visitor) const
+        {
+            if constexpr (level<0)
+                visitor((U*y).eval());
+            else
+            {
+                double center= 0.0;
+                for(int j=level+1; j<dim; ++j)
+                    center-= R(level,j)*y(j);
+                center/= R(level,level);
+                const double halfWidth= std::sqrt(std::max(residual,0.0))/std::abs(R(level,level));
+                const IntScalarType first= std::ceil(center-halfWidth);
+                const IntScalarType last= std::floor(center+halfWidth);
+                for(IntScalarType k=first; k<=last; ++k)
+                {
+                    y(level)= k;
+                    const double d= R(level,level)*(k-center);
+                    visit<level-1>(y,residual-d*d,visitor);
+                }
+                y(level)= 0;
+            }
+        }
+
+        static MatrixDimI getU(const MatrixDimD& A)
+        {
+            const Eigen::MatrixXd reducedBasis(RLLL(A,0.75).reducedBasis());
+            const MatrixDimD Ud(A.inverse()*reducedBasis);
+            const MatrixDimI output(Ud.array().round().matrix().template cast<IntScalarType>());
+            // fall back to the input basis if the reduction did not return a unimodular change of basis
+            if((Ud-output.template cast<double>()).norm()>FLT_EPSILON*Ud.norm() ||
+               std::abs(std::llround(output.template cast<double>().determinant()))!=1)
+                return MatrixDimI::Identity();
+            return output;
+        }
+
+        static MatrixDimD getR(const MatrixDimD& A, const MatrixDimI& U)
+        {
+            const MatrixDimD reducedBasis(A*U.template cast<double>());
+            std::array<VectorDimD,dim> columns;
+            for(int i=0; i<dim; ++i)
+                columns[i]= reducedBasis.col(i);
+            const GramMatrix<double,dim> G(columns);
+            return G.llt().matrixU();
+        }
+
+    public:
+        /*! @param A lattice basis (columns)
+         *  @param radius radius of the ball centered at the origin
+         */
+        BallEnumerator(const MatrixDimD& A, const double& radius) :
+        /* init */ radiusSquared(radius*radius)
+        /* init */,U(getU(A))
+        /* init */,R(getR(A,U))
+        {
+            if(radius<0)
+                throw std::runtime_error("BallEnumerator: negative radius.");
+        }
+
+        //! Calls visitor(x) for the integer coordinates x of each lattice point in the ball
+        template<typename VisitorType>
+        void visit(VisitorType& visitor) const
+        {
+            VectorDimI y(VectorDimI::Zero());
+            visit<dim-1>(y,radiusSquared,visitor);
+        }
+    };
+}
+#endif
@@ -13,6 +13,8 @@
 #include "LLL.h"
 #include "RLLL.h"
 #include <unordered_set>
+#include <array>
+#include <optional>
 #include "Rotation.h"
 
 
@@ -32,8 +34,11 @@ namespace gbLAB
         typedef typename LatticeCore<dim>::MatrixDimD MatrixDimD;
         typedef typename LatticeCore<dim>::VectorDimI VectorDimI;
         typedef typename LatticeCore<dim>::MatrixDimI MatrixDimI;
+        typedef std::array<std::array<std::optional<MatrixDimI>,4>,4> TransitionTable;
+
+        //! Indices of lattices \f$\mathcal A, \mathcal B, \mathcal C, \mathcal D\f$ in the transition tables
+        enum LatticeIndex {indexA=0, indexB=1, indexC=2, indexD=3};
 
-        
         static MatrixDimI getM(const RationalMatrix<dim>& rm, const SmithDecomposition<dim>& sd);
         static MatrixDimI getN(const RationalMatrix<dim>& rm, const SmithDecomposition<dim>& sd);
         static MatrixDimI getLambdaA(const MatrixDimI& M, const MatrixDimI& N);
@@ -50,8 +55,10 @@ namespace gbLAB
                                        const MatrixDimI& M,
                                        const MatrixDimI& N,
                                        const bool& useRLLL);
+        static const SmithDecomposition<dim>& checkSmithDecomposition(const MatrixDimI& P, const SmithDecomposition<dim>& sd);
 
     public:
+        typedef Eigen::Matrix<IntScalarType,dim,Eigen::Dynamic> MatrixDimXI;
 
         const Lattice<dim>& A;
         const Lattice<dim>& B;
@@ -107,6 +114,22 @@ namespace gbLAB
          */
         const MatrixDimI LambdaB;
 
+    private:
+        void verify() const;
+        int latticeIndex(const Lattice<dim>& lattice) const;
+        TransitionTable getTransitions(const bool& reciprocal) const;
+
+        /*! \brief Integer matrices \f$\textbf T_{ij}\f$, indexed [from][to], mapping the coordinates of a
+         * lattice vector in lattice \f$i\f$ to those of a parallel lattice vector in lattice \f$j\f$, with the
+         * same orientation. Empty for pairs that have no integer transition.
+         */
+        const TransitionTable latticeTransitions;
+
+        /*! \brief Same as latticeTransitions for the dual lattices.
+         */
+        const TransitionTable reciprocalTransitions;
+
+    public:
 
         LatticeVector<dim> shiftTensorA(const LatticeVector<dim>& d) const;
         LatticeVector<dim> shiftTensorB(const LatticeVector<dim>& d) const;
@@ -124,6 +147,15 @@ namespace gbLAB
                   const Lattice<dim>& B,
                   const bool& useRLLL=false);
 
+        /*! \brief Constructs a bicrystal from two lattices \f$\mathcal A \f$ and \f$\mathcal B \f$ using a precomputed
+         *  Smith decomposition \p sd of the integer matrix of their transition matrix (e.g. from a CslCatalogueEntry).
+         *  Throws if \p sd does not decompose that matrix.
+         * */
+        BiCrystal(const Lattice<dim>& A,
+                  const Lattice<dim>& B,
+                  const SmithDecomposition<dim>& sd,
+                  const bool& useRLLL=false);
+
         /*!
          * Outputs lattice vector in lattice \f$\mathcal A\f$ that is equal to the inputted vector \f$\textbf v\f$
          * that belongs to \f$\mathcal A\f$ or \f$\mathcal C\f$
@@ -193,6 +225,49 @@ namespace gbLAB
          */
         ReciprocalLatticeDirection<dim> getReciprocalLatticeDirectionInD(const ReciprocalLatticeVector<dim>& v) const;
 
+        /*!
+         * Outputs the integer matrix that maps the coordinates of a lattice vector in \p from to those of the
+         * equal (for targets \f$\mathcal A\f$, \f$\mathcal B\f$, and \f$\mathcal D\f$) or parallel (for target
+         * \f$\mathcal C\f$) lattice vector in \p to. Both lattices should be one of
+         * \f$\mathcal A\f$, \f$\mathcal B\f$, \f$\mathcal C\f$, or \f$\mathcal D\f$.
+         * @param from - lattice of the input coordinates
+         * @param to - lattice of the output coordinates
+         * @return transition matrix
+         */
+        const MatrixDimI& transitionMatrix(const Lattice<dim>& from, const Lattice<dim>& to) const;
+        /*!
+         * Outputs the integer matrix that maps the coordinates of a reciprocal lattice vector in the dual of \p from
+         * to those of a parallel reciprocal lattice vector in the dual of \p to.
+         * @param from - lattice of the input coordinates
+         * @param to - lattice of the output coordinates
+         * @return transition matrix
+         */
+        const MatrixDimI& reciprocalTransitionMatrix(const Lattice<dim>& from, const Lattice<dim>& to) const;
+
+        /*!
+         * Converts a block of lattice vectors, stored as the columns of a \f$dim\times N\f$ integer matrix, from
+         * lattice \p from to lattice \p to with a single matrix product. Each column of the output is the vector
+         * returned by the corresponding single-vector function (getLatticeVectorInA, getLatticeVectorInB,
+         * getLatticeVectorInD, or the lattice vector of getLatticeDirectionInC).
+         * @param coordinates - integer coordinates in \p from
+         * @param from - lattice of the input coordinates
+         * @param to - lattice of the output coordinates
+         * @return integer coordinates in \p to
+         */
+        MatrixDimXI convertLatticeCoordinates(const MatrixDimXI& coordinates,
+                                              const Lattice<dim>& from,
+                                              const Lattice<dim>& to) const;
+        /*!
+         * Reciprocal counterpart of convertLatticeCoordinates.
+         * @param coordinates - integer coordinates in the dual of \p from
+         * @param from - lattice of the input coordinates
+         * @param to - lattice of the output coordinates
+         * @return integer coordinates in the dual of \p to
+         */
+        MatrixDimXI convertReciprocalLatticeCoordinates(const MatrixDimXI& coordinates,
+                                                        const Lattice<dim>& from,
+                                                        const Lattice<dim>& to) const;
+
         /*!
          * \brief Given a tilt axis \f$\textbf d\f$, that belongs to lattices \f$\mathcal A\f$ or \f$\mathcal B\f$, this
          * function generate a set of tilt GBs. CURRENTLY ONLY WORDS FOR DIMENSION 3
@@ -220,6 +295,7 @@ namespace gbLAB
          * @param orient (optional) While printing to a file, orient the system such that one of the box sides
          * is along the global x axis. This flag does not
          * influence the returning configuration, only the configuration printed to the file.
+         * @param format (optional) format of the output file
          * @return lattice points of the bicrystal (along with the CSL) bounded by the box (std::vector<LatticeVector<2>>).
          */
         template<int dm=dim>
@@ -228,7 +304,8 @@ namespace gbLAB
                 const double& orthogonality, 
                 const int& dsclFactor,
                 std::string filename= "", 
-                bool orient=false) const;
+                bool orient=false,
+                const ConfigurationFormat& format= ConfigurationFormat::xyz) const;
     };
     
     
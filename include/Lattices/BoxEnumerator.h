@@ -0,0 +1,123 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef gbLAB_BoxEnumerator_h_
+#define gbLAB_BoxEnumerator_h_
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include <LatticeModule.h>
+#include <HermiteNormalForm.h>
+#include <IntegerMath.h>
+
+namespace gbLAB
+{
+    /*! \brief Enumerates the lattice points \f$\textbf x\f$ (integer coordinates) of the box spanned by
+     * dim linearly independent lattice vectors \f$\textbf B=[\textbf b_0 \dots \textbf b_{dim-1}]\f$, i.e.
+     * the points whose fractional coordinates \f$\textbf f=\textbf B^{-1}\textbf x\f$ lie in \f$[0,1)^{dim}\f$.
+     *
+     * With \f$D=|\det \textbf B|\f$, the integer matrix \f$\textbf G=D\textbf B^{-1}\f$ is brought to its
+     * Hermite normal form \f$\textbf H=\textbf G\textbf W\f$. The box points are \f$\textbf x=\textbf W\textbf n\f$,
+     * where \f$\textbf f=\textbf H\textbf n/D\f$. Since \f$\textbf H\f$ is lower triangular, each index
+     * \f$n_i\f$ runs over \f$D/H_{ii}\f$ consecutive integers whose first value depends only on
+     * \f$n_0,\dots,n_{i-1}\f$, so the points are generated directly, without a modulo operation. There are
+     * \f$D\f$ points in total, and \f$H_{00}\f$ points (a block) for each value of the outermost index
+     * \f$n_0\f$, so that blocks can be generated independently.
+     */
+    template<int dim>
+    class BoxEnumerator
+    {
+        typedef typename LatticeCore<dim>::IntScalarType IntScalarType;
+        typedef typename LatticeCore<dim>::VectorDimI VectorDimI;
+        typedef typename LatticeCore<dim>::MatrixDimI MatrixDimI;
+
+        IntScalarType volume;
+        MatrixDimI B;
+        MatrixDimI H;
+        MatrixDimI W;
+        MatrixDimI Winv;
+
+        // s(i) holds sum_{j<level} H(i,j)*n(j); the first admissible n(level) is ceil(-s(level)/H(level,level))
+        template<int level, typename VisitorType>
+        void visit(VectorDimI x, VectorDimI s, VisitorType& visitor) const
+        {
+            if constexpr (level==dim)
+                visitor(x);
+            else
+            {
+                const IntScalarType h= H(level,level);
+                const IntScalarType first= -(s(level)/h - ((s(level)%h!=0) && (s(level)<0)));
+                x+= first*W.col(level);
+                s+= first*H.col(level);
+                for(IntScalarType k=0; k<volume/h; ++k)
+                {
+                    visit<level+1>(x,s,visitor);
+                    x+= W.col(level);
+                    s+= H.col(level);
+                }
+            }
+        }
+
+    public:
+
+        BoxEnumerator(const std::vector<LatticeVector<dim>>& boxVectors)
+        {
+            if(boxVectors.size()!=dim)
+                throw std::runtime_error("The number of box vectors should be equal to the dimension.");
+            for(int i=0; i<dim; ++i)
+                B.col(i)= boxVectors[i];
+            const IntScalarType detB= std::llround(B.template cast<double>().determinant());
+            if(detB==0)
+                throw std::runtime_error("Box vectors are linearly dependent.");
+            volume= std::abs(detB);
+            const HermiteNormalForm<dim> hnf(((detB>0? 1 : -1)*MatrixDimIExt<IntScalarType,dim>::adjoint(B)).eval());
+            H= hnf.matrixH();
+            W= hnf.matrixW();
+            Winv= std::llround(W.template cast<double>().determinant())*MatrixDimIExt<IntScalarType,dim>::adjoint(W);
+        }
+
+        //! Number of lattice points in the box
+        IntScalarType size() const
+        {
+            return volume;
+        }
+
+        //! Number of values of the outermost index
+        IntScalarType outerSize() const
+        {
+            return volume/H(0,0);
+        }
+
+        //! Number of lattice points for each value of the outermost index
+        IntScalarType blockSize() const
+        {
+            return H(0,0);
+        }
+
+        /*! Indices \f$\textbf n\f$ of the box point congruent to \p x modulo the box vectors. The points are
+         * visited in lexicographic order of their indices, so these are sort keys for the visiting order.
+         */
+        VectorDimI indices(const VectorDimI& x) const
+        {
+            const VectorDimI numerators(H*Winv*x);   // D times the fractional coordinates of x
+            VectorDimI cells;
+            for(int i=0; i<dim; ++i)
+                cells(i)= numerators(i)/volume - ((numerators(i)%volume!=0) && (numerators(i)<0));
+            return Winv*(x-B*cells);
+        }
+
+        //! Calls visitor(x) for the integer coordinates x of each point in block \p n, with \f$0\le n<\f$ outerSize()
+        template<typename VisitorType>
+        void visitBlock(const IntScalarType& n, VisitorType& visitor) const
+        {
+            if constexpr (dim==1)
+                visitor((n*W.col(0)).eval());
+            else
+                visit<1>((n*W.col(0)).eval(),(n*H.col(0)).eval(),visitor);
+        }
+    };
+}
+#endif
@@ -0,0 +1,144 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef OILAB_CSLCATALOGUE_H
+#define OILAB_CSLCATALOGUE_H
+
+#include <array>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <LatticeModule.h>
+#include <Checkpoint.h>
+
+namespace gbLAB {
+
+    /*!
+     * \brief One coincidence rotation of a catalogue: lattice \f$\mathcal B\f$ is lattice \f$\mathcal A\f$ rotated by
+     * \p angle about \p axis, and the bicrystal \f$(\mathcal A,\mathcal B)\f$ has a CSL of index \p sigma.
+     *
+     * Integer matrices refer to the (unrotated) basis \f$\textbf A\f$ of the catalogue's lattice. The Smith
+     * decomposition \f$\textbf D=\textbf U\textbf P\textbf V\f$ is that of the integer matrix \f$\textbf P\f$ of the
+     * transition matrix between \f$\mathcal A\f$ and \f$\mathcal B\f$, so that a BiCrystal can be built from the entry
+     * without decomposing \f$\textbf P\f$ again (see smithDecomposition()).
+     */
+    struct CslCatalogueEntry
+    {
+        using IntScalarType= typename LatticeCore<3>::IntScalarType;
+        using VectorDimI= typename LatticeCore<3>::VectorDimI;
+        using MatrixDimI= typename LatticeCore<3>::MatrixDimI;
+
+        //! Rotation axis: primitive reciprocal lattice direction of \f$\mathcal A\f$, whose first nonzero entry is positive
+        VectorDimI axis;
+        //! Right-handed rotation angle about the axis, in \f$(0,2\pi)\f$
+        double angle;
+        int sigma;
+        Eigen::Matrix3d rotation;
+        //! Diagonal of \f$\textbf D\f$
+        VectorDimI smithD;
+        MatrixDimI smithU;
+        MatrixDimI smithV;
+        //! CSL basis \f$\textbf C=\textbf A\,\textbf K_{\mathcal C}\f$ (not reduced)
+        MatrixDimI cslMatrix;
+        //! DSCL basis \f$\textbf D\f$ such that \f$\textbf A=\textbf D\,\textbf K_{\mathcal D}\f$ (not reduced)
+        MatrixDimI dsclMatrix;
+        //! LLL-reduced basis (columns) of the CSL plane normal to the axis, in the coordinates of the CSL basis \f$\textbf C\f$
+        Eigen::Matrix<IntScalarType,3,2> gbPlaneBasis;
+
+        //! The Smith decomposition of the transition matrix, as stored in the entry
+        SmithDecomposition<3> smithDecomposition(const MatrixDimI& P) const;
+
+        /*!
+         * \brief Bicrystal of \p A and \p B, which have to be the lattice of the catalogue and its rotation by
+         * \p rotation. The Smith decomposition is taken from the entry.
+         */
+        BiCrystal<3> biCrystal(const Lattice<3>& A, const Lattice<3>& B, const bool& useRLLL=false) const;
+
+        //! Computes the entry of the bicrystal \p bc (built with useRLLL=false) rotated about \p axis
+        static CslCatalogueEntry fromBiCrystal(const BiCrystal<3>& bc, const VectorDimI& axis);
+
+        void write(BinaryWriter& writer) const;
+        void read(BinaryReader& reader);
+    };
+
+    /*!
+     * \brief Catalogue of the coincidence rotations of a lattice, up to a maximum \f$\Sigma\f$.
+     *
+     * A catalogue is generated once (e.g. with the oilab-csl-catalogue executable) and stored in a
+     * checkpoint-format binary file. Entries can be looked up by axis, \f$\Sigma\f$ range or angle window,
+     * and turned into bicrystals without recomputing the Smith decompositions:
+     * \code
+     * const CslCatalogue catalogue("fcc.cat");
+     * const Lattice<3> A(catalogue.latticeBasis);
+     * for(const auto* entry : catalogue.bySigma(3,11))
+     * {
+     *     const Lattice<3> B(catalogue.latticeBasis,entry->rotation);
+     *     const BiCrystal<3> bc(entry->biCrystal(A,B));
+     * }
+     * \endcode
+     */
+    class CslCatalogue
+    {
+        using IntScalarType= typename LatticeCore<3>::IntScalarType;
+        using VectorDimI= typename LatticeCore<3>::VectorDimI;
+        using Axis= std::array<IntScalarType,3>;
+
+        //! Entries of each axis, sorted by angle
+        std::map<Axis,std::vector<size_t>> axisEntries;
+        //! All entries sorted by sigma
+        std::vector<size_t> sigmaEntries;
+
+        void index();
+        static Axis key(const VectorDimI& axis);
+
+    public:
+        //! Version of the layout of the entries in a catalogue file
+        static constexpr std::uint32_t formatVersion= 1;
+
+        std::string latticeName;
+        Eigen::Matrix3d latticeBasis;
+        int maxSigma;
+        //! Entries sorted by axis and angle
+        std::vector<CslCatalogueEntry> entries;
+
+        //! Basis of a named lattice: sc, bcc and fcc (lattice constant \p a), and hcp (hexagonal, \p a and \p c)
+        static Eigen::Matrix3d standardBasis(const std::string& name, const double& a=1.0, const double& c=std::sqrt(8.0/3.0));
+
+        /*!
+         * \brief Generates the catalogue of the lattice \p latticeBasis for the axes \p axes
+         * @param maxSigma - largest \f$\Sigma\f$ in the catalogue
+         * @param maxDen - resolution of the search of rotations (see Lattice::generateCoincidentLattices)
+         */
+        CslCatalogue(const std::string& latticeName,
+                     const Eigen::Matrix3d& latticeBasis,
+                     const std::vector<VectorDimI>& axes,
+                     const int& maxSigma,
+                     const double& maxDen=100);
+
+        //! Reads a catalogue file
+        explicit CslCatalogue(const std::string& filename);
+
+        void write(const std::string& filename) const;
+
+        //! Primitive axes with entries in \f$[-\f$\p maxIndex, \p maxIndex\f$]\f$, one of each pair \f$\pm\textbf a\f$
+        static std::vector<VectorDimI> axes(const int& maxIndex);
+
+        /*!
+         * \brief Entries about \p axis (any nonzero multiple), sorted by angle.
+         *
+         * The axis and angle of the returned copies refer to \p axis: if it is a negative multiple of the stored axis,
+         * the axis is flipped and the angle \f$\theta\f$ becomes \f$2\pi-\theta\f$.
+         */
+        std::vector<CslCatalogueEntry> byAxis(const VectorDimI& axis) const;
+
+        //! Entries with \p minSigma \f$\le\Sigma\le\f$ \p maxSigma, sorted by \f$\Sigma\f$
+        std::vector<const CslCatalogueEntry*> bySigma(const int& minSigma, const int& maxSigma) const;
+
+        //! Entries about \p axis with \p minAngle \f$\le\theta\le\f$ \p maxAngle (radians), with \f$\theta\f$ as in byAxis()
+        std::vector<CslCatalogueEntry> byAngle(const VectorDimI& axis, const double& minAngle, const double& maxAngle) const;
+    };
+}
+#endif //OILAB_CSLCATALOGUE_H
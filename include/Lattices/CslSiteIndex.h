@@ -0,0 +1,132 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef OILAB_CSLSITEINDEX_H
+#define OILAB_CSLSITEINDEX_H
+
+#include <array>
+#include <cmath>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+#include <Eigen/Dense>
+#include <LatticeCore.h>
+
+namespace gbLAB {
+
+    /*!
+     * \brief Hash index of a set of CSL sites of a periodic box.
+     *
+     * The sites are points of a lattice \f$\mathcal L\f$ (e.g. the DSCL, or a refinement of it) whose
+     * vectors include the box vectors. A point is located by its integer coordinates in the basis of
+     * \f$\mathcal L\f$, reduced modulo the box into the
+     * cell \f$\{\textbf B \textbf f: \textbf f \in [\textbf t, \textbf t + 1)\}\f$, where \f$\textbf B\f$
+     * holds the box vectors as columns and \f$\textbf t\f$ is the shift. Finding the sites at a point is
+     * therefore O(1), independently of the number of sites. The index is immutable and may be shared by
+     * concurrent readers.
+     */
+    template<int dim>
+    class CslSiteIndex
+    {
+        using IntScalarType= typename LatticeCore<dim>::IntScalarType;
+        using VectorDimD= typename LatticeCore<dim>::VectorDimD;
+        using MatrixDimD= typename LatticeCore<dim>::MatrixDimD;
+
+    public:
+        using Key= std::array<IntScalarType,dim>;
+
+    private:
+        struct KeyHash
+        {
+            std::size_t operator()(const Key& key) const noexcept
+            {
+                std::size_t seed= 0;
+                for (const auto& k : key)
+                    seed^= std::hash<IntScalarType>{}(k) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+                return seed;
+            }
+        };
+
+        const MatrixDimD latticeBasis;
+        const MatrixDimD latticeBasisInverse;
+        const MatrixDimD box;
+        const MatrixDimD boxInverse;
+        const VectorDimD shift;
+        const double tolerance;
+        std::unordered_map<Key,std::vector<int>,KeyHash> sites;
+        int numberOfSites;
+
+    public:
+        /*!
+         * @param latticeBasis - basis vectors (columns) of the lattice \f$\mathcal L\f$ of the sites
+         * @param box - box vectors (columns), which have to be vectors of \f$\mathcal L\f$
+         * @param shift - fractional shift of the reduced cell
+         * @param points - points of \f$\mathcal L\f$; the i-th point is the site i
+         * @param tolerance - distance below which a point is considered to be at a lattice point
+         */
+        CslSiteIndex(const MatrixDimD& latticeBasis,
+                     const MatrixDimD& box,
+                     const VectorDimD& shift,
+                     const std::vector<VectorDimD>& points,
+                     const double& tolerance= 1e-6) :
+        /* init */ latticeBasis(latticeBasis)
+        /* init */,latticeBasisInverse(latticeBasis.inverse())
+        /* init */,box(box)
+        /* init */,boxInverse(box.inverse())
+        /* init */,shift(shift)
+        /* init */,tolerance(tolerance)
+        /* init */,numberOfSites(points.size())
+        {
+            for (int i=0; i<numberOfSites; ++i)
+            {
+                const auto k(key(points[i]));
+                if (!k)
+                    throw std::runtime_error("CslSiteIndex: a site is not a lattice point.");
+                sites[*k].push_back(i);
+            }
+        }
+
+        /*!
+         * \brief Key of the lattice point within \p tolerance of \p x, or nothing if \p x is not at a lattice point.
+         *
+         * The lattice point, not \p x, is reduced modulo the box, so that images of a site have the same
+         * key even if \p x lies on the boundary of the cell.
+         */
+        std::optional<Key> key(const VectorDimD& x) const
+        {
+            const VectorDimD coordinates(latticeBasisInverse*x);
+            VectorDimD rounded(coordinates.array().round());
+            if ((latticeBasis*(coordinates-rounded)).norm()>tolerance)
+                return std::nullopt;
+
+            const VectorDimD fractional((boxInverse*(latticeBasis*rounded)).array()-shift.array());
+            rounded-= (latticeBasisInverse*box)*fractional.array().floor().matrix();
+            Key output;
+            for (int d=0; d<dim; ++d)
+                output[d]= std::llround(rounded(d));
+            return output;
+        }
+
+        /*!
+         * \brief Sites at the point \p x (modulo the box), or nullptr if there are none
+         */
+        const std::vector<int>* find(const VectorDimD& x) const
+        {
+            const auto k(key(x));
+            if (!k)
+                return nullptr;
+            const auto iter= sites.find(*k);
+            return iter==sites.end() ? nullptr : &iter->second;
+        }
+
+        //! Number of points passed to the constructor
+        int size() const
+        {
+            return numberOfSites;
+        }
+    };
+}
+#endif //OILAB_CSLSITEINDEX_H
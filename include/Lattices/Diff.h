@@ -8,11 +8,24 @@
 #include <Operator.h>
 #include <LatticeModule.h>
 #include <unsupported/Eigen/CXX11/Tensor>
+#include <unsupported/Eigen/FFT>
 #include <FFT.h>
+#include <algorithm>
 #include <numbers>
+#include <numeric>
+#include <vector>
 
 
 namespace gbLAB {
+    /*!
+     * \brief Spectral derivative \f$\partial^{d_1}_1\cdots\partial^{d_{dim}}_{dim}\f$ of a periodic function sampled on a grid
+     * of \p n points of the domain \p A.
+     *
+     * The Fourier symbol of the operator is \f$i^{|d|}s(\textbf m)\f$, where \f$|d|=\sum_k d_k\f$ and \f$s\f$ is real. It is
+     * computed once, at construction, on the half spectrum of the real-to-complex transform along the first dimension.
+     * perform_op then transforms the input, multiplies it by the symbol and transforms it back, in the buffers of a
+     * Workspace; given a Workspace, it does not allocate.
+     */
     template<int dim>
     class Diff : public Operator<Diff<dim>,dim>
     {
@@ -21,183 +34,192 @@ namespace gbLAB {
         using Operator<Diff<dim>,dim>::n, Operator<Diff<dim>,dim>::L;
         const Eigen::array<Eigen::Index,dim> d;
 
-        explicit Diff(const Eigen::array<Eigen::Index,dim>& d_,
-                      const Eigen::Matrix<double,dim,dim>& A,
-                      const Eigen::array<Eigen::Index,dim>& n_) :
-                      Operator<Diff<dim>,dim>(A,n_),
-                      d(d_)
+        /*!
+         * \brief FFT plans and spectrum buffers of perform_op. A workspace may be reused by calls to any Diff with the
+         * same grid, but not by concurrent calls.
+         */
+        class Workspace
         {
-            for(const auto& order : d)
-                assert(order >= 0);
+            friend class Diff<dim>;
+            //! the grid whose transforms the buffers hold
+            const Eigen::array<Eigen::Index,dim> n;
+            Eigen::FFT<double> fft;
+            std::vector<dcomplex> spectrum;
+            std::vector<dcomplex> lineIn;
+            std::vector<dcomplex> lineOut;
+            std::vector<double> realLine;
+
+        public:
+            explicit Workspace(const Eigen::array<Eigen::Index,dim>& n) :
+            /* init */ n(n)
+            /* init */,spectrum((n[0]/2+1)*std::accumulate(n.begin()+1,n.end(),Eigen::Index(1),std::multiplies<>()))
+            /* init */,lineIn(*std::max_element(n.begin(),n.end()))
+            /* init */,lineOut(lineIn.size())
+            /* init */,realLine(n[0])
+            {
+                fft.SetFlag(Eigen::FFT<double>::HalfSpectrum);
+                // the first transforms create the plans and the scratch buffers of the FFT
+                fft.fwd(spectrum.data(),realLine.data(),n[0]);
+                fft.inv(realLine.data(),spectrum.data(),n[0]);
+                for (int a=1; a<dim; ++a)
+                {
+                    fft.fwd(lineOut.data(),lineIn.data(),n[a]);
+                    fft.inv(lineOut.data(),lineIn.data(),n[a]);
+                }
+            }
+        };
 
+    private:
+        static int getOrder(const Eigen::array<Eigen::Index,dim>& d)
+        {
+            int order= 0;
+            for(const auto& dk : d)
+            {
+                assert(dk >= 0);
+                order+= dk;
+            }
+            return order;
         }
 
-        template<int dm=dim>
-        typename std::enable_if<dm==1,void>::type
-        perform_op(const double* x_in, double* y_out) const
+        static dcomplex getParity(const int& order)
         {
-            Eigen::TensorMap<const Eigen::Tensor<double,dm>> xReal(x_in,n);
-            const Eigen::Tensor<dcomplex,dm> x=xReal.template cast<dcomplex>();
-            Eigen::TensorMap<Eigen::Tensor<double,dm>> y(y_out,n);
+            const std::array<dcomplex,4> powers{dcomplex(1,0),dcomplex(0,1),dcomplex(-1,0),dcomplex(0,-1)};
+            return powers[order % 4];
+        }
 
-            // if d=0 y_out= x_in and return
-            int totalOrder= 0;
-            for(const auto& order : d)
+        /*!
+         * \brief Real part \f$s(\textbf m)\f$ of the symbol at the grid index \p index. Odd derivatives vanish at the
+         * Nyquist frequency of even grids.
+         */
+        static double realSymbol(const Eigen::array<Eigen::Index,dim>& d,
+                                 const Lattice<dim>& L,
+                                 const Eigen::array<Eigen::Index,dim>& n,
+                                 const Eigen::array<Eigen::Index,dim>& index)
+        {
+            double s= 1.0;
+            for (int k= 0; k<dim; ++k)
             {
-                totalOrder= totalOrder + order;
-            }
-            if (totalOrder == 0) {
-                y= xReal;
-                return;
-            }
-
-            // Compute y = Lx using FFT
-            Eigen::Tensor<dcomplex,dm> xhat(n);
-            xhat.setZero();
-            FFT::fft(x,xhat);
-
-            Eigen::Tensor<dcomplex,dm> d2fhat(n);
-            d2fhat.setZero();
-
-            // only part which is dimension dependent
-            for (int i = 0; i < n[0]; ++i) {
-                ReciprocalLatticeVector<dm> r(L);
-                dcomplex factor(1,0);
-                for (int k= 0; k<dim; ++k) {
-                    if (d[k] == 0) continue;
-                    else if (d[k] % 2 == 0)
-                        r << (i <= n[0] / 2 ? i : i - n[0]);
+                if (d[k] == 0) continue;
+                typename LatticeCore<dim>::VectorDimD m;
+                for (int a= 0; a<dim; ++a)
+                {
+                    const Eigen::Index i= index[a];
+                    if (d[k] % 2 == 0)
+                        m(a)= (2*i <= n[a] ? i : i - n[a]);
                     else
-                        r << (i == n[0] / 2 ? 0 : -n[0] * (i / (n[0] / 2)) + i);
-                    factor = factor * std::pow(-2.0 * std::numbers::pi *
-                                               dcomplex(0, 1) *
-                                               r.cartesian()(k),
-                                               d[k]);
+                        m(a)= (2*i == n[a] ? 0 : (2*i < n[a] ? i : i - n[a]));
                 }
-                d2fhat(i)= xhat(i) * factor;
+                s*= std::pow(-2.0 * std::numbers::pi * L.reciprocalBasis.row(k).dot(m), d[k]);
             }
-
-            // Laplacian Lf
-            Eigen::Tensor<dcomplex,dm> Lf(n);
-            Lf.setZero();
-            FFT::ifft(d2fhat,Lf);
-            y= Lf.real();
+            return s;
         }
 
-        template<int dm=dim>
-        typename std::enable_if<dm==2,void>::type
-        perform_op(const double* x_in, double* y_out) const
+        /*!
+         * \brief Real part of the symbol on the half spectrum. The symbol is made Hermitian,
+         * \f$\frac{1}{2}[s(\textbf m)+(-1)^{|d|}s(-\textbf m)]\f$, so that the complex-to-real transform returns the real
+         * part of the inverse transform of the full spectrum.
+         */
+        static Eigen::Tensor<double,dim> getSymbol(const Eigen::array<Eigen::Index,dim>& d,
+                                                   const Lattice<dim>& L,
+                                                   const Eigen::array<Eigen::Index,dim>& n)
         {
-            Eigen::TensorMap<const Eigen::Tensor<double,2>> xReal(x_in,n);
-            const Eigen::Tensor<dcomplex,2> x=xReal.cast<dcomplex>();
-            Eigen::TensorMap<Eigen::Tensor<double,2>> y(y_out,n);
-
-            // if d=0 y_out= x_in and return
-            int totalOrder= 0;
-            for(const auto& order : d)
+            Eigen::array<Eigen::Index,dim> halfN(n);
+            halfN[0]= n[0]/2+1;
+            Eigen::Tensor<double,dim> symbol(halfN);
+            const double sign= getOrder(d) % 2 == 0 ? 1.0 : -1.0;
+            for (Eigen::Index p= 0; p<symbol.size(); ++p)
             {
-                totalOrder= totalOrder + order;
-            }
-            if (totalOrder == 0) {
-                y= xReal;
-                return;
+                Eigen::array<Eigen::Index,dim> index, conjugateIndex;
+                Eigen::Index q= p;
+                for (int a= 0; a<dim; ++a)
+                {
+                    index[a]= q % halfN[a];
+                    q/= halfN[a];
+                    conjugateIndex[a]= (n[a]-index[a]) % n[a];
+                }
+                symbol.data()[p]= 0.5*(realSymbol(d,L,n,index) + sign*realSymbol(d,L,n,conjugateIndex));
             }
+            return symbol;
+        }
 
-            // Compute y = Lx using FFT
-            Eigen::Tensor<dcomplex,2> xhat(n);
-            xhat.setZero();
-            FFT::fft(x,xhat);
-
-            Eigen::Tensor<dcomplex,2> d2fhat(n);
-            d2fhat.setZero();
-
-            // only part which is dimension dependent
-                for (int i = 0; i < n[0]; ++i) {
-                    for (int j = 0; j < n[1]; ++j) {
-                        ReciprocalLatticeVector<2> r(L);
-                        dcomplex factor(1,0);
-                        for (int k= 0; k<dim; ++k) {
-                            if (d[k] == 0) continue;
-                            else if (d[k] % 2 == 0)
-                                r << (i <= n[0] / 2 ? i : i - n[0]),
-                                     (j <= n[1] / 2 ? j : j - n[1]);
-                            else
-                                r << (i == n[0] / 2 ? 0 : -n[0] * (i / (n[0] / 2)) + i),
-                                     (j == n[1] / 2 ? 0 : -n[1] * (j / (n[1] / 2)) + j);
-                            factor = factor * std::pow(-2.0 * std::numbers::pi *
-                                                       dcomplex(0, 1) *
-                                                       r.cartesian()(k),
-                                                       d[k]);
-                        }
-                        d2fhat(i,j)= xhat(i,j) * factor;
+        // complex transforms along the dimensions a>0 of the half spectrum
+        void transformLines(Workspace& workspace, const bool& inverse) const
+        {
+            Eigen::Index stride= n[0]/2+1;
+            const Eigen::Index size= workspace.spectrum.size();
+            for (int a= 1; a<dim; ++a)
+            {
+                const Eigen::Index length= n[a];
+                for (Eigen::Index outer= 0; outer<size; outer+= stride*length)
+                {
+                    for (Eigen::Index inner= 0; inner<stride; ++inner)
+                    {
+                        dcomplex* line= workspace.spectrum.data()+outer+inner;
+                        for (Eigen::Index t= 0; t<length; ++t)
+                            workspace.lineIn[t]= line[t*stride];
+                        if (inverse)
+                            workspace.fft.inv(workspace.lineOut.data(),workspace.lineIn.data(),length);
+                        else
+                            workspace.fft.fwd(workspace.lineOut.data(),workspace.lineIn.data(),length);
+                        for (Eigen::Index t= 0; t<length; ++t)
+                            line[t*stride]= workspace.lineOut[t];
                     }
                 }
+                stride*= length;
+            }
+        }
 
-            // Laplacian Lf
-            Eigen::Tensor<dcomplex,2> Lf(n);
-            Lf.setZero();
-            FFT::ifft(d2fhat,Lf);
-            y= Lf.real();
+    public:
+        //! Total order \f$|d|\f$ of the derivative
+        const int order;
+        //! \f$i^{|d|}\f$
+        const dcomplex parity;
+        //! Real part of the symbol on the half spectrum, of size \f$(n_1/2+1)\times n_2\times\cdots\f$
+        const Eigen::Tensor<double,dim> symbol;
+
+        explicit Diff(const Eigen::array<Eigen::Index,dim>& d_,
+                      const Eigen::Matrix<double,dim,dim>& A,
+                      const Eigen::array<Eigen::Index,dim>& n_) :
+                      Operator<Diff<dim>,dim>(A,n_),
+                      d(d_),
+                      order(getOrder(d)),
+                      parity(getParity(order)),
+                      symbol(getSymbol(d,L,n))
+        {
         }
 
-        template<int dm=dim>
-        typename std::enable_if<dm==3,void>::type
-        perform_op(const double* x_in, double* y_out) const
+        //! Computes y = Lx in the buffers of \p workspace, without allocating
+        void perform_op(const double* x_in, double* y_out, Workspace& workspace) const
         {
-            Eigen::TensorMap<const Eigen::Tensor<double,dm>> xReal(x_in,n);
-            const Eigen::Tensor<dcomplex,dm> x=xReal.template cast<dcomplex>();
-            Eigen::TensorMap<Eigen::Tensor<double,dm>> y(y_out,n);
+            OILAB_PROFILE_SCOPE("Diff::perform_op");
+            assert(workspace.n == n && "The workspace belongs to a different grid.");
+            const Eigen::Index n0= n[0];
+            const Eigen::Index h0= n0/2+1;
+            const Eigen::Index lines= symbol.size()/h0;
 
             // if d=0 y_out= x_in and return
-            int totalOrder= 0;
-            for(const auto& order : d)
-            {
-                totalOrder= totalOrder + order;
-            }
-            if (totalOrder == 0) {
-                y= xReal;
+            if (order == 0) {
+                std::copy(x_in,x_in+n0*lines,y_out);
                 return;
             }
 
-            // Compute y = Lx using FFT
-            Eigen::Tensor<dcomplex,dm> xhat(n);
-            xhat.setZero();
-            FFT::fft(x,xhat);
-
-            Eigen::Tensor<dcomplex,dm> d2fhat(n);
-            d2fhat.setZero();
-
-            // only part which is dimension dependent
-            for (int i = 0; i < n[0]; ++i) {
-                for (int j = 0; j < n[1]; ++j) {
-                    for (int k = 0; k < n[2]; ++k) {
-                        ReciprocalLatticeVector<dm> r(L);
-                        dcomplex factor(1, 0);
-                        for (int l = 0; l < dm; ++l) {
-                            if (d[l] == 0) continue;
-                            else if (d[l] % 2 == 0)
-                                r << (i <= n[0] / 2 ? i : i - n[0]),
-                                     (j <= n[1] / 2 ? j : j - n[1]),
-                                     (k <= n[2] / 2 ? k : k - n[2]);
-                            else
-                                r << (i == n[0] / 2 ? 0 : -n[0] * (i / (n[0] / 2)) + i),
-                                     (j == n[1] / 2 ? 0 : -n[1] * (j / (n[1] / 2)) + j),
-                                     (k == n[2] / 2 ? 0 : -n[2] * (k / (n[2] / 2)) + k);
-                            factor = factor * std::pow(-2.0 * std::numbers::pi *
-                                                       dcomplex(0, 1) *
-                                                       r.cartesian()(l),
-                                                       d[l]);
-                        }
-                        d2fhat(i,j,k) = xhat(i,j,k) * factor;
-                    }
-                }
-            }
+            for (Eigen::Index l= 0; l<lines; ++l)
+                workspace.fft.fwd(workspace.spectrum.data()+l*h0,x_in+l*n0,n0);
+            transformLines(workspace,false);
+
+            for (Eigen::Index p= 0; p<symbol.size(); ++p)
+                workspace.spectrum[p]*= parity*symbol.data()[p];
 
-            // Laplacian Lf
-            Eigen::Tensor<dcomplex,dm> Lf(n);
-            Lf.setZero();
-            FFT::ifft(d2fhat,Lf);
-            y= Lf.real();
+            transformLines(workspace,true);
+            for (Eigen::Index l= 0; l<lines; ++l)
+                workspace.fft.inv(y_out+l*n0,workspace.spectrum.data()+l*h0,n0);
+        }
+
+        //! Computes y = Lx using a temporary Workspace
+        void perform_op(const double* x_in, double* y_out) const
+        {
+            Workspace workspace(n);
+            perform_op(x_in,y_out,workspace);
         }
     };
 }
@@ -109,6 +109,7 @@ namespace gbLAB
          * the global x, y, and z axes. The box vectors spanning the grain boundary have to be orthogonal
          * if orient==true. This flag does not
          * influence the returning configuration, only the configuration printed to the file.
+         * @param format (optional) format of the output file
          * @return lattice points of the grain boundary bounded by the box (std::vector<LatticeVector<dim>>).
          */
         template<int dm=dim>
@@ -117,7 +118,8 @@ namespace gbLAB
             const double& orthogonality,
             const int& dsclFactor,
             std::string filename= "",
-            bool orient=false) const;
+            bool orient=false,
+            const ConfigurationFormat& format= ConfigurationFormat::xyz) const;
 
     };
 
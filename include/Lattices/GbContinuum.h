@@ -6,12 +6,16 @@
 #define OILAB_GBPLASTICITY_H
 
 #include <LatticeCore.h>
+#include <Log.h>
+#include <Profiler.h>
 #include "Eigen/Dense"
 #include <PeriodicFunction.h>
 #include <LatticeFunction.h>
 #include <Function.h>
 #include <GbMaterialTensors.h>
 #include <OrderedTuplet.h>
+#include <map>
+#include <memory>
 
 namespace gbLAB {
 
@@ -41,29 +45,67 @@ namespace gbLAB {
         std::complex<double> operator()(const Eigen::VectorXd& xi) const;
     };
 
+    /*!
+     * \brief Selects how GbContinuum solves for the Lagrange multipliers of its N displacement constraints.
+     *
+     * The dense solver assembles the \f$3N\times 3N\f$ system matrix and factors it with a Cholesky
+     * decomposition, which costs \f$O(N^2)\f$ memory and \f$O(N^3)\f$ time. The iterative solver never
+     * forms the matrix: it is applied through the Fourier coefficients of the displacement kernels and of
+     * \f$\hat{\textbf H}^{-1}\f$, and the system is solved by Jacobi-preconditioned conjugate gradients,
+     * warm-started from the multipliers that the same constraints had in the previous solve on the calling
+     * thread. If the iterations do not converge, the dense solver is used instead.
+     */
+    struct GbContinuumSolverPolicy
+    {
+        enum Method {automatic, dense, iterative};
+
+        //! automatic selects the iterative solver above denseThreshold constraints
+        Method method= automatic;
+        int denseThreshold= 64;
+        //! the iterations stop when the residual norm drops below tolerance times the norm of the constraints
+        double tolerance= 1e-10;
+        int maxIterations= 2000;
+        bool warmStart= true;
+
+        bool useIterative(const int& numberOfConstraints) const
+        {
+            return method==iterative || (method==automatic && numberOfConstraints>denseThreshold);
+        }
+    };
+
     template<int dim>
     class GbContinuum {
         using VectorDimD= typename LatticeCore<dim>::VectorDimD;
         using FunctionFFTPair= typename std::pair<std::vector<PeriodicFunction<double,dim-1>>,
                                                   std::vector<LatticeFunction<std::complex<double>,dim-1>>>;
         using GbLatticeFunctions= typename std::vector<LatticeFunction<std::complex<double>,dim-1>> ;
+        using PihatLatticeFunctions= typename std::map<OrderedTuplet<dim+1>,LatticeFunction<std::complex<double>, dim - 1>>;
 
     private:
 
         static thread_local  GbLatticeFunctions HhatInvComponents;
         //static FunctionFFTPair pipihat;
         static thread_local std::map<OrderedTuplet<dim+1>,PeriodicFunction<double, dim - 1>> piPeriodicFunctions;
-        static thread_local std::map<OrderedTuplet<dim+1>,LatticeFunction<std::complex<double>, dim - 1>> pihatLatticeFunctions;
+        // shared with the GbContinuum objects built from it, which may be used on other threads
+        static thread_local std::shared_ptr<PihatLatticeFunctions> pihatLatticeFunctions;
+        static thread_local std::map<OrderedTuplet<dim+1>,Eigen::Vector<std::complex<double>,dim>> lagrangeMultipliers;
         // GBMesostateEnsemble should generate the bicrystal (member variable <OrderedTuplet,VectorDimD>) and pass it as a reference to each mesostate
         // pipihat should be map from OrderedTuplet to FunctionFFTPair. should be computed once in calculateb
         // at the same time, compute pipihat once
         // change xuPairs type to <Tiplet,VectorDimD>
 
         FunctionFFTPair bbhat;
+        //! Fourier transforms of the displacement kernels of the atoms, as computed by the constructing thread
+        std::shared_ptr<const PihatLatticeFunctions> latticeFunctions;
         static FunctionFFTPair calculateb(const Eigen::Matrix<double, dim,dim-1>& domain,
                                           const std::map<OrderedTuplet<dim+1>,VectorDimD>& xuPairs,
                                           const std::array<Eigen::Index,dim-1>& n,
                                           const std::map<OrderedTuplet<dim+1>,VectorDimD>& points);
+        static Eigen::VectorXcd denseLagrangeMultipliers(const std::map<OrderedTuplet<dim+1>,VectorDimD>& xuPairs,
+                                                         const Eigen::VectorXcd& u);
+        static bool iterativeLagrangeMultipliers(const std::map<OrderedTuplet<dim+1>,VectorDimD>& xuPairs,
+                                                 const Eigen::VectorXcd& u,
+                                                 Eigen::VectorXcd& lm);
         static GbLatticeFunctions getHhatInvComponents(const Eigen::Matrix<double, dim,dim-1>& domain,
                                                        const std::array<Eigen::Index,dim-1>& n);
         static PeriodicFunction<double,dim-1>get_pi(const Eigen::Matrix<double,dim,dim-1>& domain,
@@ -75,6 +117,8 @@ namespace gbLAB {
 
     public:
 
+        //! Solver used by all threads; set it before constructing mesostates
+        static GbContinuumSolverPolicy solverPolicy;
 
         const Eigen::Matrix<double,dim,dim-1> gbDomain;
         const std::map<OrderedTuplet<dim+1>,VectorDimD> xuPairs;
@@ -113,8 +157,9 @@ namespace gbLAB {
 
         static void reset(){
             std::map<OrderedTuplet<dim+1>,PeriodicFunction<double, dim - 1>>().swap(piPeriodicFunctions);
-            std::map<OrderedTuplet<dim+1>,LatticeFunction<std::complex<double>, dim - 1>>().swap(pihatLatticeFunctions);
+            pihatLatticeFunctions= std::make_shared<PihatLatticeFunctions>();
             GbLatticeFunctions().swap(HhatInvComponents);
+            std::map<OrderedTuplet<dim+1>,Eigen::Vector<std::complex<double>,dim>>().swap(lagrangeMultipliers);
 
             //HhatInvComponents.clear();
             //piPeriodicFunctions.clear();
@@ -130,7 +175,13 @@ namespace gbLAB {
     thread_local std::map<OrderedTuplet<dim+1>,PeriodicFunction<double, dim - 1>> GbContinuum<dim>::piPeriodicFunctions;
 
     template<int dim>
-    thread_local std::map<OrderedTuplet<dim+1>,LatticeFunction<std::complex<double>, dim - 1>> GbContinuum<dim>::pihatLatticeFunctions;
+    thread_local std::shared_ptr<typename GbContinuum<dim>::PihatLatticeFunctions> GbContinuum<dim>::pihatLatticeFunctions(std::make_shared<typename GbContinuum<dim>::PihatLatticeFunctions>());
+
+    template<int dim>
+    thread_local std::map<OrderedTuplet<dim+1>,Eigen::Vector<std::complex<double>,dim>> GbContinuum<dim>::lagrangeMultipliers;
+
+    template<int dim>
+    GbContinuumSolverPolicy GbContinuum<dim>::solverPolicy;
 
 }
 
@@ -20,6 +20,7 @@ namespace gbLAB {
         xuPairs(xuPairs),
         n(n),
         bbhat(calculateb(domain,xuPairs,n,atoms)),
+        latticeFunctions(pihatLatticeFunctions),
         b(bbhat.first),
         bhat(bbhat.second)
    {
@@ -30,18 +31,12 @@ namespace gbLAB {
        if (xuPairs.size() != 0)
            uAverage = uAverage / xuPairs.size();
 
-       if (verbosity) {
-           std::cout << "------------------------------------------------------------------------------" << std::endl;
-           std::cout << "Constraints: " << std::endl;
-       }
        for (const auto &[x, u]: xuPairs) {
            if (verbosity)
-               std::cout << "x = " << atoms.at(x).transpose() << "; displacement = " << u.transpose() << std::endl;
+               OILAB_LOG(info,continuum) << "Constraint x = " << atoms.at(x).transpose() << "; displacement = " << u.transpose();
            if ((u - displacement(x) - uAverage).norm() > FLT_EPSILON)
                throw std::runtime_error("GBContinuum construction failed - unable to impose constraints.");
        }
-       if (verbosity)
-           std::cout << std::endl;
 
    }
 
@@ -55,6 +50,7 @@ namespace gbLAB {
         // dimension-dependent part
         Diff<dim-1> dx({1,0},unitcellLocal,n);
         Diff<dim-1> dy({0,1},unitcellLocal,n);
+        typename Diff<dim-1>::Workspace workspace(n);
 
         std::vector<PeriodicFunction<double,dim-1>> alpha;
         for(int i=0; i<dim; ++i)
@@ -67,9 +63,9 @@ namespace gbLAB {
                     if (k==j) continue;
                     PeriodicFunction<double,dim-1> dlbi_dxk(n,unitcellLocal);;
                     if (k==0)
-                        dx.perform_op(bLocal[i].values.data(), dlbi_dxk.values.data());
+                        dx.perform_op(bLocal[i].values.data(), dlbi_dxk.values.data(), workspace);
                     else if (k==1)
-                        dy.perform_op(bLocal[i].values.data(), dlbi_dxk.values.data());
+                        dy.perform_op(bLocal[i].values.data(), dlbi_dxk.values.data(), workspace);
                     if (j==0 && k==1)
                         alphaij.values= alphaij.values + dlbi_dxk.values;
                     else if (j==1 && k==0)
@@ -153,21 +149,21 @@ namespace gbLAB {
                                 const std::array<Eigen::Index,dim-1>& n,
                                 const std::map<OrderedTuplet<dim+1>,VectorDimD>& atoms)
    {
+       OILAB_PROFILE_SCOPE("GbContinuum::calculateb");
        if (HhatInvComponents.size() ==0 ) HhatInvComponents= getHhatInvComponents(domain,n);
        Eigen::Matrix<double,dim,dim-1> basisVectors(domain.transpose().completeOrthogonalDecomposition().pseudoInverse());
-       // lb0 - read as "local b0"
-       std::vector<PeriodicFunction<double,dim-1>> lb0, lb;
-       std::vector<LatticeFunction<std::complex<double>,dim-1>> lb0hat;
+       std::vector<PeriodicFunction<double,dim-1>> lb;
+       std::vector<LatticeFunction<std::complex<double>,dim-1>> lbhat;
        for(int i=0; i<dim; ++i)
        {
-           lb0.push_back(PeriodicFunction<double,dim-1>(n,domain));
            lb.push_back(PeriodicFunction<double,dim-1>(n,domain));
-           lb0hat.push_back(LatticeFunction<std::complex<double>,dim-1>(n,basisVectors));
+           lbhat.push_back(LatticeFunction<std::complex<double>,dim-1>(n,basisVectors));
        }
-       std::vector<LatticeFunction<std::complex<double>,dim-1>> lbhat(lb0hat);
 
 
        if(piPeriodicFunctions.empty()) {
+           // a new map, since GbContinuum objects of the previous atoms may still be reading the current one
+           pihatLatticeFunctions= std::make_shared<PihatLatticeFunctions>();
            for (const auto& [key, value]: atoms) {
                // the cross product of the domain vectors has to be parallel to nA
                Eigen::Matrix<double,dim,dim-1> basisVectors(domain.transpose().completeOrthogonalDecomposition().pseudoInverse());
@@ -188,34 +184,32 @@ namespace gbLAB {
                    perturbedValue= value - 2 * value.dot(normal) * normal;
                }
                piPeriodicFunctions.insert({key, get_pi(domain, n, perturbedValue)});
-               pihatLatticeFunctions.insert({key, get_pihat(domain, n, perturbedValue)});
+               pihatLatticeFunctions->insert({key, get_pihat(domain, n, perturbedValue)});
 
                /*
                if(abs(value.dot(normal)) < FLT_EPSILON && key(dim)==1) // belongs to lattice 1 and on the GB
                {
                    VectorDimD perturbedValue= value - (value.dot(normal) + FLT_EPSILON) * normal;
                    piPeriodicFunctions.insert({key, get_pi(domain, n, perturbedValue)});
-                   pihatLatticeFunctions.insert({key, get_pihat(domain, n, perturbedValue)});
+                   pihatLatticeFunctions->insert({key, get_pihat(domain, n, perturbedValue)});
                }
                else if(abs(value.dot(normal)) < FLT_EPSILON && key(dim)==2) // belongs to lattice 2 and on the GB
                {
                    VectorDimD perturbedValue= value - (value.dot(normal) - FLT_EPSILON) * normal;
                    piPeriodicFunctions.insert({key, get_pi(domain, n, perturbedValue)});
-                   pihatLatticeFunctions.insert({key, get_pihat(domain, n, perturbedValue)});
+                   pihatLatticeFunctions->insert({key, get_pihat(domain, n, perturbedValue)});
                }
                else {
                    piPeriodicFunctions.insert({key, get_pi(domain, n, value)});
-                   pihatLatticeFunctions.insert({key, get_pihat(domain, n, value)});
+                   pihatLatticeFunctions->insert({key, get_pihat(domain, n, value)});
                }
                 */
            }
        }
 
-       // matrices P and u
+       // constraints u, relative to their average
        const int numberOfCslPoints= xuPairs.size();
        Eigen::Matrix<std::complex<double>,Eigen::Dynamic,dim> uMatrix(numberOfCslPoints,dim);
-       Eigen::Matrix<std::complex<double>,Eigen::Dynamic,Eigen::Dynamic> P(numberOfCslPoints,numberOfCslPoints);
-
 
        VectorDimD uAverage;
        uAverage.setZero();
@@ -230,47 +224,58 @@ namespace gbLAB {
        for(const auto& [xi,ui] : xuPairs)
        {
            row++;
-           //uMatrix.row(row)= ui;
            uMatrix.row(row)= ui-uAverage;
-           int col= -1;
-           for(const auto& [xj,uj] : xuPairs)
-           {
-               col++;
-               P(row, col) = pihatLatticeFunctions.at(xj).dot(pihatLatticeFunctions.at(xi));
-           }
-
        }
 
-       // Solve P \alpha = u
-       Eigen::Matrix<std::complex<double>,Eigen::Dynamic,dim> alpha(numberOfCslPoints,dim);
-       Eigen::LLT<Eigen::Matrix<std::complex<double>,Eigen::Dynamic,Eigen::Dynamic>> llt;
-       llt.compute(P);
-       alpha= llt.solve(uMatrix);
+       // Solve M lm = u for the lagrange multipliers
+       Eigen::VectorXcd uFlattened;
+       uFlattened= uMatrix.reshaped();
+       Eigen::VectorXcd lm;
+       if (!solverPolicy.useIterative(numberOfCslPoints) || !iterativeLagrangeMultipliers(xuPairs,uFlattened,lm))
+           lm= denseLagrangeMultipliers(xuPairs,uFlattened);
 
-       // calculate lb0 and lb0hat
+       lbhat[0].values.setZero();
+       lbhat[1].values.setZero();
+       lbhat[2].values.setZero();
 
-       for(int i=0; i<dim; ++i)
-       {
-           lb0hat[i].values.setZero();
-           int j= -1;
-           for(const auto& [xj,uj] : xuPairs) {
-               j++;
-               lb0hat[i].values = lb0hat[i].values + pihatLatticeFunctions.at(xj).values * alpha(j,i);
-           }
-       }
-       for(int i=0; i<dim; ++i) {
-           lb0[i].values.setZero();
-           int j = -1;
-           for (const auto &[xj, uj]: xuPairs) {
-               j++;
-               lb0[i].values = lb0[i].values + piPeriodicFunctions.at(xj).values * alpha(j,i).real();
+       auto lmMatrix= lm.reshaped(numberOfCslPoints,dim);
+       // temp = \sum_k p_k * lm_k
+       std::vector<LatticeFunction<std::complex<double>,dim-1>> temp;
+
+       for (int i=0; i<dim; ++i) {
+           temp.push_back(LatticeFunction<std::complex<double>, dim - 1>(n, basisVectors));
+           int k= -1;
+           for (const auto& [xk,uk] : xuPairs) {
+               k++;
+               temp[i].values = temp[i].values + pihatLatticeFunctions->at(xk).values * lmMatrix(k, i);
            }
        }
 
-       // calculate lagrange multipliers, lbhat, and lb
-       Eigen::VectorXcd uFlattened;
-       uFlattened= uMatrix.reshaped();
-       Eigen::VectorXcd lm(dim*numberOfCslPoints);
+       lbhat[0].values= HhatInvComponents[0].values * temp[0].values +
+                        HhatInvComponents[5].values * temp[1].values +
+                        HhatInvComponents[4].values * temp[2].values;
+
+       lbhat[1].values= HhatInvComponents[5].values * temp[0].values +
+                        HhatInvComponents[1].values * temp[1].values +
+                        HhatInvComponents[3].values * temp[2].values;
+
+       lbhat[2].values= HhatInvComponents[4].values * temp[0].values +
+                        HhatInvComponents[3].values * temp[1].values +
+                        HhatInvComponents[2].values * temp[2].values;
+
+       for (int i=0; i<dim; ++i)
+           lb[i].values = lbhat[i].ifft().values.real();
+
+       //return std::make_pair(lb,lbhat);
+       return std::make_pair(lb,lbhat);
+   }
+
+    template<int dim>
+    Eigen::VectorXcd GbContinuum<dim>::denseLagrangeMultipliers(const std::map<OrderedTuplet<dim+1>,VectorDimD>& xuPairs,
+                                                                const Eigen::VectorXcd& u)
+    {
+       OILAB_PROFILE_SCOPE("GbContinuum::denseLagrangeMultipliers");
+       const int numberOfCslPoints= xuPairs.size();
        Eigen::MatrixXcd M(dim*numberOfCslPoints,dim*numberOfCslPoints);
        M.setZero();
 
@@ -291,58 +296,137 @@ namespace gbLAB {
 
                        std::complex<double> temp;
 
-                       if (i==0 && l==0) temp = (HhatInvComponents[0]*pihatLatticeFunctions.at(xk)).dot(pihatLatticeFunctions.at(xj));
-                       if (i==1 && l==1) temp = (HhatInvComponents[1]*pihatLatticeFunctions.at(xk)).dot(pihatLatticeFunctions.at(xj));
-                       if (i==2 && l==2) temp = (HhatInvComponents[2]*pihatLatticeFunctions.at(xk)).dot(pihatLatticeFunctions.at(xj));
-                       if ((i==1 && l==2) || (i==2 && l==1)) temp = (HhatInvComponents[3]*pihatLatticeFunctions.at(xk)).dot(pihatLatticeFunctions.at(xj));
-                       if ((i==0 && l==2) || (i==2 && l==0)) temp = (HhatInvComponents[4]*pihatLatticeFunctions.at(xk)).dot(pihatLatticeFunctions.at(xj));
-                       if ((i==0 && l==1) || (i==1 && l==0)) temp = (HhatInvComponents[5]*pihatLatticeFunctions.at(xk)).dot(pihatLatticeFunctions.at(xj));
+                       if (i==0 && l==0) temp = (HhatInvComponents[0]*pihatLatticeFunctions->at(xk)).dot(pihatLatticeFunctions->at(xj));
+                       if (i==1 && l==1) temp = (HhatInvComponents[1]*pihatLatticeFunctions->at(xk)).dot(pihatLatticeFunctions->at(xj));
+                       if (i==2 && l==2) temp = (HhatInvComponents[2]*pihatLatticeFunctions->at(xk)).dot(pihatLatticeFunctions->at(xj));
+                       if ((i==1 && l==2) || (i==2 && l==1)) temp = (HhatInvComponents[3]*pihatLatticeFunctions->at(xk)).dot(pihatLatticeFunctions->at(xj));
+                       if ((i==0 && l==2) || (i==2 && l==0)) temp = (HhatInvComponents[4]*pihatLatticeFunctions->at(xk)).dot(pihatLatticeFunctions->at(xj));
+                       if ((i==0 && l==1) || (i==1 && l==0)) temp = (HhatInvComponents[5]*pihatLatticeFunctions->at(xk)).dot(pihatLatticeFunctions->at(xj));
                        M(row, col) = temp;
                    }
                }
            }
        }
 
-       // Solve M lm = u2
-       Eigen::LLT<Eigen::Matrix<std::complex<double>,Eigen::Dynamic,Eigen::Dynamic>> llt2;
-       llt2.compute(M);
-       lm= llt2.solve(uFlattened);
-
-       lbhat[0].values.setZero();
-       lbhat[1].values.setZero();
-       lbhat[2].values.setZero();
+       Eigen::LLT<Eigen::Matrix<std::complex<double>,Eigen::Dynamic,Eigen::Dynamic>> llt;
+       llt.compute(M);
+       return llt.solve(u);
+    }
 
-       auto lmMatrix= lm.reshaped(numberOfCslPoints,dim);
-       // temp = \sum_k p_k * lm_k
-       std::vector<LatticeFunction<std::complex<double>,dim-1>> temp;
+    template<int dim>
+    bool GbContinuum<dim>::iterativeLagrangeMultipliers(const std::map<OrderedTuplet<dim+1>,VectorDimD>& xuPairs,
+                                                        const Eigen::VectorXcd& u,
+                                                        Eigen::VectorXcd& lm)
+    {
+       OILAB_PROFILE_SCOPE("GbContinuum::iterativeLagrangeMultipliers");
+       static_assert(dim==3,"The iterative solver assumes six independent components of HhatInv.");
+       const int numberOfCslPoints= xuPairs.size();
+       lm.setZero(dim*numberOfCslPoints);
+       if (numberOfCslPoints==0)
+           return true;
 
-       for (int i=0; i<dim; ++i) {
-           temp.push_back(LatticeFunction<std::complex<double>, dim - 1>(n, basisVectors));
-           int k= -1;
-           for (const auto& [xk,uk] : xuPairs) {
-               k++;
-               temp[i].values = temp[i].values + pihatLatticeFunctions.at(xk).values * lmMatrix(k, i);
-           }
+       // M_{(i,j),(l,k)} = w \sum_\xi Hinv_{il} pihat_k conj(pihat_j), with w the area element of LatticeFunction::dot
+       std::vector<Eigen::Map<const Eigen::VectorXcd>> pihat;
+       for (const auto& [xj,uj] : xuPairs)
+       {
+           const auto& lf(pihatLatticeFunctions->at(xj));
+           pihat.emplace_back(lf.values.data(),lf.values.size());
        }
+       const auto& basisVectors(pihatLatticeFunctions->at(xuPairs.begin()->first).basisVectors);
+       const double w= std::sqrt((basisVectors.transpose()*basisVectors).determinant());
+       const Eigen::Index gridSize= pihat[0].size();
+       const int component[dim][dim]= {{0,5,4},{5,1,3},{4,3,2}};
+       std::vector<Eigen::Map<const Eigen::VectorXcd>> HhatInv;
+       for (const auto& lf : HhatInvComponents)
+           HhatInv.emplace_back(lf.values.data(),lf.values.size());
+
+       Eigen::MatrixXcd z(gridSize,dim), y(gridSize,dim);
+       auto apply= [&](const Eigen::VectorXcd& x, Eigen::VectorXcd& Mx)
+       {
+           z.setZero();
+           for (int l=0; l<dim; ++l)
+               for (int k=0; k<numberOfCslPoints; ++k)
+                   z.col(l)+= x(l*numberOfCslPoints+k)*pihat[k];
+           for (int i=0; i<dim; ++i)
+           {
+               y.col(i)= HhatInv[component[i][0]].cwiseProduct(z.col(0));
+               for (int l=1; l<dim; ++l)
+                   y.col(i)+= HhatInv[component[i][l]].cwiseProduct(z.col(l));
+           }
+           for (int i=0; i<dim; ++i)
+               for (int j=0; j<numberOfCslPoints; ++j)
+                   Mx(i*numberOfCslPoints+j)= w*pihat[j].dot(y.col(i));
+       };
 
-       lbhat[0].values= HhatInvComponents[0].values * temp[0].values +
-                        HhatInvComponents[5].values * temp[1].values +
-                        HhatInvComponents[4].values * temp[2].values;
+       // Jacobi preconditioner
+       Eigen::VectorXd diagonalInverse(dim*numberOfCslPoints);
+       for (int i=0; i<dim; ++i)
+           for (int j=0; j<numberOfCslPoints; ++j)
+           {
+               const double d= w*(HhatInv[i].real().cwiseProduct(pihat[j].cwiseAbs2())).sum();
+               diagonalInverse(i*numberOfCslPoints+j)= d>0? 1.0/d : 1.0;
+           }
 
-       lbhat[1].values= HhatInvComponents[5].values * temp[0].values +
-                        HhatInvComponents[1].values * temp[1].values +
-                        HhatInvComponents[3].values * temp[2].values;
+       if (solverPolicy.warmStart)
+       {
+           int j= -1;
+           for (const auto& [xj,uj] : xuPairs)
+           {
+               ++j;
+               const auto iter= lagrangeMultipliers.find(xj);
+               if (iter!=lagrangeMultipliers.end())
+                   for (int i=0; i<dim; ++i)
+                       lm(i*numberOfCslPoints+j)= iter->second(i);
+           }
+       }
 
-       lbhat[2].values= HhatInvComponents[4].values * temp[0].values +
-                        HhatInvComponents[3].values * temp[1].values +
-                        HhatInvComponents[2].values * temp[2].values;
+       // preconditioned conjugate gradients
+       const double threshold= solverPolicy.tolerance*u.norm();
+       Eigen::VectorXcd r(u.size()), p(u.size()), q(u.size());
+       apply(lm,q);
+       r= u-q;
+       Eigen::VectorXcd s(diagonalInverse.cwiseProduct(r));
+       p= s;
+       double rs= r.dot(s).real();
+       int iteration= 0;
+       while (r.norm()>threshold && iteration<solverPolicy.maxIterations)
+       {
+           apply(p,q);
+           const std::complex<double> alpha= rs/p.dot(q);
+           lm+= alpha*p;
+           r-= alpha*q;
+           s= diagonalInverse.cwiseProduct(r);
+           const double rsNew= r.dot(s).real();
+           p= s + (rsNew/rs)*p;
+           rs= rsNew;
+           ++iteration;
+       }
+       OILAB_PROFILE_COUNT("GbContinuum CG iterations",iteration);
 
-       for (int i=0; i<dim; ++i)
-           lb[i].values = lbhat[i].ifft().values.real();
+       const double residual= r.norm();
+       if (residual>threshold)
+       {
+           OILAB_LOG(warning,continuum) << "Conjugate gradients did not converge in " << iteration
+                                        << " iterations (residual = " << residual << "); using the dense solver.";
+           return false;
+       }
+       OILAB_LOG(debug,continuum) << "Conjugate gradients converged in " << iteration << " iterations for "
+                                  << numberOfCslPoints << " constraints.";
 
-       //return std::make_pair(lb,lbhat);
-       return std::make_pair(lb,lbhat);
-   }
+       if (solverPolicy.warmStart)
+       {
+           int j= -1;
+           for (const auto& [xj,uj] : xuPairs)
+           {
+               ++j;
+               Eigen::Vector<std::complex<double>,dim> lmj;
+               for (int i=0; i<dim; ++i)
+                   lmj(i)= lm(i*numberOfCslPoints+j);
+               lagrangeMultipliers[xj]= lmj;
+           }
+       }
+       return true;
+    }
 
     template<int dim>
     typename GbContinuum<dim>::VectorDimD GbContinuum<dim>::displacement(const OrderedTuplet<dim+1>& t) const
@@ -351,7 +435,7 @@ namespace gbLAB {
 
         // u = f \star b
         for(int i=0; i<dim; ++i)
-            u(i)= (bhat[i].dot(pihatLatticeFunctions.at(t))).real();
+            u(i)= (bhat[i].dot(latticeFunctions->at(t))).real();
 
         return u;
 
@@ -388,6 +472,7 @@ namespace gbLAB {
     GbContinuum<dim>::getHhatInvComponents(const Eigen::Matrix<double, dim,dim-1>& domain,
                                            const std::array<Eigen::Index,dim-1>& n)
     {
+        OILAB_PROFILE_SCOPE("GbContinuum::getHhatInvComponents");
         Eigen::Matrix<double,Eigen::Dynamic,dim-1> basisVectors(domain.transpose().completeOrthogonalDecomposition().pseudoInverse());
         std::vector<LatticeFunction<std::complex<double>,dim-1>> output;
 
@@ -6,8 +6,11 @@
 #define OILAB_GBMESOSTATE_H
 
 #include <Gb.h>
+#include <CslSiteIndex.h>
 #include <GbContinuum.h>
 #include <LatticeCore.h>
+#include <Log.h>
+#include <Profiler.h>
 #include <OrderedTuplet.h>
 #include <PeriodicFunction.h>
 
@@ -57,6 +60,13 @@ namespace gbLAB {
          */
         static std::array<Eigen::Index,dim-1> discretize(const std::vector<LatticeVector<dim>>& mesoStateCslVectors, const Gb<dim>& gb);
 
+        /*!
+         * \brief Gaussian-smoothed atomic density of \p configuration on the grid \p n of its box (see density()).
+         */
+        static PeriodicFunction<double,dim> deposit(const Configuration& configuration,
+                                                    const std::array<Eigen::Index,dim>& n,
+                                                    const double& sigma);
+
     public:
 
         /*!
@@ -89,18 +99,38 @@ namespace gbLAB {
          */
         const std::deque<std::tuple<LatticeVector<dim>, VectorDimD,int>> bs;
 
+        /*!
+         * Index of the CSL sites that may be deleted, i.e. of the shifts \f$\textbf s\f$, in the box
+         * \f$(5\textbf c_1,\textbf c_2,\textbf c_3)\f$ spanned by mesoStateCslVectors. Mesostates of an
+         * ensemble share the index of the ensemble.
+         */
+        const std::shared_ptr<const CslSiteIndex<dim>> cslSites;
+
+        /*!
+         * \brief Index of the sites \p shifts in the box used by GbMesoState::cslSites
+         */
+        static std::shared_ptr<const CslSiteIndex<dim>> indexCslSites(const Gb<dim>& gb,
+                                                                      const std::vector<LatticeVector<dim>>& mesoStateCslVectors,
+                                                                      const std::vector<VectorDimD>& shifts);
+
          // ensure that b in bs pair belongs to the DSCL vectors and s belongs to the box
          // ensure that the lattice vectors in bicrystalConfig lie entirely in the box
+        /*!
+         * @param cslSites - index of the CSL sites, which has to contain the shifts of \p bs; if null,
+         * an index of the shifts of \p bs is built
+         */
         explicit GbMesoState(const Gb<dim>& gb,
                              const ReciprocalLatticeVector<dim>& axis,
                              const std::deque<std::tuple<LatticeVector<dim>,VectorDimD,int>>& bs,
                              const std::vector<LatticeVector<dim>>& mesoStateCslVectors,
-                             const BicrystalLatticeVectors& bicrystalConfig);
+                             const BicrystalLatticeVectors& bicrystalConfig,
+                             const std::shared_ptr<const CslSiteIndex<dim>>& cslSites= nullptr);
 
         /*!
          * \brief Calculate the energy of a mesostate using lammps
          * @param ms - mesostate
-         * @return Energy of the mesostate
+         * @param n - grid of the returned density (see density()); no density is computed if \p n is empty
+         * @return Density, energy, and the atomic density of the unrelaxed mesostate
          */
         //std::pair<double,double> densityEnergy() const;
         std::tuple<double,double,PeriodicFunction<double,dim>>
@@ -110,10 +140,52 @@ namespace gbLAB {
                           const std::array<Eigen::Index,dim>& n= std::array<Eigen::Index,dim>{}) const;
         std::pair<double,double> densityEnergyPython() const;
 
+        /*!
+         * \brief In-process surrogate of densityEnergy, used to pre-screen mesostates before a LAMMPS evaluation.
+         *
+         * The energy is the Gaussian overlap \f$\frac{1}{2}\sum_{i\neq j}\exp(-r_{ij}^2/4\sigma^2)\f$ of the atoms of the
+         * (unrelaxed) box, computed from the density \f$\rho\f$ returned by density() as
+         * \f$\frac{1}{2}(4\pi\sigma^2)^{3/2}\int\rho^2\,dV - N/2\f$, minus the overlap of the same atoms in
+         * their perfect lattices, per unit area of the two grain boundaries of the periodic box.
+         * @param n - grid of the density; defaults to densityGrid()
+         * @param sigma - width of the Gaussian atoms; defaults to densityWidth()
+         * @return (number of atoms in the box, energy, density)
+         */
+        std::tuple<double,double,PeriodicFunction<double,dim>>
+            surrogateDensityEnergy(const std::array<Eigen::Index,dim>& n= std::array<Eigen::Index,dim>{},
+                                   const double& sigma= 0.0) const;
+
+        /*!
+         * \brief Atomic number density of the unrelaxed box, with every atom smeared into a normalized Gaussian of width \p sigma.
+         *
+         * The atoms are deposited onto the periodic grid \p n of the box with the triangular-shaped-cloud (quadratic
+         * spline) window, in parallel on thread-private grids. One FFT convolution with the Gaussian density of a single
+         * atom, divided by the Fourier transform of the window, then yields the density. The grid point (i,j,k) is at
+         * \f$i\textbf a_1/n_1 + j\textbf a_2/n_2 + k\textbf a_3/n_3\f$, where \f$\textbf a_i\f$ are the box vectors.
+         * The grid should resolve \p sigma (grid spacing \f$\lesssim\sigma/2\f$).
+         */
+        PeriodicFunction<double,dim> density(const std::array<Eigen::Index,dim>& n, const double& sigma) const;
+
+        //! Grid of the box with the in-plane resolution of the continuum model
+        std::array<Eigen::Index,dim> densityGrid() const;
+
+        //! Default Gaussian width of the atoms: a quarter of the shortest basis vector of lattice \f$\mathcal A\f$
+        double densityWidth() const;
+
+        /*!
+         * \brief Returns the reference and deformed configurations of the atoms in the mesostate box.
+         *
+         * The box is spanned by twice the first CSL vector and the two GB CSL vectors, with lattice \f$\mathcal A\f$
+         * (type 1) below and lattice \f$\mathcal B\f$ (type 2) above the GB. Atoms at deleted CSL positions are removed.
+         */
+        typename std::enable_if<dim==3,std::pair<Configuration,Configuration>>::type configurations() const;
+
         /*! This function outputs/prints a grain boundary mesostate
          * @param filename name of the file to be written to
+         * @param format (optional) format of the output files
          */
-        typename std::enable_if<dim==3,void>::type box(const std::string& filename) const;
+        typename std::enable_if<dim==3,void>::type box(const std::string& filename,
+                                                       const ConfigurationFormat& format= ConfigurationFormat::xyz) const;
     };
 }
 
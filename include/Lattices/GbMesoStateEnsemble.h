@@ -6,9 +6,11 @@
 #define OILAB_GBMESOSTATES_H
 
 #include <GbShifts.h>
+#include <GbShiftSymmetry.h>
 #include <deque>
 #include <GbMesoState.h>
 #include <GbContinuum.h>
+#include <GrayCodeTuplets.h>
 #include <Ensemble.h>
 
 namespace gbLAB {
@@ -38,6 +40,14 @@ namespace gbLAB {
 
         static std::deque<std::tuple<LatticeVector<dim>,VectorDimD,int>> bsPairsFromConstraints(const std::vector<std::pair<LatticeVector<dim>, VectorDimD>>& bShiftPairs,
                                                                                                 const Constraints& constraints);
+
+        /*!
+         * \brief Constructs the admissible mesostates and passes them to callback(constraints, multiplicity, mesostate).
+         * If \p symmetryReduced, only canonical constraints are constructed, with the multiplicity of their orbit;
+         * otherwise the multiplicity is 1.
+         */
+        template<typename CallbackType>
+        size_t forEachAdmissibleMesoState(CallbackType&& callback, const bool& parallel, const bool& symmetryReduced) const;
     public:
         /*!
          * CSL vectors that define the ensemble's grain boundary region
@@ -49,6 +59,16 @@ namespace gbLAB {
          */
         BicrystalLatticeVectors bicrystalConfig;
 
+        /*!
+         * Symmetry operations of the ensemble, acting on the indices of bShiftPairs
+         */
+        const GbShiftSymmetry<dim> symmetry;
+
+        /*!
+         * Index of the shifts of bShiftPairs in the box of the mesostates, built once and shared by all mesostates
+         */
+        const std::shared_ptr<const CslSiteIndex<dim>> cslSites;
+
 
         GbMesoStateEnsemble(const Gb<dim>& gb,
                             const ReciprocalLatticeVector<dim>& axis,
@@ -57,11 +77,64 @@ namespace gbLAB {
 
         /*!
          * \brief Constructs an ensemble of mesostates
-         * @param filename-
-         * @return A deque of mesostates
+         * @param filename - if not empty, the mesostates are written to filename0, filename1, ... in the
+         * order of their signatures, so that the numbering does not depend on the number of threads
+         * @return signatures mapped to their mesostates
          */
         std::map<Constraints ,GbMesoState<dim>> collectMesoStates(const std::string& filename="") const;
 
+        /*!
+         * \brief Constructs every admissible mesostate and passes it to \p callback
+         * without storing it. Constraints are generated lazily, and the Gray-code
+         * range is split into chunks that are processed by OpenMP threads, so
+         * memory use does not grow with the size of the ensemble. Constraints
+         * for which a mesostate cannot be constructed are skipped, and the reason is logged
+         * (continuum subsystem, info level).
+         * @param callback - invoked as callback(constraints, mesostate), concurrently from several threads
+         * @param parallel - if false, mesostates are processed in order on the calling thread
+         * @return the number of mesostates passed to \p callback
+         */
+        template<typename CallbackType>
+        size_t forEachMesoState(CallbackType&& callback, const bool& parallel=true) const;
+
+        /*!
+         * \brief Same as forEachMesoState, but constructs only one mesostate (the canonical one) per orbit
+         * of the symmetry group.
+         * @param callback - invoked as callback(constraints, multiplicity, mesostate), where multiplicity is
+         * the number of admissible constraints in the orbit. Averages over the ensemble are recovered by
+         * weighting each representative with its multiplicity.
+         * @param parallel - if false, mesostates are processed in order on the calling thread
+         * @return the number of orbits passed to \p callback
+         */
+        template<typename CallbackType>
+        size_t forEachMesoStateOrbit(CallbackType&& callback, const bool& parallel=true) const;
+
+        /*!
+         * \brief Constructs one mesostate per orbit of the symmetry group
+         * @param filename - if not empty, the mesostates are written to filename0, filename1, ... in the
+         * order of their canonical signatures
+         * @return canonical constraints mapped to their mesostate and multiplicity
+         */
+        std::map<Constraints,std::pair<GbMesoState<dim>,int>> collectMesoStateOrbits(const std::string& filename="") const;
+
+        /*!
+         * \brief Canonical form of \p constraints. Symmetry-equivalent constraints have the same
+         * canonical form and the same energy, so energies can be cached by canonical form.
+         */
+        Constraints canonicalState(const Constraints& constraints) const;
+
+        /*!
+         * \brief Number of admissible constraints equivalent to \p constraints. Monte Carlo samples of
+         * canonical states are reweighted by this factor to recover the full ensemble.
+         */
+        int multiplicity(const Constraints& constraints) const;
+
+        /*!
+         * \brief Lazy range of constraints with the first entry set to 1, entries
+         * of pre-existing CSL points in \f$\{1,2\}\f$ and all others in \f$\{0,1\}\f$.
+         */
+        static GrayCodeTuplets admissibleConstraints(const GbShifts<dim>& gbs);
+
         static std::deque<Constraints> enumerateConstraints(const GbShifts<dim>& gbs);
 
         /*!
@@ -74,6 +147,16 @@ namespace gbLAB {
 
         GbMesoState<dim> constructMesoState(const Constraints& constraints) const;
 
+        /*!
+         * \brief Draws new constraints from \p currentConstraints, regardless of whether they define a valid mesostate.
+         *
+         * Every call makes the same number of random<int>() draws, so consecutive calls are the
+         * successive attempts of sampleNewState.
+         */
+        Constraints drawNewState(const Constraints& currentConstraints,
+                                 const bool& randomize= false) const;
+
+        //! Repeats drawNewState until the drawn constraints define a mesostate
         Constraints sampleNewState(const Constraints& currentConstraints,
                                    const bool& randomize= false) const;
 
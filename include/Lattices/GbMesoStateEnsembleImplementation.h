@@ -6,6 +6,9 @@
 #define OILAB_GBMESOSTATEENSEMBLEIMPLEMENTATION_H
 
 #include <randomInteger.h>
+#include <exception>
+#include <mutex>
+#include <optional>
 
 namespace gbLAB {
     template<int dim>
@@ -21,18 +24,27 @@ namespace gbLAB {
                           bhalfMax),
             ensembleCslVectors(ensembleCslVectors),
             bicrystalConfig(getBicrystalConfig((const GbShifts<dim>&) *this,
-                                               ensembleCslVectors))
+                                               ensembleCslVectors)),
+            symmetry((const GbShifts<dim>&) *this,ensembleCslVectors),
+            cslSites(GbMesoState<dim>::indexCslSites(gb,this->ensembleCslVectors,[this]()
+                                                     {
+                                                         std::vector<VectorDimD> shifts;
+                                                         for(const auto& [b,s] : this->bShiftPairs)
+                                                             shifts.push_back(s);
+                                                         return shifts;
+                                                     }()))
     {
-        std::cout << "--------------------GBMesoStateEnsemble class construction ---------------------------" << std::endl;
-        std::cout << "Forming mesostate ensemble with material parameters: ";
-        std::cout << "lambda = " << GbMaterialTensors::lambda;
-        std::cout << "; mu = " << GbMaterialTensors::mu<< std::endl;
-        std::cout << std::endl;
-
-        std::cout << "Ensemble CSL vectors:"  << std::endl;
-        for(const auto& latticeVector : ensembleCslVectors)
-            std::cout << latticeVector.cartesian().transpose() <<  std::endl;
-        std::cout << std::endl;
+        if(OILAB_LOG_ENABLED(info,continuum))
+        {
+            std::ostringstream message;
+            message << "Forming mesostate ensemble with material parameters: ";
+            message << "lambda = " << GbMaterialTensors::lambda;
+            message << "; mu = " << GbMaterialTensors::mu << "\n";
+            message << "Ensemble CSL vectors:";
+            for(const auto& latticeVector : ensembleCslVectors)
+                message << "\n" << latticeVector.cartesian().transpose();
+            OILAB_LOG(info,continuum) << message.str();
+        }
 
     }
 
@@ -77,41 +89,159 @@ namespace gbLAB {
     template<int dim>
     std::map<typename GbMesoStateEnsemble<dim>::Constraints,GbMesoState<dim>> GbMesoStateEnsemble<dim>::collectMesoStates(const std::string& filename) const
     {
-        std::deque<Constraints> constraintsEnsemble(enumerateConstraints( (const GbShifts<dim>&) *this));
-        std::cout << "Number of mesostates in the ensemble = " << constraintsEnsemble.size() << std::endl;
-        std::cout << std::endl;
-        std::cout << "------------------------------" << std::endl;
+        OILAB_LOG(info,continuum) << "Number of mesostates in the ensemble = " << admissibleConstraints(*this).size();
         std::map<Constraints,GbMesoState<dim>> mesoStates;
+        std::mutex mesoStatesMutex;
 
-        int count= -1;
-        for(const Constraints& constraints : constraintsEnsemble)
+        forEachMesoState([&](const Constraints& constraints, const GbMesoState<dim>& mesoState)
+                         {
+                             OILAB_LOG(debug,continuum) << "Constructing mesostate with signature:  " << constraints.transpose();
+                             std::lock_guard<std::mutex> guard(mesoStatesMutex);
+                             mesoStates.emplace(constraints,mesoState);
+                         });
+
+        // box files are numbered in signature order, independently of the order in which the threads finish
+        if (!filename.empty())
         {
-            try {
-                if (constraints(0) != 1) continue;
-                //mesoStates.emplace_back(constructMesoState(constraints));
-                mesoStates.emplace(constraints,constructMesoState(constraints));
-                count++;
-                std::cout << "Constructing mesostate " << count << " of " << constraintsEnsemble.size() << std::endl;
-                std::cout << "Mesostate signature:  " << constraints.transpose() << std::endl;
-                if (!filename.empty())
-                    //mesoStates.back().box(filename + std::to_string(count));
-                    mesoStates.at(constraints).box(filename + std::to_string(count));
-            }
-            catch(std::runtime_error& e)
-            {
-                std::cout << e.what() << std::endl;
-            }
+            std::vector<const GbMesoState<dim>*> ordered;
+            for (const auto& [constraints,mesoState] : mesoStates)
+                ordered.push_back(&mesoState);
+#pragma omp parallel for schedule(dynamic)
+            for (long long i=0; i<static_cast<long long>(ordered.size()); ++i)
+                ordered[i]->box(filename + std::to_string(i));
+        }
+        return mesoStates;
+    }
 
+    /*-------------------------------------*/
+    template<int dim>
+    std::map<typename GbMesoStateEnsemble<dim>::Constraints,std::pair<GbMesoState<dim>,int>>
+    GbMesoStateEnsemble<dim>::collectMesoStateOrbits(const std::string& filename) const
+    {
+        std::map<Constraints,std::pair<GbMesoState<dim>,int>> mesoStates;
+        std::mutex mesoStatesMutex;
+
+        forEachMesoStateOrbit([&](const Constraints& constraints, const int& multiplicity, const GbMesoState<dim>& mesoState)
+                              {
+                                  OILAB_LOG(debug,continuum) << "Constructing mesostate with signature:  " << constraints.transpose()
+                                                             << "; multiplicity = " << multiplicity;
+                                  std::lock_guard<std::mutex> guard(mesoStatesMutex);
+                                  mesoStates.emplace(constraints,std::make_pair(mesoState,multiplicity));
+                              });
+
+        // box files are numbered in signature order, independently of the order in which the threads finish
+        if (!filename.empty())
+        {
+            std::vector<const GbMesoState<dim>*> ordered;
+            for (const auto& [constraints,mesoStateMultiplicity] : mesoStates)
+                ordered.push_back(&mesoStateMultiplicity.first);
+#pragma omp parallel for schedule(dynamic)
+            for (long long i=0; i<static_cast<long long>(ordered.size()); ++i)
+                ordered[i]->box(filename + std::to_string(i));
         }
+        OILAB_LOG(info,continuum) << "Number of mesostate orbits = " << mesoStates.size();
         return mesoStates;
     }
 
+    /*-------------------------------------*/
+    template<int dim>
+    template<typename CallbackType>
+    size_t GbMesoStateEnsemble<dim>::forEachMesoState(CallbackType&& callback, const bool& parallel) const
+    {
+        return forEachAdmissibleMesoState([&](const Constraints& constraints, const int&, const GbMesoState<dim>& mesoState)
+                                          {
+                                              callback(constraints,mesoState);
+                                          },parallel,false);
+    }
+
+    /*-------------------------------------*/
+    template<int dim>
+    template<typename CallbackType>
+    size_t GbMesoStateEnsemble<dim>::forEachMesoStateOrbit(CallbackType&& callback, const bool& parallel) const
+    {
+        return forEachAdmissibleMesoState(callback,parallel,true);
+    }
+
+    /*-------------------------------------*/
+    template<int dim>
+    template<typename CallbackType>
+    size_t GbMesoStateEnsemble<dim>::forEachAdmissibleMesoState(CallbackType&& callback,
+                                                                const bool& parallel,
+                                                                const bool& symmetryReduced) const
+    {
+        const GrayCodeTuplets constraintsRange(admissibleConstraints(*this));
+        const long long numberOfConstraints= constraintsRange.size();
+        const long long chunkSize= 64;
+        const long long numberOfChunks= (numberOfConstraints+chunkSize-1)/chunkSize;
+
+        size_t count= 0;
+        std::exception_ptr callbackException;
+        std::mutex exceptionMutex;
+
+#pragma omp parallel for schedule(dynamic) reduction(+:count) if(parallel)
+        for (long long chunk=0; chunk<numberOfChunks; ++chunk)
+        {
+            const auto last= constraintsRange.begin(std::min(numberOfConstraints,(chunk+1)*chunkSize));
+            for (auto it= constraintsRange.begin(chunk*chunkSize); it!=last; ++it)
+            {
+                int multiplicity= 1;
+                if (symmetryReduced)
+                {
+                    const auto [canonical,orbitSize]= symmetry.canonicalForm(*it);
+                    if (canonical!=*it)
+                        continue;
+                    multiplicity= orbitSize;
+                }
+
+                std::optional<GbMesoState<dim>> mesoState;
+                try {
+                    mesoState.emplace(constructMesoState(*it));
+                }
+                catch(std::runtime_error& e)
+                {
+                    OILAB_LOG(info,continuum) << "Skipping mesostate with signature " << (*it).transpose() << ": " << e.what();
+                    continue;
+                }
+
+                // exceptions must not escape the parallel region; the first one is rethrown below
+                try {
+                    callback(*it,multiplicity,*mesoState);
+                    count++;
+                }
+                catch(...)
+                {
+                    std::lock_guard<std::mutex> guard(exceptionMutex);
+                    if (!callbackException)
+                        callbackException= std::current_exception();
+                }
+            }
+        }
+        if (callbackException)
+            std::rethrow_exception(callbackException);
+        return count;
+    }
+
+    /*-------------------------------------*/
+    template<int dim>
+    typename GbMesoStateEnsemble<dim>::Constraints GbMesoStateEnsemble<dim>::canonicalState(const Constraints& constraints) const
+    {
+        return symmetry.canonicalForm(constraints).first;
+    }
+
+    /*-------------------------------------*/
+    template<int dim>
+    int GbMesoStateEnsemble<dim>::multiplicity(const Constraints& constraints) const
+    {
+        return symmetry.canonicalForm(constraints).second;
+    }
+
     /*-------------------------------------*/
     template<int dim>
     GbMesoState<dim> GbMesoStateEnsemble<dim>::constructMesoState(const Constraints& constraints) const {
+        OILAB_PROFILE_SCOPE("GbMesoStateEnsemble::constructMesoState");
         std::deque<std::tuple<LatticeVector<dim>,VectorDimD,int>> bsPairs(bsPairsFromConstraints(this->bShiftPairs,constraints));
         try {
-            GbMesoState<dim> mesostate(this->gb, this->axis, bsPairs, ensembleCslVectors, bicrystalConfig);
+            GbMesoState<dim> mesostate(this->gb, this->axis, bsPairs, ensembleCslVectors, bicrystalConfig, cslSites);
             return mesostate;
         }
         catch(std::runtime_error& e)
@@ -131,7 +261,7 @@ namespace gbLAB {
         // create the initial random mesostate
         Constraints initialConstraints(this->bShiftPairs.size());
         initialConstraints.setZero();
-        std::cout << "Initial mesostate signature = " << initialConstraints.transpose() << std::endl;
+        OILAB_LOG(info,continuum) << "Initial mesostate signature = " << initialConstraints.transpose();
         GbMesoState<dim> initial_ms(this->gb,
                                     this->axis,
                                     bsPairsFromConstraints(this->bShiftPairs,initialConstraints),
@@ -161,8 +291,8 @@ namespace gbLAB {
                     mesoStates.insert({currentConstraints, current_ms});
                     if (!filename.empty())
                         current_ms.box(filename + std::to_string(mesoStateCount));
-                    std::cout << "Step " << i << " Accept " << count << " Mesostate " << mesoStateCount << " constraints = "
-                              << currentConstraints.transpose() << "; energy = " << currentEnergy << std::endl;
+                    OILAB_LOG(info,continuum) << "Step " << i << " Accept " << count << " Mesostate " << mesoStateCount << " constraints = "
+                                              << currentConstraints.transpose() << "; energy = " << currentEnergy;
                     mesoStateCount++;
                 }
                 transition = false;
@@ -171,7 +301,7 @@ namespace gbLAB {
             // new mesostate construction
             bool randomize= false;
             if (count % resetEvery == 0 && count != 0) {
-                std::cout << "Starting over using ramdomized constraints" << std::endl;
+                OILAB_LOG(info,continuum) << "Starting over using randomized constraints";
                 randomize= true;
             }
             Constraints newConstraints(this->bShiftPairs.size());
@@ -237,47 +367,48 @@ namespace gbLAB {
     */
     /*-------------------------------------*/
     template<int dim>
-    std::deque<typename GbMesoStateEnsemble<dim>::Constraints> GbMesoStateEnsemble<dim>::enumerateConstraints(const GbShifts<dim>& gbs)
+    GrayCodeTuplets GbMesoStateEnsemble<dim>::admissibleConstraints(const GbShifts<dim>& gbs)
     {
-        std::deque<Constraints> constraintsEnsemble;
-
-        //auto tuples= XTuplet::generate_tuples(3,gbs.bShiftPairs.size());
-        auto tuples= XTuplet::generate_tuples(2,gbs.bShiftPairs.size());
+        Constraints values0(gbs.bShiftPairs.size());
+        Constraints values1(gbs.bShiftPairs.size());
+        values0.setZero();
+        values1.setOnes();
 
-        // identify indices of pre-existing CSL points
-        std::vector<int> cslIndices;
+        // pre-existing CSL points are either retained (2) or constrained (1)
         for(int i=0; i<gbs.bShiftPairs.size(); ++i)
         {
             if((gbs.bShiftPairs[i].first.array()==0).all())
-                cslIndices.push_back(i);
+                values0(i)= 2;
         }
+        if (values0.size()>0)
+            values0(0)= 1;
 
-        for (auto& tuple : tuples) {
-            bool pass= true;
-            if (tuple(0) !=1)
-                pass= false;
-
-            for(const auto& index : cslIndices) {
-                if (tuple(index) == 0)
-                    tuple(index)= 2;
-            }
+        return GrayCodeTuplets(values0,values1);
+    }
 
+    /*-------------------------------------*/
+    template<int dim>
+    std::deque<typename GbMesoStateEnsemble<dim>::Constraints> GbMesoStateEnsemble<dim>::enumerateConstraints(const GbShifts<dim>& gbs)
+    {
+        const GrayCodeTuplets constraintsRange(admissibleConstraints(gbs));
+        return std::deque<Constraints>(constraintsRange.begin(),constraintsRange.end());
+    }
 
-            /*
-            //if (!(tuple.array()==0).all())
-            // allow only constraints that do not alter pre-existing CSL points
-            for(const auto& index : cslIndices) {
-                if (tuple(index) != 1) {
-                    pass = false;
-                    break;
-                }
-            }
-             */
-            if (pass)
-                constraintsEnsemble.push_back(tuple);
+    /*-------------------------------------*/
+    template<int dim>
+    typename GbMesoStateEnsemble<dim>::Constraints GbMesoStateEnsemble<dim>::drawNewState(const Constraints& currentConstraints,
+                                                                                          const bool& randomize) const
+    {
+        Constraints newConstraints(currentConstraints);
+        // alter the constraints
+        if (randomize){
+            for (auto &elem: newConstraints)
+                elem = random<int>(0, 2);
+        } else {
+            int randomSpot = random<int>(0, this->bShiftPairs.size() - 1);
+            newConstraints(randomSpot) = random<int>(0, 2);
         }
-
-        return constraintsEnsemble;
+        return newConstraints;
     }
 
     /*-------------------------------------*/
@@ -285,28 +416,23 @@ namespace gbLAB {
     typename GbMesoStateEnsemble<dim>::Constraints GbMesoStateEnsemble<dim>::sampleNewState(const Constraints& currentConstraints,
                                                                                             const bool& randomize) const
     {
+        OILAB_PROFILE_SCOPE("GbMesoStateEnsemble::sampleNewState");
         // new mesostate construction
         Constraints newConstraints(this->bShiftPairs.size());
         bool msConstructionSuccess = false;
         while (!msConstructionSuccess) {
             try {
-                newConstraints = currentConstraints;
-                // alter the constraints
-                if (randomize){
-                    for (auto &elem: newConstraints)
-                        elem = random<int>(0, 2);
-                } else {
-                    int randomSpot = random<int>(0, this->bShiftPairs.size() - 1);
-                    newConstraints(randomSpot) = random<int>(0, 2);
-                }
+                newConstraints = drawNewState(currentConstraints,randomize);
                 GbMesoState<dim> temp(this->gb,
                                       this->axis,
                                       bsPairsFromConstraints(this->bShiftPairs, newConstraints),
                                       ensembleCslVectors,
-                                      bicrystalConfig);
+                                      bicrystalConfig,
+                                      cslSites);
                 msConstructionSuccess = true;
             }
             catch (std::runtime_error &e) {
+                OILAB_PROFILE_COUNT("GbMesoStateEnsemble::sampleNewState retries",1);
                 //throw(e);
             }
         }
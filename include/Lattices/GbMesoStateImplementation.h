@@ -9,6 +9,7 @@
 #include <iostream>
 //#include <Python.h>
 #include <PeriodicFunctionImplementation.h>
+#include <numbers>
 
 namespace gbLAB {
     template<int dim>
@@ -16,7 +17,8 @@ namespace gbLAB {
                                   const ReciprocalLatticeVector<dim>& axis,
                                   const std::deque<std::tuple<LatticeVector<dim>,VectorDimD,int>>& bs,
                                   const std::vector<LatticeVector<dim>>& mesoStateCslVectors,
-                                  const BicrystalLatticeVectors& bicrystalConfig)
+                                  const BicrystalLatticeVectors& bicrystalConfig,
+                                  const std::shared_ptr<const CslSiteIndex<dim>>& cslSites)
                                   try :
           GbContinuum<dim>(getMesoStateGbDomain(mesoStateCslVectors),
                            get_xuPairs(gb,mesoStateCslVectors,bs),
@@ -26,7 +28,14 @@ namespace gbLAB {
           axis(axis),
           mesoStateCslVectors(mesoStateCslVectors),
           bicrystalConfig(bicrystalConfig),
-          bs(bs)
+          bs(bs),
+          cslSites(cslSites ? cslSites : indexCslSites(gb,mesoStateCslVectors,[&bs]()
+                                                       {
+                                                           std::vector<VectorDimD> shifts;
+                                                           for(const auto& [b,s,include] : bs)
+                                                               shifts.push_back(s);
+                                                           return shifts;
+                                                       }()))
     {
         // check
         /*
@@ -41,6 +50,21 @@ namespace gbLAB {
     }
 
 
+    template<int dim>
+    std::shared_ptr<const CslSiteIndex<dim>> GbMesoState<dim>::indexCslSites(const Gb<dim>& gb,
+                                                                             const std::vector<LatticeVector<dim>>& mesoStateCslVectors,
+                                                                             const std::vector<VectorDimD>& shifts)
+    {
+        typename LatticeCore<dim>::MatrixDimD box;
+        for(int i=0; i<dim; ++i)
+            box.col(i)= mesoStateCslVectors[i].cartesian();
+        box.col(0)*= 5;
+        VectorDimD cslShift(VectorDimD::Constant(-FLT_EPSILON));
+        cslShift(0)= -0.5;
+        // a shift s is in A+b/2, b being a DSCL vector, so the shifts are vectors of the DSCL refined by 2
+        return std::make_shared<const CslSiteIndex<dim>>(gb.bc.dscl.latticeBasis/2,box,cslShift,shifts);
+    }
+
     template<int dim>
     Eigen::Matrix<double, dim,dim-1> GbMesoState<dim>::getMesoStateGbDomain(const std::vector<LatticeVector<dim>>& mesoStateCslVectors)
     {
@@ -118,9 +142,9 @@ namespace gbLAB {
                     keyx << gb.bc.getLatticeVectorInD(gb.bc.A.latticeVector(tempx)), -1;
             }
             catch(std::runtime_error& e) {
-                std::cout << e.what() << std::endl;
-                std::cout << "x key = " << keyx.transpose() << ";   " << tempx.transpose() << std::endl;
-                std::cout << "b = " << b.cartesian().transpose()  << " ; s= " << s.transpose() << std::endl;
+                OILAB_LOG(error,continuum) << e.what() << "\n"
+                                           << "x key = " << keyx.transpose() << ";   " << tempx.transpose() << "\n"
+                                           << "b = " << b.cartesian().transpose()  << " ; s= " << s.transpose();
                 exit(0);
             }
             xuPairs[keyx]=valueu;
@@ -175,31 +199,16 @@ namespace gbLAB {
                                                              bool relax,
                                                              const std::array<Eigen::Index,dim>& n) const
     {
-        box("temp" + std::to_string(omp_get_thread_num()));
+        OILAB_PROFILE_SCOPE("GbMesoState::densityEnergy");
+        box("temp" + scratchTag());
         std::pair<double,double> densityEnergyPair= energy(lmpLocation,
-                                                           "temp" + std::to_string(omp_get_thread_num()) + "_reference1.txt",
+                                                           "temp" + scratchTag() + "_reference1.txt",
                                                            potentialName);
 
 
-        // the columns of rhoCell defined the box in which rho is calculated
-        Eigen::Matrix3d rhoCell;
-        PeriodicFunction<double,dim> rho(n,rhoCell);
-        for (int i=0; i<n[0]; ++i)
-        {
-            for (int j=0; j<n[1]; ++j) {
-                for (int k = 0; k < n[2]; ++k)
-                {
-                    Eigen::Vector<double,Eigen::Dynamic> x= i*rho.unitCell.col(0)/n[0] +
-                                                            j*rho.unitCell.col(1)/n[1] +
-                                                            k*rho.unitCell.col(2)/n[2];
-                    // rho(i,j,k) is the density at point x
-                    // calculate rho by first reading the relaxed configuration
-
-                }
-            }
-
-        }
-
+        const bool computeDensity= std::all_of(n.begin(),n.end(),[](const Eigen::Index& ni){return ni>0;});
+        const PeriodicFunction<double,dim> rho(computeDensity ? density(n,densityWidth()) :
+                                                                PeriodicFunction<double,dim>(n,Eigen::Matrix<double,dim,dim>::Identity()));
         return {densityEnergyPair.first,densityEnergyPair.second,rho};
 
     }
@@ -215,7 +224,7 @@ namespace gbLAB {
 
      setenv("PYTHONPATH", ".", 1);
      if(!Py_IsInitialized()) {
-         std::cout << "Initializing Python Interpreter" << std::endl;
+         OILAB_LOG(info,continuum) << "Initializing Python Interpreter";
          Py_Initialize();
      }
 
@@ -225,7 +234,7 @@ namespace gbLAB {
      if (pyModule == nullptr)
      {
          PyErr_Print();
-         std::cout << "cannot import python script" << std::endl;
+         OILAB_LOG(error,continuum) << "cannot import python script";
          std::exit(0);
      }
      PyObject* pDict = PyModule_GetDict(pyModule);
@@ -245,10 +254,10 @@ namespace gbLAB {
  */
 
  template<int dim>
- //template<int dm=dim>
- typename std::enable_if<dim==3,void>::type
- GbMesoState<dim>::box(const std::string& name) const
+ typename std::enable_if<dim==3,std::pair<Configuration,Configuration>>::type
+ GbMesoState<dim>::configurations() const
  {
+     OILAB_PROFILE_SCOPE("GbMesoState::configurations");
      const auto& config= this->bicrystalConfig;
      std::vector<LatticeVector<3>> boxVectors;
      boxVectors.push_back(this->mesoStateCslVectors[0]);
@@ -259,74 +268,78 @@ namespace gbLAB {
      std::vector<VectorDimD> referenceConfigB, deformedConfigB;
      std::vector<VectorDimD> configDscl;
 
-     double bmax= 0.0;
+     // sites of the CSL points that are deleted in this mesostate
+     std::vector<bool> deletedSites(cslSites->size(),false);
      for(const auto& [b,s,include] : bs)
-         bmax= max(bmax,b.cartesian().norm());
+     {
+         if (include!=2) continue;
+         const auto* sites= cslSites->find(s);
+         if (sites==nullptr)
+             throw(std::runtime_error("GB Mesostate construction failed: a shift is not in the index of CSL sites"));
+         for(const auto& site : *sites)
+             deletedSites[site]= true;
+     }
 
+     // classify the lattice points in parallel: 1 and 2 for atoms of A and B, 0 for points that are dropped
+     const long numberOfPoints= config.size();
+     std::vector<VectorDimD> positions(numberOfPoints);
+     std::vector<int> types(numberOfPoints,0);
      int numberOfIgnoredPoints= 0;
-     for (const auto &latticeVector: config) {
+     const VectorDimD normalA(gb.nA.cartesian().normalized());
+     const VectorDimD normalB(gb.nB.cartesian().normalized());
+#pragma omp parallel for schedule(static) reduction(+:numberOfIgnoredPoints)
+     for (long p=0; p<numberOfPoints; ++p) {
+         const auto& latticeVector= config[p];
+         const bool inA= &(latticeVector.lattice) == &(this->gb.bc.A);
+         const bool inB= &(latticeVector.lattice) == &(this->gb.bc.B);
          VectorDimD x;
          OrderedTuplet<dim+1> temp;
-         if (&(latticeVector.lattice) == &(this->gb.bc.A)) {
-             double height= latticeVector.cartesian().dot(gb.nA.cartesian().normalized());
+         if (inA) {
+             double height= latticeVector.cartesian().dot(normalA);
              if (height<FLT_EPSILON)
                  temp <<  gb.bc.getLatticeVectorInD(latticeVector),1;
              else
                  temp <<  gb.bc.getLatticeVectorInD(latticeVector),-1;
          }
-         else if (&(latticeVector.lattice) == &(this->gb.bc.B)) {
-             double height = latticeVector.cartesian().dot(gb.nB.cartesian().normalized());
+         else if (inB) {
+             double height = latticeVector.cartesian().dot(normalB);
              if (height<FLT_EPSILON)
                  temp <<  gb.bc.getLatticeVectorInD(latticeVector),2;
              else
                  temp <<  gb.bc.getLatticeVectorInD(latticeVector),-2;
          }
 
-         //x = latticeVector.cartesian() + this->displacement(latticeVector.cartesian());
-
-         if (&(latticeVector.lattice) == &(this->gb.bc.A)) {
+         if (inA)
              x = latticeVector.cartesian() + this->displacement(temp) + this->uAverage;
-         }
-         else if (&(latticeVector.lattice) == &(this->gb.bc.B) )
+         else if (inB)
              x = latticeVector.cartesian() + this->displacement(temp) - this->uAverage;
          else
              x = latticeVector.cartesian() + this->displacement(temp);
+         positions[p]= x;
 
          // ignore x if it occupies a deleted CSL position
-         bool ignore= false;
-         VectorDimD cslShift;
-         cslShift << -0.5, -FLT_EPSILON, -FLT_EPSILON;
-         VectorDimD xModulo= x;
-         std::vector<LatticeVector<3>> localBoxVectors(boxVectors);
-         localBoxVectors[0]=5*boxVectors[0];
-         LatticeVector<dim>::modulo(xModulo, localBoxVectors, cslShift);
-         for(const auto& [b,s, include] : bs) {
-             if (include == 2 && (s - xModulo).norm() < 1e-6) {
-                 ignore = true;
-                 numberOfIgnoredPoints++;
-                 break;
-             }
-         }
-         if (ignore==true) {
+         const auto* sites= cslSites->find(x);
+         if (sites!=nullptr &&
+             std::any_of(sites->begin(),sites->end(),[&deletedSites](const int& site){return deletedSites[site];})) {
+             numberOfIgnoredPoints++;
              continue;
          }
 
+         if (inA && x.dot(normalA) <= 1e-6)
+             types[p]= 1;
+         else if (inB && x.dot(normalB) <= 1e-6)
+             types[p]= 2;
+     }
 
-         if (&(latticeVector.lattice) == &(this->gb.bc.A) && x.dot(this->gb.nA.cartesian().normalized()) <= 1e-6)
-         //if (&(latticeVector.lattice) == &(this->gb.bc.A) && x.dot(this->gb.nA.cartesian().normalized()) <= FLT_EPSILON)
-         //if (&(latticeVector.lattice) == &(this->gb.bc.A))
-         {
-             referenceConfigA.push_back(latticeVector.cartesian());
-             deformedConfigA.push_back(x);
+     for (long p=0; p<numberOfPoints; ++p) {
+         if (types[p]==1) {
+             referenceConfigA.push_back(config[p].cartesian());
+             deformedConfigA.push_back(positions[p]);
          }
-         else if (&(latticeVector.lattice) == &(this->gb.bc.B) && x.dot(this->gb.nB.cartesian().normalized()) <= 1e-6)
-         //else if (&(latticeVector.lattice) == &(this->gb.bc.B) && x.dot(this->gb.nB.cartesian().normalized()) <= FLT_EPSILON)
-         //else if (&(latticeVector.lattice) == &(this->gb.bc.B))
-         {
-             referenceConfigB.push_back(latticeVector.cartesian());
-             deformedConfigB.push_back(x);
+         else if (types[p]==2) {
+             referenceConfigB.push_back(config[p].cartesian());
+             deformedConfigB.push_back(positions[p]);
          }
-
      }
 
 
@@ -339,43 +352,192 @@ namespace gbLAB {
          throw(std::runtime_error("GB Mesostate construction failed: incorrect number of points"));
 
 
-     int nAtoms= referenceConfigA.size()+referenceConfigB.size()+configDscl.size();
-
-     std::string referenceFile= name + "_reference0.txt";
-     std::string deformedFile= name + "_reference1.txt";
-
-     std::ofstream reference, deformed;
-     reference.open(referenceFile);
-     deformed.open(deformedFile);
-     if (!reference || !deformed) std::cerr << "Unable to open files";
-     reference << nAtoms << std::endl; deformed << nAtoms << std::endl;
-     reference << "Lattice=\" "; deformed << "Lattice=\" ";
-
-     reference << std::setprecision(15) << (2*boxVectors[0].cartesian()).transpose() << " ";
-     deformed << std::setprecision(15) << (2*boxVectors[0].cartesian()).transpose() << " ";
-     reference << std::setprecision(15) << (boxVectors[1].cartesian()).transpose() << " ";
-     deformed << std::setprecision(15) << (boxVectors[1].cartesian()).transpose() << " ";
-     reference << std::setprecision(15) << (boxVectors[2].cartesian()).transpose();
-     deformed << std::setprecision(15) << (boxVectors[2].cartesian()).transpose();
-     reference << "\" Properties=atom_types:I:1:pos:R:3:radius:R:1 PBC=\"F T T\" origin=\" "; deformed << "\" Properties=atom_types:I:1:pos:R:3:radius:R:1 PBC=\" F T T\" origin=\" ";
-     reference << std::setprecision(15) << (-1 * boxVectors[0].cartesian()).transpose() << "\"" << std::endl;
-     deformed << std::setprecision(15) << (-1 * boxVectors[0].cartesian()).transpose() << "\"" << std::endl;
-
-     for(const auto& position : referenceConfigA)
-         reference << 1 << " " << std::setprecision(15) << position.transpose() << "  " << 0.05 << std::endl;
-     for(const auto& position : referenceConfigB)
-         reference << 2 << " " << std::setprecision(15) << position.transpose() << "  " << 0.05 << std::endl;
-     for(const auto& position : deformedConfigA)
-         deformed << 1 << " " << std::setprecision(15) << position.transpose() << "  " << 0.05 << std::endl;
-     for(const auto& position : deformedConfigB)
-         deformed << 2 << " " << std::setprecision(15) << position.transpose() << "  " << 0.05 << std::endl;
-     for(const auto& position : configDscl) {
-         reference << 4 << " " << std::setprecision(15) << position.transpose() << "  " << 0.01 << std::endl;
-         deformed << 4 << " " << std::setprecision(15) << position.transpose() << "  " << 0.01 << std::endl;
+     const size_t nAtoms= referenceConfigA.size()+referenceConfigB.size()+configDscl.size();
+     Configuration reference(nAtoms), deformed(nAtoms);
+     for(Configuration* configuration : {&reference,&deformed})
+     {
+         configuration->box.col(0)= 2*boxVectors[0].cartesian();
+         configuration->box.col(1)= boxVectors[1].cartesian();
+         configuration->box.col(2)= boxVectors[2].cartesian();
+         configuration->origin= -1*boxVectors[0].cartesian();
+     }
+
+     size_t index= 0;
+     const auto append= [&](const std::vector<VectorDimD>& referencePositions,
+                            const std::vector<VectorDimD>& deformedPositions,
+                            const int& type)
+     {
+         for(size_t i=0; i<referencePositions.size(); ++i, ++index)
+         {
+             reference.positions.col(index)= referencePositions[i];
+             deformed.positions.col(index)= deformedPositions[i];
+             reference.types[index]= type;
+             deformed.types[index]= type;
+         }
+     };
+     append(referenceConfigA,deformedConfigA,1);
+     append(referenceConfigB,deformedConfigB,2);
+     append(configDscl,configDscl,4);
+     return {reference,deformed};
+ }
+
+ template<int dim>
+ //template<int dm=dim>
+ typename std::enable_if<dim==3,void>::type
+ GbMesoState<dim>::box(const std::string& name, const ConfigurationFormat& format) const
+ {
+     OILAB_PROFILE_SCOPE("GbMesoState::box");
+     const auto [reference,deformed]= configurations();
+     writeConfiguration(name + "_reference0.txt",reference,format);
+     writeConfiguration(name + "_reference1.txt",deformed,format);
+ }
+
+ /*-------------------------------------*/
+ template<int dim>
+ std::array<Eigen::Index,dim> GbMesoState<dim>::densityGrid() const
+ {
+     // same spacing as the grid of the continuum model along the first GB vector
+     const double h= mesoStateCslVectors[1].cartesian().norm()/this->n[0];
+     std::array<Eigen::Index,dim> n;
+     n[0]= std::ceil(2*mesoStateCslVectors[0].cartesian().norm()/h);
+     for(int i=1; i<dim; ++i)
+         n[i]= this->n[i-1];
+     return n;
+ }
+
+ template<int dim>
+ double GbMesoState<dim>::densityWidth() const
+ {
+     return 0.25*gb.bc.A.latticeBasis.colwise().norm().minCoeff();
+ }
+
+ template<int dim>
+ PeriodicFunction<double,dim> GbMesoState<dim>::density(const std::array<Eigen::Index,dim>& n, const double& sigma) const
+ {
+     return deposit(configurations().second,n,sigma);
+ }
+
+ template<int dim>
+ PeriodicFunction<double,dim> GbMesoState<dim>::deposit(const Configuration& configuration,
+                                                        const std::array<Eigen::Index,dim>& n,
+                                                        const double& sigma)
+ {
+     OILAB_PROFILE_SCOPE("GbMesoState::deposit");
+     static_assert(dim==3,"The atomic density is only implemented in 3D.");
+     if (sigma<=0)
+         throw std::runtime_error("GbMesoState::deposit: the width of the atoms has to be positive.");
+     using dcomplex= std::complex<double>;
+     const Eigen::Matrix3d& cell(configuration.box);
+     const Eigen::Matrix3d cellInverse(cell.inverse());
+     const double gridVolume= std::abs(cell.determinant())/(n[0]*n[1]*n[2]);
+
+     // triangular-shaped-cloud deposition, each thread on its own grid
+     Eigen::Tensor<double,dim> counts(n[0],n[1],n[2]);
+     counts.setZero();
+#pragma omp parallel
+     {
+         Eigen::Tensor<double,dim> threadCounts(n[0],n[1],n[2]);
+         threadCounts.setZero();
+#pragma omp for schedule(static)
+         for (long a=0; a<static_cast<long>(configuration.size()); ++a)
+         {
+             const Eigen::Vector3d fractional(cellInverse*configuration.positions.col(a));
+             // nearest grid point and the weights of it and its two neighbors along each direction
+             std::array<Eigen::Index,dim> nearest;
+             std::array<std::array<double,3>,dim> weights;
+             for (int d=0; d<dim; ++d)
+             {
+                 const double g= fractional(d)*n[d];
+                 const double gNearest= std::round(g);
+                 const double delta= g-gNearest;
+                 nearest[d]= ((static_cast<Eigen::Index>(gNearest) % n[d]) + n[d]) % n[d];
+                 weights[d]= {0.5*(0.5-delta)*(0.5-delta), 0.75-delta*delta, 0.5*(0.5+delta)*(0.5+delta)};
+             }
+             for (int i=0; i<3; ++i)
+             {
+                 const Eigen::Index gi= (nearest[0]+i-1+n[0]) % n[0];
+                 for (int j=0; j<3; ++j)
+                 {
+                     const Eigen::Index gj= (nearest[1]+j-1+n[1]) % n[1];
+                     const double wij= weights[0][i]*weights[1][j];
+                     for (int k=0; k<3; ++k)
+                         threadCounts(gi,gj,(nearest[2]+k-1+n[2]) % n[2])+= wij*weights[2][k];
+                 }
+             }
+         }
+#pragma omp critical
+         counts+= threadCounts;
+     }
+
+     // convolution with the Gaussian density of one atom, undoing the smoothing by the deposition window
+     Eigen::Tensor<dcomplex,dim> countsHat(n[0],n[1],n[2]);
+     FFT::fft((counts/gridVolume).template cast<dcomplex>(),countsHat);
+     const Eigen::Matrix3d reciprocalBasis(2*std::numbers::pi*cellInverse.transpose());
+     const auto sinc= [](const double& x){return std::abs(x)<DBL_EPSILON ? 1.0 : std::sin(x)/x;};
+     for (Eigen::Index i=0; i<n[0]; ++i)
+     {
+         for (Eigen::Index j=0; j<n[1]; ++j)
+         {
+             for (Eigen::Index k=0; k<n[2]; ++k)
+             {
+                 const Eigen::Vector3d m(i<=n[0]/2 ? i : i-n[0],
+                                         j<=n[1]/2 ? j : j-n[1],
+                                         k<=n[2]/2 ? k : k-n[2]);
+                 double window= 1.0;
+                 for (int d=0; d<dim; ++d)
+                     window*= std::pow(sinc(std::numbers::pi*m(d)/n[d]),3);
+                 countsHat(i,j,k)*= std::exp(-0.5*sigma*sigma*(reciprocalBasis*m).squaredNorm())/window;
+             }
+         }
      }
 
-     reference.close();
-     deformed.close();
+     PeriodicFunction<double,dim> rho(n,cell);
+     Eigen::Tensor<dcomplex,dim> rhoComplex(n[0],n[1],n[2]);
+     FFT::ifft(countsHat,rhoComplex);
+     rho.values= rhoComplex.real();
+     return rho;
+ }
+
+ template<int dim>
+ std::tuple<double,double,PeriodicFunction<double,dim>> GbMesoState<dim>::surrogateDensityEnergy(const std::array<Eigen::Index,dim>& n,
+                                                                                                  const double& sigma) const
+ {
+     OILAB_PROFILE_SCOPE("GbMesoState::surrogateDensityEnergy");
+     const double width= sigma>0 ? sigma : densityWidth();
+     const bool defaultGrid= std::any_of(n.begin(),n.end(),[](const Eigen::Index& ni){return ni<=0;});
+     const Configuration deformed(configurations().second);
+     const PeriodicFunction<double,dim> rho(deposit(deformed,defaultGrid ? densityGrid() : n,width));
+
+     // overlap of all pairs of atoms, including periodic images: (1/2) sum_{i!=j} exp(-r_ij^2/(4 width^2))
+     const double volumePerGridPoint= std::abs(deformed.box.determinant())/rho.values.size();
+     const Eigen::Tensor<double,0> rhoSquared((rho.values*rho.values).sum());
+     const double gaussianVolume= std::pow(4*std::numbers::pi*width*width,1.5);
+     const double overlap= 0.5*gaussianVolume*rhoSquared(0)*volumePerGridPoint - 0.5*deformed.size();
+
+     // overlap per atom in the perfect lattices
+     const auto latticeOverlap= [&width](const Eigen::Matrix<double,dim,dim>& basis)
+     {
+         const double cutoff= 2*width*std::sqrt(std::log(1e16));
+         const Eigen::Matrix<double,dim,dim> basisInverse(basis.inverse());
+         std::array<int,dim> m;
+         for (int d=0; d<dim; ++d)
+             m[d]= std::ceil(cutoff*basisInverse.row(d).norm());
+         double sum= 0.0;
+         for (int i=-m[0]; i<=m[0]; ++i)
+             for (int j=-m[1]; j<=m[1]; ++j)
+                 for (int k=-m[2]; k<=m[2]; ++k)
+                     if (i!=0 || j!=0 || k!=0)
+                         sum+= std::exp(-(basis*Eigen::Vector3d(i,j,k)).squaredNorm()/(4*width*width));
+         return 0.5*sum;
+     };
+     const double overlapA= latticeOverlap(gb.bc.A.latticeBasis);
+     const double overlapB= latticeOverlap(gb.bc.B.latticeBasis);
+     double bulkOverlap= 0.0;
+     for (const auto& type : deformed.types)
+         bulkOverlap+= type==2 ? overlapB : overlapA;
+
+     const double area= mesoStateCslVectors[1].cartesian().cross(mesoStateCslVectors[2].cartesian()).norm();
+     return {static_cast<double>(deformed.size()),(overlap-bulkOverlap)/(2*area),rho};
  }
 
 }
@@ -0,0 +1,76 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef OILAB_GBSHIFTSYMMETRY_H
+#define OILAB_GBSHIFTSYMMETRY_H
+
+#include <GbShifts.h>
+#include <OrderedTuplet.h>
+#include <utility>
+#include <vector>
+
+namespace gbLAB {
+
+    /*!
+     * \brief Symmetry group of a mesostate ensemble, acting on the indices of its (b,s) pairs.
+     *
+     * An operation \f$(\textbf R,\textbf t)\f$ maps the pair \f$(\textbf b,\textbf s)\f$ to
+     * \f$(\textbf R\textbf b,\textbf R\textbf s+\textbf t)\f$, with \f$\textbf s\f$ taken modulo the
+     * GB CSL vectors. The rotations \f$\textbf R\f$ are the point-group operations (proper and improper)
+     * common to lattices \f$\mathcal A\f$ and \f$\mathcal B\f$ that fix the GB normal and map the
+     * periodic cell of the ensemble onto itself. The translations \f$\textbf t\f$ are the CSL vectors
+     * in the GB plane, i.e. the shifts of the pairs with \f$\textbf b=\textbf 0\f$. Operations that do
+     * not map the set of pairs onto itself are discarded.
+     *
+     * Two constraints related by an operation describe the same configuration up to a rigid motion,
+     * and have the same energy. The canonical form of a constraint is the lexicographically smallest
+     * admissible member of its orbit, where admissible means that the first entry is 1 (see
+     * GbMesoStateEnsemble::admissibleConstraints). The multiplicity is the number of admissible
+     * members of the orbit.
+     */
+    template<int dim>
+    class GbShiftSymmetry
+    {
+        using VectorDimD = typename LatticeCore<dim>::VectorDimD;
+        using MatrixDimD = typename LatticeCore<dim>::MatrixDimD;
+
+        static std::vector<std::vector<int>> getPermutations(const GbShifts<dim>& gbs,
+                                                             const std::vector<LatticeVector<dim>>& cellVectors,
+                                                             std::vector<MatrixDimD>& rotations);
+
+    public:
+        /*!
+         * Point-group operations of a lattice, as Cartesian orthogonal matrices.
+         */
+        static std::vector<MatrixDimD> pointGroup(const Lattice<dim>& lattice);
+
+        /*!
+         * Rotations of the group, identity first.
+         */
+        std::vector<MatrixDimD> rotations;
+
+        /*!
+         * permutations[g][i] is the index of the pair that pair i is mapped to by operation g.
+         * The first permutation is the identity.
+         */
+        const std::vector<std::vector<int>> permutations;
+
+        /*!
+         * @param gbs - (b,s) pairs of the ensemble
+         * @param cellVectors - CSL vectors of the periodic cell of the ensemble; rotations have to map
+         * the lattice they span onto itself
+         */
+        GbShiftSymmetry(const GbShifts<dim>& gbs, const std::vector<LatticeVector<dim>>& cellVectors);
+
+        //! Image of \p constraints under operation \p g
+        XTuplet apply(const size_t& g, const XTuplet& constraints) const;
+
+        //! Canonical form of the orbit of \p constraints, and the number of admissible constraints in the orbit
+        std::pair<XTuplet,int> canonicalForm(const XTuplet& constraints) const;
+
+        size_t size() const;
+    };
+}
+#endif //OILAB_GBSHIFTSYMMETRY_H
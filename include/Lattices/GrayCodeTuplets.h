@@ -0,0 +1,118 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef OILAB_GRAYCODETUPLETS_H
+#define OILAB_GRAYCODETUPLETS_H
+
+#include <bit>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+#include <OrderedTuplet.h>
+
+namespace gbLAB {
+
+    /*!
+     * \brief A lazy range of XTuplets in which entry \f$i\f$ takes one of the two
+     * values \p values0(i) or \p values1(i).
+     *
+     * Entries with values0(i)==values1(i) are fixed. The remaining \f$m\f$ free
+     * entries are enumerated in binary-reflected Gray-code order, so consecutive
+     * tuplets differ in exactly one entry and no tuplet is stored beyond the one
+     * held by an iterator. The tuplet of rank \f$n\f$ is available in O(k) via
+     * operator[], which allows the range to be split among threads.
+     */
+    class GrayCodeTuplets
+    {
+        XTuplet values0;
+        XTuplet values1;
+        std::vector<int> freeIndices;
+
+    public:
+        class iterator
+        {
+            const GrayCodeTuplets* range;
+            std::uint64_t n;
+            XTuplet current;
+
+        public:
+            using iterator_category= std::input_iterator_tag;
+            using value_type= XTuplet;
+            using difference_type= std::ptrdiff_t;
+            using pointer= const XTuplet*;
+            using reference= const XTuplet&;
+
+            iterator(const GrayCodeTuplets& range, const std::uint64_t& n) :
+                range(&range),
+                n(n),
+                current(n<range.size() ? range[n] : range.values0)
+            {}
+
+            reference operator*() const { return current; }
+            pointer operator->() const { return &current; }
+
+            //! Rank of the current tuplet
+            std::uint64_t rank() const { return n; }
+
+            //! Gray code of rank n+1 differs from that of rank n in bit countr_zero(n+1)
+            iterator& operator++()
+            {
+                ++n;
+                if (n<range->size())
+                {
+                    const int i= range->freeIndices[std::countr_zero(n)];
+                    current(i)= current(i)==range->values0(i) ? range->values1(i) : range->values0(i);
+                }
+                return *this;
+            }
+
+            bool operator==(const iterator& other) const { return n==other.n; }
+            bool operator!=(const iterator& other) const { return n!=other.n; }
+        };
+
+        GrayCodeTuplets(const XTuplet& values0, const XTuplet& values1) :
+            values0(values0),
+            values1(values1)
+        {
+            if (values0.size()!=values1.size())
+                throw std::runtime_error("GrayCodeTuplets: value tuplets of different sizes.");
+            for (int i=0; i<values0.size(); ++i)
+                if (values0(i)!=values1(i))
+                    freeIndices.push_back(i);
+            if (freeIndices.size()>63)
+                throw std::runtime_error("GrayCodeTuplets: more than 63 free entries cannot be enumerated.");
+        }
+
+        //! Number of tuplets in the range, \f$2^m\f$
+        std::uint64_t size() const
+        {
+            return std::uint64_t(1) << freeIndices.size();
+        }
+
+        //! The tuplet of rank \p n, whose free entries follow the bits of the Gray code \f$n\oplus(n\gg1)\f$
+        XTuplet operator[](const std::uint64_t& n) const
+        {
+            const std::uint64_t gray= n ^ (n >> 1);
+            XTuplet output(values0);
+            for (size_t j=0; j<freeIndices.size(); ++j)
+                if ((gray >> j) & 1)
+                    output(freeIndices[j])= values1(freeIndices[j]);
+            return output;
+        }
+
+        iterator begin(const std::uint64_t& n=0) const
+        {
+            return iterator(*this,n);
+        }
+
+        iterator end() const
+        {
+            return iterator(*this,size());
+        }
+    };
+
+}
+#endif //OILAB_GRAYCODETUPLETS_H
@@ -21,6 +21,8 @@
 #include <RationalApproximations.h>
 #include <algorithm>
 #include <fstream>
+#include <functional>
+#include <ConfigurationIO.h>
 
 
 namespace gbLAB
@@ -174,11 +176,13 @@ namespace gbLAB
          * @tparam dm dimension (int)
          * @param boxVectors three linearly independent lattice vectors
          * @param filename (optional) name of the output file
+         * @param format (optional) format of the output file
          * @return Lattice points bounded by the box vectors
          */
         template<int dm=dim>
         typename std::enable_if<dm==3,std::vector<LatticeVector<dim>>>::type
-        box(const std::vector<LatticeVector<dim>>& boxVectors, const std::string& filename= "") const;
+        box(const std::vector<LatticeVector<dim>>& boxVectors, const std::string& filename= "",
+            const ConfigurationFormat& format= ConfigurationFormat::xyz) const;
 
         /*! This function outputs/prints lattice points within a box bounded by the
          * optional input box vectors. The box vectors have to be linearly independent lattice
@@ -187,11 +191,50 @@ namespace gbLAB
          * @tparam dm dimension (int)
          * @param boxVectors two linearly independent lattice vectors
          * @param filename (optional) name of the output file
+         * @param format (optional) format of the output file
          * @return Lattice points bounded by the box vectors
          */
         template<int dm=dim>
         typename std::enable_if<dm==2,std::vector<LatticeVector<dim>>>::type
-        box(const std::vector<LatticeVector<dim>>& boxVectors, const std::string& filename= "") const;
+        box(const std::vector<LatticeVector<dim>>& boxVectors, const std::string& filename= "",
+            const ConfigurationFormat& format= ConfigurationFormat::xyz) const;
+
+        /*! Calls \p visitor for each lattice point \f$\textbf x=\sum_i f_i \textbf b_i\f$, \f$0\le f_i<1\f$, of the box
+         * spanned by the linearly independent lattice vectors \f$\textbf b_i\f$ (\p boxVectors), without storing
+         * the points. The points are generated directly from the Hermite normal form of the box matrix, in the
+         * same order as returned by boxPoints and box.
+         *
+         * @param boxVectors dim linearly independent lattice vectors
+         * @param visitor function called once for each lattice point in the box
+         */
+        void forEachBoxPoint(const std::vector<LatticeVector<dim>>& boxVectors,
+                             const std::function<void(const LatticeVector<dim>&)>& visitor) const;
+
+        /*! Lattice points within the box spanned by \p boxVectors, in the order of forEachBoxPoint (see BoxEnumerator).
+         * The output is allocated once and filled in parallel.
+         *
+         * @param boxVectors dim linearly independent lattice vectors
+         * @return Lattice points bounded by the box vectors
+         */
+        std::vector<LatticeVector<dim>> boxPoints(const std::vector<LatticeVector<dim>>& boxVectors) const;
+
+        /*! Integer coordinates of the lattice points within the box spanned by \p boxVectors, stored as the
+         * columns of a dim x N matrix, in the order of boxPoints. Unlike boxPoints, the output is a single
+         * contiguous array, which can be handed to other languages without copying.
+         *
+         * @param boxVectors dim linearly independent lattice vectors
+         * @return integer coordinates of the lattice points bounded by the box vectors
+         */
+        Eigen::Matrix<IntScalarType,dim,Eigen::Dynamic> boxCoordinates(const std::vector<LatticeVector<dim>>& boxVectors) const;
+
+        /*! Lattice points \f$\textbf x\f$ with \f$|\textbf x|\le\f$ \p radius, enumerated with the Fincke-Pohst
+         * algorithm in an RLLL-reduced basis (see BallEnumerator). The cost is proportional to the number of
+         * points in the ball.
+         *
+         * @param radius radius of the ball centered at the origin
+         * @return Lattice points in the ball
+         */
+        std::vector<LatticeVector<dim>> ballPoints(const double& radius) const;
 };
 /*! @example testPlaneParallelLatticeDirections.cpp
  *  This example demonstrates the computation of plane-parallel lattice basis and direction-orthogonal reciprocal
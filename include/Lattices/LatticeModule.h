@@ -40,6 +40,8 @@ namespace gbLAB
 
 }
 
+#include <Log.h>
+#include <Profiler.h>
 #include <LatticeCore.h>
 #include <Lattice.h>
 #include <LatticeVector.h>
@@ -123,22 +123,25 @@ namespace gbLAB {
         double density() const
         {
             double density= 0.0;
-            for (int stateIndex = 0; stateIndex < (*this).size(); ++stateIndex) {
-                if(stateIndex==0 or stateIndex==1)
-                    if((*this).operator()(stateIndex) == 2 )
-                        density= density - 1;
-                if(stateIndex>=2 and stateIndex<=(*this).size()/2) {
-                    if ((*this).operator()(stateIndex) == 1)
-                        density = density - 1;
-                    if ((*this).operator()(stateIndex) == 2)
-                        density = density - 2;
-                }
-                if(stateIndex>=(*this).size()/2+1 and stateIndex<(*this).size())
-                    if((*this).operator()(stateIndex) == 1 )
-                        density= density + 1;
-            }
+            for (int stateIndex = 0; stateIndex < (*this).size(); ++stateIndex)
+                density+= densityContribution(stateIndex,(*this).operator()(stateIndex),(*this).size());
             return density;
         }
+
+        /*!
+         * Contribution of entry \p value at position \p stateIndex of a tuplet of
+         * size \p size to density(). Used to update the density incrementally.
+         */
+        static double densityContribution(const int& stateIndex, const int& value, const int& size)
+        {
+            if(stateIndex==0 or stateIndex==1)
+                return value == 2 ? -1.0 : 0.0;
+            if(stateIndex>=2 and stateIndex<=size/2)
+                return -static_cast<double>(value == 1 || value == 2 ? value : 0);
+            if(stateIndex>=size/2+1 and stateIndex<size)
+                return value == 1 ? 1.0 : 0.0;
+            return 0.0;
+        }
     };
 
     static std::basic_ostream<char>& operator<<(std::basic_ostream<char>& s, const XTuplet& m) {
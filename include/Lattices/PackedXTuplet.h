@@ -0,0 +1,148 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef OILAB_PACKEDXTUPLET_H
+#define OILAB_PACKEDXTUPLET_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <OrderedTuplet.h>
+
+namespace gbLAB {
+
+    /*!
+     * \brief A compact representation of an XTuplet whose entries lie in \f$\{0,1,2\}\f$.
+     *
+     * Entries are packed two bits each into 64-bit words, with entry 0 in the most
+     * significant bits of the first word, so that comparing words compares
+     * tuplets lexicographically (the same order as XTuplet::operator<). A 64-bit
+     * Zobrist hash and the density are maintained incrementally by set(), making
+     * hashing O(1) and equality a comparison of packed words.
+     */
+    class PackedXTuplet
+    {
+        static constexpr int entriesPerWord= 32;
+
+        std::vector<std::uint64_t> words;
+        int sz;
+        std::uint64_t hashValue;
+        double densityValue;
+
+        static std::uint64_t splitmix64(std::uint64_t x)
+        {
+            x+= 0x9e3779b97f4a7c15ull;
+            x= (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+            x= (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+            return x ^ (x >> 31);
+        }
+
+        // zero entries do not contribute, so the hash of an all-zero tuplet depends only on its size
+        static std::uint64_t zobrist(const int& index, const int& value)
+        {
+            return value==0 ? 0 : splitmix64((static_cast<std::uint64_t>(index) << 2) | value);
+        }
+
+        static int shift(const int& index)
+        {
+            return 62-2*(index % entriesPerWord);
+        }
+
+    public:
+        explicit PackedXTuplet(const int& sz=0) :
+            words((sz+entriesPerWord-1)/entriesPerWord,0),
+            sz(sz),
+            hashValue(splitmix64(~static_cast<std::uint64_t>(sz))),
+            densityValue(0.0)
+        {}
+
+        explicit PackedXTuplet(const XTuplet& tuplet) :
+            PackedXTuplet(tuplet.size())
+        {
+            for (int i=0; i<sz; ++i)
+                set(i,tuplet(i));
+        }
+
+        int size() const
+        {
+            return sz;
+        }
+
+        int operator()(const int& index) const
+        {
+            return (words[index/entriesPerWord] >> shift(index)) & 3;
+        }
+
+        //! Sets entry \p index to \p value, updating the hash and density in O(1)
+        void set(const int& index, const int& value)
+        {
+            assert(value>=0 && value<=2);
+            const int old= operator()(index);
+            if (old==value)
+                return;
+            std::uint64_t& word= words[index/entriesPerWord];
+            word&= ~(std::uint64_t(3) << shift(index));
+            word|= std::uint64_t(value) << shift(index);
+            hashValue^= zobrist(index,old) ^ zobrist(index,value);
+            densityValue+= XTuplet::densityContribution(index,value,sz)-XTuplet::densityContribution(index,old,sz);
+        }
+
+        std::uint64_t hash() const
+        {
+            return hashValue;
+        }
+
+        //! Same value as XTuplet::density(), without rescanning the entries
+        double density() const
+        {
+            return densityValue;
+        }
+
+        XTuplet unpack() const
+        {
+            XTuplet tuplet(sz);
+            for (int i=0; i<sz; ++i)
+                tuplet(i)= operator()(i);
+            return tuplet;
+        }
+
+        explicit operator XTuplet() const
+        {
+            return unpack();
+        }
+
+        bool operator==(const PackedXTuplet& rhs) const
+        {
+            return hashValue==rhs.hashValue && sz==rhs.sz && words==rhs.words;
+        }
+
+        bool operator!=(const PackedXTuplet& rhs) const
+        {
+            return !(*this==rhs);
+        }
+
+        bool operator<(const PackedXTuplet& rhs) const
+        {
+            if (sz!=rhs.sz)
+                return sz<rhs.sz;
+            return words<rhs.words;
+        }
+    };
+
+    static std::basic_ostream<char>& operator<<(std::basic_ostream<char>& s, const PackedXTuplet& m) {
+        return s << m.unpack();
+    }
+}
+
+template<>
+struct std::hash<gbLAB::PackedXTuplet>
+{
+    std::size_t operator()(const gbLAB::PackedXTuplet& tuplet) const noexcept
+    {
+        return tuplet.hash();
+    }
+};
+
+#endif //OILAB_PACKEDXTUPLET_H
@@ -52,7 +52,7 @@ namespace gbLAB
             if (n==2)
             {
                 IntScalarType g= extended_gcd(p(0),p(1),out(0),out(1));
-                std::cout << p(0) << "   " << p(1) << std::endl;
+                OILAB_LOG(trace,math) << "solveBezout " << p(0) << "   " << p(1);
                 if (g<0) out= -out;
                 return out;
             }
@@ -156,8 +156,7 @@ namespace gbLAB
 
             if (c % g != 0)
             {
-                std::cout << a << "  " << b << "  " << c << "   " << g << std::endl;
-                puts("Impossible");
+                OILAB_LOG(error,math) << a << "  " << b << "  " << c << "   " << g << ": Impossible";
                 exit(0);
             }
 
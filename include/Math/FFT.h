@@ -8,6 +8,7 @@
 #include <Eigen/Dense>
 #include <unsupported/Eigen/FFT>
 #include <unsupported/Eigen/CXX11/Tensor>
+#include <Profiler.h>
 
 class FFT : public Eigen::FFT<double>
 {
@@ -16,6 +17,7 @@ public:
     // 3 dimensions
     static void fft(const Eigen::Tensor<dcomplex,3>& in, Eigen::Tensor<dcomplex,3>& out)
     {
+        OILAB_PROFILE_SCOPE("FFT::fft 3D");
         out.setZero();
         Eigen::FFT<double> fft;
         for (int k = 0; k < in.dimension(0); k++)
@@ -53,6 +55,7 @@ public:
     }
     static void ifft(const Eigen::Tensor<dcomplex,3>& in, Eigen::Tensor<dcomplex,3>& out)
     {
+        OILAB_PROFILE_SCOPE("FFT::ifft 3D");
         out.setZero();
         Eigen::FFT<double> fft;
         for (int k = 0; k < in.dimension(0); k++)
@@ -92,6 +95,7 @@ public:
     // 2 dimensions
     static void fft(const Eigen::Tensor<dcomplex,2>& in, Eigen::Tensor<dcomplex,2>& out)
     {
+        OILAB_PROFILE_SCOPE("FFT::fft 2D");
         out.setZero();
         Eigen::FFT<double> fft;
 
@@ -111,6 +115,7 @@ public:
     }
     static void ifft(const Eigen::Tensor<dcomplex,2>& in, Eigen::Tensor<dcomplex,2>& out)
     {
+        OILAB_PROFILE_SCOPE("FFT::ifft 2D");
         out.setZero();
         Eigen::FFT<double> fft;
         for (int k = 0; k < in.dimension(0); k++) {
@@ -0,0 +1,107 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+
+#ifndef gbLAB_HermiteNormalForm_h_
+#define gbLAB_HermiteNormalForm_h_
+
+#include <stdexcept>
+#include <Eigen/Core>
+#include <IntegerMath.h>
+
+namespace gbLAB
+{
+    /*!Class template which computes the (column-style, lower triangular) Hermite
+     * normal form of a non-singular square matrix of integers A.
+     *
+     * The decomposition is:
+     * H=A*W
+     * where
+     * W is a unimodular integer matrix
+     * H is a lower triangular integer matrix with H(i,i)>0 and 0<=H(i,j)<H(i,i) for j<i.
+     * The columns of H and A generate the same integer lattice.
+     */
+    template <int N>
+    class HermiteNormalForm
+    {
+        typedef long long int IntValueType;
+        typedef Eigen::Matrix<IntValueType,N,N> MatrixNi;
+
+        MatrixNi H;
+        MatrixNi W;
+
+        /**********************************************************************/
+        // floor(a/b) for b>0
+        static IntValueType floorDivide(const IntValueType& a, const IntValueType& b)
+        {
+            return a/b - ((a%b!=0) && (a<0));
+        }
+
+        /**********************************************************************/
+        void compute()
+        {
+            for(int i=0;i<N;++i)
+            {
+                // zero H(i,j) for j>i by unimodular operations on columns i and j
+                for(int j=i+1;j<N;++j)
+                {
+                    if(H(i,j)==0) continue;
+                    const IntValueType a(H(i,i));
+                    const IntValueType b(H(i,j));
+                    IntValueType x,y;
+                    const IntValueType g(IntegerMath<IntValueType>::extended_gcd(a,b,x,y));
+                    // [col_i col_j] <- [col_i col_j] * [x -b/g; y a/g], whose determinant is (a*x+b*y)/g=1
+                    const MatrixNi Hi(H), Wi(W);
+                    H.col(i)= x*Hi.col(i)+y*Hi.col(j);
+                    H.col(j)= (-b/g)*Hi.col(i)+(a/g)*Hi.col(j);
+                    W.col(i)= x*Wi.col(i)+y*Wi.col(j);
+                    W.col(j)= (-b/g)*Wi.col(i)+(a/g)*Wi.col(j);
+                }
+
+                if(H(i,i)==0)
+                {
+                    throw std::runtime_error("HermiteNormalForm: singular input matrix.");
+                }
+                if(H(i,i)<0)
+                {
+                    H.col(i)*=-1;
+                    W.col(i)*=-1;
+                }
+
+                // reduce the entries to the left of the diagonal
+                for(int j=0;j<i;++j)
+                {
+                    const IntValueType q(floorDivide(H(i,j),H(i,i)));
+                    if(q==0) continue;
+                    H.col(j)-= q*H.col(i);
+                    W.col(j)-= q*W.col(i);
+                }
+            }
+        }
+
+    public:
+
+        /**********************************************************************/
+        HermiteNormalForm(const MatrixNi& A) :
+        /* init */ H(A)
+        /* init */,W(MatrixNi::Identity())
+        {
+            compute();
+        }
+
+        /**********************************************************************/
+        const MatrixNi& matrixH() const
+        {
+            return H;
+        }
+
+        /**********************************************************************/
+        const MatrixNi& matrixW() const
+        {
+            return W;
+        }
+    };
+}
+#endif
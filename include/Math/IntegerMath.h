@@ -13,6 +13,7 @@
 #include <iostream>
 #include <algorithm>
 #include <deque>
+#include <Log.h>
 
 
 
@@ -206,8 +207,7 @@ namespace gbLAB
 
             if (c % g != 0)
             {
-                std::cout << a << "  " << b << "  " << c << "   " << g << std::endl;
-                puts("Impossible");
+                OILAB_LOG(error,math) << a << "  " << b << "  " << c << "   " << g << ": Impossible";
                 exit(0);
             }
 
@@ -276,7 +276,7 @@ namespace gbLAB
             }
             catch(std::runtime_error& e)
             {
-                std::cerr << e.what();
+                OILAB_LOG(error,math) << e.what();
             }
 
             Eigen::Matrix<IntScalarType,Eigen::Dynamic,Eigen::Dynamic> Q=
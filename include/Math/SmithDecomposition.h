@@ -8,7 +8,8 @@
 #define gbLAB_SmithDecomposition_h_
 
 #include <utility>      // std::pair, std::make_pair
-#include <Eigen/Core>
+#include <stdexcept>
+#include <Eigen/Dense>
 
 namespace gbLAB
 {
@@ -309,6 +310,29 @@ namespace gbLAB
             
         }
         
+        /**********************************************************************/
+        /*! Restores a decomposition D=U*A*V computed earlier (e.g. stored in a CslCatalogue),
+         * without running the diagonalization. The inverses X and Y of the unimodular matrices
+         * U and V are recomputed, and the decomposition is verified.
+         */
+        SmithDecomposition(const MatrixNi& A, const MatrixNi& D_in, const MatrixNi& U_in, const MatrixNi& V_in) :
+        /* init */ D(D_in),
+        /* init */ U(U_in),
+        /* init */ V(V_in),
+        /* init */ X(U_in.template cast<double>().inverse().array().round().template cast<IntValueType>()),
+        /* init */ Y(V_in.template cast<double>().inverse().array().round().template cast<IntValueType>())
+        {
+            const IntValueType UAVD((U*A*V-D).squaredNorm());
+            const IntValueType XDYA((X*D*Y-A).squaredNorm());
+            const IntValueType UX((U*X-MatrixNi::Identity()).squaredNorm());
+            const IntValueType VY((V*Y-MatrixNi::Identity()).squaredNorm());
+
+            if (UAVD!=0 || XDYA!=0 || UX!=0 || VY!=0 || !D.isDiagonal())
+            {
+                throw std::runtime_error("The Smith decomposition does not decompose the matrix\n");
+            }
+        }
+
         /**********************************************************************/
         const MatrixNi& matrixU() const
         {
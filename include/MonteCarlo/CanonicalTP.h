@@ -5,8 +5,11 @@
 #ifndef OILAB_CANONICALTP_H
 #define OILAB_CANONICALTP_H
 #include <EvolutionAlgorithm.h>
+#include <StateEnergyStore.h>
+#include <EnergyEvaluator.h>
+#include <Checkpoint.h>
 #include <utility>
-#include <map>
+#include <memory>
 #include <fstream>
 
 namespace gbLAB {
@@ -17,19 +20,47 @@ namespace gbLAB {
         int countTP;
         double currentEnergy, currentDensity;
         std::ofstream output;
-        std::string lmpLocation;
-        std::string potentialName;
     public:
         double temperature;
-        std::map<StateType, double> stateEnergyMap;
+        std::shared_ptr<StateEnergyStore<StateType>> stateEnergyStore;
+        EnergyEvaluator<SystemType> energyEvaluator;
 
         CanonicalTP(const std::string& lmpLocation,
                     const std::string& potentialName,
                     const double& temperature,
                     const std::string& filename="");
+
+        /*!
+         * Constructs a canonical transition probability whose state energies are
+         * cached in (and shared through) \p stateEnergyStore.
+         */
+        CanonicalTP(const std::string& lmpLocation,
+                    const std::string& potentialName,
+                    const double& temperature,
+                    const std::shared_ptr<StateEnergyStore<StateType>>& stateEnergyStore,
+                    const std::string& filename="");
+
+        /*!
+         * Constructs a canonical transition probability whose state energies are
+         * computed by \p energyEvaluator instead of LAMMPS.
+         */
+        CanonicalTP(const EnergyEvaluator<SystemType>& energyEvaluator,
+                    const double& temperature,
+                    const std::shared_ptr<StateEnergyStore<StateType>>& stateEnergyStore,
+                    const std::string& filename="");
         double probability(const std::pair<StateType, SystemType>& proposedState,
                            const std::pair<StateType, SystemType>& currentState) ;
 
+        /*!
+         * Writes the temperature, the engine of the acceptance draws, and the energy of the
+         * current state to \p checkpoint. The state-energy store is included unless it is
+         * backed by a log file, which persists it already.
+         */
+        void save(CheckpointWriter& checkpoint) const;
+
+        //! Restores the data written by save()
+        void restore(CheckpointReader& checkpoint);
+
     };
 
 }
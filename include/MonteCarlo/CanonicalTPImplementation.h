@@ -15,11 +15,34 @@ namespace gbLAB {
             const std::string& potentialName,
             const double& temperature,
             const std::string& filename) :
-                lmpLocation(lmpLocation),
-                potentialName(potentialName),
+                CanonicalTP(lmpLocation,potentialName,temperature,std::make_shared<StateEnergyStore<StateType>>(),filename)
+        {}
+
+    template<typename StateType, typename SystemType>
+    CanonicalTP<StateType,SystemType>::CanonicalTP(
+            const std::string& lmpLocation,
+            const std::string& potentialName,
+            const double& temperature,
+            const std::shared_ptr<StateEnergyStore<StateType>>& stateEnergyStore,
+            const std::string& filename) :
+                CanonicalTP(LammpsEnergyEvaluator<SystemType>{lmpLocation,potentialName},temperature,stateEnergyStore,filename)
+        {}
+
+    template<typename StateType, typename SystemType>
+    CanonicalTP<StateType,SystemType>::CanonicalTP(
+            const EnergyEvaluator<SystemType>& energyEvaluator,
+            const double& temperature,
+            const std::shared_ptr<StateEnergyStore<StateType>>& stateEnergyStore,
+            const std::string& filename) :
+                countTP(0),
                 temperature(temperature),
-                countTP(0)
+                stateEnergyStore(stateEnergyStore),
+                energyEvaluator(energyEvaluator)
         {
+            if (!this->energyEvaluator)
+                throw std::runtime_error("CanonicalTP: null energy evaluator.");
+            if (!this->stateEnergyStore)
+                throw std::runtime_error("CanonicalTP: null state-energy store.");
             if (!filename.empty())
                 output.open(filename);
         }
@@ -34,32 +57,35 @@ namespace gbLAB {
         const auto& proposedState= proposedStateSystem.first;
         const auto& proposedSystem= proposedStateSystem.second;
 
-        if(countTP==0) {
-            const auto &temp = currentSystem.densityEnergy(lmpLocation, potentialName, false);
-            currentDensity = std::get<0>(temp);
-            currentEnergy = std::get<1>(temp);
-            stateEnergyMap[currentState] = currentEnergy;
-            //std::cout << "density = " << currentDensity << ", energy = " << currentEnergy << std::endl;
+        const auto currentCached= stateEnergyStore->find(currentState);
+        if(currentCached) {
+            currentDensity= currentCached->first;
+            currentEnergy= currentCached->second;
         }
         else {
-            assert(stateEnergyMap.find(currentState) != stateEnergyMap.end());
-            currentEnergy= stateEnergyMap[currentState];
+            assert(countTP==0);
+            const auto &temp = energyEvaluator(currentSystem);
+            currentDensity = temp.first;
+            currentEnergy = temp.second;
+            stateEnergyStore->insert(currentState, currentDensity, currentEnergy);
+            //std::cout << "density = " << currentDensity << ", energy = " << currentEnergy << std::endl;
         }
 
         double proposedEnergy, proposedDensity;
 
         //StateType proposedState(proposedStateSystemPair.first);
         //SystemType proposedSystem(proposedStateSystemPair.second);
-        if (stateEnergyMap.find(proposedState) != stateEnergyMap.end()) {
-            proposedEnergy = stateEnergyMap.at(proposedState);
+        const auto proposedCached= stateEnergyStore->find(proposedState);
+        if (proposedCached) {
+            proposedEnergy = proposedCached->second;
         }
         else {
-            const auto& temp= proposedSystem.densityEnergy(lmpLocation, potentialName, false);
-            proposedDensity= std::get<0>(temp);
-            proposedEnergy= std::get<1>(temp);
+            const auto& temp= energyEvaluator(proposedSystem);
+            proposedDensity= temp.first;
+            proposedEnergy= temp.second;
             //proposedEnergy = proposedSystem.energy();
             //std::cout << "density = " << proposedDensity << ", energy = " << proposedEnergy << std::endl;
-            stateEnergyMap[proposedState] = proposedEnergy;
+            stateEnergyStore->insert(proposedState, proposedDensity, proposedEnergy);
         }
 
         countTP++;
@@ -70,5 +96,35 @@ namespace gbLAB {
         return std::min(1.0, exp(-delta / temperature));
     }
 
+    template<typename StateType, typename SystemType>
+    void CanonicalTP<StateType,SystemType>::save(CheckpointWriter& checkpoint) const
+    {
+        checkpoint.section("CanonicalTP");
+        checkpoint.write(countTP);
+        checkpoint.write(currentEnergy);
+        checkpoint.write(currentDensity);
+        checkpoint.write(temperature);
+        checkpoint.write(this->rng.state());
+        const bool includeStore= stateEnergyStore->filename().empty();
+        checkpoint.write(includeStore);
+        if (includeStore)
+            stateEnergyStore->save(checkpoint);
+    }
+
+    template<typename StateType, typename SystemType>
+    void CanonicalTP<StateType,SystemType>::restore(CheckpointReader& checkpoint)
+    {
+        checkpoint.section("CanonicalTP");
+        checkpoint.read(countTP);
+        checkpoint.read(currentEnergy);
+        checkpoint.read(currentDensity);
+        checkpoint.read(temperature);
+        this->rng.setState(checkpoint.read<std::array<std::uint64_t,4>>());
+        if (checkpoint.read<bool>())
+            stateEnergyStore->restore(checkpoint);
+        else
+            stateEnergyStore->refresh();
+    }
+
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,56 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef OILAB_ENERGYEVALUATOR_H
+#define OILAB_ENERGYEVALUATOR_H
+
+#include <functional>
+#include <string>
+#include <tuple>
+#include <utility>
+
+namespace gbLAB {
+    /*!
+     * An energy evaluator maps a system to the pair (density, energy). Transition
+     * probabilities call it for every state that is not yet in their state-energy store.
+     */
+    template<typename SystemType>
+    using EnergyEvaluator= std::function<std::pair<double,double>(const SystemType&)>;
+
+    /*!
+     * The default energy evaluator: relaxes the system with the LAMMPS executable
+     * \p lmpLocation and the interatomic potential \p potentialName.
+     */
+    template<typename SystemType>
+    struct LammpsEnergyEvaluator {
+        std::string lmpLocation;
+        std::string potentialName;
+
+        std::pair<double,double> operator()(const SystemType& system) const
+        {
+            const auto& temp= system.densityEnergy(lmpLocation, potentialName, false);
+            return std::make_pair(std::get<0>(temp), std::get<1>(temp));
+        }
+    };
+
+    /*!
+     * An in-process energy evaluator: the Gaussian-overlap surrogate of the energy
+     * (GbMesoState::surrogateDensityEnergy) with atoms of width \p sigma, or of the
+     * default width if \p sigma is zero. It is cheap enough to pre-screen states
+     * before evaluating them with LammpsEnergyEvaluator.
+     */
+    template<typename SystemType>
+    struct SurrogateEnergyEvaluator {
+        double sigma= 0.0;
+
+        std::pair<double,double> operator()(const SystemType& system) const
+        {
+            const auto& temp= system.surrogateDensityEnergy({}, sigma);
+            return std::make_pair(std::get<0>(temp), std::get<1>(temp));
+        }
+    };
+}
+
+#endif //OILAB_ENERGYEVALUATOR_H
@@ -6,15 +6,24 @@
 #define OILAB_EVOLUTIONALGORITHM_H
 
 #include <utility>
+#include <cstdint>
+#include <randomInteger.h>
 
 namespace gbLAB {
     template<typename StateType, typename SystemType, typename TransitionProbabilityType>
     class EvolutionAlgorithm {
+    protected:
+        // engine for the acceptance draws; seeded from the OS entropy source unless seed() is called
+        mutable RandomEngine rng;
+
     public:
         TransitionProbabilityType& transitionProbability;
 
         EvolutionAlgorithm();
 
+        //! Makes the acceptance draws reproducible: stream \p stream of seed \p seed
+        void seed(const std::uint64_t& seed, const std::uint64_t& stream=0);
+
         bool acceptMove(const std::pair<StateType,SystemType>& proposedStateSystem,
                         const std::pair<StateType,SystemType>& currentStateSystem) const;
     };
@@ -17,12 +17,21 @@ namespace gbLAB {
         transitionProbability(static_cast<TransitionProbabilityType &>(*this))
     { }
 
+    template<typename StateType, typename SystemType, typename TransitionProbabilityType>
+    void EvolutionAlgorithm<StateType, SystemType, TransitionProbabilityType>::seed(const std::uint64_t& seed,
+                                                                                    const std::uint64_t& stream)
+    {
+        rng.seed(seed,stream);
+    }
+
     template<typename StateType, typename SystemType, typename TransitionProbabilityType>
     bool EvolutionAlgorithm<StateType, SystemType, TransitionProbabilityType>::acceptMove(const std::pair<StateType,SystemType>& proposedStateSystem,
                                                                                           const std::pair<StateType,SystemType>& currentStateSystem) const
     {
         double probability = transitionProbability.probability(proposedStateSystem,currentStateSystem);
-        if (random<double>(0.0, 1.0) <= probability)
+        // draw from the transition probability's engine, which is shared by every copy of this base
+        RandomEngine& engine= static_cast<const EvolutionAlgorithm&>(transitionProbability).rng;
+        if (engine.uniform<double>(0.0, 1.0) <= probability)
             return true;
         else
             return false;
@@ -5,7 +5,11 @@
 #ifndef OILAB_LANDAUWANGTP_H
 #define OILAB_LANDAUWANGTP_H
 #include<EvolutionAlgorithm.h>
+#include<StateEnergyStore.h>
+#include<EnergyEvaluator.h>
+#include<Checkpoint.h>
 #include<vector>
+#include<memory>
 #include<Eigen/Eigen>
 #include <fstream>
 
@@ -23,10 +27,7 @@ namespace gbLAB {
         const std::tuple<double,double,int> energyLimits, densityLimits;
         const int numberOfEnergyStates, numberOfDensityStates;
         Eigen::MatrixXi histogram;
-        std::map<StateType, std::pair<double,double>> stateDensityEnergyMap;
         std::ofstream spectrumFile;
-        std::string lmpLocation;
-        std::string potentialName;
 
 
         bool histogramIsFlat(const double& c) const;
@@ -37,12 +38,14 @@ namespace gbLAB {
                                                       const std::tuple<double,double,int>& densityLimits);
         static Eigen::Matrix<bool,Eigen::Dynamic,Eigen::Dynamic> getMask(const int& numberOfEnergyStates,
                                                                          const int& numberOfDensityStates);
-        static std::map<StateType,std::pair<double,double>> getStateDensityEnergyMap();
+        static std::shared_ptr<StateEnergyStore<StateType>> getStateEnergyStore();
         static Eigen::MatrixXd getTheta(const Eigen::Matrix<bool,Eigen::Dynamic,Eigen::Dynamic>& mask, double& f);
 
     public:
         Eigen::Matrix<bool,Eigen::Dynamic,Eigen::Dynamic> mask;
         Eigen::MatrixXd theta;
+        std::shared_ptr<StateEnergyStore<StateType>> stateEnergyStore;
+        EnergyEvaluator<SystemType> energyEvaluator;
 
 
         explicit LandauWangTP(const std::tuple<double,double,int>& energyLimits,
@@ -54,11 +57,40 @@ namespace gbLAB {
                      const std::string& lmpLocation,
                      const std::string& potentialName);
 
+        /*!
+         * Constructs a Landau-Wang transition probability whose state energies are
+         * cached in (and shared through) \p stateEnergyStore.
+         */
+        LandauWangTP(const std::tuple<double,double,int>& energyLimits,
+                     const std::tuple<double,double,int>& densityLimits,
+                     const std::string& lmpLocation,
+                     const std::string& potentialName,
+                     const std::shared_ptr<StateEnergyStore<StateType>>& stateEnergyStore);
+
+        /*!
+         * Constructs a Landau-Wang transition probability whose state energies are
+         * computed by \p energyEvaluator instead of LAMMPS.
+         */
+        LandauWangTP(const std::tuple<double,double,int>& energyLimits,
+                     const std::tuple<double,double,int>& densityLimits,
+                     const EnergyEvaluator<SystemType>& energyEvaluator,
+                     const std::shared_ptr<StateEnergyStore<StateType>>& stateEnergyStore);
+
         double probability(const std::pair<StateType,SystemType>& proposedState,
                            const std::pair<StateType,SystemType>& currentState);
 
         void writeTheta(const std::string& filename) const;
 
+        /*!
+         * Writes the density of states theta, the histogram, the mask, the modification factor,
+         * the engine of the acceptance draws, and the energy of the current state to \p checkpoint.
+         * The state-energy store is included unless it is backed by a log file, which persists it already.
+         */
+        void save(CheckpointWriter& checkpoint) const;
+
+        //! Restores the data written by save(); throws if the energy or density bins differ
+        void restore(CheckpointReader& checkpoint);
+
 
     };
 }
@@ -6,6 +6,7 @@
 #define OILAB_LANDAUWANGTPIMPLEMENTATION_H
 
 #include <iostream>
+#include <Log.h>
 #include <numeric>
 #include <GbMesoState.h>
 #include <iomanip>
@@ -23,7 +24,24 @@ namespace gbLAB {
     LandauWangTP<StateType,SystemType>::LandauWangTP(const std::tuple<double,double,int>& energyLimits,
                                                      const std::tuple<double,double,int>& densityLimits,
                                                      const std::string& lmpLocation,
-                                                     const std::string& potentialName) try:
+                                                     const std::string& potentialName):
+            LandauWangTP(energyLimits,densityLimits,lmpLocation,potentialName,getStateEnergyStore())
+    {}
+
+    template<typename StateType, typename SystemType>
+    LandauWangTP<StateType,SystemType>::LandauWangTP(const std::tuple<double,double,int>& energyLimits,
+                                                     const std::tuple<double,double,int>& densityLimits,
+                                                     const std::string& lmpLocation,
+                                                     const std::string& potentialName,
+                                                     const std::shared_ptr<StateEnergyStore<StateType>>& stateEnergyStore):
+            LandauWangTP(energyLimits,densityLimits,LammpsEnergyEvaluator<SystemType>{lmpLocation,potentialName},stateEnergyStore)
+    {}
+
+    template<typename StateType, typename SystemType>
+    LandauWangTP<StateType,SystemType>::LandauWangTP(const std::tuple<double,double,int>& energyLimits,
+                                                     const std::tuple<double,double,int>& densityLimits,
+                                                     const EnergyEvaluator<SystemType>& energyEvaluator,
+                                                     const std::shared_ptr<StateEnergyStore<StateType>>& stateEnergyStore) try:
             exponentialRegime(true),
             f(exp(1.0)),
             countLW(-1),
@@ -34,18 +52,21 @@ namespace gbLAB {
             numberOfEnergyStates(std::get<2>(energyLimits)),
             numberOfDensityStates(std::get<2>(densityLimits)),
             histogram(Eigen::MatrixXi::Zero(numberOfEnergyStates,numberOfDensityStates)),
-            stateDensityEnergyMap(getStateDensityEnergyMap()),
-            lmpLocation(lmpLocation),
-            potentialName(potentialName),
             mask(getMask(numberOfEnergyStates,numberOfDensityStates)),
-            theta(getTheta(mask,f))
+            theta(getTheta(mask,f)),
+            stateEnergyStore(stateEnergyStore),
+            energyEvaluator(energyEvaluator)
     {
-        std::cout << "Number of the mask-free histogram bins= " << histogram.size()-mask.template cast<int>().sum() << std::endl;
+        if (!this->stateEnergyStore)
+            throw std::runtime_error("LandauWangTP: null state-energy store.");
+        if (!this->energyEvaluator)
+            throw std::runtime_error("LandauWangTP: null energy evaluator.");
+        OILAB_LOG(info,monteCarlo) << "Number of the mask-free histogram bins= " << histogram.size()-mask.template cast<int>().sum();
         spectrumFile.open("energyDensityLW.txt",std::ios_base::app);
     }
     catch(std::runtime_error& e)
     {
-        std::cout << e.what() << std::endl;
+        OILAB_LOG(error,monteCarlo) << e.what();
         exit(0);
     }
     template<typename StateType, typename SystemType>
@@ -53,7 +74,6 @@ namespace gbLAB {
                                                            const std::pair<StateType,SystemType>& currentStateSystem)
     {
         countLW++;
-        std::cout << countLW << ") ";
         const auto& currentState= currentStateSystem.first;
         const auto& currentSystem= currentStateSystem.second;
         const auto& proposedState= proposedStateSystem.first;
@@ -61,36 +81,35 @@ namespace gbLAB {
 
         // Compute current state properties
         // if this is the first call, compute the current energy and density
-        if(countLW==0) {
-            const auto& temp= currentSystem.densityEnergy(lmpLocation, potentialName, false);
-            //currentDensity= temp.first;
-            currentDensity= currentState.density();
-            currentEnergy= std::get<1>(temp);
-            std::cout << currentState;
-            stateDensityEnergyMap[currentState]= std::make_pair(std::get<0>(temp),std::get<1>(temp));
-            spectrumFile << currentDensity << " " << currentEnergy << " " << currentState << std::endl;
+        // The spectrum density is always the state density; the store keeps the energy
+        const auto currentCached= stateEnergyStore->find(currentState);
+        currentDensity= currentState.density();
+        if(currentCached) {
+            currentEnergy= currentCached->second;
         }
         else {
-            assert(stateDensityEnergyMap.find(currentState) != stateDensityEnergyMap.end());
-            currentDensity= stateDensityEnergyMap.at(currentState).first;
-            currentEnergy= stateDensityEnergyMap.at(currentState).second;
+            assert(countLW==0);
+            const auto& temp= energyEvaluator(currentSystem);
+            currentEnergy= temp.second;
+            OILAB_LOG(debug,monteCarlo) << countLW << ") initial state " << currentState;
+            stateEnergyStore->insert(currentState,temp.first,temp.second);
+            spectrumFile << currentDensity << " " << currentEnergy << " " << currentState << std::endl;
         }
 
         // Compute proposed state properties
         double proposedEnergy, proposedDensity;
-        if (stateDensityEnergyMap.find(proposedState) != stateDensityEnergyMap.end()) {
-            std::cout << "found. Proposed state = " << proposedState << std::endl;
-            proposedDensity= stateDensityEnergyMap.at(proposedState).first;
-            proposedEnergy = stateDensityEnergyMap.at(proposedState).second;
-            std::cout << "proposedDensity =  " << proposedDensity << "; proposedEnergy = " << proposedEnergy << std::endl;
+        const auto proposedCached= stateEnergyStore->find(proposedState);
+        proposedDensity= proposedState.density();
+        if (proposedCached) {
+            proposedEnergy = proposedCached->second;
+            OILAB_LOG(debug,monteCarlo) << countLW << ") found. Proposed state = " << proposedState
+                                        << "; proposedDensity =  " << proposedDensity << "; proposedEnergy = " << proposedEnergy;
         }
         else {
-            std::cout << "new" << std::endl;
-            const auto& temp= proposedSystem.densityEnergy(lmpLocation, potentialName, false);
-            //proposedDensity= temp.first;
-            proposedDensity= proposedState.density();
-            proposedEnergy= std::get<1>(temp);
-            stateDensityEnergyMap[proposedState]= std::make_pair(std::get<0>(temp),std::get<1>(temp));
+            OILAB_LOG(debug,monteCarlo) << countLW << ") new. Proposed state = " << proposedState;
+            const auto& temp= energyEvaluator(proposedSystem);
+            proposedEnergy= temp.second;
+            stateEnergyStore->insert(proposedState,temp.first,temp.second);
             spectrumFile << proposedDensity << " " << proposedEnergy << " " << proposedState << std::endl;
         }
 
@@ -117,27 +136,31 @@ namespace gbLAB {
         // output histogram
         //std::cout << "current density = " << currentDensity
         //          << ", energy = " << currentEnergy << std::endl;
-        for(int i=0; i<histogram.rows(); ++i)
+        if(OILAB_LOG_ENABLED(trace,monteCarlo))
         {
-            for(int j=0; j<histogram.cols(); ++j)
+            std::ostringstream message;
+            for(int i=0; i<histogram.rows(); ++i)
             {
-                if(!mask(i,j))
-                    std::cout << histogram(i,j) << " ";
+                for(int j=0; j<histogram.cols(); ++j)
+                {
+                    if(!mask(i,j))
+                        message << histogram(i,j) << " ";
+                }
             }
+            OILAB_LOG(trace,monteCarlo) << "histogram = " << message.str();
         }
-        std::cout << std::endl;
 
         // update f
         if (exponentialRegime) {
             if (histogramIsFlat(0.8)) {
-                std::cout << "Histogram is flat: f = " << f << std::endl;
+                OILAB_LOG(info,monteCarlo) << "Histogram is flat: f = " << f;
                 // reset the histogram
                 histogram.setZero();
                 // exponential regime
                 f = sqrt(f);
             }
             if (f < exp(1.0 / (countLW + 1))) {
-                std::cout << "Beginning non-exponential regime." << std::endl;
+                OILAB_LOG(info,monteCarlo) << "Beginning non-exponential regime.";
                 exponentialRegime = false;
                 // non-exponential regime
                 f = exp(1.0 / (countLW + 1));
@@ -176,7 +199,7 @@ namespace gbLAB {
 
         double nonFlatness= *std::max_element(flatnessMeasure.begin(), flatnessMeasure.end())*size/c;
         //if (*std::max_element(flatnessMeasure.begin(), flatnessMeasure.end()) < c / histogram.size())
-        std::cout << "Flatness measure = " << nonFlatness << std::endl;
+        OILAB_LOG(debug,monteCarlo) << "Flatness measure = " << nonFlatness;
 
         if (nonFlatness<1)
             return true;
@@ -214,7 +237,7 @@ namespace gbLAB {
         file.open("mask.txt");
         std::string line;
         if (!file)
-            std::cout << "File mask.txt not found.";
+            OILAB_LOG(warning,monteCarlo) << "File mask.txt not found.";
         else{
             int i= 0;
             while(std::getline(file,line)) {
@@ -224,44 +247,18 @@ namespace gbLAB {
                 ++i;
             }
         }
-        std::cout << "mask = " << std::endl;
-        std::cout << output << std::endl;
+        OILAB_LOG(debug,monteCarlo) << "mask = \n" << output;
         return output;
     }
 
     template<typename StateType,typename SystemType>
-    std::map<StateType, std::pair<double,double>> LandauWangTP<StateType,SystemType>::getStateDensityEnergyMap()
+    std::shared_ptr<StateEnergyStore<StateType>> LandauWangTP<StateType,SystemType>::getStateEnergyStore()
     {
-        std::map<StateType, std::pair<double,double>> output;
-        std::ifstream file;
-        file.open("energyDensityLW.txt");
-        if (!file)
-            return output;
-
-        double energy, density;
-
-        std::string line;
-        while(std::getline(file,line)) {
-            std::stringstream s(line);
-            s >> density; s >> energy;
-            int temp;
-            std::vector<int> tempVector;
-            while (s >> temp)
-                tempVector.push_back(temp);
-
-            StateType state(tempVector.size());
-            for (int i=0; i<tempVector.size(); ++i)
-                state(i)= tempVector[i];
-
-            output[state]= std::make_pair(density,energy);
-        }
-
-        /*
-        for (const auto& [key,value]: output)
-            std::cout <<  value.first << " " << value.second << " " << key << std::endl;
-         */
-        std::cout << "Number of pre-computed states = " << output.size() << std::endl;
-        file.close();
+        auto output= std::make_shared<StateEnergyStore<StateType>>("energyDensityLW.bin");
+        // seed a fresh binary log with the energies of earlier runs
+        if (output->size()==0)
+            output->importText("energyDensityLW.txt");
+        OILAB_LOG(info,monteCarlo) << "Number of pre-computed states = " << output->size();
         return output;
     }
 
@@ -274,7 +271,7 @@ namespace gbLAB {
         file.open("theta.txt");
         std::string line;
         if (!file) {
-            std::cout << "File theta.txt not found. Setting a uniform distribution for theta";
+            OILAB_LOG(warning,monteCarlo) << "File theta.txt not found. Setting a uniform distribution for theta";
             outputTheta.setOnes();
         }
         else {
@@ -315,13 +312,64 @@ namespace gbLAB {
             }
         }
         outputTheta= outputTheta/outputThetaNorm;
-        std::cout << "f = " << f << std::endl;
-        std::cout << "theta = " << std::endl;
-        std::cout << outputTheta << std::endl;
+        OILAB_LOG(info,monteCarlo) << "f = " << f;
+        OILAB_LOG(debug,monteCarlo) << "theta = \n" << outputTheta;
         return outputTheta;
     }
 
 
+    template<typename StateType,typename SystemType>
+    void LandauWangTP<StateType,SystemType>::save(CheckpointWriter& checkpoint) const
+    {
+        checkpoint.section("LandauWangTP");
+        for (const auto& [lower,upper,bins] : {energyLimits,densityLimits})
+        {
+            checkpoint.write(lower);
+            checkpoint.write(upper);
+            checkpoint.write(bins);
+        }
+        checkpoint.write(exponentialRegime);
+        checkpoint.write(f);
+        checkpoint.write(countLW);
+        checkpoint.write(currentEnergy);
+        checkpoint.write(currentDensity);
+        checkpoint.write(histogram);
+        checkpoint.write(mask);
+        checkpoint.write(theta);
+        checkpoint.write(this->rng.state());
+        const bool includeStore= stateEnergyStore->filename().empty();
+        checkpoint.write(includeStore);
+        if (includeStore)
+            stateEnergyStore->save(checkpoint);
+    }
+
+    template<typename StateType,typename SystemType>
+    void LandauWangTP<StateType,SystemType>::restore(CheckpointReader& checkpoint)
+    {
+        checkpoint.section("LandauWangTP");
+        for (const auto& limits : {energyLimits,densityLimits})
+        {
+            const double lower= checkpoint.read<double>();
+            const double upper= checkpoint.read<double>();
+            const int bins= checkpoint.read<int>();
+            if (std::make_tuple(lower,upper,bins)!=limits)
+                throw std::runtime_error("LandauWangTP: the checkpoint was written with different energy or density limits.");
+        }
+        checkpoint.read(exponentialRegime);
+        checkpoint.read(f);
+        checkpoint.read(countLW);
+        checkpoint.read(currentEnergy);
+        checkpoint.read(currentDensity);
+        checkpoint.read(histogram);
+        checkpoint.read(mask);
+        checkpoint.read(theta);
+        this->rng.setState(checkpoint.read<std::array<std::uint64_t,4>>());
+        if (checkpoint.read<bool>())
+            stateEnergyStore->restore(checkpoint);
+        else
+            stateEnergyStore->refresh();
+    }
+
     template<typename StateType,typename SystemType>
     void LandauWangTP<StateType,SystemType>::writeTheta(const std::string& filename) const
     {
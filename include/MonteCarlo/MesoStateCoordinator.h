@@ -0,0 +1,194 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef OILAB_MESOSTATECOORDINATOR_H
+#define OILAB_MESOSTATECOORDINATOR_H
+
+#include <chrono>
+#include <deque>
+#include <set>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <Eigen/Dense>
+#include <OrderedTuplet.h>
+#include <WorkerProtocol.h>
+
+namespace gbLAB {
+
+    /*!
+     * \brief Everything a worker needs to rebuild a GbMesoStateEnsemble<3> and evaluate the energies of its mesostates.
+     *
+     * The bicrystal is made of the lattices \p latticeBasis rotated by \p rotationA and \p rotationB; the GB normal,
+     * the tilt axis and the CSL vectors of the ensemble are given in Cartesian coordinates. Energies are evaluated
+     * with LammpsEnergyEvaluator{\p lmpLocation, \p potentialName}.
+     */
+    struct MesoStateWorkerSetup
+    {
+        Eigen::Matrix3d latticeBasis;
+        Eigen::Matrix3d rotationA;
+        Eigen::Matrix3d rotationB;
+        bool useRLLL= false;
+        Eigen::Vector3d gbNormal;
+        Eigen::Vector3d axis;
+        //! The columns are the CSL vectors of the ensemble
+        Eigen::Matrix3d cslVectors;
+        double bhalfMax= 1.0;
+        double lambda= 0.0;
+        double mu= 0.0;
+        std::string lmpLocation;
+        std::string potentialName;
+
+        void write(BinaryWriter& writer) const
+        {
+            writer.write(latticeBasis);
+            writer.write(rotationA);
+            writer.write(rotationB);
+            writer.write(useRLLL);
+            writer.write(gbNormal);
+            writer.write(axis);
+            writer.write(cslVectors);
+            writer.write(bhalfMax);
+            writer.write(lambda);
+            writer.write(mu);
+            writer.write(lmpLocation);
+            writer.write(potentialName);
+        }
+
+        void read(BinaryReader& reader)
+        {
+            reader.read(latticeBasis);
+            reader.read(rotationA);
+            reader.read(rotationB);
+            reader.read(useRLLL);
+            reader.read(gbNormal);
+            reader.read(axis);
+            reader.read(cslVectors);
+            reader.read(bhalfMax);
+            reader.read(lambda);
+            reader.read(mu);
+            reader.read(lmpLocation);
+            reader.read(potentialName);
+        }
+    };
+
+    //! The outcome of the evaluation of one state
+    struct MesoStateWorkResult
+    {
+        bool success= false;
+        double density= 0.0;
+        double energy= 0.0;
+        //! Why the evaluation failed
+        std::string message;
+    };
+
+    /*!
+     * \brief Distributes the construction and energy evaluation of mesostates over worker processes.
+     *
+     * The coordinator listens on a Unix domain socket, to which workers (oilab-worker) connect;
+     * the constructor spawns the local ones. evaluate() splits the states into shards of
+     * Options::shardSize consecutive states, sends each shard to an idle worker, and returns the
+     * results in the order of the states, independently of which worker evaluated which shard.
+     *
+     * A worker that closes its connection (e.g. because it crashed) or exceeds Options::timeout
+     * is dropped, and its shard is resubmitted to another worker, at most Options::maxRetries times;
+     * after that the states of the shard are reported as failed. Dead local workers are replaced,
+     * at most Options::maxRespawns times.
+     *
+     * Workers only need to reach the socket, so workers started by other means (e.g. on other
+     * machines, through a forwarded socket) are accepted as well. The process id a worker reports
+     * is not trusted: a worker counts as local only if the operating system reports a spawned
+     * child as the peer of its connection (SO_PEERCRED, LOCAL_PEERPID), and only local workers
+     * are ever killed.
+     */
+    class MesoStateCoordinator
+    {
+    public:
+        struct Options
+        {
+            //! Number of workers spawned on this machine
+            int numberOfWorkers= 1;
+            std::string workerExecutable= "oilab-worker";
+            //! Path of the listening socket; defaults to oilab-<pid>.sock in the working directory
+            std::string socketPath;
+            //! Number of consecutive states sent to a worker at once
+            int shardSize= 1;
+            //! Number of times a shard is resubmitted after its worker died
+            int maxRetries= 2;
+            //! Number of replacements of dead local workers
+            int maxRespawns= 4;
+            //! Seconds a worker may spend on a shard before it is considered dead; zero disables the limit
+            double timeout= 0.0;
+            //! Seconds the constructor waits for the local workers to become ready
+            double startupTimeout= 60.0;
+        };
+
+    private:
+        struct Worker
+        {
+            int fd;
+            //! Process id reported by the worker, for messages only
+            pid_t pid;
+            //! Process id of the peer of the socket as reported by the operating system, if available
+            std::optional<pid_t> peerPid;
+            //! Whether the worker is a process spawned by this coordinator; only those are killed and replaced
+            bool local;
+            bool ready;
+            //! Index and task id of the shard in progress
+            std::optional<size_t> shard;
+            std::uint64_t taskId;
+            std::chrono::steady_clock::time_point shardStart;
+        };
+
+        struct Shard
+        {
+            size_t begin, end;
+            int attempts;
+        };
+
+        const MesoStateWorkerSetup setup;
+        const Options options;
+        int listener;
+        std::vector<Worker> workers;
+        std::set<pid_t> localProcesses;
+        int respawns;
+        std::optional<size_t> numberOfBShiftPairs;
+        std::uint64_t nextTaskId;
+
+        // state of the evaluation in progress
+        const std::vector<XTuplet>* states;
+        std::vector<Shard> shards;
+        std::deque<size_t> queue;
+        std::vector<MesoStateWorkResult>* results;
+        size_t pendingShards;
+
+        void shutdown();
+        void spawn();
+        void accept();
+        void drop(const size_t& w, const std::string& reason);
+        void receive(const size_t& w);
+        void dispatch();
+        void processEvents(const int& timeoutMilliseconds);
+        int numberOfReadyWorkers() const;
+
+    public:
+        MesoStateCoordinator(const MesoStateWorkerSetup& setup, const Options& options);
+        ~MesoStateCoordinator();
+        MesoStateCoordinator(const MesoStateCoordinator&) = delete;
+        MesoStateCoordinator& operator=(const MesoStateCoordinator&) = delete;
+
+        //! Evaluates \p states on the workers; the i-th result belongs to the i-th state
+        std::vector<MesoStateWorkResult> evaluate(const std::vector<XTuplet>& states);
+
+        //! Number of connected workers that have built the ensemble
+        int numberOfWorkers() const;
+
+        //! Process ids of the live local workers
+        std::vector<pid_t> workerProcesses() const;
+    };
+}
+#include <MesoStateCoordinatorImplementation.h>
+#endif //OILAB_MESOSTATECOORDINATOR_H
@@ -0,0 +1,407 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef OILAB_MESOSTATECOORDINATORIMPLEMENTATION_H
+#define OILAB_MESOSTATECOORDINATORIMPLEMENTATION_H
+
+#include <algorithm>
+#include <csignal>
+#include <cstring>
+#include <thread>
+#include <Log.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+namespace gbLAB {
+
+    namespace MesoStateCoordinatorDetail
+    {
+        //! Process id of the peer of the Unix domain socket \p fd, where the operating system reports it
+        inline std::optional<pid_t> peerProcess(const int& fd)
+        {
+#if defined(SO_PEERCRED)
+            ucred credentials;
+            socklen_t length= sizeof(credentials);
+            if (::getsockopt(fd,SOL_SOCKET,SO_PEERCRED,&credentials,&length)==0)
+                return credentials.pid;
+#elif defined(LOCAL_PEERPID)
+            pid_t pid;
+            socklen_t length= sizeof(pid);
+            if (::getsockopt(fd,SOL_LOCAL,LOCAL_PEERPID,&pid,&length)==0)
+                return pid;
+#endif
+            return std::nullopt;
+        }
+    }
+
+    inline MesoStateCoordinator::MesoStateCoordinator(const MesoStateWorkerSetup& setup, const Options& options_in) :
+    /* init */ setup(setup),
+    /* init */ options([&options_in]()
+                       {
+                           Options temp(options_in);
+                           if (temp.socketPath.empty())
+                               temp.socketPath= "oilab-"+std::to_string(::getpid())+".sock";
+                           return temp;
+                       }()),
+    /* init */ listener(-1),
+    /* init */ respawns(0),
+    /* init */ nextTaskId(0),
+    /* init */ states(nullptr),
+    /* init */ results(nullptr),
+    /* init */ pendingShards(0)
+    {
+        if (options.shardSize<1)
+            throw std::runtime_error("MesoStateCoordinator: the shard size has to be positive.");
+        sockaddr_un address;
+        std::memset(&address,0,sizeof(address));
+        address.sun_family= AF_UNIX;
+        if (options.socketPath.size()>=sizeof(address.sun_path))
+            throw std::runtime_error("MesoStateCoordinator: the socket path "+options.socketPath+" is too long.");
+        std::strncpy(address.sun_path,options.socketPath.c_str(),sizeof(address.sun_path)-1);
+
+        listener= ::socket(AF_UNIX,SOCK_STREAM,0);
+        if (listener<0)
+            throw std::runtime_error("MesoStateCoordinator: cannot create a socket.");
+        ::unlink(options.socketPath.c_str());
+        if (::bind(listener,reinterpret_cast<const sockaddr*>(&address),sizeof(address))!=0 || ::listen(listener,SOMAXCONN)!=0)
+        {
+            ::close(listener);
+            throw std::runtime_error("MesoStateCoordinator: cannot listen on "+options.socketPath+".");
+        }
+
+        for (int i=0; i<options.numberOfWorkers; ++i)
+            spawn();
+
+        const auto deadline= std::chrono::steady_clock::now()+std::chrono::duration<double>(options.startupTimeout);
+        while (numberOfReadyWorkers()<options.numberOfWorkers && std::chrono::steady_clock::now()<deadline &&
+               !(workers.empty() && localProcesses.empty()))
+            processEvents(100);
+
+        if (numberOfReadyWorkers()==0 && options.numberOfWorkers>0)
+        {
+            shutdown();
+            throw std::runtime_error("MesoStateCoordinator: none of the workers started.");
+        }
+        if (numberOfReadyWorkers()<options.numberOfWorkers)
+            OILAB_LOG(warning,monteCarlo) << "MesoStateCoordinator: only " << numberOfReadyWorkers() << " of "
+                                          << options.numberOfWorkers << " workers started";
+        OILAB_LOG(info,monteCarlo) << "MesoStateCoordinator: " << numberOfReadyWorkers() << " workers ready on " << options.socketPath;
+    }
+
+    inline MesoStateCoordinator::~MesoStateCoordinator()
+    {
+        shutdown();
+    }
+
+    inline void MesoStateCoordinator::shutdown()
+    {
+        for (auto& worker : workers)
+        {
+            try
+            {
+                WorkerProtocol::send(worker.fd,WorkerProtocol::MessageType::shutdown);
+            }
+            catch (std::runtime_error&) {}
+            ::close(worker.fd);
+        }
+        workers.clear();
+
+        // give the local workers some time to exit, then kill them
+        const auto deadline= std::chrono::steady_clock::now()+std::chrono::seconds(5);
+        while (!localProcesses.empty())
+        {
+            for (auto it= localProcesses.begin(); it!=localProcesses.end(); )
+            {
+                if (std::chrono::steady_clock::now()>deadline)
+                    ::kill(*it,SIGKILL);
+                if (::waitpid(*it,nullptr,WNOHANG)!=0)
+                    it= localProcesses.erase(it);
+                else
+                    ++it;
+            }
+            if (!localProcesses.empty())
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        if (listener>=0)
+        {
+            ::close(listener);
+            ::unlink(options.socketPath.c_str());
+            listener= -1;
+        }
+    }
+
+    inline void MesoStateCoordinator::spawn()
+    {
+        const pid_t pid= ::fork();
+        if (pid<0)
+            throw std::runtime_error("MesoStateCoordinator: cannot fork a worker.");
+        if (pid==0)
+        {
+            ::execl(options.workerExecutable.c_str(),options.workerExecutable.c_str(),
+                    "--socket",options.socketPath.c_str(),static_cast<char*>(nullptr));
+            ::_exit(127);
+        }
+        localProcesses.insert(pid);
+        OILAB_LOG(debug,monteCarlo) << "MesoStateCoordinator: spawned worker " << pid;
+    }
+
+    inline void MesoStateCoordinator::accept()
+    {
+        const int fd= ::accept(listener,nullptr,nullptr);
+        if (fd<0)
+            return;
+        WorkerProtocol::disableSigPipe(fd);
+        workers.push_back(Worker{fd,0,MesoStateCoordinatorDetail::peerProcess(fd),false,false,std::nullopt,0,std::chrono::steady_clock::now()});
+    }
+
+    inline void MesoStateCoordinator::drop(const size_t& w, const std::string& reason)
+    {
+        Worker worker(workers[w]);
+        workers.erase(workers.begin()+w);
+        ::close(worker.fd);
+        OILAB_LOG(warning,monteCarlo) << "MesoStateCoordinator: dropping worker " << worker.pid << ": " << reason;
+
+        const bool local= worker.local;
+        if (local)
+        {
+            ::kill(worker.pid,SIGKILL);
+            ::waitpid(worker.pid,nullptr,0);
+            localProcesses.erase(worker.pid);
+        }
+
+        if (worker.shard)
+        {
+            Shard& shard(shards[*worker.shard]);
+            if (++shard.attempts>options.maxRetries)
+            {
+                for (size_t i=shard.begin; i<shard.end; ++i)
+                    (*results)[i]= MesoStateWorkResult{false,0.0,0.0,"worker lost ("+reason+")"};
+                --pendingShards;
+            }
+            else
+                queue.push_front(*worker.shard);
+        }
+
+        // a worker that failed to build the ensemble would fail again
+        if (local && worker.ready && respawns<options.maxRespawns)
+        {
+            ++respawns;
+            spawn();
+        }
+    }
+
+    inline void MesoStateCoordinator::receive(const size_t& w)
+    {
+        using namespace WorkerProtocol;
+        Worker& worker(workers[w]);
+        MessageType type;
+        BinaryReader payload;
+        try
+        {
+            if (!WorkerProtocol::receive(worker.fd,type,payload))
+            {
+                drop(w,"connection closed");
+                return;
+            }
+
+            switch (type)
+            {
+                case MessageType::hello:
+                {
+                    const auto version= payload.read<std::uint32_t>();
+                    worker.pid= static_cast<pid_t>(payload.read<std::int64_t>());
+                    // a child counts as local only through the kernel's account of the peer, and only once
+                    worker.local= worker.peerPid && *worker.peerPid==worker.pid && localProcesses.count(worker.pid) &&
+                                  std::none_of(workers.begin(),workers.end(),[&worker](const Worker& other)
+                                               { return &other!=&worker && other.local && other.pid==worker.pid; });
+                    if (version!=WorkerProtocol::version)
+                    {
+                        drop(w,"unsupported protocol version "+std::to_string(version));
+                        return;
+                    }
+                    BinaryWriter message;
+                    setup.write(message);
+                    WorkerProtocol::send(worker.fd,MessageType::setup,message);
+                    break;
+                }
+                case MessageType::ready:
+                {
+                    const size_t n= payload.read<std::uint64_t>();
+                    if (numberOfBShiftPairs && *numberOfBShiftPairs!=n)
+                    {
+                        drop(w,"the worker built a different ensemble");
+                        return;
+                    }
+                    numberOfBShiftPairs= n;
+                    worker.ready= true;
+                    OILAB_LOG(debug,monteCarlo) << "MesoStateCoordinator: worker " << worker.pid << " ready";
+                    break;
+                }
+                case MessageType::failure:
+                    drop(w,payload.read<std::string>());
+                    return;
+                case MessageType::result:
+                {
+                    const auto taskId= payload.read<std::uint64_t>();
+                    const auto n= payload.read<std::uint64_t>();
+                    if (!worker.shard || taskId!=worker.taskId)
+                    {
+                        drop(w,"unexpected result");
+                        return;
+                    }
+                    const Shard& shard(shards[*worker.shard]);
+                    if (n!=shard.end-shard.begin)
+                    {
+                        drop(w,"incomplete result");
+                        return;
+                    }
+                    std::vector<MesoStateWorkResult> shardResults(n);
+                    for (auto& result : shardResults)
+                    {
+                        payload.read(result.success);
+                        payload.read(result.density);
+                        payload.read(result.energy);
+                        payload.read(result.message);
+                    }
+                    std::copy(shardResults.begin(),shardResults.end(),results->begin()+shard.begin);
+                    --pendingShards;
+                    worker.shard.reset();
+                    break;
+                }
+                default:
+                    drop(w,"unexpected message");
+                    return;
+            }
+        }
+        catch (std::runtime_error& e)
+        {
+            drop(w,e.what());
+        }
+    }
+
+    inline void MesoStateCoordinator::dispatch()
+    {
+        for (size_t w=workers.size(); w-->0; )
+        {
+            if (queue.empty())
+                return;
+            Worker& worker(workers[w]);
+            if (!worker.ready || worker.shard)
+                continue;
+            const size_t s= queue.front();
+            queue.pop_front();
+            worker.shard= s;
+            worker.shardStart= std::chrono::steady_clock::now();
+            worker.taskId= nextTaskId++;
+
+            BinaryWriter message;
+            message.write(worker.taskId);
+            message.write(static_cast<std::uint64_t>(shards[s].end-shards[s].begin));
+            for (size_t i=shards[s].begin; i<shards[s].end; ++i)
+                message.write((*states)[i]);
+            try
+            {
+                WorkerProtocol::send(worker.fd,WorkerProtocol::MessageType::task,message);
+            }
+            catch (std::runtime_error& e)
+            {
+                drop(w,e.what());
+            }
+        }
+    }
+
+    inline void MesoStateCoordinator::processEvents(const int& timeoutMilliseconds)
+    {
+        std::vector<pollfd> fds(1,pollfd{listener,POLLIN,0});
+        for (const auto& worker : workers)
+            fds.push_back(pollfd{worker.fd,POLLIN,0});
+        if (::poll(fds.data(),fds.size(),timeoutMilliseconds)<0 && errno!=EINTR)
+            throw std::runtime_error("MesoStateCoordinator: poll failed.");
+
+        // from the back, so that dropping a worker does not shift the workers still to be visited
+        for (size_t w=workers.size(); w-->0; )
+            if (fds[w+1].revents & (POLLIN | POLLHUP | POLLERR))
+                receive(w);
+        if (fds[0].revents & POLLIN)
+            accept();
+
+        if (options.timeout>0.0)
+        {
+            const auto now= std::chrono::steady_clock::now();
+            for (size_t w=workers.size(); w-->0; )
+                if (workers[w].shard && std::chrono::duration<double>(now-workers[w].shardStart).count()>options.timeout)
+                    drop(w,"timeout");
+        }
+
+        // local workers that exited without connecting
+        for (auto it= localProcesses.begin(); it!=localProcesses.end(); )
+        {
+            const pid_t pid= *it;
+            const bool connected= std::any_of(workers.begin(),workers.end(),[pid](const Worker& worker){ return worker.local && worker.pid==pid; });
+            if (!connected && ::waitpid(pid,nullptr,WNOHANG)==pid)
+            {
+                OILAB_LOG(warning,monteCarlo) << "MesoStateCoordinator: worker " << pid << " exited before connecting";
+                it= localProcesses.erase(it);
+            }
+            else
+                ++it;
+        }
+    }
+
+    inline std::vector<MesoStateWorkResult> MesoStateCoordinator::evaluate(const std::vector<XTuplet>& states_in)
+    {
+        std::vector<MesoStateWorkResult> output(states_in.size());
+        if (states_in.empty())
+            return output;
+        for (const auto& state : states_in)
+            if (numberOfBShiftPairs && static_cast<size_t>(state.size())!=*numberOfBShiftPairs)
+                throw std::runtime_error("MesoStateCoordinator: the size of a state differs from the number of (b,s) pairs of the ensemble.");
+
+        states= &states_in;
+        results= &output;
+        shards.clear();
+        queue.clear();
+        for (size_t begin=0; begin<states_in.size(); begin+= options.shardSize)
+        {
+            queue.push_back(shards.size());
+            shards.push_back(Shard{begin,std::min(begin+options.shardSize,states_in.size()),0});
+        }
+        pendingShards= shards.size();
+
+        while (pendingShards>0)
+        {
+            dispatch();
+            if (workers.empty() && localProcesses.empty())
+            {
+                states= nullptr;
+                results= nullptr;
+                throw std::runtime_error("MesoStateCoordinator: no workers left.");
+            }
+            processEvents(100);
+        }
+        states= nullptr;
+        results= nullptr;
+        return output;
+    }
+
+    inline int MesoStateCoordinator::numberOfReadyWorkers() const
+    {
+        return std::count_if(workers.begin(),workers.end(),[](const Worker& worker){ return worker.ready; });
+    }
+
+    inline int MesoStateCoordinator::numberOfWorkers() const
+    {
+        return numberOfReadyWorkers();
+    }
+
+    inline std::vector<pid_t> MesoStateCoordinator::workerProcesses() const
+    {
+        return std::vector<pid_t>(localProcesses.begin(),localProcesses.end());
+    }
+}
+#endif //OILAB_MESOSTATECOORDINATORIMPLEMENTATION_H
@@ -9,23 +9,119 @@
 #include <map>
 #include <Eigen/Eigen>
 #include <randomInteger.h>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
 #include <EvolutionAlgorithm.h>
+#include <Checkpoint.h>
+#include <ThreadPool.h>
 
 namespace gbLAB {
     template<typename StateType, typename SystemType, typename EnsembleType, typename EvolveType>
     class MonteCarlo : public EvolutionAlgorithm<StateType, SystemType, EvolveType> {
+        using StateSystemType= std::pair<StateType,SystemType>;
+        using DensityEnergyType= std::pair<double,double>;
+
+        //! A speculative proposal: a draw from the current state, and its mesostate and energy computed ahead of time
+        struct Speculation
+        {
+            //! The mesostate, or null if the drawn state does not define one
+            std::shared_ptr<const StateSystemType> stateSystem;
+            //! The energy, if the state was not in the state-energy store when the proposal was built
+            std::shared_future<std::optional<DensityEnergyType>> densityEnergy;
+        };
+
+        struct Proposal
+        {
+            StateType state;
+            //! Engine of the proposals after drawing this one
+            std::array<std::uint64_t,4> engineState;
+            std::shared_ptr<std::atomic<bool>> discarded;
+            std::shared_future<Speculation> speculation;
+        };
+
+        std::string checkpointFilename;
+        int checkpointSteps;
+        double checkpointSeconds;
+        std::shared_ptr<ThreadPool> constructionPool, evaluationPool;
+        int pipelineDepth;
+
+        void checkpointIfDue(std::chrono::steady_clock::time_point& lastCheckpoint);
+        void evolveSerial(const int& maxIterations);
+        //! Reproducible only with GbContinuumSolverPolicy::warmStart off when the iterative solver is used (see pipeline())
+        void evolvePipelined(const int& maxIterations);
+
     public:
 
         StateType currentState;
 
+        //! Number of steps taken by evolve() since construction (or since the restored checkpoint was started)
+        std::uint64_t step;
+
         const EnsembleType& ensemble;
 
         MonteCarlo(const EnsembleType& ensemble, const EvolveType &evolve);
 
         MonteCarlo(const EnsembleType& ensemble, const EvolveType &evolve, const StateType& state);
 
+        /*!
+         * Constructs a reproducible walker: proposals (including the initial random
+         * state) and acceptance draws come from streams \f$2s\f$ and \f$2s+1\f$ of
+         * \p seed, where \f$s\f$=\p stream. Walkers with distinct streams are independent.
+         */
+        MonteCarlo(const EnsembleType& ensemble, const EvolveType &evolve, const std::uint64_t& seed, const std::uint64_t& stream);
+
+        //! Reseeds the proposal engine of this walker and the acceptance engine of its transition probability
+        void seed(const std::uint64_t& seed, const std::uint64_t& stream=0);
+
+        //! Takes \p maxIterations Monte Carlo steps, serially or through the pipeline set up by pipeline()
         void evolve(const int &maxIterations);
+
+        /*!
+         * \brief Overlaps the construction and the energy evaluation of proposals with the acceptance steps.
+         *
+         * evolve() draws up to \p depth proposals from the current state ahead of time, assuming that
+         * they will be rejected, constructs their mesostates on \p constructionThreads threads, and
+         * evaluates the energies of states missing from the state-energy store on \p evaluationThreads
+         * other threads. The proposals are accepted or rejected in order on the calling thread, and
+         * those drawn after an accepted proposal are discarded; energies that were already computed
+         * for them are reused if the states are proposed again during the same evolve() call.
+         *
+         * For a fixed seed, the chain, the state-energy store and the checkpoints are identical to those
+         * of the serial evolve(), provided that the energy evaluator is deterministic. The evaluator
+         * is called concurrently, and has to be thread-safe. A \p depth of zero restores the serial evolve().
+         *
+         * Mesostates built with the iterative GbContinuum solver depend on the thread-local warm start of
+         * the pool thread that constructs them, and that assignment varies from run to run. Pipelined runs
+         * are therefore reproducible only with GbContinuumSolverPolicy::warmStart off (or the dense solver).
+         */
+        void pipeline(const int& constructionThreads, const int& evaluationThreads, const int& depth);
+
+        /*!
+         * Atomically writes a checkpoint of the walker to \p filename: the step count, the current
+         * state, the engine of the proposals, and the transition probability (see CanonicalTP::save
+         * and LandauWangTP::save).
+         */
+        void save(const std::string& filename) const;
+
+        /*!
+         * Restores a checkpoint written by save() into this walker and its transition probability,
+         * which must have been constructed for the same ensemble. The restored run continues
+         * bit-identically provided that the energies of new states are reproducible (e.g. with
+         * GbContinuumSolverPolicy::warmStart off if the iterative solver is used).
+         */
+        void restore(const std::string& filename);
+
+        /*!
+         * Makes evolve() call save(\p filename) every \p everySteps steps and, if \p everySeconds
+         * is positive, whenever \p everySeconds have passed since the last checkpoint.
+         * An empty filename turns checkpointing off.
+         */
+        void checkpoint(const std::string& filename, const int& everySteps, const double& everySeconds=0.0);
     };
 
 
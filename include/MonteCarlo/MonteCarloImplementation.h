@@ -4,6 +4,9 @@
 #ifndef OILAB_MONTECARLOIMPLEMENTATION_H
 #define OILAB_MONTECARLOIMPLEMENTATION_H
 
+#include <algorithm>
+#include <deque>
+#include <mutex>
 #include <OrderedTuplet.h>
 #include <GbMesoStateEnsemble.h>
 #include <LandauWangTP.h>
@@ -14,23 +17,90 @@ namespace gbLAB {
     MonteCarlo<StateType,SystemType,EnsembleType,EvolveType>::
         MonteCarlo(const EnsembleType& ensemble,
                    const EvolveType& evolve) : EvolutionAlgorithm<StateType,SystemType,EvolveType>(evolve),
+                                               checkpointSteps(0),
+                                               checkpointSeconds(0.0),
+                                              pipelineDepth(0),
                                                ensemble(ensemble),
-                                               currentState(ensemble.sampleNewState(ensemble.initializeState(), true))
-        {}
+                                               currentState(ensemble.initializeState()),
+                                               step(0)
+        {
+            // the base is copied from evolve, so give the proposals an engine of their own
+            this->rng= RandomEngine();
+            ScopedRandomEngine scope(this->rng);
+            currentState= ensemble.sampleNewState(currentState, true);
+        }
+
+    template<typename StateType, typename SystemType, typename EnsembleType, typename EvolveType>
+    MonteCarlo<StateType,SystemType,EnsembleType,EvolveType>::
+    MonteCarlo(const EnsembleType& ensemble,
+               const EvolveType& evolve,
+               const std::uint64_t& seed,
+               const std::uint64_t& stream) : EvolutionAlgorithm<StateType,SystemType,EvolveType>(evolve),
+                                              checkpointSteps(0),
+                                              checkpointSeconds(0.0),
+                                              pipelineDepth(0),
+                                              ensemble(ensemble),
+                                              currentState(ensemble.initializeState()),
+                                              step(0)
+    {
+        this->seed(seed,stream);
+        ScopedRandomEngine scope(this->rng);
+        currentState= ensemble.sampleNewState(currentState, true);
+    }
+
     template<typename StateType, typename SystemType, typename EnsembleType, typename EvolveType>
     MonteCarlo<StateType,SystemType,EnsembleType,EvolveType>::
     MonteCarlo(const EnsembleType& ensemble,
                const EvolveType& evolve,
                const StateType& state) : EvolutionAlgorithm<StateType,SystemType,EvolveType>(evolve),
+                                         checkpointSteps(0),
+                                         checkpointSeconds(0.0),
+                                              pipelineDepth(0),
                                          ensemble(ensemble),
                                          //currentState(ensemble.sampleNewState(state, false))
-                                         currentState(state)
-    {}
+                                         currentState(state),
+                                         step(0)
+    {
+        this->rng= RandomEngine();
+    }
+
+    template<typename StateType, typename SystemType, typename EnsembleType, typename EvolveType>
+    void MonteCarlo<StateType,SystemType,EnsembleType,EvolveType>::seed(const std::uint64_t& seed, const std::uint64_t& stream)
+    {
+        this->rng.seed(seed,2*stream);
+        this->transitionProbability.seed(seed,2*stream+1);
+    }
 
     template<typename StateType, typename SystemType, typename EnsembleType, typename EvolveType>
     void MonteCarlo<StateType,SystemType,EnsembleType,EvolveType>::evolve(const int& maxIterations)
+    {
+        if (pipelineDepth>0)
+            evolvePipelined(maxIterations);
+        else
+            evolveSerial(maxIterations);
+    }
+
+    template<typename StateType, typename SystemType, typename EnsembleType, typename EvolveType>
+    void MonteCarlo<StateType,SystemType,EnsembleType,EvolveType>::checkpointIfDue(std::chrono::steady_clock::time_point& lastCheckpoint)
+    {
+        if (checkpointFilename.empty())
+            return;
+        const auto now= std::chrono::steady_clock::now();
+        if ((checkpointSteps>0 && step%checkpointSteps==0) ||
+            (checkpointSeconds>0.0 && std::chrono::duration<double>(now-lastCheckpoint).count()>=checkpointSeconds))
+        {
+            save(checkpointFilename);
+            lastCheckpoint= now;
+        }
+    }
+
+    template<typename StateType, typename SystemType, typename EnsembleType, typename EvolveType>
+    void MonteCarlo<StateType,SystemType,EnsembleType,EvolveType>::evolveSerial(const int& maxIterations)
     {
         int acceptCount = 0;
+        // proposals drawn by the ensemble come from this walker's stream
+        ScopedRandomEngine scope(this->rng);
+        auto lastCheckpoint= std::chrono::steady_clock::now();
 
         for (int i = 0; i < maxIterations; ++i) {
             auto proposedState= ensemble.sampleNewState(currentState, false);
@@ -41,8 +111,231 @@ namespace gbLAB {
                 currentState = proposedState;
                 acceptCount++;
             }
+            ++step;
+            checkpointIfDue(lastCheckpoint);
         }
     }
 
+    template<typename StateType, typename SystemType, typename EnsembleType, typename EvolveType>
+    void MonteCarlo<StateType,SystemType,EnsembleType,EvolveType>::evolvePipelined(const int& maxIterations)
+    {
+        auto& tp(this->transitionProbability);
+        const EnergyEvaluator<SystemType> evaluator(tp.energyEvaluator);
+        const auto store(tp.stateEnergyStore);
+
+        // energies of speculative proposals, shared by proposals of the same state
+        std::mutex energiesMutex;
+        std::map<StateType,std::shared_future<std::optional<DensityEnergyType>>> energies;
+        std::deque<Proposal> proposals;
+        std::vector<std::shared_future<Speculation>> pending;
+
+        // the transition probability takes the energy of the proposed state from its speculation, if there is one
+        const SystemType* prefetchedSystem= nullptr;
+        std::optional<DensityEnergyType> prefetchedEnergy;
+        tp.energyEvaluator= [&](const SystemType& system)
+        {
+            if (&system==prefetchedSystem && prefetchedEnergy)
+                return *prefetchedEnergy;
+            return evaluator(system);
+        };
+
+        // on exit, discard the speculations in flight, wait for the tasks referring to the locals above, and restore the evaluator
+        struct Cleanup
+        {
+            std::function<void()> function;
+            ~Cleanup() { function(); }
+        } cleanup{[&]()
+        {
+            for (auto& proposal : proposals)
+                proposal.discarded->store(true);
+            std::vector<std::shared_future<std::optional<DensityEnergyType>>> evaluations;
+            for (auto& speculation : pending)
+            {
+                speculation.wait();
+                try { evaluations.push_back(speculation.get().densityEnergy); }
+                catch (...) {}
+            }
+            for (auto& evaluation : evaluations)
+                if (evaluation.valid())
+                    evaluation.wait();
+            tp.energyEvaluator= evaluator;
+        }};
+
+        auto speculate= [&, this](const StateType& state, const std::shared_ptr<std::atomic<bool>>& discarded)
+        {
+            Speculation output;
+            if (discarded->load())
+                return output;
+            try
+            {
+                output.stateSystem= std::make_shared<const StateSystemType>(state,ensemble.constructMesoState(state));
+            }
+            catch (std::runtime_error& e)
+            {
+                // not a mesostate: the serial chain would draw again, which is the next proposal
+                return output;
+            }
+            if (store->find(state))
+                return output;
+
+            std::lock_guard<std::mutex> guard(energiesMutex);
+            auto cached= energies.find(state);
+            if (cached!=energies.end() &&
+                (cached->second.wait_for(std::chrono::seconds(0))!=std::future_status::ready || cached->second.get()))
+            {
+                OILAB_PROFILE_COUNT("MonteCarlo::evolve reused energies",1);
+                output.densityEnergy= cached->second;
+                return output;
+            }
+            const auto stateSystem(output.stateSystem);
+            output.densityEnergy= evaluationPool->submit([stateSystem,discarded,&evaluator]() -> std::optional<DensityEnergyType>
+            {
+                if (discarded->load())
+                    return std::nullopt;
+                OILAB_PROFILE_SCOPE("MonteCarlo::evolve speculative evaluation");
+                return evaluator(stateSystem->second);
+            }).share();
+            energies[state]= output.densityEnergy;
+            return output;
+        };
+
+        // proposals are drawn from the current state with a copy of the proposal engine, assuming rejection
+        RandomEngine proposalEngine(this->rng);
+        auto propose= [&]()
+        {
+            while (proposals.size()<static_cast<size_t>(pipelineDepth))
+            {
+                StateType state(currentState);
+                {
+                    ScopedRandomEngine scope(proposalEngine);
+                    state= ensemble.drawNewState(currentState,false);
+                }
+                Proposal proposal{state,proposalEngine.state(),std::make_shared<std::atomic<bool>>(false),{}};
+                proposal.speculation= constructionPool->submit([state=proposal.state,discarded=proposal.discarded,speculate]()
+                {
+                    return speculate(state,discarded);
+                }).share();
+                pending.push_back(proposal.speculation);
+                proposals.push_back(proposal);
+            }
+        };
+
+        auto current= std::make_shared<const StateSystemType>(currentState,ensemble.constructMesoState(currentState));
+        auto lastCheckpoint= std::chrono::steady_clock::now();
+        for (int i = 0; i < maxIterations; )
+        {
+            propose();
+            const Proposal proposal(proposals.front());
+            proposals.pop_front();
+            const Speculation speculation(proposal.speculation.get());
+            this->rng.setState(proposal.engineState);
+            if (!speculation.stateSystem)
+            {
+                // sampleNewState would draw again, which is the next proposal
+                OILAB_PROFILE_COUNT("GbMesoStateEnsemble::sampleNewState retries",1);
+                continue;
+            }
+
+            prefetchedSystem= &speculation.stateSystem->second;
+            prefetchedEnergy= speculation.densityEnergy.valid() ? speculation.densityEnergy.get() : std::nullopt;
+            const bool transition= this->acceptMove(*speculation.stateSystem,*current);
+            prefetchedSystem= nullptr;
+            prefetchedEnergy.reset();
+            {
+                std::lock_guard<std::mutex> guard(energiesMutex);
+                energies.erase(proposal.state);
+            }
+
+            if (transition)
+            {
+                // the remaining proposals were drawn from the previous state
+                for (auto& discarded : proposals)
+                    discarded.discarded->store(true);
+                proposals.clear();
+                proposalEngine= this->rng;
+                currentState= proposal.state;
+                current= speculation.stateSystem;
+            }
+            ++i;
+            ++step;
+            checkpointIfDue(lastCheckpoint);
+
+            // forget the speculations whose tasks have all completed
+            pending.erase(std::remove_if(pending.begin(),pending.end(),[](const std::shared_future<Speculation>& speculation)
+            {
+                if (speculation.wait_for(std::chrono::seconds(0))!=std::future_status::ready)
+                    return false;
+                try
+                {
+                    const auto& densityEnergy(speculation.get().densityEnergy);
+                    return !densityEnergy.valid() || densityEnergy.wait_for(std::chrono::seconds(0))==std::future_status::ready;
+                }
+                catch (...)
+                {
+                    return true;
+                }
+            }),pending.end());
+        }
+    }
+
+    template<typename StateType, typename SystemType, typename EnsembleType, typename EvolveType>
+    void MonteCarlo<StateType,SystemType,EnsembleType,EvolveType>::pipeline(const int& constructionThreads,
+                                                                             const int& evaluationThreads,
+                                                                             const int& depth)
+    {
+        if (depth<0)
+            throw std::runtime_error("MonteCarlo: the depth of the pipeline cannot be negative.");
+        pipelineDepth= depth;
+        if (depth==0)
+        {
+            constructionPool.reset();
+            evaluationPool.reset();
+            return;
+        }
+        constructionPool= std::make_shared<ThreadPool>(constructionThreads);
+        evaluationPool= std::make_shared<ThreadPool>(evaluationThreads);
+    }
+
+    template<typename StateType, typename SystemType, typename EnsembleType, typename EvolveType>
+    void MonteCarlo<StateType,SystemType,EnsembleType,EvolveType>::save(const std::string& filename) const
+    {
+        CheckpointWriter checkpoint;
+        checkpoint.section("MonteCarlo");
+        checkpoint.write(step);
+        checkpoint.write(currentState);
+        checkpoint.write(this->rng.state());
+        this->transitionProbability.save(checkpoint);
+        checkpoint.commit(filename);
+        OILAB_LOG(debug,monteCarlo) << "Checkpoint " << filename << " written at step " << step;
+    }
+
+    template<typename StateType, typename SystemType, typename EnsembleType, typename EvolveType>
+    void MonteCarlo<StateType,SystemType,EnsembleType,EvolveType>::restore(const std::string& filename)
+    {
+        CheckpointReader checkpoint(filename);
+        checkpoint.section("MonteCarlo");
+        checkpoint.read(step);
+        StateType state(0);
+        checkpoint.read(state);
+        if (state.size()!=currentState.size())
+            throw std::runtime_error("MonteCarlo: the checkpoint "+filename+" was written for a different ensemble.");
+        currentState= state;
+        this->rng.setState(checkpoint.read<std::array<std::uint64_t,4>>());
+        this->transitionProbability.restore(checkpoint);
+        if (!checkpoint.atEnd())
+            throw std::runtime_error("MonteCarlo: unexpected data at the end of the checkpoint "+filename+".");
+        OILAB_LOG(info,monteCarlo) << "Restored checkpoint " << filename << " at step " << step;
+    }
+
+    template<typename StateType, typename SystemType, typename EnsembleType, typename EvolveType>
+    void MonteCarlo<StateType,SystemType,EnsembleType,EvolveType>::checkpoint(const std::string& filename,
+                                                                               const int& everySteps,
+                                                                               const double& everySeconds)
+    {
+        checkpointFilename= filename;
+        checkpointSteps= everySteps;
+        checkpointSeconds= everySeconds;
+    }
+
 }
 #endif
\ No newline at end of file
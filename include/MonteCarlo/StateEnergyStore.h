@@ -0,0 +1,111 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef OILAB_STATEENERGYSTORE_H
+#define OILAB_STATEENERGYSTORE_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <PackedXTuplet.h>
+#include <Checkpoint.h>
+#include <SharedLogFile.h>
+
+namespace gbLAB {
+
+    /*!
+     * \brief A concurrent, optionally persistent cache of (density, energy) pairs
+     * keyed on the state of a Monte Carlo walker.
+     *
+     * The in-memory map is split into shards, each guarded by its own mutex,
+     * so that several walkers (threads) can share one store. States are held
+     * as PackedXTuplet keys, so lookups hash in O(1). When a log file is
+     * given, every new entry is appended to it as a fixed-layout binary record.
+     * On construction the log is replayed; a torn record at the end of the file
+     * (e.g. from a crash during a write) is discarded and the file is truncated
+     * to the last complete record. Appends are serialized across processes with
+     * an advisory lock (see SharedLogFile), and refresh() picks up records
+     * written by other processes on the same node.
+     *
+     * StateType should be a dynamically sized integer vector with entries in
+     * \f$\{0,1,2\}\f$ (e.g. XTuplet).
+     */
+    template<typename StateType>
+    class StateEnergyStore {
+    public:
+        using DensityEnergyType= std::pair<double,double>;
+
+    private:
+        static constexpr int numberOfShards= 64;
+        static constexpr std::uint32_t recordMagic= 0x5345534fu;
+
+        struct Shard
+        {
+            mutable std::mutex mutex;
+            std::unordered_map<PackedXTuplet,DensityEnergyType> map;
+        };
+
+        std::array<Shard,numberOfShards> shards;
+        std::string logFilename;
+        std::unique_ptr<SharedLogFile> log;
+        std::uint64_t logOffset;
+        std::mutex logMutex;
+
+        Shard& shard(const std::uint64_t& key);
+        const Shard& shard(const std::uint64_t& key) const;
+        bool insertInMemory(const PackedXTuplet& key, const DensityEnergyType& densityEnergy);
+        void appendToLog(const PackedXTuplet& key, const DensityEnergyType& densityEnergy);
+        size_t replay(const bool& truncateTornTail);
+
+    public:
+        /*!
+         * Constructs an in-memory store. If \p logFilename is not empty, the
+         * store is backed by an append-only binary log of that name, which is
+         * replayed immediately.
+         */
+        explicit StateEnergyStore(const std::string& logFilename="");
+        StateEnergyStore(const StateEnergyStore&) = delete;
+        StateEnergyStore& operator=(const StateEnergyStore&) = delete;
+
+        static PackedXTuplet pack(const StateType& state);
+
+        //! 64-bit hash of the size and entries of \p state
+        static std::uint64_t hash(const StateType& state);
+
+        std::optional<DensityEnergyType> find(const StateType& state) const;
+
+        /*!
+         * Inserts the pair (\p density, \p energy) for \p state. Returns false,
+         * and leaves the store unchanged, if \p state is already present.
+         */
+        bool insert(const StateType& state, const double& density, const double& energy);
+
+        /*!
+         * Imports a legacy whitespace-separated text file whose lines read
+         * "density energy s_0 s_1 ... s_{k-1}". Returns the number of new states.
+         */
+        size_t importText(const std::string& filename);
+
+        //! Replays records appended to the log by other processes since the last read
+        size_t refresh();
+
+        //! Writes all entries to \p checkpoint, sorted by state so that equal stores give equal checkpoints
+        void save(CheckpointWriter& checkpoint) const;
+
+        //! Inserts the entries saved by save(); returns the number of new states
+        size_t restore(CheckpointReader& checkpoint);
+
+        size_t size() const;
+        const std::string& filename() const;
+    };
+
+}
+#include <StateEnergyStoreImplementation.h>
+#endif //OILAB_STATEENERGYSTORE_H
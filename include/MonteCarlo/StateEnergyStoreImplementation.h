@@ -0,0 +1,284 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef OILAB_STATEENERGYSTOREIMPLEMENTATION_H
+#define OILAB_STATEENERGYSTOREIMPLEMENTATION_H
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <Log.h>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace gbLAB {
+
+    namespace StateEnergyStoreDetail
+    {
+        // Record layout: magic, state size, state hash, density, energy, state entries (one byte each), checksum
+        constexpr size_t headerSize= 2*sizeof(std::uint32_t)+sizeof(std::uint64_t)+2*sizeof(double);
+
+        inline std::uint32_t checksum(const unsigned char* data, const size_t& n)
+        {
+            std::uint32_t h= 2166136261u;
+            for (size_t i=0; i<n; ++i)
+            {
+                h^= data[i];
+                h*= 16777619u;
+            }
+            return h;
+        }
+    }
+
+    template<typename StateType>
+    StateEnergyStore<StateType>::StateEnergyStore(const std::string& logFilename) :
+        logFilename(logFilename),
+        logOffset(0)
+    {
+        if (logFilename.empty())
+            return;
+
+        log= std::make_unique<SharedLogFile>(logFilename);
+        SharedLogFile::Lock lock(*log,true);
+        std::lock_guard<std::mutex> guard(logMutex);
+        replay(true);
+    }
+
+    template<typename StateType>
+    PackedXTuplet StateEnergyStore<StateType>::pack(const StateType& state)
+    {
+        PackedXTuplet packed(state.size());
+        for (int i=0; i<state.size(); ++i)
+            packed.set(i,state(i));
+        return packed;
+    }
+
+    template<typename StateType>
+    std::uint64_t StateEnergyStore<StateType>::hash(const StateType& state)
+    {
+        return pack(state).hash();
+    }
+
+    template<typename StateType>
+    typename StateEnergyStore<StateType>::Shard& StateEnergyStore<StateType>::shard(const std::uint64_t& key)
+    {
+        return shards[(key >> 58) % numberOfShards];
+    }
+
+    template<typename StateType>
+    const typename StateEnergyStore<StateType>::Shard& StateEnergyStore<StateType>::shard(const std::uint64_t& key) const
+    {
+        return shards[(key >> 58) % numberOfShards];
+    }
+
+    template<typename StateType>
+    std::optional<typename StateEnergyStore<StateType>::DensityEnergyType>
+    StateEnergyStore<StateType>::find(const StateType& state) const
+    {
+        const PackedXTuplet key(pack(state));
+        const Shard& s= shard(key.hash());
+        std::lock_guard<std::mutex> guard(s.mutex);
+        const auto it= s.map.find(key);
+        if (it==s.map.end())
+            return std::nullopt;
+        return it->second;
+    }
+
+    template<typename StateType>
+    bool StateEnergyStore<StateType>::insertInMemory(const PackedXTuplet& key,
+                                                     const DensityEnergyType& densityEnergy)
+    {
+        Shard& s= shard(key.hash());
+        std::lock_guard<std::mutex> guard(s.mutex);
+        return s.map.try_emplace(key,densityEnergy).second;
+    }
+
+    template<typename StateType>
+    bool StateEnergyStore<StateType>::insert(const StateType& state, const double& density, const double& energy)
+    {
+        const PackedXTuplet key(pack(state));
+        const DensityEnergyType densityEnergy(density,energy);
+        if (!insertInMemory(key,densityEnergy))
+            return false;
+        if (log)
+            appendToLog(key,densityEnergy);
+        return true;
+    }
+
+    template<typename StateType>
+    void StateEnergyStore<StateType>::appendToLog(const PackedXTuplet& state,
+                                                  const DensityEnergyType& densityEnergy)
+    {
+        const std::uint32_t k= state.size();
+        const std::uint64_t key= state.hash();
+        std::vector<unsigned char> record(StateEnergyStoreDetail::headerSize+k+sizeof(std::uint32_t));
+        unsigned char* p= record.data();
+        std::memcpy(p,&recordMagic,sizeof(recordMagic));                    p+= sizeof(recordMagic);
+        std::memcpy(p,&k,sizeof(k));                                        p+= sizeof(k);
+        std::memcpy(p,&key,sizeof(key));                                    p+= sizeof(key);
+        std::memcpy(p,&densityEnergy.first,sizeof(double));                 p+= sizeof(double);
+        std::memcpy(p,&densityEnergy.second,sizeof(double));                p+= sizeof(double);
+        for (int i=0; i<state.size(); ++i)
+            *p++= static_cast<unsigned char>(state(i));
+        const std::uint32_t sum= StateEnergyStoreDetail::checksum(record.data(),p-record.data());
+        std::memcpy(p,&sum,sizeof(sum));
+
+        std::lock_guard<std::mutex> guard(logMutex);
+        SharedLogFile::Lock lock(*log,true);
+        // pick up records appended by other processes so that logOffset stays at the end of the file
+        replay(true);
+        log->append(record.data(),record.size());
+        logOffset+= record.size();
+    }
+
+    template<typename StateType>
+    size_t StateEnergyStore<StateType>::replay(const bool& truncateTornTail)
+    {
+        const std::uint64_t fileSize= log->size();
+        if (fileSize<=logOffset)
+            return 0;
+
+        std::vector<unsigned char> buffer(fileSize-logOffset);
+        const size_t bytesRead= log->read(logOffset,buffer.data(),buffer.size());
+
+        size_t newStates= 0;
+        size_t pos= 0;
+        while (pos+StateEnergyStoreDetail::headerSize<=bytesRead)
+        {
+            const unsigned char* p= buffer.data()+pos;
+            std::uint32_t magic, k;
+            DensityEnergyType densityEnergy;
+            std::memcpy(&magic,p,sizeof(magic));                    p+= sizeof(magic);
+            if (magic!=recordMagic) break;
+            std::memcpy(&k,p,sizeof(k));                            p+= sizeof(k);
+            const size_t recordSize= StateEnergyStoreDetail::headerSize+k+sizeof(std::uint32_t);
+            if (pos+recordSize>bytesRead) break;
+            p+= sizeof(std::uint64_t);
+            std::memcpy(&densityEnergy.first,p,sizeof(double));     p+= sizeof(double);
+            std::memcpy(&densityEnergy.second,p,sizeof(double));    p+= sizeof(double);
+            std::uint32_t sum;
+            std::memcpy(&sum,p+k,sizeof(sum));
+            if (sum!=StateEnergyStoreDetail::checksum(buffer.data()+pos,recordSize-sizeof(sum))) break;
+
+            // the stored hash is informational; keys are rebuilt from the entries
+            PackedXTuplet state(k);
+            for (std::uint32_t i=0; i<k; ++i)
+                state.set(i,p[i]);
+            if (insertInMemory(state,densityEnergy))
+                newStates++;
+            pos+= recordSize;
+        }
+
+        if (pos<buffer.size() && truncateTornTail)
+        {
+            OILAB_LOG(warning,monteCarlo) << "StateEnergyStore: discarding " << buffer.size()-pos << " bytes of a torn record in " << logFilename;
+            log->truncate(logOffset+pos);
+        }
+        logOffset+= pos;
+        return newStates;
+    }
+
+    template<typename StateType>
+    size_t StateEnergyStore<StateType>::refresh()
+    {
+        if (!log)
+            return 0;
+        std::lock_guard<std::mutex> guard(logMutex);
+        SharedLogFile::Lock lock(*log,false);
+        return replay(false);
+    }
+
+    template<typename StateType>
+    size_t StateEnergyStore<StateType>::importText(const std::string& filename)
+    {
+        std::ifstream file(filename);
+        if (!file)
+            return 0;
+
+        size_t newStates= 0;
+        std::string line;
+        while (std::getline(file,line))
+        {
+            std::stringstream s(line);
+            double density, energy;
+            if (!(s >> density >> energy))
+                continue;
+            int temp;
+            std::vector<int> tempVector;
+            while (s >> temp)
+                tempVector.push_back(temp);
+
+            StateType state(tempVector.size());
+            for (int i=0; i<tempVector.size(); ++i)
+                state(i)= tempVector[i];
+            if (insert(state,density,energy))
+                newStates++;
+        }
+        return newStates;
+    }
+
+    template<typename StateType>
+    void StateEnergyStore<StateType>::save(CheckpointWriter& checkpoint) const
+    {
+        std::vector<std::pair<PackedXTuplet,DensityEnergyType>> entries;
+        for (const auto& s : shards)
+        {
+            std::lock_guard<std::mutex> guard(s.mutex);
+            entries.insert(entries.end(),s.map.begin(),s.map.end());
+        }
+        std::sort(entries.begin(),entries.end(),[](const auto& a, const auto& b){ return a.first<b.first; });
+
+        checkpoint.section("StateEnergyStore");
+        checkpoint.write(static_cast<std::uint64_t>(entries.size()));
+        for (const auto& [state,densityEnergy] : entries)
+        {
+            checkpoint.write(static_cast<std::uint32_t>(state.size()));
+            for (int i=0; i<state.size(); ++i)
+                checkpoint.write(static_cast<std::uint8_t>(state(i)));
+            checkpoint.write(densityEnergy.first);
+            checkpoint.write(densityEnergy.second);
+        }
+    }
+
+    template<typename StateType>
+    size_t StateEnergyStore<StateType>::restore(CheckpointReader& checkpoint)
+    {
+        checkpoint.section("StateEnergyStore");
+        const auto numberOfEntries= checkpoint.read<std::uint64_t>();
+        size_t newStates= 0;
+        for (std::uint64_t n=0; n<numberOfEntries; ++n)
+        {
+            StateType state(checkpoint.read<std::uint32_t>());
+            for (int i=0; i<state.size(); ++i)
+                state(i)= checkpoint.read<std::uint8_t>();
+            const double density= checkpoint.read<double>();
+            const double energy= checkpoint.read<double>();
+            if (insert(state,density,energy))
+                newStates++;
+        }
+        return newStates;
+    }
+
+    template<typename StateType>
+    size_t StateEnergyStore<StateType>::size() const
+    {
+        size_t n= 0;
+        for (const auto& s : shards)
+        {
+            std::lock_guard<std::mutex> guard(s.mutex);
+            n+= s.map.size();
+        }
+        return n;
+    }
+
+    template<typename StateType>
+    const std::string& StateEnergyStore<StateType>::filename() const
+    {
+        return logFilename;
+    }
+}
+#endif
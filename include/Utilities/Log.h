@@ -0,0 +1,225 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef gbLAB_LOG_H_
+#define gbLAB_LOG_H_
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+/*! Messages below this level are removed at compile time
+ * (0: trace, 1: debug, 2: info, 3: warning, 4: error, 5: off).
+ * Trace messages are compiled only in debug builds.
+ */
+#ifndef OILAB_LOG_COMPILE_LEVEL
+#ifdef NDEBUG
+#define OILAB_LOG_COMPILE_LEVEL 1
+#else
+#define OILAB_LOG_COMPILE_LEVEL 0
+#endif
+#endif
+
+namespace gbLAB
+{
+    enum class LogLevel : int {trace=0, debug=1, info=2, warning=3, error=4, off=5};
+
+    enum class LogSubsystem : int {general=0, math, lattice, bicrystal, gb, continuum, monteCarlo, io, numberOfSubsystems};
+
+    /*! \brief A leveled, thread-safe logger.
+     *
+     * Every message belongs to a subsystem, and is emitted only if its level is
+     * at least the runtime level of that subsystem. The runtime levels default to
+     * LogLevel::warning, so the library is silent unless something goes wrong.
+     * They can be set programmatically, or with the environment variable OILAB_LOG,
+     * e.g. OILAB_LOG=info or OILAB_LOG=warning,continuum=debug,monteCarlo=info.
+     *
+     * Messages are written by a sink, which is called under a mutex. The default
+     * sink writes to std::clog.
+     *
+     * Example:
+     * \code
+     * OILAB_LOG(info,monteCarlo) << "Step " << i << "; energy = " << energy;
+     * \endcode
+     * The stream expression is not evaluated if the message is filtered out.
+     */
+    class Log
+    {
+    public:
+        using Sink= std::function<void(const LogLevel&, const LogSubsystem&, std::string_view)>;
+
+    private:
+        static constexpr int numberOfSubsystems= static_cast<int>(LogSubsystem::numberOfSubsystems);
+
+        struct State
+        {
+            std::array<std::atomic<int>,numberOfSubsystems> levels;
+            std::mutex sinkMutex;
+            Sink sink;
+
+            State()
+            {
+                for(auto& level : levels)
+                    level.store(static_cast<int>(LogLevel::warning),std::memory_order_relaxed);
+                if(const char* env= std::getenv("OILAB_LOG"))
+                {
+                    try
+                    {
+                        configure(env,levels);
+                    }
+                    catch(const std::invalid_argument& e)
+                    {
+                        std::clog << "OILAB_LOG ignored: " << e.what() << std::endl;
+                    }
+                }
+            }
+        };
+
+        static State& state()
+        {
+            static State s;
+            return s;
+        }
+
+        static void configure(std::string_view spec, std::array<std::atomic<int>,numberOfSubsystems>& levels)
+        {
+            while(!spec.empty())
+            {
+                const size_t comma= spec.find(',');
+                const std::string_view item(spec.substr(0,comma));
+                spec= comma==std::string_view::npos? std::string_view() : spec.substr(comma+1);
+                if(item.empty())
+                    continue;
+
+                const size_t equal= item.find('=');
+                if(equal==std::string_view::npos)
+                {
+                    const int level(static_cast<int>(logLevel(item)));
+                    for(auto& l : levels)
+                        l.store(level,std::memory_order_relaxed);
+                }
+                else
+                    levels[static_cast<int>(logSubsystem(item.substr(0,equal)))].store(static_cast<int>(logLevel(item.substr(equal+1))),
+                                                                                      std::memory_order_relaxed);
+            }
+        }
+
+    public:
+        static constexpr std::array<std::string_view,6> levelNames{"trace","debug","info","warning","error","off"};
+        static constexpr std::array<std::string_view,numberOfSubsystems> subsystemNames{"general","math","lattice","bicrystal","gb","continuum","monteCarlo","io"};
+
+        static LogLevel logLevel(std::string_view name)
+        {
+            for(size_t i=0; i<levelNames.size(); ++i)
+                if(levelNames[i]==name)
+                    return static_cast<LogLevel>(i);
+            throw std::invalid_argument("Unknown log level " + std::string(name));
+        }
+
+        static LogSubsystem logSubsystem(std::string_view name)
+        {
+            for(size_t i=0; i<subsystemNames.size(); ++i)
+                if(subsystemNames[i]==name)
+                    return static_cast<LogSubsystem>(i);
+            throw std::invalid_argument("Unknown log subsystem " + std::string(name));
+        }
+
+        static bool enabled(const LogLevel& level, const LogSubsystem& subsystem)
+        {
+            return static_cast<int>(level)>=state().levels[static_cast<int>(subsystem)].load(std::memory_order_relaxed);
+        }
+
+        //! Sets the runtime level of all subsystems
+        static void setLevel(const LogLevel& level)
+        {
+            for(auto& l : state().levels)
+                l.store(static_cast<int>(level),std::memory_order_relaxed);
+        }
+
+        static void setLevel(const LogSubsystem& subsystem, const LogLevel& level)
+        {
+            state().levels[static_cast<int>(subsystem)].store(static_cast<int>(level),std::memory_order_relaxed);
+        }
+
+        static LogLevel level(const LogSubsystem& subsystem)
+        {
+            return static_cast<LogLevel>(state().levels[static_cast<int>(subsystem)].load(std::memory_order_relaxed));
+        }
+
+        //! Sets the runtime levels from a specification in the format of OILAB_LOG
+        static void configure(std::string_view spec)
+        {
+            configure(spec,state().levels);
+        }
+
+        //! Replaces the sink; an empty sink restores the default one
+        static void setSink(const Sink& sink)
+        {
+            std::lock_guard<std::mutex> guard(state().sinkMutex);
+            state().sink= sink;
+        }
+
+        static void write(const LogLevel& level, const LogSubsystem& subsystem, std::string_view message)
+        {
+            State& s(state());
+            std::lock_guard<std::mutex> guard(s.sinkMutex);
+            if(s.sink)
+                s.sink(level,subsystem,message);
+            else
+                std::clog << "[" << levelNames[static_cast<int>(level)] << "] "
+                          << "[" << subsystemNames[static_cast<int>(subsystem)] << "] "
+                          << message << '\n';
+        }
+    };
+
+    /*! \brief Collects one message and hands it to the sink when destroyed */
+    class LogMessage
+    {
+        const LogLevel level;
+        const LogSubsystem subsystem;
+        std::ostringstream message;
+
+    public:
+        LogMessage(const LogLevel& level, const LogSubsystem& subsystem) :
+        /* init */ level(level),
+        /* init */ subsystem(subsystem)
+        {}
+
+        LogMessage(const LogMessage&) = delete;
+
+        ~LogMessage()
+        {
+            Log::write(level,subsystem,message.view());
+        }
+
+        std::ostream& stream()
+        {
+            return message;
+        }
+    };
+}
+
+//! True if a message at level LEVEL of SUBSYSTEM would be emitted; guards expensive diagnostics
+#define OILAB_LOG_ENABLED(LEVEL,SUBSYSTEM) \
+    (static_cast<int>(gbLAB::LogLevel::LEVEL)>=OILAB_LOG_COMPILE_LEVEL && \
+     gbLAB::Log::enabled(gbLAB::LogLevel::LEVEL,gbLAB::LogSubsystem::SUBSYSTEM))
+
+/*! Streams a message at level LEVEL (trace, debug, info, warning, error) to subsystem SUBSYSTEM.
+ * Messages below OILAB_LOG_COMPILE_LEVEL are removed by the compiler. The switch keeps the
+ * trailing else from binding to an enclosing unbraced if.
+ */
+#define OILAB_LOG(LEVEL,SUBSYSTEM) \
+    switch (0) case 0: default: \
+    if (!OILAB_LOG_ENABLED(LEVEL,SUBSYSTEM)) ; \
+    else gbLAB::LogMessage(gbLAB::LogLevel::LEVEL,gbLAB::LogSubsystem::SUBSYSTEM).stream()
+
+#endif
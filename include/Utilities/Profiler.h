@@ -0,0 +1,321 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef gbLAB_PROFILER_H_
+#define gbLAB_PROFILER_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace gbLAB
+{
+    /*! \brief Registry of scoped timers and counters.
+     *
+     * Instrumented code uses the macros OILAB_PROFILE_SCOPE(name) and
+     * OILAB_PROFILE_COUNT(name,increment), which compile to nothing unless
+     * OILAB_ENABLE_PROFILING is defined (cmake -DENABLE_PROFILING=ON).
+     *
+     * Every thread accumulates into its own records, so timing a scope costs two
+     * clock reads and an uncontended lock. The records of a thread outlive the
+     * thread, and are aggregated when a report is requested.
+     *
+     * A report is written on demand with Profiler::report or Profiler::writeJSON,
+     * and at exit if the environment variable OILAB_PROFILE is set: a value ending
+     * in ".json" names the JSON file, any other value prints the table to std::clog.
+     */
+    class Profiler
+    {
+    public:
+        struct Record
+        {
+            std::uint64_t calls= 0;
+            std::uint64_t total= 0;     // nanoseconds for timers, sum of increments for counters
+            std::uint64_t max= 0;       // nanoseconds, timers only
+        };
+
+        /*! \brief A named timer or counter, owned by a macro expansion.
+         * Sites with the same name share their records.
+         */
+        class Site
+        {
+        public:
+            const bool isTimer;
+            const size_t id;
+
+            Site(const std::string& name, const bool& isTimer) :
+            /* init */ isTimer(isTimer),
+            /* init */ id(Profiler::registerSite(name,isTimer))
+            {}
+        };
+
+    private:
+        struct ThreadRecords
+        {
+            std::mutex mutex;
+            const size_t threadIndex;
+            std::vector<Record> records;   // indexed by Site::id
+
+            explicit ThreadRecords(const size_t& threadIndex) :
+            /* init */ threadIndex(threadIndex)
+            {}
+        };
+
+        struct State
+        {
+            std::mutex mutex;
+            std::vector<std::pair<std::string,bool>> sites;  // (name, isTimer) indexed by Site::id
+            std::vector<std::shared_ptr<ThreadRecords>> threads;
+
+            ~State()
+            {
+                if(const char* env= std::getenv("OILAB_PROFILE"))
+                {
+                    const std::string target(env);
+                    if(target.size()>5 && target.compare(target.size()-5,5,".json")==0)
+                    {
+                        std::ofstream file(target);
+                        write(file,true);
+                    }
+                    else
+                        write(std::clog,false);
+                }
+            }
+
+            void write(std::ostream& os, const bool& json)
+            {
+                std::lock_guard<std::mutex> guard(mutex);
+                if(json)
+                    writeJSON(os,sites,threads);
+                else
+                    writeTable(os,sites,threads);
+            }
+        };
+
+        static State& state()
+        {
+            static State s;
+            return s;
+        }
+
+        static size_t registerSite(const std::string& name, const bool& isTimer)
+        {
+            State& s(state());
+            std::lock_guard<std::mutex> guard(s.mutex);
+            for(size_t id=0; id<s.sites.size(); ++id)
+                if(s.sites[id].first==name)
+                {
+                    if(s.sites[id].second!=isTimer)
+                        throw std::runtime_error("Profiler: "+name+" is used both as a timer and as a counter.");
+                    return id;
+                }
+            s.sites.emplace_back(name,isTimer);
+            return s.sites.size()-1;
+        }
+
+        static ThreadRecords& threadRecords()
+        {
+            thread_local std::shared_ptr<ThreadRecords> records([](){
+                State& s(state());
+                std::lock_guard<std::mutex> guard(s.mutex);
+                s.threads.push_back(std::make_shared<ThreadRecords>(s.threads.size()));
+                return s.threads.back();
+            }());
+            return *records;
+        }
+
+        static Record merged(const size_t& id, const std::vector<std::shared_ptr<ThreadRecords>>& threads, size_t& activeThreads)
+        {
+            Record output;
+            activeThreads= 0;
+            for(const auto& thread : threads)
+            {
+                std::lock_guard<std::mutex> guard(thread->mutex);
+                if(id<thread->records.size() && thread->records[id].calls>0)
+                {
+                    const Record& record(thread->records[id]);
+                    output.calls+= record.calls;
+                    output.total+= record.total;
+                    output.max= std::max(output.max,record.max);
+                    ++activeThreads;
+                }
+            }
+            return output;
+        }
+
+        static void writeTable(std::ostream& os,
+                               const std::vector<std::pair<std::string,bool>>& sites,
+                               const std::vector<std::shared_ptr<ThreadRecords>>& threads)
+        {
+            const std::ios_base::fmtflags flags(os.flags());
+            os << std::left << std::setw(36) << "name" << std::right
+               << std::setw(12) << "calls" << std::setw(14) << "total [s]"
+               << std::setw(14) << "mean [ms]" << std::setw(14) << "max [ms]"
+               << std::setw(9) << "threads" << "\n";
+            for(size_t id=0; id<sites.size(); ++id)
+            {
+                const auto& [name,isTimer]= sites[id];
+                size_t activeThreads;
+                const Record record(merged(id,threads,activeThreads));
+                if(record.calls==0)
+                    continue;
+                os << std::left << std::setw(36) << name << std::right << std::setw(12) << record.calls;
+                if(isTimer)
+                    os << std::fixed << std::setprecision(4)
+                       << std::setw(14) << record.total*1e-9
+                       << std::setw(14) << record.total*1e-6/record.calls
+                       << std::setw(14) << record.max*1e-6;
+                else
+                    os << std::setw(14) << record.total << std::setw(14) << "-" << std::setw(14) << "-";
+                os << std::setw(9) << activeThreads << "\n";
+            }
+            os.flags(flags);
+        }
+
+        static void writeJSON(std::ostream& os,
+                              const std::vector<std::pair<std::string,bool>>& sites,
+                              const std::vector<std::shared_ptr<ThreadRecords>>& threads)
+        {
+            os << "{\n  \"timers\": [";
+            for(const bool timers : {true,false})
+            {
+                if(!timers)
+                    os << "\n  ],\n  \"counters\": [";
+                bool first= true;
+                for(size_t id=0; id<sites.size(); ++id)
+                {
+                    const auto& [name,isTimer]= sites[id];
+                    size_t activeThreads;
+                    const Record record(merged(id,threads,activeThreads));
+                    if(isTimer!=timers || record.calls==0)
+                        continue;
+                    os << (first? "\n" : ",\n") << "    {\"name\": \"" << name << "\""
+                       << ", \"calls\": " << record.calls
+                       << (timers? ", \"nanoseconds\": " : ", \"total\": ") << record.total;
+                    if(timers)
+                        os << ", \"maxNanoseconds\": " << record.max;
+                    os << ", \"threads\": [";
+                    bool firstThread= true;
+                    for(const auto& thread : threads)
+                    {
+                        std::lock_guard<std::mutex> guard(thread->mutex);
+                        if(id<thread->records.size() && thread->records[id].calls>0)
+                        {
+                            const Record& r(thread->records[id]);
+                            os << (firstThread? "" : ", ") << "{\"thread\": " << thread->threadIndex
+                               << ", \"calls\": " << r.calls << ", \"total\": " << r.total << "}";
+                            firstThread= false;
+                        }
+                    }
+                    os << "]}";
+                    first= false;
+                }
+            }
+            os << "\n  ]\n}\n";
+        }
+
+    public:
+        //! Adds one observation to the record of site on the calling thread
+        static void add(const Site& site, const std::uint64_t& value)
+        {
+            ThreadRecords& thread(threadRecords());
+            std::lock_guard<std::mutex> guard(thread.mutex);
+            if(thread.records.size()<=site.id)
+                thread.records.resize(site.id+1);
+            Record& record(thread.records[site.id]);
+            ++record.calls;
+            record.total+= value;
+            if(site.isTimer)
+                record.max= std::max(record.max,value);
+        }
+
+        //! Record of the named site aggregated over all threads
+        static Record record(const std::string& name)
+        {
+            State& s(state());
+            std::lock_guard<std::mutex> guard(s.mutex);
+            for(size_t id=0; id<s.sites.size(); ++id)
+                if(s.sites[id].first==name)
+                {
+                    size_t activeThreads;
+                    return merged(id,s.threads,activeThreads);
+                }
+            return Record();
+        }
+
+        //! Writes a summary table of all timers and counters
+        static void report(std::ostream& os= std::clog)
+        {
+            state().write(os,false);
+        }
+
+        static void writeJSON(std::ostream& os)
+        {
+            state().write(os,true);
+        }
+
+        //! Zeroes all records, e.g. after a warm-up phase
+        static void reset()
+        {
+            State& s(state());
+            std::lock_guard<std::mutex> guard(s.mutex);
+            for(const auto& thread : s.threads)
+            {
+                std::lock_guard<std::mutex> threadGuard(thread->mutex);
+                std::fill(thread->records.begin(),thread->records.end(),Record());
+            }
+        }
+    };
+
+    /*! \brief Adds the lifetime of the object to a timer */
+    class ProfileScope
+    {
+        const Profiler::Site& site;
+        const std::chrono::steady_clock::time_point start;
+
+    public:
+        explicit ProfileScope(const Profiler::Site& site) :
+        /* init */ site(site),
+        /* init */ start(std::chrono::steady_clock::now())
+        {}
+
+        ProfileScope(const ProfileScope&) = delete;
+
+        ~ProfileScope()
+        {
+            Profiler::add(site,std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()-start).count());
+        }
+    };
+}
+
+#define OILAB_PROFILE_CONCAT_IMPL(a,b) a##b
+#define OILAB_PROFILE_CONCAT(a,b) OILAB_PROFILE_CONCAT_IMPL(a,b)
+
+#ifdef OILAB_ENABLE_PROFILING
+//! Times the enclosing scope under NAME
+#define OILAB_PROFILE_SCOPE(NAME) \
+    static const gbLAB::Profiler::Site OILAB_PROFILE_CONCAT(oilabProfileSite,__LINE__)(NAME,true); \
+    const gbLAB::ProfileScope OILAB_PROFILE_CONCAT(oilabProfileScope,__LINE__)(OILAB_PROFILE_CONCAT(oilabProfileSite,__LINE__))
+//! Adds INCREMENT to the counter NAME
+#define OILAB_PROFILE_COUNT(NAME,INCREMENT) \
+    do { \
+        static const gbLAB::Profiler::Site oilabProfileSite(NAME,false); \
+        gbLAB::Profiler::add(oilabProfileSite,INCREMENT); \
+    } while(false)
+#else
+#define OILAB_PROFILE_SCOPE(NAME) do {} while(false)
+#define OILAB_PROFILE_COUNT(NAME,INCREMENT) do {} while(false)
+#endif
+
+#endif
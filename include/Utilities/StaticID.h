@@ -7,6 +7,8 @@
 #ifndef gbLAB_STATICID_H_
 #define gbLAB_STATICID_H_
 
+#include <atomic>
+#include <stdexcept>
 
 namespace gbLAB
 {
@@ -16,6 +18,12 @@ namespace gbLAB
 	/*! \brief A class template that implements a counter of the number of 
      * instances of Derived type that are created at runtime. It also provides a 
      * unique increasing static identifier (sID) for each instance.
+     *
+     * The counter is atomic, so that instances can be constructed concurrently
+     * (e.g. lattices and bicrystals built in OpenMP loops or std::threads).
+     * The IDs of concurrently constructed instances are unique, but their order
+     * depends on scheduling. set_count and set_increment are not meant to be
+     * called while instances are being constructed.
 	 *
      * Example:
      * \include test/test_StaticID/main.cpp 
@@ -27,11 +35,11 @@ namespace gbLAB
     {
 
 		// The increment
-		static size_t increment;
+		static std::atomic<size_t> increment;
 		
 		// The incremental counters
-		static size_t count;
-        static bool count_used;
+		static std::atomic<size_t> count;
+        static std::atomic<bool> count_used;
 		
 	public:
 		
@@ -39,17 +47,15 @@ namespace gbLAB
 		const  size_t sID;
 		
         /**********************************************************************/
-		StaticID() : sID(count)
+		StaticID() : sID(count.fetch_add(increment))
         {
             count_used=true;
-            count+=increment;
 		}
 		
         /**********************************************************************/
-		StaticID(const StaticID&) : sID(count)
+		StaticID(const StaticID&) : sID(count.fetch_add(increment))
         {
             count_used=true;
-            count+=increment;
 		}
         
         /**********************************************************************/
@@ -58,7 +64,7 @@ namespace gbLAB
             return count;
         }
         
-        static size_t& get_count()
+        static size_t get_count()
         {
             return count;
         }
@@ -93,13 +99,13 @@ namespace gbLAB
 	
 	/* Static data members  *****************************/
 	template<typename Derived>
-	size_t StaticID<Derived>::increment = 1;
+	std::atomic<size_t> StaticID<Derived>::increment(1);
 
 	template<typename Derived>
-	size_t StaticID<Derived>::count = 0;
+	std::atomic<size_t> StaticID<Derived>::count(0);
 
     template<typename Derived>
-    bool StaticID<Derived>::count_used = false;
+    std::atomic<bool> StaticID<Derived>::count_used(false);
 	
 } // namespace gbLAB
 #endif
@@ -0,0 +1,99 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef gbLAB_THREADPOOL_H_
+#define gbLAB_THREADPOOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace gbLAB
+{
+    /*! \brief A fixed set of worker threads executing tasks in submission order.
+     *
+     * The threads are long-lived, so thread-local caches (e.g. the kernels of GbContinuum)
+     * are built once per thread and reused by later tasks. Tasks that are still queued when
+     * the pool is destroyed are discarded; their futures report std::future_errc::broken_promise.
+     */
+    class ThreadPool
+    {
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::deque<std::function<void()>> tasks;
+        std::vector<std::thread> threads;
+        bool stopping;
+
+        void work()
+        {
+            while(true)
+            {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    condition.wait(lock,[this](){ return stopping || !tasks.empty(); });
+                    if(stopping)
+                        return;
+                    task= std::move(tasks.front());
+                    tasks.pop_front();
+                }
+                task();
+            }
+        }
+
+    public:
+        explicit ThreadPool(const int& numberOfThreads) :
+        /* init */ stopping(false)
+        {
+            if(numberOfThreads<1)
+                throw std::runtime_error("ThreadPool: the number of threads has to be positive.");
+            for(int i=0; i<numberOfThreads; ++i)
+                threads.emplace_back(&ThreadPool::work,this);
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> guard(mutex);
+                stopping= true;
+                tasks.clear();
+            }
+            condition.notify_all();
+            for(auto& thread : threads)
+                thread.join();
+        }
+
+        size_t size() const
+        {
+            return threads.size();
+        }
+
+        //! Queues \p function, and returns the future of its result
+        template<typename FunctionType>
+        std::future<std::invoke_result_t<FunctionType>> submit(FunctionType&& function)
+        {
+            using ResultType= std::invoke_result_t<FunctionType>;
+            auto task= std::make_shared<std::packaged_task<ResultType()>>(std::forward<FunctionType>(function));
+            std::future<ResultType> output(task->get_future());
+            {
+                std::lock_guard<std::mutex> guard(mutex);
+                tasks.emplace_back([task](){ (*task)(); });
+            }
+            condition.notify_one();
+            return output;
+        }
+    };
+}
+#endif
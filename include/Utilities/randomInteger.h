@@ -4,25 +4,187 @@
 
 #ifndef OILAB_RANDOM_H
 #define OILAB_RANDOM_H
+#include <array>
+#include <cstdint>
 #include <iostream>
+#include <limits>
 #include <random>
+#include <type_traits>
 
 namespace gbLAB {
-    template<typename T>
-    T random(const T& a, const T& b) {
-        std::random_device rd;  // a seed source for the random number engine
-        std::mt19937 gen(rd()); // mersenne_twister_engine seeded with rd()
-        if(typeid(T) == typeid(int)) {
-            std::uniform_int_distribution<> distrib(a, b);
-            return distrib(gen);
+
+    /*!
+     * \brief A xoshiro256** pseudo-random number generator.
+     *
+     * The engine is seeded from a (seed, stream) pair: both are mixed through
+     * splitmix64 to fill the 256-bit state, so that walkers sharing a seed but
+     * using different stream numbers draw statistically independent sequences.
+     * Uniform integers and reals are produced by fixed algorithms (Lemire's
+     * multiply-shift rejection and 53-bit mantissa scaling), so a seeded run is
+     * bit-reproducible across compilers and standard libraries.
+     */
+    class RandomEngine
+    {
+        std::array<std::uint64_t,4> s;
+
+        static std::uint64_t rotl(const std::uint64_t& x, const int& k)
+        {
+            return (x << k) | (x >> (64 - k));
+        }
+
+        static std::uint64_t splitmix64(std::uint64_t& x)
+        {
+            std::uint64_t z= (x+= 0x9e3779b97f4a7c15ull);
+            z= (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z= (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
         }
-        else if(typeid(T) == typeid(double)) {
-            std::uniform_real_distribution<> distrib(a, b);
-            return distrib(gen);
+
+    public:
+        using result_type= std::uint64_t;
+
+        /*!
+         * Full 128-bit product of \p x and \p y: returns the high 64 bits and stores
+         * the low 64 bits in \p low. Computed from 32-bit halves, so it needs no
+         * compiler-specific 128-bit integer type.
+         */
+        static std::uint64_t multiply(const std::uint64_t& x, const std::uint64_t& y, std::uint64_t& low)
+        {
+            const std::uint64_t x0= x & 0xffffffffull, x1= x >> 32;
+            const std::uint64_t y0= y & 0xffffffffull, y1= y >> 32;
+            const std::uint64_t p00= x0 * y0, p01= x0 * y1, p10= x1 * y0, p11= x1 * y1;
+            const std::uint64_t middle= (p00 >> 32) + (p01 & 0xffffffffull) + (p10 & 0xffffffffull);
+            low= (middle << 32) | (p00 & 0xffffffffull);
+            return p11 + (p01 >> 32) + (p10 >> 32) + (middle >> 32);
         }
-        else{
-            throw(std::runtime_error("Unknown type\n"));
+
+        //! Seeds the engine from the operating system's entropy source
+        RandomEngine()
+        {
+            std::random_device rd;
+            seed((static_cast<std::uint64_t>(rd()) << 32) | rd(), rd());
         }
+
+        RandomEngine(const std::uint64_t& seedValue, const std::uint64_t& stream=0)
+        {
+            seed(seedValue,stream);
+        }
+
+        void seed(const std::uint64_t& seedValue, const std::uint64_t& stream=0)
+        {
+            std::uint64_t x= seedValue;
+            std::uint64_t key= splitmix64(x) ^ stream;
+            for (auto& word : s)
+                word= splitmix64(key);
+        }
+
+        //! The 256-bit state of the engine, e.g. for checkpoints
+        const std::array<std::uint64_t,4>& state() const
+        {
+            return s;
+        }
+
+        void setState(const std::array<std::uint64_t,4>& state)
+        {
+            s= state;
+        }
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        result_type operator()()
+        {
+            const std::uint64_t result= rotl(s[1] * 5, 7) * 9;
+            const std::uint64_t t= s[1] << 17;
+            s[2]^= s[0];
+            s[3]^= s[1];
+            s[1]^= s[2];
+            s[0]^= s[3];
+            s[2]^= t;
+            s[3]= rotl(s[3], 45);
+            return result;
+        }
+
+        //! Uniformly distributed value in \f$[a,b]\f$ for integral T, and in \f$[a,b)\f$ for floating-point T
+        template<typename T>
+        T uniform(const T& a, const T& b)
+        {
+            if constexpr (std::is_integral_v<T>) {
+                const std::uint64_t range= static_cast<std::uint64_t>(b) - static_cast<std::uint64_t>(a) + 1;
+                if (range == 0) // the full 64-bit range
+                    return static_cast<T>(operator()());
+                std::uint64_t low;
+                std::uint64_t high= multiply(operator()(), range, low);
+                if (low < range) {
+                    const std::uint64_t threshold= -range % range;
+                    while (low < threshold)
+                        high= multiply(operator()(), range, low);
+                }
+                return static_cast<T>(static_cast<std::uint64_t>(a) + high);
+            }
+            else {
+                static_assert(std::is_floating_point_v<T>, "RandomEngine::uniform requires an arithmetic type.");
+                const double u= (operator()() >> 11) * 0x1.0p-53;
+                return a + static_cast<T>(u) * (b - a);
+            }
+        }
+    };
+
+    namespace RandomDetail
+    {
+        inline RandomEngine& threadEngine()
+        {
+            thread_local RandomEngine engine;
+            return engine;
+        }
+
+        inline RandomEngine*& activeEngine()
+        {
+            thread_local RandomEngine* engine= nullptr;
+            return engine;
+        }
+    }
+
+    /*!
+     * The engine used by random<T>() on the calling thread: the engine installed by
+     * the innermost ScopedRandomEngine, or otherwise a thread-local engine.
+     */
+    inline RandomEngine& randomEngine()
+    {
+        RandomEngine* active= RandomDetail::activeEngine();
+        return active ? *active : RandomDetail::threadEngine();
+    }
+
+    //! Seeds the calling thread's default engine
+    inline void seedRandom(const std::uint64_t& seed, const std::uint64_t& stream=0)
+    {
+        RandomDetail::threadEngine().seed(seed,stream);
+    }
+
+    /*!
+     * Installs \p engine as the calling thread's random engine for the lifetime of
+     * this object, so that draws made through random<T>() (e.g. inside an ensemble's
+     * sampleNewState) come from a walker's own stream.
+     */
+    class ScopedRandomEngine
+    {
+        RandomEngine* previous;
+    public:
+        explicit ScopedRandomEngine(RandomEngine& engine) : previous(RandomDetail::activeEngine())
+        {
+            RandomDetail::activeEngine()= &engine;
+        }
+        ~ScopedRandomEngine()
+        {
+            RandomDetail::activeEngine()= previous;
+        }
+        ScopedRandomEngine(const ScopedRandomEngine&) = delete;
+        ScopedRandomEngine& operator=(const ScopedRandomEngine&) = delete;
+    };
+
+    template<typename T>
+    T random(const T& a, const T& b) {
+        return randomEngine().uniform<T>(a,b);
     }
 }
 #endif //OILAB_RANDOM_H
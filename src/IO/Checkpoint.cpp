@@ -0,0 +1,71 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef gbLAB_Checkpoint_cpp_
+#define gbLAB_Checkpoint_cpp_
+
+#include <Checkpoint.h>
+#include <filesystem>
+#include <system_error>
+#include <fcntl.h>
+#ifdef _WIN32
+    #include <io.h>
+#else
+    #include <unistd.h>
+#endif
+
+namespace gbLAB
+{
+    namespace CheckpointDetail
+    {
+        //! Flushes the contents of the closed file \p filename to the disk
+        bool syncFile(const std::string& filename)
+        {
+#ifdef _WIN32
+            const int fd= ::_open(filename.c_str(),_O_WRONLY | _O_BINARY);
+            if (fd<0)
+                return false;
+            const bool synced= ::_commit(fd)==0;
+            return ::_close(fd)==0 && synced;
+#else
+            const int fd= ::open(filename.c_str(),O_WRONLY);
+            if (fd<0)
+                return false;
+            const bool synced= ::fsync(fd)==0;
+            return ::close(fd)==0 && synced;
+#endif
+        }
+    }
+
+    void CheckpointWriter::commit(const std::string& filename) const
+    {
+        const std::string temporary(filename+".tmp");
+        {
+            std::ofstream file(temporary,std::ios::binary | std::ios::trunc);
+            if (!file)
+                throw std::runtime_error("CheckpointWriter: cannot open "+temporary+".");
+
+            const std::uint64_t size= payload.size();
+            const std::uint32_t sum= CheckpointDetail::checksum(reinterpret_cast<const unsigned char*>(payload.data()),payload.size());
+            file.write(CheckpointDetail::magic,sizeof(CheckpointDetail::magic));
+            file.write(reinterpret_cast<const char*>(&CheckpointDetail::version),sizeof(CheckpointDetail::version));
+            file.write(reinterpret_cast<const char*>(&size),sizeof(size));
+            file.write(payload.data(),payload.size());
+            file.write(reinterpret_cast<const char*>(&sum),sizeof(sum));
+            file.close();
+            if (!file)
+                throw std::runtime_error("CheckpointWriter: cannot write to "+temporary+".");
+        }
+        if (!CheckpointDetail::syncFile(temporary))
+            throw std::runtime_error("CheckpointWriter: cannot flush "+temporary+".");
+
+        // unlike std::rename, replaces an existing target on Windows too
+        std::error_code error;
+        std::filesystem::rename(temporary,filename,error);
+        if (error)
+            throw std::runtime_error("CheckpointWriter: cannot rename "+temporary+" to "+filename+": "+error.message()+".");
+    }
+}
+#endif
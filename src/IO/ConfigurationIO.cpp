@@ -0,0 +1,362 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef gbLAB_ConfigurationIO_cpp_
+#define gbLAB_ConfigurationIO_cpp_
+
+#include <ConfigurationIO.h>
+#ifdef _WIN32
+    #include <iterator>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+#ifdef OILAB_USE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace gbLAB
+{
+    namespace ConfigurationDetail
+    {
+        std::string readFile(const std::string& filename)
+        {
+            std::ifstream file(filename,std::ios::binary | std::ios::ate);
+            if(!file)
+                throw std::runtime_error("Unable to open configuration file "+filename+".");
+            std::string content(static_cast<size_t>(file.tellg()),'\0');
+            file.seekg(0);
+            file.read(content.data(),content.size());
+            return content;
+        }
+    }
+
+    void writeExtendedXYZ(const std::string& filename, const Configuration& configuration)
+    {
+        using ConfigurationDetail::appendNumber;
+
+        std::ofstream file(filename,std::ios::binary);
+        if (!file)
+        {
+            OILAB_LOG(error,io) << "Unable to open file " << filename;
+            return;
+        }
+
+        std::string header;
+        appendNumber(header,static_cast<int>(configuration.size()));
+        header+= "\nLattice=\"";
+        for(int j=0; j<3; ++j)
+            for(int i=0; i<3; ++i)
+            {
+                header+= ' ';
+                appendNumber(header,configuration.box(i,j));
+            }
+        if(configuration.extended)
+        {
+            header+= "\" Properties=atom_types:I:1:pos:R:3:radius:R:1 PBC=\"";
+            for(int i=0; i<3; ++i)
+            {
+                header+= configuration.pbc[i]? 'T' : 'F';
+                header+= i<2? " " : "\"";
+            }
+            header+= " origin=\"";
+            for(int i=0; i<3; ++i)
+            {
+                header+= ' ';
+                appendNumber(header,configuration.origin(i));
+            }
+            header+= "\"\n";
+        }
+        else
+            header+= "\" Properties=atom_types:I:1:pos:R:3\n";
+        file.write(header.data(),header.size());
+
+        constexpr size_t chunkSize= 1<<14;
+        constexpr size_t chunksPerBatch= 64;
+        const size_t n= configuration.size();
+        const size_t numberOfChunks= (n+chunkSize-1)/chunkSize;
+        std::vector<std::string> chunks(chunksPerBatch);
+        for(size_t batch=0; batch<numberOfChunks; batch+= chunksPerBatch)
+        {
+            const size_t batchEnd= std::min(numberOfChunks,batch+chunksPerBatch);
+#pragma omp parallel for schedule(dynamic)
+            for(size_t c=batch; c<batchEnd; ++c)
+            {
+                std::string& chunk= chunks[c-batch];
+                chunk.clear();
+                chunk.reserve(64*chunkSize);
+                for(size_t a=c*chunkSize; a<std::min(n,(c+1)*chunkSize); ++a)
+                {
+                    const int type= configuration.types[a];
+                    appendNumber(chunk,type);
+                    for(int i=0; i<3; ++i)
+                    {
+                        chunk+= ' ';
+                        appendNumber(chunk,configuration.positions(i,a));
+                    }
+                    if(configuration.extended)
+                    {
+                        chunk+= "  ";
+                        appendNumber(chunk,configuration.radius(type));
+                    }
+                    chunk+= '\n';
+                }
+            }
+            for(size_t c=batch; c<batchEnd; ++c)
+                file.write(chunks[c-batch].data(),chunks[c-batch].size());
+        }
+    }
+
+    void writeBinaryConfiguration(const std::string& filename, const Configuration& configuration, const bool& compress)
+    {
+        ConfigurationDetail::Header header{};
+        std::memcpy(header.magic,ConfigurationDetail::magic,sizeof(header.magic));
+        header.version= ConfigurationDetail::version;
+        header.numberOfAtoms= configuration.size();
+        std::memcpy(header.box,configuration.box.data(),sizeof(header.box));
+        std::memcpy(header.origin,configuration.origin.data(),sizeof(header.origin));
+        std::copy(configuration.radii.begin(),configuration.radii.end(),header.radii);
+        for(int i=0; i<3; ++i)
+            header.pbc[i]= configuration.pbc[i];
+
+        const size_t positionBytes= 3*configuration.size()*sizeof(double);
+        const size_t typeBytes= configuration.size()*sizeof(std::int8_t);
+        std::vector<char> compressed;
+        if(compress)
+        {
+#ifdef OILAB_USE_ZSTD
+            std::vector<char> raw(positionBytes+typeBytes);
+            std::memcpy(raw.data(),configuration.positions.data(),positionBytes);
+            std::memcpy(raw.data()+positionBytes,configuration.types.data(),typeBytes);
+            compressed.resize(ZSTD_compressBound(raw.size()));
+            const size_t compressedSize= ZSTD_compress(compressed.data(),compressed.size(),raw.data(),raw.size(),3);
+            if(ZSTD_isError(compressedSize))
+                throw std::runtime_error("zstd compression of "+filename+" failed: "+ZSTD_getErrorName(compressedSize));
+            compressed.resize(compressedSize);
+            header.flags|= ConfigurationDetail::compressedFlag;
+            header.payloadSize= compressedSize;
+#else
+            throw std::runtime_error("Compressed configuration files require oILAB to be built with USE_ZSTD.");
+#endif
+        }
+        else
+            header.payloadSize= positionBytes+typeBytes;
+
+        std::ofstream file(filename,std::ios::binary);
+        if (!file)
+        {
+            OILAB_LOG(error,io) << "Unable to open file " << filename;
+            return;
+        }
+        file.write(reinterpret_cast<const char*>(&header),sizeof(header));
+        if(compress)
+            file.write(compressed.data(),compressed.size());
+        else
+        {
+            file.write(reinterpret_cast<const char*>(configuration.positions.data()),positionBytes);
+            file.write(reinterpret_cast<const char*>(configuration.types.data()),typeBytes);
+        }
+    }
+
+    void writeConfiguration(const std::string& filename,
+                            const Configuration& configuration,
+                            const ConfigurationFormat& format)
+    {
+        switch(format)
+        {
+            case ConfigurationFormat::xyz:
+                writeExtendedXYZ(filename,configuration);
+                break;
+            case ConfigurationFormat::binary:
+                writeBinaryConfiguration(filename,configuration,false);
+                break;
+            case ConfigurationFormat::compressedBinary:
+                writeBinaryConfiguration(filename,configuration,true);
+                break;
+        }
+    }
+
+    /**************************************************************************/
+    /**************************************************************************/
+    MappedConfiguration::MappedConfiguration(const std::string& filename) :
+    /* init */ map(nullptr)
+    /* init */,mapSize(0)
+    /* init */,positionData(nullptr)
+    /* init */,typeData(nullptr)
+    {
+        const char* data;
+#ifdef _WIN32
+        std::ifstream file(filename,std::ios::binary);
+        if(!file)
+            throw std::runtime_error("Unable to open configuration file "+filename+".");
+        fileData.assign(std::istreambuf_iterator<char>(file),std::istreambuf_iterator<char>());
+        mapSize= fileData.size();
+        if(mapSize<sizeof(header))
+            throw std::runtime_error(filename+" is not a binary configuration file.");
+        data= fileData.data();
+#else
+        const int fd= ::open(filename.c_str(),O_RDONLY);
+        if(fd<0)
+            throw std::runtime_error("Unable to open configuration file "+filename+".");
+        struct stat st;
+        if(fstat(fd,&st)!=0 || static_cast<size_t>(st.st_size)<sizeof(header))
+        {
+            ::close(fd);
+            throw std::runtime_error(filename+" is not a binary configuration file.");
+        }
+        mapSize= st.st_size;
+        map= mmap(nullptr,mapSize,PROT_READ,MAP_PRIVATE,fd,0);
+        ::close(fd);
+        if(map==MAP_FAILED)
+        {
+            map= nullptr;
+            throw std::runtime_error("Unable to map configuration file "+filename+".");
+        }
+        data= static_cast<const char*>(map);
+#endif
+
+        std::memcpy(&header,data,sizeof(header));
+        if(std::memcmp(header.magic,ConfigurationDetail::magic,sizeof(header.magic))!=0 ||
+           header.version!=ConfigurationDetail::version ||
+           sizeof(header)+header.payloadSize>mapSize)
+        {
+            release();
+            throw std::runtime_error(filename+" is not a valid binary configuration file.");
+        }
+
+        const char* payload= data+sizeof(header);
+        const size_t positionBytes= 3*header.numberOfAtoms*sizeof(double);
+        if(header.flags & ConfigurationDetail::compressedFlag)
+        {
+#ifdef OILAB_USE_ZSTD
+            decompressed.resize(positionBytes+header.numberOfAtoms);
+            const size_t size= ZSTD_decompress(decompressed.data(),decompressed.size(),payload,header.payloadSize);
+            if(ZSTD_isError(size) || size!=decompressed.size())
+            {
+                release();
+                throw std::runtime_error("zstd decompression of "+filename+" failed.");
+            }
+            payload= decompressed.data();
+#else
+            release();
+            throw std::runtime_error("Reading compressed configuration files requires oILAB to be built with USE_ZSTD.");
+#endif
+        }
+        else if(header.payloadSize!=positionBytes+header.numberOfAtoms)
+        {
+            release();
+            throw std::runtime_error(filename+" is truncated.");
+        }
+        positionData= reinterpret_cast<const double*>(payload);
+        typeData= reinterpret_cast<const std::int8_t*>(payload+positionBytes);
+    }
+
+    MappedConfiguration::~MappedConfiguration()
+    {
+        release();
+    }
+
+    void MappedConfiguration::release()
+    {
+#ifndef _WIN32
+        if(map!=nullptr)
+            munmap(map,mapSize);
+#endif
+        map= nullptr;
+        std::vector<char>().swap(fileData);
+    }
+
+    bool MappedConfiguration::isBinary(const std::string& filename)
+    {
+        char buffer[sizeof(ConfigurationDetail::magic)];
+        std::ifstream file(filename,std::ios::binary);
+        return file.read(buffer,sizeof(buffer)) &&
+               std::memcmp(buffer,ConfigurationDetail::magic,sizeof(buffer))==0;
+    }
+
+    Configuration MappedConfiguration::configuration() const
+    {
+        Configuration output(size());
+        output.box= box();
+        output.origin= origin();
+        for(int i=0; i<3; ++i)
+            output.pbc[i]= header.pbc[i];
+        std::copy(header.radii,header.radii+Configuration::maxTypes,output.radii.begin());
+        output.positions= positions();
+        std::copy(typeData,typeData+size(),output.types.begin());
+        return output;
+    }
+
+    /**************************************************************************/
+    /**************************************************************************/
+    Configuration readExtendedXYZ(const std::string& filename)
+    {
+        using namespace ConfigurationDetail;
+        const std::string content(readFile(filename));
+        const char* p= content.data();
+        const char* end= p+content.size();
+
+        size_t n;
+        if(!parseNumber(p,end,n))
+            throw std::runtime_error("Unable to read the number of atoms from "+filename+".");
+        p= std::find(p,end,'\n');
+        const char* lineEnd= std::find(std::min(p+1,end),end,'\n');
+        const std::string_view commentLine(p,lineEnd-p);
+
+        Configuration configuration(n);
+        if(const size_t pos= commentLine.find("Lattice=\""); pos!=std::string_view::npos)
+        {
+            const char* q= commentLine.data()+pos+9;
+            for(int k=0; k<9 && parseNumber(q,lineEnd,configuration.box(k%3,k/3)); ++k) {}
+        }
+        if(const size_t pos= commentLine.find("origin=\""); pos!=std::string_view::npos)
+        {
+            const char* q= commentLine.data()+pos+8;
+            for(int k=0; k<3 && parseNumber(q,lineEnd,configuration.origin(k)); ++k) {}
+        }
+        if(const size_t pos= commentLine.find("PBC=\""); pos!=std::string_view::npos)
+        {
+            const char* q= commentLine.data()+pos+5;
+            for(int k=0; k<3; ++k)
+            {
+                skipSpaces(q,lineEnd);
+                configuration.pbc[k]= q<lineEnd && *q=='T';
+                ++q;
+            }
+        }
+        else
+            configuration.extended= false;
+
+        p= lineEnd;
+        for(size_t a=0; a<n; ++a)
+        {
+            if(p<end) ++p;
+            lineEnd= std::find(p,end,'\n');
+            int type;
+            if(!parseNumber(p,lineEnd,type))
+                throw std::runtime_error("Unable to read atom "+std::to_string(a)+" from "+filename+".");
+            configuration.types[a]= type;
+            for(int i=0; i<3; ++i)
+                if(!parseNumber(p,lineEnd,configuration.positions(i,a)))
+                    throw std::runtime_error("Unable to read atom "+std::to_string(a)+" from "+filename+".");
+            double radius;
+            if(type>=0 && type<Configuration::maxTypes && parseNumber(p,lineEnd,radius))
+                configuration.radii[type]= radius;
+            p= lineEnd;
+        }
+        return configuration;
+    }
+
+    Configuration readConfiguration(const std::string& filename)
+    {
+        if(MappedConfiguration::isBinary(filename))
+            return MappedConfiguration(filename).configuration();
+        else
+            return readExtendedXYZ(filename);
+    }
+}
+#endif
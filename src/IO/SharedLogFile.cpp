@@ -0,0 +1,188 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef gbLAB_SharedLogFile_cpp_
+#define gbLAB_SharedLogFile_cpp_
+
+#include <SharedLogFile.h>
+#include <algorithm>
+#include <stdexcept>
+#ifdef _WIN32
+    #define NOMINMAX
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/file.h>
+    #include <sys/stat.h>
+#endif
+
+namespace gbLAB
+{
+#ifdef _WIN32
+    namespace
+    {
+        HANDLE fileHandle(const std::intptr_t& handle)
+        {
+            return reinterpret_cast<HANDLE>(handle);
+        }
+
+        OVERLAPPED overlapped(const std::uint64_t& offset)
+        {
+            OVERLAPPED output{};
+            output.Offset= static_cast<DWORD>(offset);
+            output.OffsetHigh= static_cast<DWORD>(offset >> 32);
+            return output;
+        }
+    }
+
+    SharedLogFile::Lock::Lock(const SharedLogFile& file, const bool& exclusive) :
+    /* init */ file(file)
+    {
+        OVERLAPPED o(overlapped(0));
+        if (!LockFileEx(fileHandle(file.handle),exclusive ? LOCKFILE_EXCLUSIVE_LOCK : 0,0,MAXDWORD,MAXDWORD,&o))
+            throw std::runtime_error("SharedLogFile: cannot lock "+file.filename+".");
+    }
+
+    SharedLogFile::Lock::~Lock()
+    {
+        OVERLAPPED o(overlapped(0));
+        UnlockFileEx(fileHandle(file.handle),0,MAXDWORD,MAXDWORD,&o);
+    }
+
+    SharedLogFile::SharedLogFile(const std::string& filename_in) :
+    /* init */ filename(filename_in)
+    {
+        const HANDLE h= CreateFileA(filename.c_str(),GENERIC_READ | GENERIC_WRITE,
+                                    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                    nullptr,OPEN_ALWAYS,FILE_ATTRIBUTE_NORMAL,nullptr);
+        if (h==INVALID_HANDLE_VALUE)
+            throw std::runtime_error("SharedLogFile: cannot open "+filename+".");
+        handle= reinterpret_cast<std::intptr_t>(h);
+    }
+
+    SharedLogFile::~SharedLogFile()
+    {
+        CloseHandle(fileHandle(handle));
+    }
+
+    std::uint64_t SharedLogFile::size() const
+    {
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(fileHandle(handle),&size))
+            throw std::runtime_error("SharedLogFile: cannot stat "+filename+".");
+        return size.QuadPart;
+    }
+
+    size_t SharedLogFile::read(const std::uint64_t& offset, void* data, const size_t& n) const
+    {
+        size_t bytesRead= 0;
+        while (bytesRead<n)
+        {
+            OVERLAPPED o(overlapped(offset+bytesRead));
+            DWORD count= 0;
+            const DWORD chunk= static_cast<DWORD>(std::min<size_t>(n-bytesRead,MAXDWORD));
+            if (!ReadFile(fileHandle(handle),static_cast<char*>(data)+bytesRead,chunk,&count,&o) || count==0)
+                break;
+            bytesRead+= count;
+        }
+        return bytesRead;
+    }
+
+    void SharedLogFile::append(const void* data, const size_t& n)
+    {
+        size_t written= 0;
+        while (written<n)
+        {
+            // the caller holds the exclusive lock, so the end of the file does not move
+            OVERLAPPED o(overlapped(size()));
+            DWORD count= 0;
+            const DWORD chunk= static_cast<DWORD>(std::min<size_t>(n-written,MAXDWORD));
+            if (!WriteFile(fileHandle(handle),static_cast<const char*>(data)+written,chunk,&count,&o))
+                throw std::runtime_error("SharedLogFile: cannot write to "+filename+".");
+            written+= count;
+        }
+    }
+
+    void SharedLogFile::truncate(const std::uint64_t& size)
+    {
+        LARGE_INTEGER position;
+        position.QuadPart= size;
+        if (!SetFilePointerEx(fileHandle(handle),position,nullptr,FILE_BEGIN) || !SetEndOfFile(fileHandle(handle)))
+            throw std::runtime_error("SharedLogFile: cannot truncate "+filename+".");
+    }
+#else
+    SharedLogFile::Lock::Lock(const SharedLogFile& file, const bool& exclusive) :
+    /* init */ file(file)
+    {
+        while (flock(file.handle,exclusive ? LOCK_EX : LOCK_SH)!=0)
+            if (errno!=EINTR)
+                throw std::runtime_error("SharedLogFile: cannot lock "+file.filename+".");
+    }
+
+    SharedLogFile::Lock::~Lock()
+    {
+        flock(file.handle,LOCK_UN);
+    }
+
+    SharedLogFile::SharedLogFile(const std::string& filename_in) :
+    /* init */ filename(filename_in)
+    /* init */,handle(::open(filename.c_str(),O_RDWR | O_CREAT | O_APPEND,0644))
+    {
+        if (handle<0)
+            throw std::runtime_error("SharedLogFile: cannot open "+filename+".");
+    }
+
+    SharedLogFile::~SharedLogFile()
+    {
+        ::close(handle);
+    }
+
+    std::uint64_t SharedLogFile::size() const
+    {
+        struct stat st;
+        if (fstat(handle,&st)!=0)
+            throw std::runtime_error("SharedLogFile: cannot stat "+filename+".");
+        return st.st_size;
+    }
+
+    size_t SharedLogFile::read(const std::uint64_t& offset, void* data, const size_t& n) const
+    {
+        size_t bytesRead= 0;
+        while (bytesRead<n)
+        {
+            const ssize_t count= ::pread(handle,static_cast<char*>(data)+bytesRead,n-bytesRead,offset+bytesRead);
+            if (count<0 && errno==EINTR) continue;
+            if (count<=0) break;
+            bytesRead+= count;
+        }
+        return bytesRead;
+    }
+
+    void SharedLogFile::append(const void* data, const size_t& n)
+    {
+        size_t written= 0;
+        while (written<n)
+        {
+            const ssize_t count= ::write(handle,static_cast<const char*>(data)+written,n-written);
+            if (count<0)
+            {
+                if (errno==EINTR) continue;
+                throw std::runtime_error("SharedLogFile: cannot write to "+filename+".");
+            }
+            written+= count;
+        }
+    }
+
+    void SharedLogFile::truncate(const std::uint64_t& size)
+    {
+        if (ftruncate(handle,size)!=0)
+            throw std::runtime_error("SharedLogFile: cannot truncate "+filename+".");
+    }
+#endif
+}
+#endif
@@ -8,6 +8,7 @@
 #define gbLAB_BiCrystal_cpp_
 
 #include <LatticeModule.h>
+#include <BoxEnumerator.h>
 #include <numbers>
 
 namespace gbLAB
@@ -87,6 +88,7 @@ namespace gbLAB
                                                                              const typename BiCrystal<dim>::MatrixDimI& N,
                                                                              const bool& useRLLL)
     {
+        OILAB_PROFILE_SCOPE("BiCrystal::getCSLBasis");
         // The transition matrix is T=P/sigma, where P=rm.integerMatrix is
         // an integer matrix and sigma=rm.sigma is an integer
         // The integer matrix P can be decomposed as P=X*D*Y using the Smith decomposition.
@@ -136,6 +138,7 @@ namespace gbLAB
                                    const typename BiCrystal<dim>::MatrixDimI& N,
                                    const bool& useRLLL)
     {
+        OILAB_PROFILE_SCOPE("BiCrystal::getDSCLBasis");
 
         const auto D1(A.latticeBasis*sd.matrixX().template cast<double>()*N.template cast<double>().inverse());
         const auto D2(B.latticeBasis*sd.matrixV().template cast<double>()*M.template cast<double>().inverse());
@@ -173,8 +176,66 @@ namespace gbLAB
     /* init */,Bp(B.latticeBasis*this->matrixV().template cast<double>())
     /* init */,LambdaA(getLambdaA(M,N))
     /* init */,LambdaB(getLambdaB(M,N))
+    /* init */,latticeTransitions(getTransitions(false))
+    /* init */,reciprocalTransitions(getTransitions(true))
     {
+        OILAB_PROFILE_COUNT("BiCrystal constructions",1);
 
+        verify();
+    }
+
+    catch(std::runtime_error& e)
+    {
+        OILAB_LOG(debug,bicrystal) << e.what();
+        throw(std::runtime_error("Bicrystal construction failed. "));
+    }
+
+    template <int dim>
+    BiCrystal<dim>::BiCrystal(const Lattice<dim>& A_in,
+              const Lattice<dim>& B_in,
+              const SmithDecomposition<dim>& sd,
+              const bool& useRLLL) try :
+    /* init */ RationalMatrix<dim>(A_in.reciprocalBasis.transpose()*B_in.latticeBasis)
+    /* init */,SmithDecomposition<dim>(checkSmithDecomposition(this->integerMatrix,sd))
+    /* init */,A(A_in)
+    /* init */,B(B_in)
+    /* init */,M(getM(*this,*this))
+    /* init */,N(getN(*this,*this))
+    /* init */,sigmaA(round(M.template cast<double>().determinant()))
+    /* init */,sigmaB(round(N.template cast<double>().determinant()))
+    /* init */,sigma(std::abs(sigmaA)==std::abs(sigmaB)? std::abs(sigmaA) : 0)
+    /* init */, csl(getCSLBasis (A,B,*this,M,N,useRLLL),MatrixDimD::Identity())
+    /* init */,dscl(getDSCLBasis(A,B,*this,M,N,useRLLL),MatrixDimD::Identity())
+    /* init */,Ap(A.latticeBasis*this->matrixX().template cast<double>())
+    /* init */,Bp(B.latticeBasis*this->matrixV().template cast<double>())
+    /* init */,LambdaA(getLambdaA(M,N))
+    /* init */,LambdaB(getLambdaB(M,N))
+    /* init */,latticeTransitions(getTransitions(false))
+    /* init */,reciprocalTransitions(getTransitions(true))
+    {
+        OILAB_PROFILE_COUNT("BiCrystal constructions",1);
+
+        verify();
+    }
+
+    catch(std::runtime_error& e)
+    {
+        OILAB_LOG(debug,bicrystal) << e.what();
+        throw(std::runtime_error("Bicrystal construction failed. "));
+    }
+
+    template <int dim>
+    const SmithDecomposition<dim>& BiCrystal<dim>::checkSmithDecomposition(const MatrixDimI& P,
+                                                                           const SmithDecomposition<dim>& sd)
+    {
+        if ((sd.matrixU()*P*sd.matrixV()-sd.matrixD()).squaredNorm()!=0)
+            throw std::runtime_error("The Smith decomposition is not that of the transition matrix.\n");
+        return sd;
+    }
+
+    template <int dim>
+    void BiCrystal<dim>::verify() const
+    {
         if(true)
         {//verify that CSL can be obtained as multiple of A and B
 
@@ -221,105 +282,176 @@ namespace gbLAB
 
     }
 
-    catch(std::runtime_error& e)
+    template<int dim>
+    int BiCrystal<dim>::latticeIndex(const Lattice<dim>& lattice) const
     {
-        std::cout << e.what() << std::endl;
-        throw(std::runtime_error("Bicrystal construction failed. "));
+        if(&lattice == &A)
+            return indexA;
+        else if(&lattice == &B)
+            return indexB;
+        else if(&lattice == &csl)
+            return indexC;
+        else if(&lattice == &dscl)
+            return indexD;
+        else
+            return -1;
     }
 
     template<int dim>
-    LatticeVector<dim> BiCrystal<dim>::getLatticeVectorInA(const LatticeVector<dim> &v) const
+    typename BiCrystal<dim>::TransitionTable BiCrystal<dim>::getTransitions(const bool& reciprocal) const
+    {
+        OILAB_PROFILE_SCOPE("BiCrystal::getTransitions");
+        const MatrixDimI& X= this->matrixX();
+        const MatrixDimI& V= this->matrixV();
+        const MatrixDimI adjX= MatrixDimIExt<IntScalarType,dim>::adjoint(X);
+        const MatrixDimI adjV= MatrixDimIExt<IntScalarType,dim>::adjoint(V);
+        const MatrixDimI adjM= MatrixDimIExt<IntScalarType,dim>::adjoint(M);
+        const MatrixDimI adjN= MatrixDimIExt<IntScalarType,dim>::adjoint(N);
+        const MatrixDimI I= MatrixDimI::Identity();
+
+        TransitionTable T;
+        if(!reciprocal)
+        {
+            T[indexA][indexA]= I;
+            T[indexC][indexA]= X*M;                 // U*M
+            T[indexB][indexB]= I;
+            T[indexC][indexB]= V*N;                 // V*N
+            T[indexA][indexC]= adjM*adjX;           // inv(M)*inv(U)
+            T[indexB][indexC]= adjN*adjV;           // inv(N)*inv(V)
+            T[indexC][indexC]= I;
+            T[indexD][indexC]= MatrixDimIExt<IntScalarType,dim>::adjoint(M*N);
+            T[indexA][indexD]= N*adjX;              // N*inv(U)
+            T[indexB][indexD]= M*adjV;              // M*inv(V)
+            T[indexC][indexD]= N*M;
+            T[indexD][indexD]= I;
+        }
+        else
+        {
+            T[indexA][indexA]= I;
+            T[indexB][indexA]= adjX.transpose()*adjM*N*V.transpose();   // U^-T*inv(M)*N*V^T
+            T[indexC][indexA]= adjX.transpose()*adjM;                   // U^-T*inv(M)
+            T[indexD][indexA]= adjX.transpose()*N;                      // U^-T*N
+            T[indexA][indexB]= adjV.transpose()*adjN*M*X.transpose();   // V^-T*inv(N)*M*U^T
+            T[indexB][indexB]= I;
+            T[indexC][indexB]= adjV.transpose()*adjN;                   // V^-T*inv(N)
+            T[indexD][indexB]= adjV.transpose()*M;                      // V^-T*M
+            T[indexA][indexC]= M*X.transpose();                         // M*U^T
+            T[indexB][indexC]= N*V.transpose();                         // N*V^T
+            T[indexC][indexC]= I;
+            T[indexD][indexC]= M*N;
+            T[indexA][indexD]= adjN*X.transpose();                      // inv(N)*U^T
+            T[indexB][indexD]= adjM*V.transpose();                      // inv(M)*V^T
+            T[indexC][indexD]= adjN*adjM;
+            T[indexD][indexD]= I;
+        }
+
+        // Each transition is a positive or negative multiple of the identity in Cartesian space.
+        // Fold the sign into the matrix so that converted vectors keep the orientation of their input.
+        const std::array<const Lattice<dim>*,4> lattices{&A,&B,&csl,&dscl};
+        for(int from=0; from<4; ++from)
+        {
+            for(int to=0; to<4; ++to)
+            {
+                if(!T[from][to] || from==to) continue;
+                const MatrixDimD& basisFrom(reciprocal ? lattices[from]->reciprocalBasis : lattices[from]->latticeBasis);
+                const MatrixDimD& basisTo(reciprocal ? lattices[to]->reciprocalBasis : lattices[to]->latticeBasis);
+                const MatrixDimD cartesianMap(basisTo*T[from][to]->template cast<double>()*basisFrom.inverse());
+                if(cartesianMap.trace()<0)
+                    *T[from][to]= -*T[from][to];
+            }
+        }
+        return T;
+    }
+
+    template<int dim>
+    const typename BiCrystal<dim>::MatrixDimI& BiCrystal<dim>::transitionMatrix(const Lattice<dim>& from,
+                                                                                 const Lattice<dim>& to) const
     {
-        VectorDimI integerCoordinates;
+        const int i= latticeIndex(from);
+        const int j= latticeIndex(to);
+        if(i<0 || j<0)
+            throw(std::runtime_error("The input lattices should be one of the four lattices of the bicrystal"));
+        if(!latticeTransitions[i][j])
+            throw(std::runtime_error("There is no integer transition between the input lattices"));
+        return *latticeTransitions[i][j];
+    }
 
+    template<int dim>
+    const typename BiCrystal<dim>::MatrixDimI& BiCrystal<dim>::reciprocalTransitionMatrix(const Lattice<dim>& from,
+                                                                                           const Lattice<dim>& to) const
+    {
+        const int i= latticeIndex(from);
+        const int j= latticeIndex(to);
+        if(i<0 || j<0)
+            throw(std::runtime_error("The input lattices should be one of the four lattices of the bicrystal"));
+        if(!reciprocalTransitions[i][j])
+            throw(std::runtime_error("There is no integer transition between the input reciprocal lattices"));
+        return *reciprocalTransitions[i][j];
+    }
+
+    template<int dim>
+    typename BiCrystal<dim>::MatrixDimXI BiCrystal<dim>::convertLatticeCoordinates(const MatrixDimXI& coordinates,
+                                                                                    const Lattice<dim>& from,
+                                                                                    const Lattice<dim>& to) const
+    {
+        return transitionMatrix(from,to)*coordinates;
+    }
+
+    template<int dim>
+    typename BiCrystal<dim>::MatrixDimXI BiCrystal<dim>::convertReciprocalLatticeCoordinates(const MatrixDimXI& coordinates,
+                                                                                              const Lattice<dim>& from,
+                                                                                              const Lattice<dim>& to) const
+    {
+        return reciprocalTransitionMatrix(from,to)*coordinates;
+    }
+
+    template<int dim>
+    LatticeVector<dim> BiCrystal<dim>::getLatticeVectorInA(const LatticeVector<dim> &v) const
+    {
         if(&(v.lattice) == &(this->A))
             return v;
         else if(&(v.lattice) == &(this->csl))
             // U*M*v
-            integerCoordinates= this->matrixX() * M * v;
+            return LatticeVector<dim>((*latticeTransitions[indexC][indexA]*v).eval(),A);
         else
             throw(std::runtime_error("The input lattice vector should belong "
                                      "to lattice A or the CSL"));
-        auto temp= LatticeVector<dim>(integerCoordinates,A);
-        if (temp.cartesian().dot(v.cartesian()) < 0) temp= -1*temp;
-        return temp;
     }
 
     template<int dim>
     LatticeVector<dim> BiCrystal<dim>::getLatticeVectorInB(const LatticeVector<dim> &v) const
     {
-        VectorDimI integerCoordinates;
-
         if(&(v.lattice) == &(this->B))
             return v;
         else if(&(v.lattice) == &(this->csl))
             // V*N*v
-            integerCoordinates= this->matrixV() * N * v;
+            return LatticeVector<dim>((*latticeTransitions[indexC][indexB]*v).eval(),B);
         else
             throw(std::runtime_error("The input lattice vector should belong "
                                      "to lattice B or the CSL"));
-        auto temp= LatticeVector<dim>(integerCoordinates,B);
-        if (temp.cartesian().dot(v.cartesian()) < 0) temp= -1*temp;
-        return temp;
     }
 
     template<int dim>
     LatticeVector<dim> BiCrystal<dim>::getLatticeVectorInD(const LatticeVector<dim> &v) const
     {
-        VectorDimI integerCoordinates;
-
-        MatrixDimI adjX= MatrixDimIExt<IntScalarType,dim>::adjoint(this->matrixX());
-        MatrixDimI adjV= MatrixDimIExt<IntScalarType,dim>::adjoint(this->matrixV());
-
-        if(&(v.lattice) == &(this->A))
-            // N*inv(U)*v
-            integerCoordinates = N * adjX * v;
-        else if(&(v.lattice) == &(this->B))
-            // M*inv(V)*v
-            integerCoordinates = M * adjV * v;
-        else if(&(v.lattice) == &(this->csl))
-            // N*M*v
-            integerCoordinates = N * M * v;
-        else if(&(v.lattice) == &(this->dscl))
+        if(&(v.lattice) == &(this->dscl))
             return LatticeVector<dim>(v);
-        else
+        const int from= latticeIndex(v.lattice);
+        if(from<0)
             throw(std::runtime_error("The input lattice vector should belong to one of the four lattices of the bicrystal"));
-
-        auto temp= LatticeVector<dim>(integerCoordinates,dscl);
-        if (temp.cartesian().dot(v.cartesian()) < 0) temp= -1*temp;
-
-        //return LatticeVector<dim>(integerCoordinates,dscl);
-        return temp;
+        return LatticeVector<dim>((*latticeTransitions[from][indexD]*v).eval(),dscl);
     }
 
 
     template<int dim>
     LatticeDirection<dim> BiCrystal<dim>::getLatticeDirectionInC(const LatticeVector<dim> &v) const
     {
-        VectorDimI integerCoordinates;
-
-        MatrixDimI adjX= MatrixDimIExt<IntScalarType,dim>::adjoint(this->matrixX());
-        MatrixDimI adjV= MatrixDimIExt<IntScalarType,dim>::adjoint(this->matrixV());
-        MatrixDimI adjM= MatrixDimIExt<IntScalarType,dim>::adjoint(M);
-        MatrixDimI adjN= MatrixDimIExt<IntScalarType,dim>::adjoint(N);
-        MatrixDimI adjMN= MatrixDimIExt<IntScalarType,dim>::adjoint(M*N);
-
-        if(&(v.lattice) == &(this->A))
-            // inv(M)*inv(U)*v
-            integerCoordinates = adjM * adjX * v;
-        else if(&(v.lattice) == &(this->B))
-            // inv(N)*inv(V)*v
-            integerCoordinates = adjN * adjV * v;
-        else if(&(v.lattice) == &(this->csl))
+        if(&(v.lattice) == &(this->csl))
             return LatticeDirection<dim>(v);
-        else if(&(v.lattice) == &(this->dscl))
-            integerCoordinates = adjMN* v;
-        else
+        const int from= latticeIndex(v.lattice);
+        if(from<0)
             throw(std::runtime_error("The input reciprocal lattice vector should belong to one of the four reciprocal lattices of the bicrystal"));
-
-        auto temp= LatticeVector<dim>(integerCoordinates,csl);
-        if (temp.cartesian().dot(v.cartesian()) < 0) temp= -1*temp;
-        return LatticeDirection<dim>(temp);
+        return LatticeDirection<dim>(LatticeVector<dim>((*latticeTransitions[from][indexC]*v).eval(),csl));
     }
     template<int dim>
     LatticeDirection<dim> BiCrystal<dim>::getLatticeDirectionInD(const LatticeVector<dim> &v) const
@@ -330,100 +462,40 @@ namespace gbLAB
     template<int dim>
     ReciprocalLatticeDirection<dim> BiCrystal<dim>::getReciprocalLatticeDirectionInA(const ReciprocalLatticeVector<dim>& rv) const
     {
-        VectorDimI integerCoordinates;
-
-        MatrixDimI adjX = MatrixDimIExt<IntScalarType, dim>::adjoint(this->matrixX());
-        MatrixDimI adjM= MatrixDimIExt<IntScalarType,dim>::adjoint(M);
-
         if(&(rv.lattice) == &(this->A))
             return ReciprocalLatticeDirection<dim>(rv);
-        else if(&(rv.lattice) == &(this->B))
-            // U^-T*inverse(M)*N*V^T
-            integerCoordinates= adjX.transpose() * adjM * N * (this->matrixV()).transpose() * rv;
-        else if(&(rv.lattice) == &(this->csl))
-            // U^-T*inverse(M)
-            integerCoordinates= adjX.transpose() * adjM * rv;
-        else if(&(rv.lattice) == &(this->dscl))
-            // U^-T*N*rv
-            integerCoordinates = adjX.transpose() * N * rv;
-        else
+        const int from= latticeIndex(rv.lattice);
+        if(from<0)
             throw(std::runtime_error("The input reciprocal lattice vector should belong to one of the four reciprocal lattices of the bicrystal"));
-
-        auto temp= ReciprocalLatticeVector<dim>(integerCoordinates,A);
-        if (temp.cartesian().dot(rv.cartesian()) < 0) temp= -1*temp;
-        return ReciprocalLatticeDirection<dim>(temp);
+        return ReciprocalLatticeDirection<dim>(ReciprocalLatticeVector<dim>((*reciprocalTransitions[from][indexA]*rv).eval(),A));
     }
     template<int dim>
     ReciprocalLatticeDirection<dim> BiCrystal<dim>::getReciprocalLatticeDirectionInB(const ReciprocalLatticeVector<dim>& rv) const
     {
-        VectorDimI integerCoordinates;
-
-        MatrixDimI adjX= MatrixDimIExt<IntScalarType,dim>::adjoint(this->matrixX());
-        MatrixDimI adjV= MatrixDimIExt<IntScalarType,dim>::adjoint(this->matrixV());
-        MatrixDimI adjM= MatrixDimIExt<IntScalarType,dim>::adjoint(M);
-        MatrixDimI adjN= MatrixDimIExt<IntScalarType,dim>::adjoint(N);
-
-        if(&(rv.lattice) == &(this->A))
-            // V^-T*inverse(N)*M*U^T
-            integerCoordinates= adjV.transpose() * adjN * M * (this->matrixX()).transpose() * rv;
-        else if(&(rv.lattice) == &(this->B))
+        if(&(rv.lattice) == &(this->B))
             return ReciprocalLatticeDirection<dim>(rv);
-        else if(&(rv.lattice) == &(this->csl))
-            // V^-T*inverse(N)*rv
-            integerCoordinates= adjV.transpose() * adjN * rv;
-        else if(&(rv.lattice) == &(this->dscl))
-            // V^-T*M*rv
-            integerCoordinates= adjV.transpose() * M * rv;
-        else
+        const int from= latticeIndex(rv.lattice);
+        if(from<0)
             throw(std::runtime_error("The input reciprocal lattice vector should belong to one of the four reciprocal lattices of the bicrystal"));
-
-        auto temp= ReciprocalLatticeVector<dim>(integerCoordinates,B);
-        if (temp.cartesian().dot(rv.cartesian()) < 0) temp= -1*temp;
-        return ReciprocalLatticeDirection<dim>(temp);
+        return ReciprocalLatticeDirection<dim>(ReciprocalLatticeVector<dim>((*reciprocalTransitions[from][indexB]*rv).eval(),B));
     }
     template<int dim>
     ReciprocalLatticeDirection<dim> BiCrystal<dim>::getReciprocalLatticeDirectionInC(const ReciprocalLatticeVector<dim>& rv) const
     {
-        VectorDimI integerCoordinates;
-
-        if(&(rv.lattice) == &(this->A))
-            // M*U^T*rv
-            integerCoordinates= M*this->matrixX().transpose()*rv;
-        else if(&(rv.lattice) == &(this->B))
-            // N*V^T*rv
-            integerCoordinates=  N*this->matrixV().transpose()*rv;
-        else if(&(rv.lattice) == &(this->csl))
+        if(&(rv.lattice) == &(this->csl))
             return ReciprocalLatticeDirection<dim>(rv);
-        else if(&(rv.lattice) == &(this->dscl))
-            // M*N*rv
-            integerCoordinates= M*N*rv;
-        else
+        const int from= latticeIndex(rv.lattice);
+        if(from<0)
             throw(std::runtime_error("The input reciprocal lattice vector should belong to one of the four reciprocal lattices of the bicrystal"));
-
-        auto temp= ReciprocalLatticeVector<dim>(integerCoordinates,csl);
-        if (temp.cartesian().dot(rv.cartesian()) < 0) temp= -1*temp;
-        return ReciprocalLatticeDirection<dim>(temp);
+        return ReciprocalLatticeDirection<dim>(ReciprocalLatticeVector<dim>((*reciprocalTransitions[from][indexC]*rv).eval(),csl));
     }
     template<int dim>
     ReciprocalLatticeDirection<dim> BiCrystal<dim>::getReciprocalLatticeDirectionInD(const ReciprocalLatticeVector<dim> &rv) const
     {
-        VectorDimI integerCoordinates;
-
-        MatrixDimI adjM= MatrixDimIExt<IntScalarType,dim>::adjoint(M);
-        MatrixDimI adjN= MatrixDimIExt<IntScalarType,dim>::adjoint(N);
-
-        if(&(rv.lattice) == &(this->A))
-            integerCoordinates= adjN * (this->matrixX().transpose()) * rv;
-        else if(&(rv.lattice) == &(this->B))
-            integerCoordinates= adjM * (this->matrixV().transpose()) * rv;
-        else if(&(rv.lattice) == &(this->csl))
-            integerCoordinates= adjN * adjM * rv;
-        else
+        const int from= latticeIndex(rv.lattice);
+        if(from<0 || from==indexD)
             throw(std::runtime_error("The input reciprocal lattice vector should belong to one of the four reciprocal lattices of the bicrystal"));
-
-        auto temp= ReciprocalLatticeVector<dim>(integerCoordinates,dscl);
-        if (temp.cartesian().dot(rv.cartesian()) < 0) temp= -1*temp;
-        return ReciprocalLatticeDirection<dim>(temp);
+        return ReciprocalLatticeDirection<dim>(ReciprocalLatticeVector<dim>((*reciprocalTransitions[from][indexD]*rv).eval(),dscl));
     }
 
     template<int dim>
@@ -469,9 +541,9 @@ namespace gbLAB
                     }
                     catch(std::runtime_error& e)
                     {
-                        std::cout << e.what() << std::endl;
-                        std::cout << "Unable to form GB with normal = " << rv << std::endl;
-                        std::cout << "moving on to next inclination" << std::endl;
+                        OILAB_LOG(info,bicrystal) << e.what() << "\n"
+                                                  << "Unable to form GB with normal = " << rv << "\n"
+                                                  << "moving on to next inclination";
                     }
                 }
             }
@@ -502,7 +574,8 @@ namespace gbLAB
                         const double& orthogonality,
                         const int& dsclFactor,
                         std::string filename,
-                        bool orient) const
+                        bool orient,
+                        const ConfigurationFormat& format) const
     {
         assert(orthogonality>=0.0 && orthogonality<=1.0 &&
                "The \"orthogonality\" parameter should be between 0.0 and 1.0");
@@ -585,9 +658,6 @@ namespace gbLAB
                && "Cannot orient the grain boundary. Box vectors are not orthogonal.");
 
 
-        std::vector<LatticeVector<dim>> configurationA, configurationB, configurationC, configurationD;
-        std::vector<LatticeVector<dim>> configuration;
-
         std::vector<LatticeVector<dim>> boxVectorsInA, boxVectorsInB, boxVectorsInD;
         // calculate boxVectors in A, B, and D
         for(const auto& boxVector : boxVectors) {
@@ -611,67 +681,58 @@ namespace gbLAB
         boxVectorsForC[0]=2*boxVectors[0];
         boxVectorsForD[0]=2*boxVectorsInD[0];
 
-        configurationA= A.box(boxVectorsForA);
-        configurationB= B.box(boxVectorsForB);
-        configurationC= csl.box(boxVectorsForC);
-        configurationD= dscl.box(boxVectorsForD);
-
-        LatticeVector<dim> origin(-1*boxVectors[0]);
-        for(auto& vector : configurationA)
-            vector= vector + LatticeVector<dim>(-1*boxVectorsInA[0]);
-        for(auto& vector : configurationB)
-            vector= vector + LatticeVector<dim>(-1*boxVectorsInB[0]);
-        for(auto& vector : configurationC)
-            vector= vector + origin;
-        for(auto& vector : configurationD)
-            vector= vector + LatticeVector<dim>(-1*boxVectorsInD[0]);
-
-        configuration= configurationA;
-        configuration.insert(configuration.end(),configurationB.begin(),configurationB.end());
-        configuration.insert(configuration.end(),configurationC.begin(),configurationC.end());
-        configuration.insert(configuration.end(),configurationD.begin(),configurationD.end());
+        // Generate the boxes of the four lattices into a single preallocated buffer, in which
+        // points of lattice k occupy [offsets[k],offsets[k+1]) and are tagged by their lattice.
+        const std::array<const Lattice<dim>*,4> lattices{&A,&B,&csl,&dscl};
+        const std::array<BoxEnumerator<dim>,4> boxEnumerators{BoxEnumerator<dim>(boxVectorsForA),
+                                                              BoxEnumerator<dim>(boxVectorsForB),
+                                                              BoxEnumerator<dim>(boxVectorsForC),
+                                                              BoxEnumerator<dim>(boxVectorsForD)};
+        const std::array<VectorDimI,4> origins{-1*boxVectorsInA[0],-1*boxVectorsInB[0],-1*boxVectors[0],-1*boxVectorsInD[0]};
+        std::array<size_t,5> offsets{0}, blockOffsets{0};
+        for(int k=0; k<4; ++k)
+        {
+            offsets[k+1]= offsets[k]+boxEnumerators[k].size();
+            blockOffsets[k+1]= blockOffsets[k]+boxEnumerators[k].outerSize();
+        }
 
-        if(!filename.empty()) {
-            std::ofstream file;
-            file.open(filename);
-            if (!file) std::cerr << "Unable to open file";
-            file << configuration.size() << std::endl;
-            file << "Lattice=\"";
-
-            if (dim==2) {
-                file << (rotation*boxVectorsForC[0].cartesian()).transpose() << " 0 ";
-                file << (rotation*boxVectorsForC[1].cartesian()).transpose() << " 0 ";
-                file << " 0 0 1 ";
-                file << "\" Properties=atom_types:I:1:pos:R:3:radius:R:1 PBC=\"F T T\" origin=\"";
-                file << (rotation*origin.cartesian()).transpose() << " 0.0\"" << std::endl;
-                for (const auto &vector: configurationA)
-                    file << 1 << " " << (rotation*vector.cartesian()).transpose() << " " << 0.0 << "  " << 0.05 << std::endl;
-                for (const auto &vector: configurationB)
-                    file << 2 << " " << (rotation*vector.cartesian()).transpose() << " " << 0.0 << "  " << 0.05 << std::endl;
-                for (const auto &vector: configurationC)
-                    file << 3 << " " << (rotation*vector.cartesian()).transpose() << " " << 0.0 << "  " << 0.2 << std::endl;
-                for (const auto &vector: configurationD)
-                    file << 4 << " " << (rotation*vector.cartesian()).transpose() << " " << 0.0 << "  " << 0.01 << std::endl;
-            }
-            else if (dim==3){
-                file << (rotation*boxVectorsForC[0].cartesian()).transpose()  << " ";
-                file << (rotation*boxVectorsForC[1].cartesian()).transpose() << " ";
-                file << (rotation*boxVectorsForC[2].cartesian()).transpose() << " ";
-                file << "\" Properties=atom_types:I:1:pos:R:3:radius:R:1 PBC=\"F T T\" origin=\"";
-                file << (rotation*origin.cartesian()).transpose() << "\"" << std::endl;
-
-                for (const auto &vector: configurationA)
-                    file << 1 << " " << (rotation*vector.cartesian()).transpose() << "  " << 0.05 << std::endl;
-                for (const auto &vector: configurationB)
-                    file << 2 << " " << (rotation*vector.cartesian()).transpose() << "  " << 0.05 << std::endl;
-                for (const auto &vector: configurationC)
-                    file << 3 << " " << (rotation*vector.cartesian()).transpose() << "  " << 0.2 << std::endl;
-                for (const auto &vector: configurationD)
-                    file << 4 << " " << (rotation*vector.cartesian()).transpose() << "  " << 0.01 << std::endl;
-            }
+        std::vector<LatticeVector<dim>> configuration;
+        configuration.reserve(offsets[4]);
+        for(int k=0; k<4; ++k)
+            configuration.insert(configuration.end(),boxEnumerators[k].size(),LatticeVector<dim>(*lattices[k]));
 
+        // blocks of all four lattices are generated concurrently
+#pragma omp parallel for schedule(dynamic,16)
+        for(size_t block=0; block<blockOffsets[4]; ++block)
+        {
+            int k= 0;
+            while(block>=blockOffsets[k+1]) ++k;
+            const IntScalarType n= block-blockOffsets[k];
+            size_t index= offsets[k]+n*boxEnumerators[k].blockSize();
+            const VectorDimI& origin(origins[k]);
+            auto storePoint= [&](const VectorDimI& x)
+            {
+                static_cast<VectorDimI&>(configuration[index++])= x+origin;
+            };
+            boxEnumerators[k].visitBlock(n,storePoint);
+        }
 
-            file.close();
+        if(!filename.empty()) {
+            // the box and positions are written in 3D, with a zero third coordinate in 2D
+            Configuration output(configuration.size());
+            for(int i=0; i<dim; ++i)
+                output.box.col(i).template head<dim>()= rotation*boxVectorsForC[i].cartesian();
+            output.origin.template head<dim>()= rotation*LatticeVector<dim>(-1*boxVectors[0]).cartesian();
+            output.positions.setZero();
+#pragma omp parallel for
+            for(size_t i=0; i<configuration.size(); ++i)
+            {
+                int k= 0;
+                while(i>=offsets[k+1]) ++k;
+                output.types[i]= k+1;
+                output.positions.col(i).template head<dim>()= rotation*configuration[i].cartesian();
+            }
+            writeConfiguration(filename,output,format);
         }
         return configuration;
     }
@@ -683,7 +744,8 @@ namespace gbLAB
     template std::vector<LatticeVector<2>>
             BiCrystal<2>::box<2>(std::vector<LatticeVector<2>> &boxVectors,
                                  const double &orthogonality, const int &dsclFactor,
-                                 std::string filename, bool orient) const;
+                                 std::string filename, bool orient,
+                                 const ConfigurationFormat& format) const;
 
     template class BiCrystal<3>;
     template std::map<BiCrystal<3>::IntScalarType, Gb<3>>
@@ -691,7 +753,8 @@ namespace gbLAB
     template std::vector<LatticeVector<3>>
     BiCrystal<3>::box<3>(std::vector<LatticeVector<3>> &boxVectors,
                          const double &orthogonality, const int &dsclFactor,
-                         std::string filename, bool orient) const;
+                         std::string filename, bool orient,
+                                 const ConfigurationFormat& format) const;
 
     template class BiCrystal<4>;
     template class BiCrystal<5>;
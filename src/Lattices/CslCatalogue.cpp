@@ -0,0 +1,271 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#ifndef gbLAB_CslCatalogue_cpp_
+#define gbLAB_CslCatalogue_cpp_
+
+#include <CslCatalogue.h>
+#include <algorithm>
+#include <numbers>
+#include <numeric>
+
+namespace gbLAB
+{
+    SmithDecomposition<3> CslCatalogueEntry::smithDecomposition(const MatrixDimI& P) const
+    {
+        return SmithDecomposition<3>(P,smithD.asDiagonal().toDenseMatrix(),smithU,smithV);
+    }
+
+    BiCrystal<3> CslCatalogueEntry::biCrystal(const Lattice<3>& A, const Lattice<3>& B, const bool& useRLLL) const
+    {
+        const RationalMatrix<3> rm(A.reciprocalBasis.transpose()*B.latticeBasis);
+        return BiCrystal<3>(A,B,smithDecomposition(rm.integerMatrix),useRLLL);
+    }
+
+    CslCatalogueEntry CslCatalogueEntry::fromBiCrystal(const BiCrystal<3>& bc, const VectorDimI& axis)
+    {
+        CslCatalogueEntry entry;
+        entry.axis= axis;
+        entry.sigma= bc.sigma;
+        entry.rotation= bc.B.latticeBasis*bc.A.latticeBasis.inverse();
+
+        const Eigen::AngleAxisd angleAxis(entry.rotation);
+        const ReciprocalLatticeVector<3> rA(axis,bc.A);
+        entry.angle= angleAxis.axis().dot(rA.cartesian())<0 ? 2*std::numbers::pi-angleAxis.angle() : angleAxis.angle();
+
+        entry.smithD= bc.matrixD().diagonal();
+        entry.smithU= bc.matrixU();
+        entry.smithV= bc.matrixV();
+        // C = A X M and A = D (N U), since the DSCL basis is A X N^{-1} and X = U^{-1}
+        entry.cslMatrix= bc.matrixX()*bc.M;
+        entry.dsclMatrix= bc.N*bc.matrixU();
+
+        const auto basis(bc.csl.planeParallelLatticeBasis(bc.getReciprocalLatticeDirectionInC(rA),true));
+        entry.gbPlaneBasis.col(0)= basis[1].latticeVector();
+        entry.gbPlaneBasis.col(1)= basis[2].latticeVector();
+        return entry;
+    }
+
+    void CslCatalogueEntry::write(BinaryWriter& writer) const
+    {
+        writer.write(axis);
+        writer.write(angle);
+        writer.write(sigma);
+        writer.write(rotation);
+        writer.write(smithD);
+        writer.write(smithU);
+        writer.write(smithV);
+        writer.write(cslMatrix);
+        writer.write(dsclMatrix);
+        writer.write(gbPlaneBasis);
+    }
+
+    void CslCatalogueEntry::read(BinaryReader& reader)
+    {
+        reader.read(axis);
+        reader.read(angle);
+        reader.read(sigma);
+        reader.read(rotation);
+        reader.read(smithD);
+        reader.read(smithU);
+        reader.read(smithV);
+        reader.read(cslMatrix);
+        reader.read(dsclMatrix);
+        reader.read(gbPlaneBasis);
+    }
+
+    /**************************************************************************/
+    /**************************************************************************/
+    Eigen::Matrix3d CslCatalogue::standardBasis(const std::string& name, const double& a, const double& c)
+    {
+        Eigen::Matrix3d basis;
+        if (name=="sc")
+            basis= a*Eigen::Matrix3d::Identity();
+        else if (name=="bcc")
+            basis << -0.5*a,  0.5*a,  0.5*a,
+                      0.5*a, -0.5*a,  0.5*a,
+                      0.5*a,  0.5*a, -0.5*a;
+        else if (name=="fcc")
+            basis << 0.0,   0.5*a, 0.5*a,
+                     0.5*a, 0.0,   0.5*a,
+                     0.5*a, 0.5*a, 0.0;
+        else if (name=="hcp")
+            basis << a,   -0.5*a,                    0.0,
+                     0.0,  0.5*std::sqrt(3.0)*a,     0.0,
+                     0.0,  0.0,                      c;
+        else
+            throw std::runtime_error("CslCatalogue: unknown lattice "+name+". Use sc, bcc, fcc or hcp.");
+        return basis;
+    }
+
+    CslCatalogue::CslCatalogue(const std::string& latticeName_in,
+                               const Eigen::Matrix3d& latticeBasis_in,
+                               const std::vector<VectorDimI>& axes,
+                               const int& maxSigma_in,
+                               const double& maxDen) :
+    /* init */ latticeName(latticeName_in)
+    /* init */,latticeBasis(latticeBasis_in)
+    /* init */,maxSigma(maxSigma_in)
+    {
+        const Lattice<3> A(latticeBasis);
+        std::set<Axis> done;
+        for (const auto& axis : axes)
+        {
+            const ReciprocalLatticeDirection<3> rd(ReciprocalLatticeVector<3>(axis,A));
+            const Axis k(key(rd.reciprocalLatticeVector()));
+            if (!done.insert(k).second)
+                continue;
+            const VectorDimI primitiveAxis(Eigen::Map<const VectorDimI>(k.data()));
+
+            for (const auto& rotation : A.generateCoincidentLattices(rd,maxDen))
+            {
+                if (rotation.isIdentity(FLT_EPSILON))
+                    continue;
+                try
+                {
+                    const Lattice<3> B(latticeBasis,rotation);
+                    const BiCrystal<3> bc(A,B,false);
+                    if (bc.sigma<1 || bc.sigma>maxSigma)
+                        continue;
+                    entries.push_back(CslCatalogueEntry::fromBiCrystal(bc,primitiveAxis));
+                }
+                catch(std::runtime_error& e)
+                {
+                    OILAB_LOG(debug,bicrystal) << "CslCatalogue: skipping a rotation about " << primitiveAxis.transpose()
+                                               << ". " << e.what();
+                }
+            }
+        }
+        index();
+    }
+
+    CslCatalogue::CslCatalogue(const std::string& filename)
+    {
+        CheckpointReader reader(filename);
+        reader.section("CslCatalogue");
+        const auto version(reader.read<std::uint32_t>());
+        if (version!=formatVersion)
+            throw std::runtime_error("CslCatalogue: unsupported format version "+std::to_string(version)+" of "+filename+".");
+        reader.read(latticeName);
+        reader.read(latticeBasis);
+        reader.read(maxSigma);
+        entries.resize(reader.read<std::uint64_t>());
+        for (auto& entry : entries)
+            entry.read(reader);
+        if (!reader.atEnd())
+            throw std::runtime_error("CslCatalogue: unexpected data at the end of "+filename+".");
+        index();
+    }
+
+    void CslCatalogue::write(const std::string& filename) const
+    {
+        CheckpointWriter writer;
+        writer.section("CslCatalogue");
+        writer.write(formatVersion);
+        writer.write(latticeName);
+        writer.write(latticeBasis);
+        writer.write(maxSigma);
+        writer.write(static_cast<std::uint64_t>(entries.size()));
+        for (const auto& entry : entries)
+            entry.write(writer);
+        writer.commit(filename);
+    }
+
+    std::vector<typename CslCatalogue::VectorDimI> CslCatalogue::axes(const int& maxIndex)
+    {
+        std::set<Axis> keys;
+        for (int i=-maxIndex; i<=maxIndex; ++i)
+            for (int j=-maxIndex; j<=maxIndex; ++j)
+                for (int k=-maxIndex; k<=maxIndex; ++k)
+                    if (i!=0 || j!=0 || k!=0)
+                        keys.insert(key(VectorDimI(i,j,k)));
+
+        std::vector<VectorDimI> output;
+        for (const auto& k : keys)
+            output.push_back(Eigen::Map<const VectorDimI>(k.data()));
+        return output;
+    }
+
+    std::vector<CslCatalogueEntry> CslCatalogue::byAxis(const VectorDimI& axis) const
+    {
+        std::vector<CslCatalogueEntry> output;
+        const Axis k(key(axis));
+        const auto iter= axisEntries.find(k);
+        if (iter!=axisEntries.end())
+        {
+            // axis is a negative multiple of the stored axis: a rotation by angle about the stored axis is a
+            // rotation by 2 pi - angle about axis
+            const bool flipped= Eigen::Map<const VectorDimI>(k.data()).dot(axis)<0;
+            for (const auto& e : iter->second)
+            {
+                output.push_back(entries[e]);
+                if (flipped)
+                {
+                    output.back().axis*= -1;
+                    output.back().angle= 2*std::numbers::pi-output.back().angle;
+                }
+            }
+            if (flipped)
+                std::reverse(output.begin(),output.end());
+        }
+        return output;
+    }
+
+    std::vector<const CslCatalogueEntry*> CslCatalogue::bySigma(const int& minSigma, const int& maxSigma) const
+    {
+        const auto first= std::partition_point(sigmaEntries.begin(),sigmaEntries.end(),
+                                               [&](const size_t& e){return entries[e].sigma<minSigma;});
+        std::vector<const CslCatalogueEntry*> output;
+        for (auto iter= first; iter!=sigmaEntries.end() && entries[*iter].sigma<=maxSigma; ++iter)
+            output.push_back(&entries[*iter]);
+        return output;
+    }
+
+    std::vector<CslCatalogueEntry> CslCatalogue::byAngle(const VectorDimI& axis,
+                                                         const double& minAngle,
+                                                         const double& maxAngle) const
+    {
+        std::vector<CslCatalogueEntry> output;
+        for (const auto& entry : byAxis(axis))
+            if (entry.angle>=minAngle && entry.angle<=maxAngle)
+                output.push_back(entry);
+        return output;
+    }
+
+    void CslCatalogue::index()
+    {
+        std::stable_sort(entries.begin(),entries.end(),[](const CslCatalogueEntry& e1, const CslCatalogueEntry& e2)
+                         {
+                             const Axis k1(key(e1.axis)), k2(key(e2.axis));
+                             return k1!=k2 ? k1<k2 : e1.angle<e2.angle;
+                         });
+        axisEntries.clear();
+        for (size_t e=0; e<entries.size(); ++e)
+            axisEntries[key(entries[e].axis)].push_back(e);
+
+        sigmaEntries.resize(entries.size());
+        std::iota(sigmaEntries.begin(),sigmaEntries.end(),0);
+        std::stable_sort(sigmaEntries.begin(),sigmaEntries.end(),
+                         [this](const size_t& e1, const size_t& e2){return entries[e1].sigma<entries[e2].sigma;});
+    }
+
+    typename CslCatalogue::Axis CslCatalogue::key(const VectorDimI& axis)
+    {
+        if (axis.isZero())
+            throw std::runtime_error("CslCatalogue: the zero vector is not an axis.");
+        VectorDimI primitive(axis/IntegerMath<IntScalarType>::gcd(axis));
+        for (int d=0; d<3; ++d)
+        {
+            if (primitive(d)!=0)
+            {
+                if (primitive(d)<0)
+                    primitive*= -1;
+                break;
+            }
+        }
+        return {primitive(0),primitive(1),primitive(2)};
+    }
+}
+#endif
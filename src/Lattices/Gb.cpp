@@ -22,7 +22,7 @@ namespace gbLAB
     }
     catch(std::runtime_error& e)
     {
-        std::cout << e.what() << std::endl;
+        OILAB_LOG(debug,gb) << e.what();
         throw(std::runtime_error("GB construction failed. "));
     }
 
@@ -59,7 +59,8 @@ namespace gbLAB
                  const double& orthogonality,
                  const int& dsclFactor,
                  std::string filename,
-                 bool orient) const
+                 bool orient,
+                 const ConfigurationFormat& format) const
     {
         for (auto iter= std::next(boxVectors.begin()); iter < boxVectors.end(); iter++)
             assert((*iter).dot(bc.getReciprocalLatticeDirectionInC(nA.reciprocalLatticeVector())) == 0 &&
@@ -95,53 +96,27 @@ namespace gbLAB
                && "Cannot orient the grain boundary. The GB plane box vectors are not orthogonal.");
 
         if(!filename.empty()) {
-            std::ofstream file;
-            file.open(filename);
-            if (!file) std::cerr << "Unable to open file";
-            file << configuration.size() << std::endl;
-            file << "Lattice=\"";
-
-            LatticeVector<dim> origin(-1*boxVectors[0]);
-            if (dim == 2) {
-                file << (rotation * 2 * boxVectors[0].cartesian()).transpose() << " 0 ";
-                file << (rotation * boxVectors[1].cartesian()).transpose() << " 0 ";
-                file << " 0 0 1 ";
-                file << "\" Properties=atom_types:I:1:pos:R:3:radius:R:1 PBC=\"F T T\" origin=\"";
-                file << (rotation * origin.cartesian()).transpose() << " 0.0\"" << std::endl;
-                for (const auto &vector: configuration)
-                    if (&(vector.lattice) == &bc.A)
-                        file << 1 << " " << (rotation * vector.cartesian()).transpose() << " " << 0.0 << "  "
-                             << 0.05 << std::endl;
-                    else if (&(vector.lattice) == &bc.B)
-                        file << 2 << " " << (rotation * vector.cartesian()).transpose() << " " << 0.0 << "  "
-                             << 0.05 << std::endl;
-                    else if (&(vector.lattice) == &bc.csl)
-                        file << 3 << " " << (rotation * vector.cartesian()).transpose() << " " << 0.0 << "  " << 0.2
-                             << std::endl;
-                    else
-                        file << 4 << " " << (rotation * vector.cartesian()).transpose() << " " << 0.0 << "  "
-                             << 0.01 << std::endl;
-            } else if (dim == 3) {
-                file << (rotation * 2 * boxVectors[0].cartesian()).transpose() << " ";
-                file << (rotation * boxVectors[1].cartesian()).transpose() << " ";
-                file << (rotation * boxVectors[2].cartesian()).transpose() << " ";
-                file << "\" Properties=atom_types:I:1:pos:R:3:radius:R:1 PBC=\"F T T\" origin=\"";
-                file << (rotation * origin.cartesian()).transpose() << "\"" << std::endl;
-
-                for (const auto &vector: configuration)
-                    if (&(vector.lattice) == &bc.A)
-                        file << 1 << " " << (rotation * vector.cartesian()).transpose() << "  " << 0.05
-                             << std::endl;
-                    else if (&(vector.lattice) == &bc.B)
-                        file << 2 << " " << (rotation * vector.cartesian()).transpose() << "  " << 0.05
-                             << std::endl;
-                    else if (&(vector.lattice) == &bc.csl)
-                        file << 3 << " " << (rotation * vector.cartesian()).transpose() << "  " << 0.2 << std::endl;
-                    else
-                        file << 4 << " " << (rotation * vector.cartesian()).transpose() << "  " << 0.01
-                             << std::endl;
+            // the box and positions are written in 3D, with a zero third coordinate in 2D
+            Configuration output(configuration.size());
+            output.box.col(0).template head<dim>()= rotation * 2 * boxVectors[0].cartesian();
+            for(int i=1; i<dim; ++i)
+                output.box.col(i).template head<dim>()= rotation * boxVectors[i].cartesian();
+            output.origin.template head<dim>()= rotation * LatticeVector<dim>(-1*boxVectors[0]).cartesian();
+            output.positions.setZero();
+            for(size_t i=0; i<configuration.size(); ++i)
+            {
+                const LatticeVector<dim>& vector(configuration[i]);
+                if (&(vector.lattice) == &bc.A)
+                    output.types[i]= 1;
+                else if (&(vector.lattice) == &bc.B)
+                    output.types[i]= 2;
+                else if (&(vector.lattice) == &bc.csl)
+                    output.types[i]= 3;
+                else
+                    output.types[i]= 4;
+                output.positions.col(i).template head<dim>()= rotation * vector.cartesian();
             }
-            file.close();
+            writeConfiguration(filename,output,format);
         }
         return configuration;
     }
@@ -240,7 +215,8 @@ namespace gbLAB
                                                       const double& orthogonality,
                                                       const int& dsclFactor,
                                                       std::string filename,
-                                                      bool orient) const;
+                                                      bool orient,
+                                                      const ConfigurationFormat& format) const;
 
     template class Gb<3>;
     template LatticeVector<3> Gb<3>::getPeriodVector<3>(const ReciprocalLatticeVector<3> &axis) const;
@@ -248,7 +224,8 @@ namespace gbLAB
                                                          const double& orthogonality,
                                                          const int& dsclFactor,
                                                          std::string filename,
-                                                         bool orient) const;
+                                                         bool orient,
+                                                         const ConfigurationFormat& format) const;
 
     template class Gb<4>;
     template class Gb<5>;
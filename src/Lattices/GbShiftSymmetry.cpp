@@ -0,0 +1,208 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+#include <GbShiftSymmetry.h>
+#include <RLLL.h>
+#include <array>
+#include <set>
+
+namespace gbLAB
+{
+    namespace GbShiftSymmetryDetail
+    {
+        const double tolerance= 1e-6;
+
+        template<typename MatrixType>
+        bool isInteger(const MatrixType& m)
+        {
+            return (m-m.array().round().matrix()).cwiseAbs().maxCoeff()<tolerance;
+        }
+    }
+
+    template<int dim>
+    std::vector<typename GbShiftSymmetry<dim>::MatrixDimD> GbShiftSymmetry<dim>::pointGroup(const Lattice<dim>& lattice)
+    {
+        using namespace GbShiftSymmetryDetail;
+
+        // the images of the vectors of a reduced basis are lattice vectors of the same lengths
+        const MatrixDimD reducedBasis(RLLL(lattice.latticeBasis,0.75).reducedBasis());
+        const MatrixDimD gram(reducedBasis.transpose()*reducedBasis);
+        std::array<std::vector<VectorDimD>,dim> candidates;
+        for(int i=0; i<dim; ++i)
+        {
+            const double length= reducedBasis.col(i).norm();
+            for(const auto& point : lattice.ballPoints(length*(1.0+tolerance)))
+                if(std::abs(point.cartesian().norm()-length)<tolerance*length)
+                    candidates[i].push_back(point.cartesian());
+        }
+
+        std::vector<MatrixDimD> output;
+        output.push_back(MatrixDimD::Identity());
+        std::array<size_t,dim> index;
+        index.fill(0);
+        while(true)
+        {
+            MatrixDimD images;
+            for(int i=0; i<dim; ++i)
+                images.col(i)= candidates[i][index[i]];
+            if((images.transpose()*images-gram).norm()<tolerance*gram.norm())
+            {
+                const MatrixDimD R(images*reducedBasis.inverse());
+                if((R-MatrixDimD::Identity()).norm()>tolerance)
+                    output.push_back(R);
+            }
+
+            int i= 0;
+            while(i<dim && ++index[i]==candidates[i].size())
+            {
+                index[i]= 0;
+                ++i;
+            }
+            if(i==dim) break;
+        }
+        return output;
+    }
+
+    template<int dim>
+    std::vector<std::vector<int>> GbShiftSymmetry<dim>::getPermutations(const GbShifts<dim>& gbs,
+                                                                        const std::vector<LatticeVector<dim>>& cellVectors,
+                                                                        std::vector<MatrixDimD>& rotations)
+    {
+        using namespace GbShiftSymmetryDetail;
+        const auto& bc(gbs.gb.bc);
+        const auto& pairs(gbs.bShiftPairs);
+        const VectorDimD normal(gbs.gb.nA.cartesian().normalized());
+
+        if(cellVectors.size()!=dim)
+            throw std::runtime_error("GbShiftSymmetry: the number of cell vectors should be equal to the dimension.");
+        MatrixDimD cell;
+        for(int i=0; i<dim; ++i)
+            cell.col(i)= cellVectors[i].cartesian();
+        const MatrixDimD cellInverse(cell.inverse());
+
+        Eigen::Matrix<double,dim,dim-1> gbCslBasis;
+        for(int i=0; i<dim-1; ++i)
+            gbCslBasis.col(i)= gbs.gbCslVectors[i].cartesian();
+        const Eigen::Matrix<double,dim-1,dim> gbCslBasisInverse(gbCslBasis.completeOrthogonalDecomposition().pseudoInverse());
+
+        // shifts are defined modulo the GB CSL vectors
+        auto equivalentShifts= [&](const VectorDimD& s1, const VectorDimD& s2)
+        {
+            const VectorDimD d(s1-s2);
+            return std::abs(d.dot(normal))<tolerance && isInteger((gbCslBasisInverse*d).eval());
+        };
+
+        // CSL translations in the GB plane
+        std::vector<VectorDimD> translations(1,VectorDimD::Zero());
+        for(const auto& [b,s] : pairs)
+        {
+            if((b.array()!=0).any())
+                continue;
+            bool isNew= true;
+            for(const auto& t : translations)
+                isNew= isNew && !equivalentShifts(s,t);
+            if(isNew)
+                translations.push_back(s);
+        }
+
+        std::vector<std::vector<int>> output;
+        std::set<std::vector<int>> uniquePermutations;
+        for(const auto& R : pointGroup(bc.A))
+        {
+            if((R*normal-normal).norm()>tolerance ||
+               !isInteger((bc.B.reciprocalBasis.transpose()*R*bc.B.latticeBasis).eval()) ||
+               !isInteger((cellInverse*R*cell).eval()))
+                continue;
+
+            // pair i is mapped to the pair with b=Rb_i and s=Rs_i+t, if there is one
+            auto getPermutation= [&](const VectorDimD& t, std::vector<int>& permutation)
+            {
+                std::vector<bool> used(pairs.size(),false);
+                for(size_t i=0; i<pairs.size(); ++i)
+                {
+                    const VectorDimD bImage(gbs.gb.T.reciprocalBasis.transpose()*R*pairs[i].first.cartesian());
+                    if(!isInteger(bImage))
+                        return false;
+                    const VectorDimD sImage(R*pairs[i].second+t);
+                    for(size_t j=0; j<pairs.size() && permutation[i]<0; ++j)
+                    {
+                        if(!used[j] &&
+                           (pairs[j].first.template cast<double>()-bImage).cwiseAbs().maxCoeff()<0.5 &&
+                           equivalentShifts(pairs[j].second,sImage))
+                        {
+                            permutation[i]= j;
+                            used[j]= true;
+                        }
+                    }
+                    if(permutation[i]<0)
+                        return false;
+                }
+                return true;
+            };
+
+            std::vector<std::vector<int>> rotationPermutations;
+            for(const auto& t : translations)
+            {
+                std::vector<int> permutation(pairs.size(),-1);
+                if(!getPermutation(t,permutation))
+                    break;
+                rotationPermutations.push_back(permutation);
+            }
+            if(rotationPermutations.size()!=translations.size())
+            {
+                OILAB_LOG(debug,gb) << "GbShiftSymmetry: rotation\n" << R << "\ndoes not map the (b,s) pairs onto themselves";
+                continue;
+            }
+
+            rotations.push_back(R);
+            for(const auto& permutation : rotationPermutations)
+                if(uniquePermutations.insert(permutation).second)
+                    output.push_back(permutation);
+        }
+        OILAB_LOG(info,gb) << "GbShiftSymmetry: " << rotations.size() << " rotations, "
+                           << translations.size() << " translations, "
+                           << output.size() << " distinct permutations of " << pairs.size() << " (b,s) pairs";
+        return output;
+    }
+
+    template<int dim>
+    GbShiftSymmetry<dim>::GbShiftSymmetry(const GbShifts<dim>& gbs, const std::vector<LatticeVector<dim>>& cellVectors) :
+    /* init */ permutations(getPermutations(gbs,cellVectors,rotations))
+    {}
+
+    template<int dim>
+    XTuplet GbShiftSymmetry<dim>::apply(const size_t& g, const XTuplet& constraints) const
+    {
+        const auto& permutation(permutations.at(g));
+        assert(permutation.size()==constraints.size());
+        XTuplet output(constraints.size());
+        for(size_t i=0; i<permutation.size(); ++i)
+            output(permutation[i])= constraints(i);
+        return output;
+    }
+
+    template<int dim>
+    std::pair<XTuplet,int> GbShiftSymmetry<dim>::canonicalForm(const XTuplet& constraints) const
+    {
+        std::set<XTuplet> admissibleImages;
+        for(size_t g=0; g<permutations.size(); ++g)
+        {
+            XTuplet image(apply(g,constraints));
+            if(image.size()==0 || image(0)==1)
+                admissibleImages.insert(image);
+        }
+        if(admissibleImages.empty())
+            return std::make_pair(constraints,0);
+        return std::make_pair(*admissibleImages.begin(),static_cast<int>(admissibleImages.size()));
+    }
+
+    template<int dim>
+    size_t GbShiftSymmetry<dim>::size() const
+    {
+        return permutations.size();
+    }
+
+    template class GbShiftSymmetry<3>;
+}
@@ -3,6 +3,9 @@
 //
 #include <GbShifts.h>
 #include <randomInteger.h>
+#include <Log.h>
+#include <BoxEnumerator.h>
+#include <algorithm>
 
 namespace gbLAB
 {
@@ -16,22 +19,23 @@ namespace gbLAB
             gbCslVectors(gbCslVectors),
             bShiftPairs(getbShiftPairs(gb,gbCslVectors,bhalfMax))
     {
-        std::cout << "--------------------GBShifts class construction ---------------------------" << std::endl;
-        std::cout << "GB CSL vectors = " << std::endl;
-        for(const auto& elem : gbCslVectors)
-            std::cout << elem.cartesian().transpose() << std::endl;
-        std::cout << std::endl;
-
-        std::cout << "GB reciprocal CSL vectors = " << std::endl;
         Eigen::Matrix<double,dim,dim-1> gbCslBasis;
         for(int i=0; i<dim-1; ++i)
             gbCslBasis.col(i)= gbCslVectors[i].cartesian();
         Eigen::Matrix<double,dim,dim-1> gbCslReciprocalBasis= gbCslBasis.completeOrthogonalDecomposition().pseudoInverse().transpose();
-        std::cout << gbCslReciprocalBasis.transpose() << std::endl;
-        std::cout << std::endl;
 
-        std::cout << "Maximum b < " << 2*bhalfMax*gb.bc.A.latticeBasis.col(0).norm() << std::endl;
-        std::cout << std::endl;
+        if(OILAB_LOG_ENABLED(info,gb))
+        {
+            std::ostringstream message;
+            message << "GBShifts construction\n";
+            message << "GB CSL vectors =\n";
+            for(const auto& elem : gbCslVectors)
+                message << elem.cartesian().transpose() << "\n";
+            message << "GB reciprocal CSL vectors =\n";
+            message << gbCslReciprocalBasis.transpose() << "\n";
+            message << "Maximum b < " << 2*bhalfMax*gb.bc.A.latticeBasis.col(0).norm();
+            OILAB_LOG(info,gb) << message.str();
+        }
 
         VectorDimD normal;
         if (dim==3)
@@ -39,25 +43,21 @@ namespace gbLAB
         else
             normal= gbCslVectors[0].cross().cartesian().normalized();
 
-        std::cout << "Exploring the following translation-shift pairs:" << std::endl;
+        OILAB_LOG(debug,gb) << "Exploring " << bShiftPairs.size() << " translation-shift pairs";
         for(const auto& [b,s]: bShiftPairs)
         {
-            std::cout << "b = " << b.cartesian().transpose();
-            std::cout << "; s = " << s.transpose() << std::endl;
+            OILAB_LOG(debug,gb) << "b = " << b.cartesian().transpose() << "; s = " << s.transpose();
             //if (abs(s.dot(normal)) > FLT_EPSILON)
             if (abs(s.dot(normal)) > 1e-6)
                 throw std::runtime_error("GBShifts construction failed - shifts are not parallel to the GB.");
 
             Eigen::MatrixXd shiftCoordinates= gbCslReciprocalBasis.transpose()*s;
             if( (shiftCoordinates.array() < -FLT_EPSILON).any() || (shiftCoordinates.array() > 1+FLT_EPSILON).any()) {
-                std::cout << "Shift coordinates = " << shiftCoordinates.transpose() << std::endl;
+                OILAB_LOG(debug,gb) << "Shift coordinates = " << shiftCoordinates.transpose();
                 throw std::runtime_error("GB shifts are not in the area spanned by the GB CSL vectors.");
             }
 
         }
-        std::cout << "----------------------------" << std::endl;
-        std::cout << std::endl;
-
     }
 
     template<int dim>
@@ -78,6 +78,15 @@ namespace gbLAB
         cslSubLatticeVectors.push_back(gbCslVectors[1]);
         auto cslPoints= gb.bc.csl.box(cslSubLatticeVectors);
 
+        // only those CSL points on the boundary are used as shift origins
+        typename BiCrystal<dim>::MatrixDimXI cslCoordinates(dim,cslPoints.size());
+        for(size_t i=0; i<cslPoints.size(); ++i)
+            cslCoordinates.col(i)= cslPoints[i];
+        const auto heightsInA= (gb.nA.reciprocalLatticeVector().transpose()*gb.bc.convertLatticeCoordinates(cslCoordinates,gb.bc.csl,gb.bc.A)).eval();
+        std::vector<LatticeVector<dim>> gbCslPoints;
+        for(size_t i=0; i<cslPoints.size(); ++i)
+            if (heightsInA(i)==0) gbCslPoints.push_back(cslPoints[i]);
+
         // form a T lattice cell for exploring translations
         auto nT= gb.getReciprocalLatticeDirectionInT(gb.bc.getReciprocalLatticeDirectionInD(gb.nA.reciprocalLatticeVector()).reciprocalLatticeVector());
         auto planeParallelBasisT= gb.T.planeParallelLatticeBasis(nT,true);
@@ -92,27 +101,40 @@ namespace gbLAB
             factor= (factor>0 ? factor : 1);
             latticeVectorsT.push_back(factor * planeParallelBasisT[i].latticeVector());
         }
-        auto points= gb.T.box(latticeVectorsT,"T.txt");
-
-
+        // T points in the ball |b| <= bhalfMax*latticeConstant that lie in the cell spanned by latticeVectorsT.
+        // They are ordered as the points of the cell box, so that the order of the pairs (and hence the
+        // meaning of mesostate signatures) does not depend on the enumeration.
         VectorDimD shiftT, shiftC;
         shiftT << -0.5, -0.5, -0.5;
         shiftC << -0.5, -FLT_EPSILON, -FLT_EPSILON;
-        for(auto& point : points) {
-            //if (point.cartesian().norm() > bhalfMax*gb.bc.A.latticeBasis.col(0).norm())
-            //    continue;
-            LatticeVector<dim>::modulo(point, latticeVectorsT, shiftT);
-            if (point.cartesian().norm() > bhalfMax*gb.bc.A.latticeBasis.col(0).norm())
-                continue;
+        const BoxEnumerator<dim> cellEnumerator(latticeVectorsT);
+        std::vector<std::pair<VectorDimI,LatticeVector<dim>>> sortedPoints;
+        for(const auto& point : gb.T.ballPoints(bhalfMax*latticeConstant))
+        {
+            LatticeVector<dim> cellPoint(point);
+            LatticeVector<dim>::modulo(cellPoint, latticeVectorsT, shiftT);
+            if(static_cast<const VectorDimI&>(cellPoint)==static_cast<const VectorDimI&>(point))
+                sortedPoints.emplace_back(cellEnumerator.indices(point),point);
+        }
+        std::sort(sortedPoints.begin(),sortedPoints.end(),[](const auto& a, const auto& b){
+            return std::lexicographical_compare(a.first.begin(),a.first.end(),b.first.begin(),b.first.end());
+        });
+
+        std::vector<std::vector<std::pair<LatticeVector<dim>, VectorDimD>>> pointPairs(sortedPoints.size());
+#pragma omp parallel for
+        for(size_t i=0; i<sortedPoints.size(); ++i)
+        {
+            const LatticeVector<dim>& point(sortedPoints[i].second);
             auto cslShift = LatticeVector<dim>((gb.bc.LambdaA * gb.basisT * point).eval(), gb.bc.dscl);
-            for(const auto& cslPoint : cslPoints) {
-                // only for those CSL points on the boundary
-                if (gb.bc.getLatticeVectorInA(cslPoint).dot(gb.nA)!=0) continue;
+            pointPairs[i].reserve(gbCslPoints.size());
+            for(const auto& cslPoint : gbCslPoints) {
                 VectorDimD cslShiftCentered = cslShift.cartesian() + cslPoint.cartesian() - point.cartesian() / 2;
                 LatticeVector<dim>::modulo(cslShiftCentered, cslSubLatticeVectors, shiftC);
-                output.push_back(std::make_pair(point, cslShiftCentered));
+                pointPairs[i].push_back(std::make_pair(point, cslShiftCentered));
             }
         }
+        for(const auto& pairs : pointPairs)
+            output.insert(output.end(),pairs.begin(),pairs.end());
         return output;
     }
     /*
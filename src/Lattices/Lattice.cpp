@@ -11,6 +11,8 @@
 
 #include <LatticeModule.h>
 #include <GramMatrix.h>
+#include <BoxEnumerator.h>
+#include <BallEnumerator.h>
 #include <iomanip>
 
 namespace gbLAB
@@ -69,10 +71,10 @@ namespace gbLAB
         const double crossNorm(sqrt(G.determinant()));
         if(crossNorm>tol)
         {
-            std::cout<<"input direction="<<d.normalized().transpose()<<std::endl;
-            std::cout<<"lattice direction="<<temp.cartesian().normalized().transpose()<<std::endl;
-            std::cout<<"cross product norm="<<std::setprecision(15)<<std::scientific<<crossNorm<<std::endl;
-            std::cout<<"tolerance="<<std::setprecision(15)<<std::scientific<<tol<<std::endl;
+            OILAB_LOG(debug,lattice) << "input direction="<<d.normalized().transpose() << "\n"
+                                     << "lattice direction="<<temp.cartesian().normalized().transpose() << "\n"
+                                     << "cross product norm="<<std::setprecision(15)<<std::scientific<<crossNorm << "\n"
+                                     << "tolerance="<<std::setprecision(15)<<std::scientific<<tol;
             throw std::runtime_error("LATTICE DIRECTION NOT FOUND\n");
         }
         return LatticeDirection<dim>(temp);
@@ -96,10 +98,10 @@ namespace gbLAB
         const double crossNorm(sqrt(abs(G.determinant())));
         if(crossNorm>tol)
         {
-            std::cout<<"input direction="<<std::setprecision(15)<<std::scientific<<d.normalized().transpose()<<std::endl;
-            std::cout<<"reciprocal lattice direction="<<std::setprecision(15)<<std::scientific<<temp.cartesian().normalized().transpose()<<std::endl;
-            std::cout<<"cross product norm="<<std::setprecision(15)<<std::scientific<<crossNorm<<std::endl;
-            std::cout<<"tolerance="<<std::setprecision(15)<<std::scientific<<tol<<std::endl;
+            OILAB_LOG(debug,lattice) << "input direction="<<std::setprecision(15)<<std::scientific<<d.normalized().transpose() << "\n"
+                                     << "reciprocal lattice direction="<<std::setprecision(15)<<std::scientific<<temp.cartesian().normalized().transpose() << "\n"
+                                     << "cross product norm="<<std::setprecision(15)<<std::scientific<<crossNorm << "\n"
+                                     << "tolerance="<<std::setprecision(15)<<std::scientific<<tol;
             throw std::runtime_error("RECIPROCAL LATTICE DIRECTION NOT FOUND\n");
         }
         return ReciprocalLatticeDirection<dim>(temp);
@@ -118,10 +120,10 @@ namespace gbLAB
         const RationalLatticeDirection<dim> rld(rat, ld);
         if ((rld.cartesian() - d).squaredNorm() > magnitudeTol)
         {
-            std::cout << "input vector=" << d.transpose() << std::endl;
-            std::cout << "lattice direction=" << ld.cartesian().transpose() << std::endl;
-            std::cout << "rational=" << rat << std::endl;
-            std::cout << "d.norm()/ld.cartesian().norm()=" << d.norm() / ld.latticeVector().norm() << std::endl;
+            OILAB_LOG(debug,lattice) << "input vector=" << d.transpose() << "\n"
+                                     << "lattice direction=" << ld.cartesian().transpose() << "\n"
+                                     << "rational=" << rat << "\n"
+                                     << "d.norm()/ld.cartesian().norm()=" << d.norm() / ld.latticeVector().norm();
             throw std::runtime_error("Rational Lattice DirectionType NOT FOUND\n");
         }
         return rld;
@@ -141,10 +143,10 @@ namespace gbLAB
         const RationalReciprocalLatticeDirection<dim> rrld(rat, rld);
         if ((rrld.cartesian() - d).squaredNorm() > magnitudeTol)
         {
-            std::cout << "input reciprocal vector=" << d.transpose() << std::endl;
-            std::cout << "reciprocal lattice direction=" << rld.cartesian().transpose() << std::endl;
-            std::cout << "rational=" << rat << std::endl;
-            std::cout << "d.norm()/rld.cartesian().norm()=" << d.norm() / rld.reciprocalLatticeVector().norm() << std::endl;
+            OILAB_LOG(debug,lattice) << "input reciprocal vector=" << d.transpose() << "\n"
+                                     << "reciprocal lattice direction=" << rld.cartesian().transpose() << "\n"
+                                     << "rational=" << rat << "\n"
+                                     << "d.norm()/rld.cartesian().norm()=" << d.norm() / rld.reciprocalLatticeVector().norm();
             throw std::runtime_error("Rational Reciprocal Lattice DirectionType NOT FOUND\n");
         }
         return rrld;
@@ -444,7 +446,7 @@ namespace gbLAB
 
                             output.push_back( F );
                             numberOfConfigurations++;
-                            std::cout << numberOfConfigurations << std::endl;
+                            OILAB_LOG(trace,lattice) << "coincident configuration " << numberOfConfigurations;
                             if (numberOfConfigurations == maxConfigurations)
                                 return output;
                         }
@@ -462,206 +464,158 @@ namespace gbLAB
         return output;
     }
 
-    template<int dim> template<int dm>
-    typename std::enable_if<dm==3,std::vector<LatticeVector<dim>>>::type
-    Lattice<dim>::box(const std::vector<LatticeVector<dim>>& boxVectors, const std::string& filename) const
+    template<int dim>
+    void Lattice<dim>::forEachBoxPoint(const std::vector<LatticeVector<dim>>& boxVectors,
+                                       const std::function<void(const LatticeVector<dim>&)>& visitor) const
     {
-        for(const LatticeVector<dim>& boxVector : boxVectors)
+        for([[maybe_unused]] const LatticeVector<dim>& boxVector : boxVectors)
         {
             assert(this == &boxVector.lattice && "Box vectors belong to different lattice.");
         }
 
-        // Form the box lattice
-        MatrixDimD C;
-        for (int i=0; i<dim; ++i) {
-            C.col(i) = boxVectors[i].cartesian();
-        }
-        assert(C.determinant() != 0);
-        Lattice<dim> boxLattice(C);
-
-        auto planeParallelBasis= planeParallelLatticeBasis(boxVectors[1].cross(boxVectors[2]),true);
-        MatrixDimD A;
-        MatrixDimI mat;
-        for(int i=0; i<dim; ++i) {
-            A.col(i) = planeParallelBasis[i].cartesian();
-            mat.col(i)=planeParallelBasis[i].latticeVector();
-        }
-
-        // l - lattice with plane parallel basis, where the second and third basis vectors
-        //     lie on the plane spanned by boxVectors[1] and boxVectors[2]
-        Lattice<dim> l(A);
-
-        // Form plane parallel vectors v1 and v2
-        // v1 is along boxVector[1]
-        LatticeDirection<dim> v1(MatrixDimIExt<IntScalarType,dim>::adjoint(mat)*boxVectors[1],l);
-        assert(v1.latticeVector()(0)==0);
-        IntScalarType x,y;
-        IntegerMath<IntScalarType>::extended_gcd(v1.latticeVector()(1),-v1.latticeVector()(2),x,y);
-        LatticeVector<dim> temp(l);
-        temp << 0,y,x;
-        LatticeDirection<dim> v2(temp);
-
-        int areaRatio= round((boxLattice.latticeBasis.col(1).cross(boxLattice.latticeBasis.col(2))).norm()/
-                             (l.latticeBasis.col(1).cross(l.latticeBasis.col(2))).norm());
-        int scale1= abs(IntegerMath<IntScalarType>::gcd(boxVectors[1]));
-        int scale2= round(areaRatio/scale1);
-        int scale0= round(abs(C.determinant()/latticeBasis.determinant()/areaRatio));
-
-        std::vector<LatticeVector<dim>> output;
+        const BoxEnumerator<dim> boxEnumerator(boxVectors);
+        LatticeVector<dim> point(*this);
+        auto visitPoint= [&](const VectorDimI& x)
+        {
+            static_cast<VectorDimI&>(point)= x;
+            visitor(point);
+        };
+        for(IntScalarType n=0; n<boxEnumerator.outerSize(); ++n)
+            boxEnumerator.visitBlock(n,visitPoint);
+    }
 
-        // r0, r1, and r2 are reciprocal vectors perpendicular to areas spanned by boxVectors[0],
-        // boxVectors[1], and boxVectors[2]
-        ReciprocalLatticeVector<dim> r0_temp(*this), r1_temp(*this), r2_temp(*this);
-        r0_temp= (boxVectors[1].cross(boxVectors[2])).reciprocalLatticeVector();
-        if (r0_temp.dot(boxVectors[0]) < 0)
-            r0_temp=-1*r0_temp;
-        r1_temp= (boxVectors[2].cross(boxVectors[0])).reciprocalLatticeVector();
-        if (r1_temp.dot(boxVectors[1]) < 0)
-            r1_temp=-1*r1_temp;
-        r2_temp= (boxVectors[0].cross(boxVectors[1])).reciprocalLatticeVector();
-        if (r2_temp.dot(boxVectors[2]) < 0)
-            r2_temp=-1*r2_temp;
-        assert(r0_temp.dot(boxVectors[1])==0 && r0_temp.dot(boxVectors[2])==0);
-        assert(r1_temp.dot(boxVectors[0])==0 && r1_temp.dot(boxVectors[2])==0);
-        assert(r2_temp.dot(boxVectors[0])==0 && r2_temp.dot(boxVectors[1])==0);
-        ReciprocalLatticeDirection<dim> r0(r0_temp), r1(r1_temp), r2(r2_temp);
-
-        for(int i=0; i<scale0; ++i)
+    template<int dim>
+    std::vector<LatticeVector<dim>> Lattice<dim>::boxPoints(const std::vector<LatticeVector<dim>>& boxVectors) const
+    {
+        OILAB_PROFILE_SCOPE("Lattice::boxPoints");
+        for([[maybe_unused]] const LatticeVector<dim>& boxVector : boxVectors)
         {
-            for(int j=0; j<scale1; ++j)
-            {
-                for(int k=0; k<scale2; ++k) {
-                    LatticeVector<dim> vectorIn_l(l);
-                    vectorIn_l << i, 0, 0;
-                    vectorIn_l= vectorIn_l + j*v1.latticeVector()+k*v2.latticeVector();
-                    //LatticeVector<dim> vector(latticeVector(vectorIn_l.cartesian()));
-                    LatticeVector<dim> vector((mat*vectorIn_l).eval(),*this);
-                    //LatticeDirection<dim> v1(MatrixDimIExt<IntScalarType,dim>::adjoint(mat)*boxVectors[1],l);
-
-                    int c0= IntegerMath<IntScalarType>::positive_modulo(vector.dot(r0),boxVectors[0].dot(r0)) -
-                            vector.dot(r0);
-                    c0= c0/boxVectors[0].dot(r0);
-                    int c1= IntegerMath<IntScalarType>::positive_modulo(vector.dot(r1),boxVectors[1].dot(r1)) -
-                            vector.dot(r1);
-                    c1= c1/boxVectors[1].dot(r1);
-                    int c2= IntegerMath<IntScalarType>::positive_modulo(vector.dot(r2),boxVectors[2].dot(r2)) -
-                            vector.dot(r2);
-                    c2= c2/boxVectors[2].dot(r2);
-                    vector= vector+c0*boxVectors[0]+c1*boxVectors[1]+c2*boxVectors[2];
-                    output.push_back(vector);
-                }
-            }
+            assert(this == &boxVector.lattice && "Box vectors belong to different lattice.");
         }
 
-        if(!filename.empty()) {
-            std::ofstream file;
-            file.open(filename);
-            if (!file) std::cerr << "Unable to open file";
-            file << output.size() << std::endl;
-            file << "Lattice=\"";
+        const BoxEnumerator<dim> boxEnumerator(boxVectors);
+        std::vector<LatticeVector<dim>> output(boxEnumerator.size(),LatticeVector<dim>(*this));
+        const IntScalarType outerSize= boxEnumerator.outerSize();
+        const IntScalarType blockSize= boxEnumerator.blockSize();
 
-            for(const auto& vector:boxVectors) {
-                file << vector.cartesian().transpose() << " ";
-            }
-            file << "\" Properties=atom_types:I:1:pos:R:3" << std::endl;
-
-            for (const auto &vector: output)
-                file << 1 << " " << vector.cartesian().transpose() << std::endl;
-
-            file.close();
+#pragma omp parallel for schedule(static)
+        for(IntScalarType n=0; n<outerSize; ++n)
+        {
+            size_t index= n*blockSize;
+            auto storePoint= [&](const VectorDimI& x)
+            {
+                static_cast<VectorDimI&>(output[index++])= x;
+            };
+            boxEnumerator.visitBlock(n,storePoint);
         }
         return output;
     }
 
-
-    template<int dim> template<int dm>
-    typename std::enable_if<dm==2,std::vector<LatticeVector<dim>>>::type
-    Lattice<dim>::box(const std::vector<LatticeVector<dim>>& boxVectors, const std::string& filename) const
+    template<int dim>
+    Eigen::Matrix<typename Lattice<dim>::IntScalarType,dim,Eigen::Dynamic>
+    Lattice<dim>::boxCoordinates(const std::vector<LatticeVector<dim>>& boxVectors) const
     {
-        for(const LatticeVector<dim>& boxVector : boxVectors)
+        OILAB_PROFILE_SCOPE("Lattice::boxCoordinates");
+        for([[maybe_unused]] const LatticeVector<dim>& boxVector : boxVectors)
         {
             assert(this == &boxVector.lattice && "Box vectors belong to different lattice.");
         }
 
-        // Form the box lattice
-        MatrixDimD C;
-        for (int i=0; i<dim; ++i) {
-            C.col(i) = boxVectors[i].cartesian();
-        }
-        assert(C.determinant() != 0);
-        Lattice<dim> boxLattice(C);
-
-        // Form plane parallel vectors v0 and v1
-        //LatticeDirection<dim> v0(this->latticeDirection(boxVectors[0].cartesian()));
-        LatticeDirection<dim> v0(
-                (VectorDimI) boxVectors[0]/IntegerMath<IntScalarType>::gcd(boxVectors[0]),
-                *this);
+        const BoxEnumerator<dim> boxEnumerator(boxVectors);
+        Eigen::Matrix<IntScalarType,dim,Eigen::Dynamic> output(dim,boxEnumerator.size());
+        const IntScalarType outerSize= boxEnumerator.outerSize();
+        const IntScalarType blockSize= boxEnumerator.blockSize();
 
-        ReciprocalLatticeVector<dim> temp(*this);
-        temp << v0.latticeVector()(1),-v0.latticeVector()(0);
-        LatticeDirection<dim> v1(planeParallelLatticeBasis(temp,true)[0]);
+#pragma omp parallel for schedule(static)
+        for(IntScalarType n=0; n<outerSize; ++n)
+        {
+            Eigen::Index index= n*blockSize;
+            auto storePoint= [&](const VectorDimI& x)
+            {
+                output.col(index++)= x;
+            };
+            boxEnumerator.visitBlock(n,storePoint);
+        }
+        return output;
+    }
 
-        /*
-        IntScalarType x,y;
-        IntegerMath<IntScalarType>::extended_gcd(v0.latticeVector()(0),-v0.latticeVector()(1),x,y);
-        LatticeVector<dim> temp(*this);
-        temp << y,x;
+    template<int dim>
+    std::vector<LatticeVector<dim>> Lattice<dim>::ballPoints(const double& radius) const
+    {
+        OILAB_PROFILE_SCOPE("Lattice::ballPoints");
+        const BallEnumerator<dim> ballEnumerator(latticeBasis,radius*(1.0+FLT_EPSILON));
+        std::vector<LatticeVector<dim>> output;
+        auto storePoint= [&](const VectorDimI& x)
+        {
+            LatticeVector<dim> point(x,*this);
+            if(point.cartesian().norm()<=radius)
+                output.push_back(point);
+        };
+        ballEnumerator.visit(storePoint);
+        return output;
+    }
 
-        LatticeDirection<dim> v1(temp);
+    namespace LatticeDetail
+    {
+        /*! Configuration (box, origin at zero, type-1 atoms) of lattice points bounded by \p boxVectors.
+         *  In 2D, the third box vector is the unit z vector. The box is periodic, and its extended-XYZ
+         *  file has no PBC, origin or radius (see Configuration::extended).
          */
+        template<int dim>
+        Configuration boxConfiguration(const std::vector<LatticeVector<dim>>& boxVectors,
+                                       const std::vector<LatticeVector<dim>>& points)
+        {
+            Configuration configuration(points.size());
+            configuration.box.setIdentity();
+            configuration.pbc= {true,true,true};
+            configuration.extended= false;
+            for(int i=0; i<dim; ++i)
+                configuration.box.col(i).template head<dim>()= boxVectors[i].cartesian();
+            configuration.positions.setZero();
+#pragma omp parallel for
+            for(size_t a=0; a<points.size(); ++a)
+                configuration.positions.col(a).template head<dim>()= points[a].cartesian();
+            return configuration;
+        }
+    }
 
-        int areaRatio= round(abs(boxLattice.latticeBasis.determinant()/
-                                 (*this).latticeBasis.determinant()));
-
-        int scale1= abs(IntegerMath<IntScalarType>::gcd(boxVectors[0]));
-        int scale2= round(areaRatio/scale1);
+    template<int dim> template<int dm>
+    typename std::enable_if<dm==3,std::vector<LatticeVector<dim>>>::type
+    Lattice<dim>::box(const std::vector<LatticeVector<dim>>& boxVectors, const std::string& filename,
+                      const ConfigurationFormat& format) const
+    {
+        for([[maybe_unused]] const LatticeVector<dim>& boxVector : boxVectors)
+        {
+            assert(this == &boxVector.lattice && "Box vectors belong to different lattice.");
+        }
 
-        std::vector<LatticeVector<dim>> output;
+        std::vector<LatticeVector<dim>> output(boxPoints(boxVectors));
 
-        // r0 and r1 are reciprocal vectors perpendicular to boxVectors[1] and boxVectors[0], respectively.
-        ReciprocalLatticeVector<dim> r1_temp(*this), r0_temp(*this);
-        r1_temp << boxVectors[0](1),-boxVectors[0](0);
-        if (r1_temp.dot(boxVectors[1]) < 0)
-            r1_temp=-1*r1_temp;
-        r0_temp << boxVectors[1](1),-boxVectors[1](0);
-        if (r0_temp.dot(boxVectors[0]) < 0)
-            r0_temp=-1*r0_temp;
-        assert(r1_temp.dot(boxVectors[0])==0);
-        assert(r0_temp.dot(boxVectors[1])==0);
-        ReciprocalLatticeDirection<dim> r1(r1_temp), r0(r0_temp);
-
-        for(int j=0; j<scale1; ++j)
+        if(!filename.empty())
         {
-            for(int k=0; k<scale2; ++k) {
-                LatticeVector<dim> vector(j*v0.latticeVector()+k*v1.latticeVector());
-                int c1= IntegerMath<IntScalarType>::positive_modulo(vector.dot(r1),boxVectors[1].dot(r1)) -
-                        vector.dot(r1);
-                c1= c1/boxVectors[1].dot(r1);
-                int c2= IntegerMath<IntScalarType>::positive_modulo(vector.dot(r0),boxVectors[0].dot(r0)) -
-                        vector.dot(r0);
-                c2= c2/boxVectors[0].dot(r0);
-                vector= vector+c1*boxVectors[1]+c2*boxVectors[0];
-                output.push_back(vector);
-            }
+            OILAB_PROFILE_SCOPE("Lattice::box write");
+            writeConfiguration(filename,LatticeDetail::boxConfiguration(boxVectors,output),format);
         }
+        return output;
+    }
 
-        if(!filename.empty()) {
-            std::ofstream file;
-            file.open(filename);
-            if (!file) std::cerr << "Unable to open file";
-            file << output.size() << std::endl;
-            file << "Lattice=\"";
 
-            for(const auto& vector:boxVectors) {
-                file << vector.cartesian().transpose() << " 0 ";
-            }
-            file << " 0 0 1 ";
-            file << "\" Properties=atom_types:I:1:pos:R:3" << std::endl;
+    template<int dim> template<int dm>
+    typename std::enable_if<dm==2,std::vector<LatticeVector<dim>>>::type
+    Lattice<dim>::box(const std::vector<LatticeVector<dim>>& boxVectors, const std::string& filename,
+                      const ConfigurationFormat& format) const
+    {
+        for([[maybe_unused]] const LatticeVector<dim>& boxVector : boxVectors)
+        {
+            assert(this == &boxVector.lattice && "Box vectors belong to different lattice.");
+        }
 
-            for (const auto &vector: output)
-                file << 1 << " " << vector.cartesian().transpose() << " 0 " << std::endl;
+        std::vector<LatticeVector<dim>> output(boxPoints(boxVectors));
 
-            file.close();
+        if(!filename.empty())
+        {
+            OILAB_PROFILE_SCOPE("Lattice::box write");
+            writeConfiguration(filename,LatticeDetail::boxConfiguration(boxVectors,output),format);
         }
         return output;
     }
@@ -675,14 +629,16 @@ namespace gbLAB
     template std::vector<typename Lattice<2>::MatrixDimD> Lattice<2>::generateCoincidentLattices<2>(
             const Lattice<2> &undeformedLattice, const double &maxStrain, const int &maxDen, const int &N) const;
     template std::vector<LatticeVector<2>> Lattice<2>::box<2>(const std::vector<LatticeVector<2>> &boxVectors,
-                                                           const std::string &filename) const;
+                                                           const std::string &filename,
+                                                              const ConfigurationFormat& format) const;
 
 
     template class Lattice<3>;
     template std::vector<typename Lattice<3>::MatrixDimD> Lattice<3>::generateCoincidentLattices<3>(
             const ReciprocalLatticeDirection<3> &rd, const double &maxDen, const int& N) const;
     template std::vector<LatticeVector<3>> Lattice<3>::box<3>(const std::vector<LatticeVector<3>> &boxVectors,
-                                                              const std::string &filename) const;
+                                                              const std::string &filename,
+                                                              const ConfigurationFormat& format) const;
 
     template class Lattice<4>;
     template class Lattice<5>;
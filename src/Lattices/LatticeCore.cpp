@@ -8,6 +8,7 @@
 #define gbLAB_LatticeCore_cpp_
 
 #include <LatticeCore.h>
+#include <Log.h>
 #include <BestRationalApproximation.h>
 #include <Eigen/Dense>
 
@@ -58,9 +59,9 @@ typename LatticeCore<dim>::VectorDimI LatticeCore<dim>::integerCoordinates(const
     const VectorDimD rd(nd.array().round());
     if ((nd - rd).norm() > roundTol)
     {
-        std::cout << "nd=" << nd.transpose() << std::endl;
-        std::cout << "rd=" << rd.transpose() << std::endl;
-        std::cout << "rounding error = |nd-rd| = " << (nd-rd).norm() << std::endl;
+        OILAB_LOG(debug,lattice) << "nd=" << nd.transpose() << "\n"
+                                 << "rd=" << rd.transpose() << "\n"
+                                 << "rounding error = |nd-rd| = " << (nd-rd).norm();
         throw(std::runtime_error("Input vector is not a lattice vector"));
     }
     return rd.template cast<IntScalarType>();
@@ -137,10 +137,10 @@ namespace gbLAB
         const IntScalarType h(std::lround(hd));
         if (fabs(hd - h) > FLT_EPSILON)
         {
-            std::cout << "P=" << P.transpose() << std::endl;
-            std::cout << "r=" << this->cartesian().transpose() << std::endl;
-            std::cout << "hd=" << std::setprecision(15) << std::scientific << hd << std::endl;
-            std::cout << "h=" << h << std::endl;
+            OILAB_LOG(error,lattice) << "P=" << P.transpose() << "\n"
+                                     << "r=" << this->cartesian().transpose() << "\n"
+                                     << "hd=" << std::setprecision(15) << std::scientific << hd << "\n"
+                                     << "h=" << h;
             assert(0 && "P in not on a lattice plane.");
         }
         return h;
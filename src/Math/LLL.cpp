@@ -8,6 +8,7 @@
 #define gbLAB_LLL_cpp_
 
 #include "LLL.h"
+#include <Log.h>
 // http://www.arageli.org/download
 // https://www.mathworks.com/matlabcentral/fileexchange/49457-lattice-reduction-mimo?focused=3859922&tab=function
 
@@ -60,14 +61,10 @@ namespace gbLAB
                                   const int &k_max)
     {
         //            typedef typename Lambda_type::value_type T;
-        std::cout << "1" << std::endl;
-
         Eigen::VectorXi tempCol = B.col(k);
         B.col(k) = B.col(k - 1);
         B.col(k - 1) = tempCol;
 
-        std::cout << "2" << std::endl;
-
         tempCol = H.col(k);
         H.col(k) = H.col(k - 1);
         H.col(k - 1) = tempCol;
@@ -75,20 +72,15 @@ namespace gbLAB
         //            B.swap_cols(k, k - 1);
         //            H.swap_cols(k, k - 1);
 
-        std::cout << "3" << std::endl;
-
         for (int j = 0; j < k - 1; j++)
         {
             std::swap(Lambda(k, j), Lambda(k - 1, j));
         }
 
-        std::cout << "4" << std::endl;
-
         int lambda = Lambda(k, k - 1);
         int b = (d(k - 1) * d(k + 1) + pow(lambda, 2)) / d(k);
 
-        std::cout << "5" << std::endl;
-        std::cout << "d(k+1)=" << d(k + 1) << std::endl;
+        OILAB_LOG(trace,math) << "d(k+1)=" << d(k + 1);
 
         for (int i = k + 1; i <= k_max; i++)
         {
@@ -96,10 +88,7 @@ namespace gbLAB
             Lambda(i, k) = (d(k + 1) * Lambda(i, k - 1) - lambda * t) / d(k);
             Lambda(i, k - 1) = (b * t + lambda * Lambda(i, k)) / d(k + 1);
         }
-        std::cout << "6" << std::endl;
-
         d(k) = b;
-        std::cout << "7" << std::endl;
     }
 
     template <int m, int n>
@@ -115,10 +104,9 @@ namespace gbLAB
         int k_max = 0;
         for (int k = 1; k < n;)
         {
-            std::cout << "k=" << k << std::endl;
+            OILAB_LOG(trace,math) << "k=" << k;
             if (k > k_max)
             {
-                std::cout << "0" << std::endl;
                 k_max = k;
 
                 lll_gram_schmidt_int(k);
@@ -133,30 +121,25 @@ namespace gbLAB
 
             if (2 * std::abs(Lambda(k, k - 1)) > d(k))
             {
-                std::cout << "A" << std::endl;
                 lll_size_reduction_int(k, k - 1);
             }
 
             if (4 * d(k + 1) * d(k - 1) < 3 * pow(d(k), 2) - 4 * pow(Lambda(k, k - 1), 2))
             {
-                std::cout << "B" << std::endl;
                 lll_interchange_int(k, k_max);
                 k = std::max(1, k - 1);
-                std::cout << "B1" << std::endl;
             }
             else
             {
-                std::cout << "C" << std::endl;
                 for (int l = k - 1; l > 0; l--)
                     if (2 * std::abs(Lambda(k, l - 1)) > d(l))
                         lll_size_reduction_int(k, l - 1);
                 k++;
             }
-            std::cout << "B=" << B << std::endl;
-            std::cout << "d=" << d.transpose() << std::endl;
+            OILAB_LOG(trace,math) << "B=\n" << B << "\nd=" << d.transpose();
         }
 
-        std::cout << B << std::endl;
+        OILAB_LOG(trace,math) << "reduced basis=\n" << B;
     }
 
 } // end namespace
@@ -8,6 +8,7 @@
 #define gbLAB_RLLL_cpp_
 
 #include "RLLL.h"
+#include <Log.h>
 #include <vector>
 
 namespace gbLAB
@@ -175,13 +176,13 @@ namespace gbLAB
             }
 
             if (err > FLT_EPSILON) {
-                std::cout << "RLLL relative error= " << std::setprecision(15) << std::scientific << err << " > "
-                          << FLT_EPSILON << std::endl;
+                OILAB_LOG(debug,math) << "RLLL relative error= " << std::setprecision(15) << std::scientific << err << " > "
+                                      << FLT_EPSILON;
                 throw std::runtime_error("Relative error too large. RLLL failed.\n");
             }
 
             if (fabs(absDetU - 1.0) > FLT_EPSILON) {
-                std::cout << "|det(U)|= " << std::setprecision(15) << std::scientific << absDetU << std::endl;
+                OILAB_LOG(debug,math) << "|det(U)|= " << std::setprecision(15) << std::scientific << absDetU;
                 throw std::runtime_error("U is not unimodular. RLLL failed.\n");
             }
 
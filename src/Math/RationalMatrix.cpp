@@ -11,6 +11,7 @@
 #include <iostream>
 #include <iomanip>
 #include "IntegerMath.h"
+#include <Log.h>
 #include "BestRationalApproximation.h"
 #include <cfloat> // FLT_EPSILON
 
@@ -50,14 +51,14 @@ namespace gbLAB
         const double error = (im.template cast<double>() / sigma - R).norm() / (dim * dim);
         if (error > FLT_EPSILON)
         {
-            std::cout << "error=" << error << std::endl;
-            std::cout << "maxDen=" << maxDen << std::endl;
-            std::cout << "im=\n"
-                      << std::setprecision(15) << std::scientific << im.template cast<double>() / sigma << std::endl;
-            std::cout << "= 1/" << sigma << "*\n"
-                      << std::setprecision(15) << std::scientific << im << std::endl;
-            std::cout << "R=\n"
-                      << std::setprecision(15) << std::scientific << R << std::endl;
+            OILAB_LOG(debug,math) << "error=" << error << "\n"
+                                  << "maxDen=" << maxDen << "\n"
+                                  << "im=\n"
+                                  << std::setprecision(15) << std::scientific << im.template cast<double>() / sigma << "\n"
+                                  << "= 1/" << sigma << "*\n"
+                                  << im << "\n"
+                                  << "R=\n"
+                                  << R;
             throw std::runtime_error("Rational Matrix failed, check maxDen");
         }
 
@@ -92,12 +93,13 @@ namespace gbLAB
             }
         }
         if (IntegerMath<IntScalarType>::gcd(IntegerMath<IntScalarType>::gcd(im.cwiseAbs()), sigma) != 1) {
-            std::cout << Rn << std::endl;
-            std::cout << Rd << std::endl;
-            std::cout << RnReduced << std::endl;
-            std::cout << RdReduced << std::endl;
-            std::cout << im << std::endl;
-            std::cout << sigma <<std::endl;
+            OILAB_LOG(error,math) << "Rational matrix reduction failed:\n"
+                                  << "Rn=\n" << Rn << "\n"
+                                  << "Rd=\n" << Rd << "\n"
+                                  << "RnReduced=\n" << RnReduced << "\n"
+                                  << "RdReduced=\n" << RdReduced << "\n"
+                                  << "im=\n" << im << "\n"
+                                  << "sigma=" << sigma;
         }
         assert(IntegerMath<IntScalarType>::gcd(IntegerMath<IntScalarType>::gcd(im.cwiseAbs()), sigma) == 1);
         return std::make_pair(im, sigma);
@@ -120,7 +122,7 @@ namespace gbLAB
     }
     catch(std::runtime_error& e)
     {
-        std::cout << e.what() << std::endl;
+        OILAB_LOG(debug,math) << e.what();
         throw(std::runtime_error("Rational Matrix construction failed. "));
     }
     template <int dim>
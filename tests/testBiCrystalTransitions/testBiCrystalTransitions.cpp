@@ -0,0 +1,115 @@
+#include <LatticeModule.h>
+#include <numbers>
+#include <randomInteger.h>
+
+using namespace gbLAB;
+
+template<int dim>
+void checkParallel(const Eigen::Matrix<double,dim,1>& x, const Eigen::Matrix<double,dim,1>& y, const std::string& name)
+{
+    if (x.dot(y) <= 0 || std::abs(x.normalized().dot(y.normalized())-1.0) > 1e-8)
+        throw std::runtime_error(name+": converted vector is not parallel to its input.");
+}
+
+template<int dim>
+void checkEqual(const Eigen::Matrix<double,dim,1>& x, const Eigen::Matrix<double,dim,1>& y, const std::string& name)
+{
+    if ((x-y).norm() > 1e-8*std::max(1.0,y.norm()))
+        throw std::runtime_error(name+": converted vector is not equal to its input.");
+}
+
+template<int dim>
+void testBiCrystal(const BiCrystal<dim>& bc)
+{
+    using MatrixDimXI= typename BiCrystal<dim>::MatrixDimXI;
+    const std::vector<const Lattice<dim>*> lattices{&bc.A,&bc.B,&bc.csl,&bc.dscl};
+    const int n= 50;
+
+    for(const Lattice<dim>* from : lattices)
+    {
+        MatrixDimXI coordinates(dim,n);
+        for(int j=0; j<n; ++j)
+            for(int i=0; i<dim; ++i)
+                coordinates(i,j)= random<int>(-5,5);
+
+        const MatrixDimXI inD= bc.convertLatticeCoordinates(coordinates,*from,bc.dscl);
+        const MatrixDimXI inC= bc.convertLatticeCoordinates(coordinates,*from,bc.csl);
+        const MatrixDimXI reciprocalInC= bc.convertReciprocalLatticeCoordinates(coordinates,*from,bc.csl);
+        for(int j=0; j<n; ++j)
+        {
+            const LatticeVector<dim> v(coordinates.col(j).eval(),*from);
+            const ReciprocalLatticeVector<dim> rv(coordinates.col(j).eval(),*from);
+            if (v.isZero()) continue;
+
+            // lattice vectors
+            const auto vD= bc.getLatticeVectorInD(v);
+            checkEqual<dim>(vD.cartesian(),v.cartesian(),"getLatticeVectorInD");
+            if (vD!=inD.col(j))
+                throw std::runtime_error("Batch conversion to D differs from getLatticeVectorInD.");
+            const auto vC= bc.getLatticeDirectionInC(v).latticeVector();
+            checkParallel<dim>(vC.cartesian(),v.cartesian(),"getLatticeDirectionInC");
+            const LatticeVector<dim> batchC(inC.col(j).eval(),bc.csl);
+            checkParallel<dim>(batchC.cartesian(),v.cartesian(),"convertLatticeCoordinates to C");
+            if (from==&bc.csl)
+            {
+                const MatrixDimXI inA= bc.convertLatticeCoordinates(coordinates.col(j),bc.csl,bc.A);
+                const auto vA= bc.getLatticeVectorInA(v);
+                checkEqual<dim>(vA.cartesian(),v.cartesian(),"getLatticeVectorInA");
+                checkEqual<dim>(bc.getLatticeVectorInB(v).cartesian(),v.cartesian(),"getLatticeVectorInB");
+                if (vA!=inA.col(0))
+                    throw std::runtime_error("Batch conversion to A differs from getLatticeVectorInA.");
+            }
+
+            // reciprocal lattice vectors
+            checkParallel<dim>(bc.getReciprocalLatticeDirectionInA(rv).cartesian(),rv.cartesian(),"getReciprocalLatticeDirectionInA");
+            checkParallel<dim>(bc.getReciprocalLatticeDirectionInB(rv).cartesian(),rv.cartesian(),"getReciprocalLatticeDirectionInB");
+            checkParallel<dim>(bc.getReciprocalLatticeDirectionInC(rv).cartesian(),rv.cartesian(),"getReciprocalLatticeDirectionInC");
+            const ReciprocalLatticeVector<dim> batchRC(reciprocalInC.col(j).eval(),bc.csl);
+            checkParallel<dim>(batchRC.cartesian(),rv.cartesian(),"convertReciprocalLatticeCoordinates to C");
+            if (from!=&bc.dscl)
+                checkParallel<dim>(bc.getReciprocalLatticeDirectionInD(rv).cartesian(),rv.cartesian(),"getReciprocalLatticeDirectionInD");
+        }
+    }
+
+    // A and B have no integer transition to each other
+    bool thrown= false;
+    try { bc.transitionMatrix(bc.A,bc.B); }
+    catch(std::runtime_error&) { thrown= true; }
+    if (!thrown)
+        throw std::runtime_error("transitionMatrix(A,B) should throw.");
+}
+
+int main()
+{
+    try
+    {
+        seedRandom(1234);
+
+        Eigen::Matrix2d A2;
+        A2 << 1.0, 0.5,
+              0.0, std::sqrt(3.0)/2;
+        Lattice<2> L1(A2);
+        Lattice<2> L2(A2,Eigen::Rotation2D<double>(2*std::atan(std::sqrt(3.0)/5)).toRotationMatrix());
+        BiCrystal<2> bc2(L1,L2);
+        std::cout << "2D bicrystal, sigma = " << bc2.sigma << std::endl;
+        testBiCrystal(bc2);
+
+        Eigen::Matrix3d A3;
+        A3 << 0.0, 0.5, 0.5,
+              0.5, 0.0, 0.5,
+              0.5, 0.5, 0.0;
+        const Eigen::Vector3d axis(Eigen::Vector3d(1,1,0).normalized());
+        const double theta= 70.52877936550931*std::numbers::pi/180;
+        Lattice<3> L3(A3,Eigen::AngleAxis<double>(theta/2,axis).matrix());
+        Lattice<3> L4(A3,Eigen::AngleAxis<double>(-theta/2,axis).matrix());
+        BiCrystal<3> bc3(L3,L4);
+        std::cout << "3D bicrystal, sigma = " << bc3.sigma << std::endl;
+        testBiCrystal(bc3);
+    }
+    catch(std::runtime_error& e)
+    {
+        std::cout << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
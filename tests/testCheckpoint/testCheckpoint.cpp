@@ -0,0 +1,136 @@
+#include <LatticeModule.h>
+#include <GbMesoStateEnsemble.h>
+#include <MonteCarlo.h>
+#include <CanonicalTP.h>
+#include <LandauWangTP.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <numbers>
+
+using namespace gbLAB;
+
+using Canonical= CanonicalTP<XTuplet,GbMesoState<3>>;
+using LandauWang= LandauWangTP<XTuplet,GbMesoState<3>>;
+template<typename TransitionProbabilityType>
+using Walker= MonteCarlo<XTuplet,GbMesoState<3>,GbMesoStateEnsemble<3>,TransitionProbabilityType>;
+
+// a cheap, deterministic stand-in for LAMMPS: the number of constraints and the squared constraint displacements
+std::pair<double,double> constraintEnergy(const GbMesoState<3>& mesoState)
+{
+    double output= 0.0;
+    for(const auto& [x,u] : mesoState.xuPairs)
+        output+= u.squaredNorm();
+    return std::make_pair(mesoState.xuPairs.size(),output);
+}
+
+std::string contents(const std::string& filename)
+{
+    std::ifstream file(filename,std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(file)),std::istreambuf_iterator<char>());
+}
+
+/*
+ * Runs a walker for 2n steps in one go, and a second walker for n steps from a checkpoint
+ * taken after n steps of the first one. Both runs have to end in identical checkpoints.
+ */
+template<typename TransitionProbabilityType, typename FactoryType>
+void testRestart(const GbMesoStateEnsemble<3>& ensemble, const FactoryType& factory, const int& n, const std::string& name)
+{
+    auto tp1(factory());
+    Walker<TransitionProbabilityType> mc1(ensemble,*tp1,7,0);
+    mc1.evolve(n);
+    mc1.save(name+"_half.bin");
+    mc1.evolve(n);
+    mc1.save(name+"_continuous.bin");
+
+    // a differently seeded walker, overwritten by the checkpoint
+    auto tp2(factory());
+    Walker<TransitionProbabilityType> mc2(ensemble,*tp2,11,3);
+    mc2.restore(name+"_half.bin");
+    if(mc2.step!=static_cast<std::uint64_t>(n))
+        throw std::runtime_error(name+": wrong step count after restore.");
+    mc2.evolve(n);
+    mc2.save(name+"_restarted.bin");
+
+    if(mc1.currentState!=mc2.currentState || contents(name+"_continuous.bin")!=contents(name+"_restarted.bin"))
+        throw std::runtime_error(name+": the restarted run differs from the continuous run.");
+    std::cout << name << ": restarted run matches the continuous run after " << 2*n << " steps" << std::endl;
+}
+
+int main()
+{
+    try
+    {
+        const double c11= 169.9281940954852/160.2176621;
+        const double c12= 122.65063014404001/160.2176621;
+        GbMaterialTensors::lambda= c12;
+        GbMaterialTensors::mu= (c11-c12)/2;
+
+        Eigen::Matrix3d A;
+        A << 0.0, 0.5, 0.5,
+             0.5, 0.0, 0.5,
+             0.5, 0.5, 0.0;
+        A*= 3.615;
+
+        // Sigma29 [0-10](2 0 -5) symmetric tilt GB
+        const Eigen::Vector3d axis(0,-1,0);
+        const Eigen::AngleAxisd halfRotation(43.60282*std::numbers::pi/180/2,axis.normalized());
+        const Lattice<3> latticeA(A,halfRotation.matrix());
+        const Lattice<3> latticeB(A,halfRotation.matrix().transpose());
+        const BiCrystal<3> bc(latticeA,latticeB,false);
+        const Gb<3> gb(bc,latticeA.reciprocalLatticeDirection(halfRotation.matrix()*Eigen::Vector3d(2,0,5)));
+        const ReciprocalLatticeVector<3> axisA(latticeA.reciprocalLatticeDirection(axis).reciprocalLatticeVector());
+        const LatticeVector<3> axisC(bc.getLatticeDirectionInC(bc.A.latticeDirection(axis).latticeVector()).latticeVector());
+        std::vector<LatticeVector<3>> cslVectors;
+        cslVectors.push_back(bc.csl.latticeDirection(gb.nA.cartesian()).latticeVector());
+        cslVectors.push_back(gb.getPeriodVector(axisA));
+        cslVectors.push_back(axisC);
+        const GbMesoStateEnsemble<3> ensemble(gb,axisA,cslVectors,1.0);
+
+        testRestart<Canonical>(ensemble,[](){
+            return std::make_unique<Canonical>(EnergyEvaluator<GbMesoState<3>>(constraintEnergy),0.05,std::make_shared<StateEnergyStore<XTuplet>>());
+        },40,"canonical");
+
+        std::remove("mask.txt");
+        std::remove("theta.txt");
+        testRestart<LandauWang>(ensemble,[](){
+            return std::make_unique<LandauWang>(std::make_tuple(0.0,2.0,8),std::make_tuple(0.0,1.0,1),EnergyEvaluator<GbMesoState<3>>(constraintEnergy),
+                                                std::make_shared<StateEnergyStore<XTuplet>>());
+        },40,"landauWang");
+
+        // periodic checkpoints
+        std::remove("periodic.bin");
+        Canonical tp(EnergyEvaluator<GbMesoState<3>>(constraintEnergy),0.05,std::make_shared<StateEnergyStore<XTuplet>>());
+        Walker<Canonical> mc(ensemble,tp,7,0);
+        mc.checkpoint("periodic.bin",10);
+        mc.evolve(25);
+        Canonical tpRestored(EnergyEvaluator<GbMesoState<3>>(constraintEnergy),0.05,std::make_shared<StateEnergyStore<XTuplet>>());
+        Walker<Canonical> mcRestored(ensemble,tpRestored,7,0);
+        mcRestored.restore("periodic.bin");
+        if(mcRestored.step!=20 || std::filesystem::exists("periodic.bin.tmp"))
+            throw std::runtime_error("Periodic checkpoint not written at step 20.");
+
+        // a damaged checkpoint is rejected
+        std::filesystem::resize_file("periodic.bin",std::filesystem::file_size("periodic.bin")-1);
+        bool rejected= false;
+        try
+        {
+            mcRestored.restore("periodic.bin");
+        }
+        catch(std::runtime_error& e)
+        {
+            std::cout << "Damaged checkpoint rejected: " << e.what() << std::endl;
+            rejected= true;
+        }
+        if(!rejected)
+            throw std::runtime_error("A truncated checkpoint was accepted.");
+    }
+    catch(std::runtime_error& e)
+    {
+        std::cout << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,303 @@
+#include <LatticeModule.h>
+#include <GbShifts.h>
+#include <GbMesoStateEnsemble.h>
+#include <numbers>
+#include <set>
+#include <thread>
+#include <omp.h>
+
+using namespace gbLAB;
+
+// What a construction produced, compared between serial and concurrent runs
+struct Result
+{
+    size_t latticeID= 0;
+    int sigma= 0;
+    Eigen::Matrix3d csl;
+    Eigen::Matrix3d dscl;
+    Eigen::Matrix3d T;
+    size_t numberOfShifts= 0;
+};
+
+struct Candidate
+{
+    Eigen::Matrix3d rotation;
+    bool shifts;
+};
+
+Result construct(const Lattice<3>& A, const Candidate& candidate)
+{
+    Result result;
+    const Lattice<3> B(A.latticeBasis,candidate.rotation);
+    result.latticeID= B.sID;
+    const BiCrystal<3> bc(A,B,true);
+    result.sigma= bc.sigma;
+    result.csl= bc.csl.latticeBasis;
+    result.dscl= bc.dscl.latticeBasis;
+
+    // a GB along a plane of the CSL
+    const Eigen::Vector3d normal(bc.csl.latticeBasis.col(0).cross(bc.csl.latticeBasis.col(1)));
+    const Gb<3> gb(bc,A.reciprocalLatticeDirection(normal));
+    result.T= gb.T.latticeBasis;
+
+    if (candidate.shifts && bc.sigma<=25)
+    {
+        // the shifts of the CSL vectors of a tilt GB about the first CSL vector
+        const ReciprocalLatticeVector<3> axis(A.reciprocalLatticeDirection(bc.csl.latticeBasis.col(0)).reciprocalLatticeVector());
+        std::vector<LatticeVector<3>> cslVectors;
+        cslVectors.push_back(bc.csl.latticeDirection(gb.nA.cartesian()).latticeVector());
+        cslVectors.push_back(gb.getPeriodVector(axis));
+        cslVectors.push_back(bc.csl.latticeDirection(bc.csl.latticeBasis.col(0)).latticeVector());
+        const GbShifts<3> shifts(gb,axis,cslVectors,0.5);
+        result.numberOfShifts= shifts.bShiftPairs.size();
+    }
+    return result;
+}
+
+void compare(const std::vector<Result>& serial, const std::vector<Result>& concurrent, const std::string& name)
+{
+    std::set<size_t> ids;
+    for (size_t c=0; c<serial.size(); ++c)
+    {
+        if (serial[c].sigma!=concurrent[c].sigma ||
+            !serial[c].csl.isApprox(concurrent[c].csl) ||
+            !serial[c].dscl.isApprox(concurrent[c].dscl) ||
+            !serial[c].T.isApprox(concurrent[c].T) ||
+            serial[c].numberOfShifts!=concurrent[c].numberOfShifts)
+            throw std::runtime_error(name+": construction "+std::to_string(c)+" differs from the serial one.");
+        if (!ids.insert(concurrent[c].latticeID).second)
+            throw std::runtime_error(name+": two lattices have the same static ID.");
+    }
+}
+
+// The reference and deformed configurations of a mesostate; configurations() evaluates the
+// displacement field of the mesostate in an OpenMP loop
+std::pair<Configuration,Configuration> configurations(const GbMesoState<3>& mesostate)
+{
+    return mesostate.configurations();
+}
+
+void compare(const std::vector<std::pair<Configuration,Configuration>>& serial,
+             const std::vector<std::pair<Configuration,Configuration>>& concurrent,
+             const std::string& name)
+{
+    for (size_t c=0; c<serial.size(); ++c)
+    {
+        for (const auto& [s,t] : {std::make_pair(&serial[c].first,&concurrent[c].first),
+                                  std::make_pair(&serial[c].second,&concurrent[c].second)})
+        {
+            if (s->size()!=t->size() || s->types!=t->types ||
+                !s->box.isApprox(t->box) || !s->positions.isApprox(t->positions))
+                throw std::runtime_error(name+": configurations of mesostate "+std::to_string(c)+" differ from the serial ones.");
+        }
+    }
+}
+
+// Mesostates of a Sigma5 [100](0-21) symmetric tilt GB, constructed and deformed on several threads
+void testMesoStates()
+{
+    const double c11= 169.9281940954852/160.2176621;
+    const double c12= 122.65063014404001/160.2176621;
+    GbMaterialTensors::lambda= c12;
+    GbMaterialTensors::mu= (c11-c12)/2;
+
+    Eigen::Matrix3d basis;
+    basis << 0.0, 0.5, 0.5,
+             0.5, 0.0, 0.5,
+             0.5, 0.5, 0.0;
+    basis*= 3.615;
+
+    const Eigen::Vector3d axis(1,0,0);
+    const Eigen::AngleAxisd halfRotation(36.869897645844*std::numbers::pi/180/2,axis);
+    const Lattice<3> latticeA(basis,halfRotation.matrix());
+    const Lattice<3> latticeB(basis,halfRotation.matrix().transpose());
+    const BiCrystal<3> bc(latticeA,latticeB,false);
+    const Eigen::Vector3d normal(halfRotation.matrix()*Eigen::Vector3d(0,-2,1));
+    const Gb<3> gb(bc,latticeA.reciprocalLatticeDirection(normal));
+    const ReciprocalLatticeVector<3> axisA(latticeA.reciprocalLatticeDirection(axis).reciprocalLatticeVector());
+    const LatticeVector<3> axisC(bc.getLatticeDirectionInC(bc.A.latticeDirection(axis).latticeVector()).latticeVector());
+    std::vector<LatticeVector<3>> cslVectors;
+    cslVectors.push_back(bc.csl.latticeDirection(gb.nA.cartesian()).latticeVector());
+    cslVectors.push_back(gb.getPeriodVector(axisA));
+    cslVectors.push_back(axisC);
+    const GbMesoStateEnsemble<3> ensemble(gb,axisA,cslVectors,1.0);
+
+    // serial reference; constraints that do not give a mesostate are skipped
+    std::vector<XTuplet> states;
+    std::vector<GbMesoState<3>> mesostates;
+    std::vector<std::pair<Configuration,Configuration>> serial;
+    for (const auto& constraints : GbMesoStateEnsemble<3>::admissibleConstraints(ensemble))
+    {
+        try
+        {
+            mesostates.push_back(ensemble.constructMesoState(constraints));
+        }
+        catch (std::runtime_error&)
+        {
+            continue;
+        }
+        states.push_back(constraints);
+        serial.push_back(configurations(mesostates.back()));
+        if (states.size()==12) break;
+    }
+    if (states.empty())
+        throw std::runtime_error("No mesostate could be constructed.");
+
+    // mesostates constructed on this thread, deformed on other threads
+    std::vector<std::pair<Configuration,Configuration>> threaded(states.size());
+    std::vector<std::string> errors(states.size());
+    std::vector<std::thread> threads;
+    for (size_t c=0; c<states.size(); ++c)
+    {
+        threads.emplace_back([&,c]()
+                             {
+                                 try
+                                 {
+                                     threaded[c]= configurations(mesostates[c]);
+                                 }
+                                 catch (std::runtime_error& e)
+                                 {
+                                     errors[c]= e.what();
+                                 }
+                             });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    for (const auto& error : errors)
+        if (!error.empty())
+            throw std::runtime_error(error);
+    compare(serial,threaded,"std::thread");
+    std::cout << states.size() << " mesostates deformed on other threads" << std::endl;
+
+    // mesostates constructed and deformed in an OpenMP loop
+    std::vector<std::pair<Configuration,Configuration>> openmp(states.size());
+    bool failed= false;
+    #pragma omp parallel for schedule(dynamic) num_threads(4)
+    for (size_t c=0; c<states.size(); ++c)
+    {
+        try
+        {
+            openmp[c]= configurations(ensemble.constructMesoState(states[c]));
+        }
+        catch (std::runtime_error& e)
+        {
+            #pragma omp critical
+            failed= true;
+        }
+    }
+    if (failed)
+        throw std::runtime_error("OpenMP: a mesostate construction failed.");
+    compare(serial,openmp,"OpenMP");
+    std::cout << states.size() << " mesostates constructed and deformed in an OpenMP loop" << std::endl;
+}
+
+int main()
+{
+    try
+    {
+        Eigen::Matrix3d basis;
+        basis << 0.0, 0.5, 0.5,
+                 0.5, 0.0, 0.5,
+                 0.5, 0.5, 0.0;
+        const Lattice<3> A(basis);
+
+        // coincidence rotations about low-index axes, repeated to a few thousand constructions
+        std::vector<Candidate> candidates;
+        for (int repeat=0; repeat<8; ++repeat)
+        {
+            for (const Eigen::Vector3d& d : {Eigen::Vector3d(1,0,0),Eigen::Vector3d(1,1,0),Eigen::Vector3d(1,1,1),
+                                             Eigen::Vector3d(2,1,0),Eigen::Vector3d(2,1,1),Eigen::Vector3d(2,2,1)})
+            {
+                for (const auto& rotation : A.generateCoincidentLattices(A.reciprocalLatticeDirection(d),30))
+                {
+                    if (!rotation.isIdentity(FLT_EPSILON))
+                        candidates.push_back(Candidate{rotation,candidates.size()%10==0});
+                }
+            }
+        }
+
+        // serial reference; candidates whose bicrystal or GB cannot be constructed are dropped
+        std::vector<Result> serial;
+        std::vector<Candidate> accepted;
+        for (const auto& candidate : candidates)
+        {
+            try
+            {
+                serial.push_back(construct(A,candidate));
+                accepted.push_back(candidate);
+            }
+            catch (std::runtime_error&)
+            {
+            }
+        }
+        candidates.swap(accepted);
+        std::cout << candidates.size() << " serial constructions, "
+                  << std::count_if(serial.begin(),serial.end(),[](const Result& r){return r.numberOfShifts>0;})
+                  << " with GB shifts" << std::endl;
+
+        // std::thread
+        std::vector<Result> threaded(candidates.size());
+        const unsigned numberOfThreads= std::max(4u,std::thread::hardware_concurrency());
+        std::vector<std::thread> threads;
+        std::vector<std::string> errors(numberOfThreads);
+        for (unsigned t=0; t<numberOfThreads; ++t)
+        {
+            threads.emplace_back([&,t]()
+                                 {
+                                     try
+                                     {
+                                         for (size_t c=t; c<candidates.size(); c+=numberOfThreads)
+                                             threaded[c]= construct(A,candidates[c]);
+                                     }
+                                     catch (std::runtime_error& e)
+                                     {
+                                         errors[t]= e.what();
+                                     }
+                                 });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        for (const auto& error : errors)
+            if (!error.empty())
+                throw std::runtime_error(error);
+        compare(serial,threaded,"std::thread");
+        std::cout << candidates.size() << " constructions on " << numberOfThreads << " threads" << std::endl;
+
+        // OpenMP
+        std::vector<Result> openmp(candidates.size());
+        bool failed= false;
+        #pragma omp parallel for schedule(dynamic)
+        for (size_t c=0; c<candidates.size(); ++c)
+        {
+            try
+            {
+                openmp[c]= construct(A,candidates[c]);
+            }
+            catch (std::runtime_error& e)
+            {
+                #pragma omp critical
+                failed= true;
+            }
+        }
+        if (failed)
+            throw std::runtime_error("OpenMP: a construction failed.");
+        compare(serial,openmp,"OpenMP");
+        std::cout << candidates.size() << " constructions in an OpenMP loop" << std::endl;
+
+        // every lattice got its own static ID
+        std::set<size_t> ids;
+        for (const auto* results : {&serial,&threaded,&openmp})
+            for (const auto& result : *results)
+                ids.insert(result.latticeID);
+        if (ids.size()!=3*candidates.size())
+            throw std::runtime_error("Static IDs are not unique across runs.");
+
+        testMesoStates();
+    }
+    catch(std::runtime_error& e)
+    {
+        std::cout << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,120 @@
+#include <LatticeModule.h>
+#include <ConfigurationIO.h>
+#include <randomInteger.h>
+#include <iterator>
+#include <sstream>
+
+using namespace gbLAB;
+
+bool sameConfiguration(const Configuration& a, const Configuration& b)
+{
+    return a.size()==b.size() &&
+           a.box==b.box &&
+           a.origin==b.origin &&
+           a.pbc==b.pbc &&
+           a.types==b.types &&
+           a.positions==b.positions;
+}
+
+int main()
+{
+    try
+    {
+        // a configuration with values that are not exactly representable in short decimal form
+        seedRandom(7);
+        Configuration configuration(1000);
+        configuration.box << 3.0, 0.1, 0.0,
+                             0.0, 2.0/3.0, 0.0,
+                             0.0, 0.0, std::sqrt(2.0);
+        configuration.origin << -1.5, 1.0/7.0, 0.0;
+        for(size_t a=0; a<configuration.size(); ++a)
+        {
+            configuration.types[a]= random<int>(1,4);
+            for(int i=0; i<3; ++i)
+                configuration.positions(i,a)= random<double>(-10.0,10.0);
+        }
+
+        // text output is exact: std::to_chars writes the shortest representation that reads back identically
+        writeConfiguration("configuration.txt",configuration,ConfigurationFormat::xyz);
+        if(!sameConfiguration(configuration,readConfiguration("configuration.txt")))
+            throw std::runtime_error("Extended-XYZ round trip failed.");
+
+        writeConfiguration("configuration.bin",configuration,configurationFormat("binary"));
+        if(MappedConfiguration::isBinary("configuration.txt") || !MappedConfiguration::isBinary("configuration.bin"))
+            throw std::runtime_error("Binary configuration files are not recognized.");
+        {
+            const MappedConfiguration mapped("configuration.bin");
+            if(mapped.size()!=configuration.size() || mapped.positions()!=configuration.positions ||
+               mapped.box()!=configuration.box || mapped.origin()!=configuration.origin)
+                throw std::runtime_error("Memory-mapped configuration differs from the written one.");
+            for(size_t a=0; a<mapped.size(); ++a)
+                if(mapped.types()[a]!=configuration.types[a])
+                    throw std::runtime_error("Memory-mapped types differ from the written ones.");
+        }
+        if(!sameConfiguration(configuration,readConfiguration("configuration.bin")))
+            throw std::runtime_error("Binary round trip failed.");
+
+#ifdef OILAB_USE_ZSTD
+        writeConfiguration("configuration.zst",configuration,ConfigurationFormat::compressedBinary);
+        if(!sameConfiguration(configuration,readConfiguration("configuration.zst")))
+            throw std::runtime_error("Compressed binary round trip failed.");
+#else
+        bool thrown= false;
+        try
+        {
+            writeConfiguration("configuration.zst",configuration,ConfigurationFormat::compressedBinary);
+        }
+        catch(const std::runtime_error&)
+        {
+            thrown= true;
+        }
+        if(!thrown)
+            throw std::runtime_error("Compressed output should fail without zstd support.");
+#endif
+
+        // lattice boxes written in both formats agree with the returned lattice points
+        Eigen::Matrix3d A;
+        A << 0.0, 0.5, 0.5,
+             0.5, 0.0, 0.5,
+             0.5, 0.5, 0.0;
+        Lattice<3> lattice(A);
+        std::vector<LatticeVector<3>> boxVectors;
+        boxVectors.push_back(LatticeVector<3>((Eigen::Vector3<long long int>() << 2, 1, -1).finished(),lattice));
+        boxVectors.push_back(LatticeVector<3>((Eigen::Vector3<long long int>() << -1, 3, 0).finished(),lattice));
+        boxVectors.push_back(LatticeVector<3>((Eigen::Vector3<long long int>() << 0, 1, 4).finished(),lattice));
+        const auto points= lattice.box(boxVectors,"box.txt");
+        lattice.box(boxVectors,"box.bin",ConfigurationFormat::binary);
+        const Configuration text(readConfiguration("box.txt"));
+        const MappedConfiguration binary("box.bin");
+        if(text.size()!=points.size() || binary.size()!=points.size())
+            throw std::runtime_error("Incorrect number of points in the lattice box files.");
+        for(size_t a=0; a<points.size(); ++a)
+        {
+            if(text.positions.col(a)!=points[a].cartesian() || binary.positions().col(a)!=points[a].cartesian())
+                throw std::runtime_error("Lattice box files differ from the lattice points.");
+        }
+        for(int i=0; i<3; ++i)
+            if(binary.box().col(i)!=boxVectors[i].cartesian())
+                throw std::runtime_error("Incorrect box in the lattice box file.");
+
+        // lattice box text files keep their format: no PBC, origin or radius
+        std::ifstream boxFile("box.txt");
+        std::string line;
+        std::getline(boxFile,line);
+        std::getline(boxFile,line);
+        if(line.find("Properties=atom_types:I:1:pos:R:3")==std::string::npos || line.find("radius")!=std::string::npos ||
+           line.find("PBC")!=std::string::npos || line.find("origin")!=std::string::npos)
+            throw std::runtime_error("Unexpected header of the lattice box file: "+line);
+        std::getline(boxFile,line);
+        std::istringstream firstAtom(line);
+        std::vector<double> columns{std::istream_iterator<double>(firstAtom),std::istream_iterator<double>()};
+        if(columns.size()!=4)
+            throw std::runtime_error("Lattice box files should have no radius column: "+line);
+    }
+    catch(std::runtime_error& e)
+    {
+        std::cout << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
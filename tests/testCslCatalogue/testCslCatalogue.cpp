@@ -0,0 +1,162 @@
+#include <LatticeModule.h>
+#include <CslCatalogue.h>
+#include <numbers>
+
+using namespace gbLAB;
+
+using VectorDimI= LatticeCore<3>::VectorDimI;
+
+// Compares the entries of a catalogue, and the bicrystals built from them, with bicrystals constructed from scratch
+void validate(const CslCatalogue& catalogue)
+{
+    const Lattice<3> A(catalogue.latticeBasis);
+    for (const auto& entry : catalogue.entries)
+    {
+        const Lattice<3> B(catalogue.latticeBasis,entry.rotation);
+        const BiCrystal<3> live(A,B,false);
+        const BiCrystal<3> bc(entry.biCrystal(A,B));
+        const std::string name("sigma"+std::to_string(entry.sigma)+" about ["+std::to_string(entry.axis(0))+" "
+                               +std::to_string(entry.axis(1))+" "+std::to_string(entry.axis(2))+"]: ");
+
+        if (bc.sigma!=entry.sigma || live.sigma!=entry.sigma || entry.sigma>catalogue.maxSigma)
+            throw std::runtime_error(name+"wrong sigma.");
+        if (bc.M!=live.M || bc.N!=live.N || bc.LambdaA!=live.LambdaA || bc.LambdaB!=live.LambdaB)
+            throw std::runtime_error(name+"the shift tensors differ from live construction.");
+        if (!bc.csl.latticeBasis.isApprox(live.csl.latticeBasis) || !bc.dscl.latticeBasis.isApprox(live.dscl.latticeBasis))
+            throw std::runtime_error(name+"the CSL and DSCL differ from live construction.");
+        if (!(A.latticeBasis*entry.cslMatrix.cast<double>()).isApprox(live.csl.latticeBasis) ||
+            !(live.dscl.latticeBasis*entry.dsclMatrix.cast<double>()).isApprox(A.latticeBasis))
+            throw std::runtime_error(name+"wrong integer CSL or DSCL matrices.");
+
+        // the rotation is about the axis by the angle
+        const ReciprocalLatticeVector<3> axis(entry.axis,A);
+        const Eigen::Vector3d n(axis.cartesian().normalized());
+        if (!Eigen::AngleAxisd(entry.angle,n).matrix().isApprox(entry.rotation,1e-10) || entry.angle<=0 || entry.angle>=2*std::numbers::pi)
+            throw std::runtime_error(name+"wrong angle.");
+
+        // the GB plane basis spans a primitive cell of the CSL plane normal to the axis
+        const Eigen::Matrix<double,3,2> plane(live.csl.latticeBasis*entry.gbPlaneBasis.cast<double>());
+        const double area= plane.col(0).cross(plane.col(1)).norm();
+        const double spacing= live.csl.interPlanarSpacing(live.getReciprocalLatticeDirectionInC(axis));
+        if (std::abs(plane.col(0).dot(n))>FLT_EPSILON*plane.norm() || std::abs(plane.col(1).dot(n))>FLT_EPSILON*plane.norm() ||
+            std::abs(area*spacing-std::abs(live.csl.latticeBasis.determinant()))>1e-8*area*spacing)
+            throw std::runtime_error(name+"wrong GB plane basis.");
+    }
+}
+
+int main()
+{
+    try
+    {
+        /*! [Generate] */
+        const Eigen::Matrix3d fccBasis(CslCatalogue::standardBasis("fcc"));
+        const Lattice<3> fcc(fccBasis);
+        std::vector<VectorDimI> fccAxes;
+        for (const Eigen::Vector3d& d : {Eigen::Vector3d(1,0,0),Eigen::Vector3d(1,1,0),Eigen::Vector3d(1,1,1)})
+            fccAxes.push_back(fcc.reciprocalLatticeDirection(d).reciprocalLatticeVector());
+        const CslCatalogue generated("fcc",fccBasis,fccAxes,25);
+        generated.write("fcc.cat");
+        /*! [Generate] */
+
+        /*! [Read] */
+        const CslCatalogue catalogue("fcc.cat");
+        /*! [Read] */
+        if (catalogue.latticeName!="fcc" || catalogue.maxSigma!=25 || catalogue.latticeBasis!=fccBasis ||
+            catalogue.entries.size()!=generated.entries.size() || catalogue.entries.empty())
+            throw std::runtime_error("The catalogue read back differs from the generated one.");
+        for (size_t e=0; e<catalogue.entries.size(); ++e)
+        {
+            const auto& read(catalogue.entries[e]);
+            const auto& written(generated.entries[e]);
+            if (read.axis!=written.axis || read.angle!=written.angle || read.sigma!=written.sigma ||
+                read.rotation!=written.rotation || read.smithD!=written.smithD || read.smithU!=written.smithU ||
+                read.smithV!=written.smithV || read.cslMatrix!=written.cslMatrix ||
+                read.dsclMatrix!=written.dsclMatrix || read.gbPlaneBasis!=written.gbPlaneBasis)
+                throw std::runtime_error("Entry "+std::to_string(e)+" changed in the catalogue file.");
+        }
+        std::cout << "fcc catalogue: " << catalogue.entries.size() << " entries" << std::endl;
+        validate(catalogue);
+
+        // lookups
+        const VectorDimI axis110(fccAxes[1]);
+        const auto entries110(catalogue.byAxis(axis110));
+        if (entries110.empty() || catalogue.byAxis(-2*axis110).size()!=entries110.size())
+            throw std::runtime_error("Lookup by axis depends on the multiple of the axis.");
+        for (size_t e=1; e<entries110.size(); ++e)
+            if (entries110[e].angle<entries110[e-1].angle)
+                throw std::runtime_error("Entries of an axis are not sorted by angle.");
+
+        // angles refer to the queried axis: theta about [110] is 2 pi - theta about -[110]
+        const auto entries110Flipped(catalogue.byAxis(-axis110));
+        for (size_t e=0; e<entries110.size(); ++e)
+        {
+            const auto& entry(entries110[e]);
+            const auto& flipped(entries110Flipped[entries110.size()-1-e]);
+            if (flipped.axis!=-axis110 || std::abs(flipped.angle-(2*std::numbers::pi-entry.angle))>1e-12 ||
+                flipped.rotation!=entry.rotation)
+                throw std::runtime_error("Wrong entry for the flipped axis.");
+            for (const auto* lookup : {&entry,&flipped})
+            {
+                const Eigen::Vector3d direction(ReciprocalLatticeVector<3>(lookup->axis,fcc).cartesian().normalized());
+                if (!Eigen::AngleAxisd(lookup->angle,direction).matrix().isApprox(lookup->rotation))
+                    throw std::runtime_error("The angle of an entry is not a right-handed rotation about the queried axis.");
+            }
+        }
+
+        for (const auto& [sigma,axis,degrees] : {std::tuple<int,VectorDimI,double>{5,fccAxes[0],36.869897645844},
+                                                 std::tuple<int,VectorDimI,double>{3,fccAxes[1],70.528779365509},
+                                                 std::tuple<int,VectorDimI,double>{11,fccAxes[1],50.478803641137},
+                                                 std::tuple<int,VectorDimI,double>{7,fccAxes[2],38.213210337688}})
+        {
+            const double angle= degrees*std::numbers::pi/180;
+            const auto window(catalogue.byAngle(axis,angle-1e-6,angle+1e-6));
+            if (window.size()!=1 || window[0].sigma!=sigma)
+                throw std::runtime_error("Sigma"+std::to_string(sigma)+" is not found by angle.");
+            const auto sigmas(catalogue.bySigma(sigma,sigma));
+            if (std::find_if(sigmas.begin(),sigmas.end(),[&](const CslCatalogueEntry* entry)
+                             {return entry->rotation==window[0].rotation;})==sigmas.end())
+                throw std::runtime_error("Sigma"+std::to_string(sigma)+" is not found by sigma.");
+        }
+        const auto range(catalogue.bySigma(3,11));
+        for (size_t e=0; e<range.size(); ++e)
+            if (range[e]->sigma<3 || range[e]->sigma>11 || (e>0 && range[e]->sigma<range[e-1]->sigma))
+                throw std::runtime_error("Wrong entries in a sigma range.");
+
+        // the entry builds bicrystals of any common orientation of the two lattices
+        const CslCatalogueEntry sigma3(catalogue.byAngle(axis110,1.23,1.24)[0]);
+        const Eigen::Matrix3d Q(Eigen::AngleAxisd(-sigma3.angle/2,ReciprocalLatticeVector<3>(axis110,fcc).cartesian().normalized()).matrix());
+        const Lattice<3> A(fccBasis,Q);
+        const Lattice<3> B(fccBasis,Q*sigma3.rotation);
+        const BiCrystal<3> symmetric(sigma3.biCrystal(A,B,true));
+        if (symmetric.sigma!=3 || !symmetric.csl.latticeBasis.isApprox(BiCrystal<3>(A,B,true).csl.latticeBasis))
+            throw std::runtime_error("Wrong bicrystal of a rotated pair of lattices.");
+
+        // an entry does not build bicrystals of other rotations
+        bool thrown= false;
+        try
+        {
+            const Lattice<3> other(fccBasis,catalogue.byAngle(fccAxes[0],0.64,0.65)[0].rotation);
+            sigma3.biCrystal(fcc,other);
+        }
+        catch(std::runtime_error&) { thrown= true; }
+        if (!thrown)
+            throw std::runtime_error("An entry built the bicrystal of a different rotation.");
+
+        // hcp [0001]
+        const Eigen::Matrix3d hcpBasis(CslCatalogue::standardBasis("hcp",1.0,1.6));
+        const CslCatalogue hcp("hcp",hcpBasis,{VectorDimI(0,0,1)},30);
+        hcp.write("hcp.cat");
+        const CslCatalogue hcpRead("hcp.cat");
+        std::cout << "hcp [0001] catalogue: " << hcpRead.entries.size() << " entries" << std::endl;
+        validate(hcpRead);
+        const auto sigma7(hcpRead.byAngle(VectorDimI(0,0,1),21.786789/180*std::numbers::pi-1e-6,21.786790/180*std::numbers::pi));
+        if (sigma7.size()!=1 || sigma7[0].sigma!=7)
+            throw std::runtime_error("hcp sigma7 [0001] is not found.");
+    }
+    catch(std::runtime_error& e)
+    {
+        std::cout << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
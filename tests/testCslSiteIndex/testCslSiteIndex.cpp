@@ -0,0 +1,100 @@
+#include <LatticeModule.h>
+#include <GbMesoStateEnsemble.h>
+#include <numbers>
+
+using namespace gbLAB;
+
+int main()
+{
+    try
+    {
+        const double c11= 169.9281940954852/160.2176621;
+        const double c12= 122.65063014404001/160.2176621;
+        GbMaterialTensors::lambda= c12;
+        GbMaterialTensors::mu= (c11-c12)/2;
+
+        Eigen::Matrix3d A;
+        A << 0.0, 0.5, 0.5,
+             0.5, 0.0, 0.5,
+             0.5, 0.5, 0.0;
+        A*= 3.615;
+
+        // Sigma5 [100](0-21) symmetric tilt GB
+        const Eigen::Vector3d axis(1,0,0);
+        const Eigen::AngleAxisd halfRotation(36.869897645844*std::numbers::pi/180/2,axis);
+        const Lattice<3> latticeA(A,halfRotation.matrix());
+        const Lattice<3> latticeB(A,halfRotation.matrix().transpose());
+        const BiCrystal<3> bc(latticeA,latticeB,false);
+        const Eigen::Vector3d normal(halfRotation.matrix()*Eigen::Vector3d(0,-2,1));
+        const Gb<3> gb(bc,latticeA.reciprocalLatticeDirection(normal));
+        const ReciprocalLatticeVector<3> axisA(latticeA.reciprocalLatticeDirection(axis).reciprocalLatticeVector());
+        const LatticeVector<3> axisC(bc.getLatticeDirectionInC(bc.A.latticeDirection(axis).latticeVector()).latticeVector());
+        std::vector<LatticeVector<3>> cslVectors;
+        cslVectors.push_back(bc.csl.latticeDirection(gb.nA.cartesian()).latticeVector());
+        cslVectors.push_back(gb.getPeriodVector(axisA));
+        cslVectors.push_back(axisC);
+        const GbMesoStateEnsemble<3> ensemble(gb,axisA,cslVectors,1.0);
+        const auto& index= *ensemble.cslSites;
+
+        // every shift is found at itself and at its periodic images, and nowhere else
+        Eigen::Matrix3d box;
+        for(int i=0; i<3; ++i)
+            box.col(i)= ensemble.ensembleCslVectors[i].cartesian();
+        box.col(0)*= 5;
+        for(size_t k=0; k<ensemble.bShiftPairs.size(); ++k)
+        {
+            const Eigen::Vector3d& s= ensemble.bShiftPairs[k].second;
+            for(const Eigen::Vector3d& image : {Eigen::Vector3d(s),
+                                                Eigen::Vector3d(s+box.col(1)),
+                                                Eigen::Vector3d(s-box.col(2)+2*box.col(1)),
+                                                Eigen::Vector3d(s+box.col(0)+1e-8*Eigen::Vector3d::Ones())})
+            {
+                const auto* sites= index.find(image);
+                if(sites==nullptr || std::find(sites->begin(),sites->end(),k)==sites->end())
+                    throw std::runtime_error("Shift "+std::to_string(k)+" is not found at one of its images.");
+            }
+            if(index.find(s+Eigen::Vector3d(1e-3,0,0))!=nullptr)
+                throw std::runtime_error("A point off the CSL is found in the index.");
+        }
+        std::cout << "Found the " << index.size() << " shifts of the ensemble at their images" << std::endl;
+
+        // mesostates that share the index of the ensemble delete the same atoms as mesostates with their own index
+        int tested= 0;
+        for(const auto& constraints : GbMesoStateEnsemble<3>::admissibleConstraints(ensemble))
+        {
+            if((constraints.array()==2).count()==0)
+                continue;
+            const auto shared(ensemble.constructMesoState(constraints));
+            const GbMesoState<3> own(gb,axisA,shared.bs,ensemble.ensembleCslVectors,ensemble.bicrystalConfig);
+            if(shared.cslSites==own.cslSites || shared.cslSites!=ensemble.cslSites)
+                throw std::runtime_error("The index of the ensemble is not shared.");
+
+            const Configuration deformed(shared.configurations().second);
+            const Configuration deformedOwn(own.configurations().second);
+            if(deformed.size()!=deformedOwn.size() || !deformed.positions.isApprox(deformedOwn.positions))
+                throw std::runtime_error("The shared and the own index delete different atoms.");
+
+            // no atom remains at a deleted CSL site
+            for(size_t a=0; a<deformed.size(); ++a)
+            {
+                Eigen::Vector3d x(deformed.positions.col(a));
+                const Eigen::Vector3d f((box.inverse()*x).array()-Eigen::Array3d(-0.5,-FLT_EPSILON,-FLT_EPSILON));
+                x-= box*f.array().floor().matrix();
+                for(const auto& [b,s,include] : shared.bs)
+                    if(include==2 && (s-x).norm()<1e-6)
+                        throw std::runtime_error("An atom occupies a deleted CSL site.");
+            }
+            std::cout << "state with " << (constraints.array()==2).count() << " deleted CSL sites: "
+                      << deformed.size() << " atoms" << std::endl;
+            if(++tested==3) break;
+        }
+        if(tested==0)
+            throw std::runtime_error("No mesostates with deleted CSL sites.");
+    }
+    catch(std::runtime_error& e)
+    {
+        std::cout << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
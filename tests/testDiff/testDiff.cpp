@@ -0,0 +1,171 @@
+#include <LatticeModule.h>
+#include <Diff.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+
+using namespace gbLAB;
+
+// counts the heap allocations made through operator new (std::vector, std::map, ...)
+std::atomic<size_t> allocations(0);
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    if (void* p= std::malloc(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+using dcomplex= std::complex<double>;
+
+// Previous implementation of Diff::perform_op: full complex FFTs, and the multipliers evaluated at every call
+template<int dim>
+void referenceDiff(const Eigen::array<Eigen::Index,dim>& d,
+                   const Lattice<dim>& L,
+                   const Eigen::array<Eigen::Index,dim>& n,
+                   const double* x_in,
+                   double* y_out)
+{
+    Eigen::TensorMap<const Eigen::Tensor<double,dim>> xReal(x_in,n);
+    const Eigen::Tensor<dcomplex,dim> x= xReal.template cast<dcomplex>();
+    Eigen::TensorMap<Eigen::Tensor<double,dim>> y(y_out,n);
+
+    Eigen::Tensor<dcomplex,dim> xhat(n);
+    xhat.setZero();
+    FFT::fft(x,xhat);
+
+    Eigen::Tensor<dcomplex,dim> d2fhat(n);
+    for (Eigen::Index p= 0; p<xhat.size(); ++p)
+    {
+        Eigen::array<Eigen::Index,dim> index;
+        Eigen::Index q= p;
+        for (int a= 0; a<dim; ++a)
+        {
+            index[a]= q % n[a];
+            q/= n[a];
+        }
+        dcomplex factor(1,0);
+        for (int k= 0; k<dim; ++k)
+        {
+            if (d[k] == 0) continue;
+            typename LatticeCore<dim>::VectorDimI m;
+            for (int a= 0; a<dim; ++a)
+            {
+                const auto i= index[a];
+                if (d[k] % 2 == 0)
+                    m(a)= (i <= n[a] / 2 ? i : i - n[a]);
+                else
+                    m(a)= (i == n[a] / 2 ? 0 : -n[a] * (i / (n[a] / 2)) + i);
+            }
+            const ReciprocalLatticeVector<dim> r(m,L);
+            factor= factor * std::pow(-2.0 * std::numbers::pi * dcomplex(0, 1) * r.cartesian()(k), d[k]);
+        }
+        d2fhat.data()[p]= xhat.data()[p] * factor;
+    }
+
+    Eigen::Tensor<dcomplex,dim> Lf(n);
+    Lf.setZero();
+    FFT::ifft(d2fhat,Lf);
+    y= Lf.real();
+}
+
+template<int dim>
+void compare(const Eigen::Matrix<double,dim,dim>& A,
+             const Eigen::array<Eigen::Index,dim>& n,
+             const std::vector<Eigen::array<Eigen::Index,dim>>& orders)
+{
+    const Lattice<dim> L(A);
+    const Eigen::Index size= std::accumulate(n.begin(),n.end(),Eigen::Index(1),std::multiplies<>());
+    std::mt19937 generator(dim);
+    std::uniform_real_distribution<double> distribution(-1.0,1.0);
+    Eigen::VectorXd x(size);
+    for (Eigen::Index p= 0; p<size; ++p)
+        x(p)= distribution(generator);
+
+    typename Diff<dim>::Workspace workspace(n);
+    for (const auto& d : orders)
+    {
+        const Diff<dim> diff(d,A,n);
+        Eigen::VectorXd y(size), yWorkspace(size), yReference(size);
+        referenceDiff<dim>(d,L,n,x.data(),yReference.data());
+        diff.perform_op(x.data(),y.data());
+
+        const size_t before= allocations;
+        diff.perform_op(x.data(),yWorkspace.data(),workspace);
+        if (allocations!=before)
+            throw std::runtime_error(std::to_string(dim)+"D: perform_op allocated with a workspace.");
+
+        const double error= (y-yReference).cwiseAbs().maxCoeff()/yReference.cwiseAbs().maxCoeff();
+        std::cout << dim << "D, order";
+        for (const auto& dk : d) std::cout << " " << dk;
+        std::cout << ": relative error= " << error << std::endl;
+        if (error>1e-10 || y!=yWorkspace)
+            throw std::runtime_error(std::to_string(dim)+"D: Diff differs from the previous implementation.");
+    }
+}
+
+int main()
+{
+    try
+    {
+        // 1D
+        Eigen::Matrix<double,1,1> A1;
+        A1 << 2.5;
+        compare<1>(A1,{16},{{1},{2},{3},{4}});
+        compare<1>(A1,{18},{{1},{2}});
+
+        // 2D, oblique cell
+        Eigen::Matrix2d A2;
+        A2 << 3.0, 1.2,
+              0.0, 2.1;
+        compare<2>(A2,{12,10},{{1,0},{0,1},{1,1},{2,0},{2,1},{0,2},{0,0}});
+        compare<2>(A2,{8,14},{{1,0},{0,1},{1,2}});
+
+        // 3D, triclinic cell
+        Eigen::Matrix3d A3;
+        A3 << 2.0, 0.4, 0.3,
+              0.0, 1.7, 0.2,
+              0.0, 0.0, 1.3;
+        compare<3>(A3,{8,6,10},{{1,0,0},{0,1,0},{0,0,1},{0,1,1},{2,0,1},{0,0,2},{1,1,1}});
+
+        // odd grids, where the previous implementation dropped or misplaced frequencies: compare with the
+        // derivatives of a band-limited function, with the symbol (-2 pi i k)^d of the operator
+        const int n= 15;
+        const double a= A1(0,0);
+        const double k1= 2*std::numbers::pi*3/a, k2= 2*std::numbers::pi*7/a;
+        Eigen::VectorXd f(n), df(n), d2f(n);
+        for (int i= 0; i<n; ++i)
+        {
+            const double x= i*a/n;
+            f(i)= std::cos(k1*x) + std::sin(k2*x);
+            df(i)= k1*std::sin(k1*x) - k2*std::cos(k2*x);
+            d2f(i)= -k1*k1*std::cos(k1*x) - k2*k2*std::sin(k2*x);
+        }
+        Eigen::VectorXd y(n);
+        Diff<1>({1},A1,{n}).perform_op(f.data(),y.data());
+        if ((y-df).cwiseAbs().maxCoeff()>1e-10*df.cwiseAbs().maxCoeff())
+            throw std::runtime_error("Wrong first derivative on an odd grid.");
+        Diff<1>({2},A1,{n}).perform_op(f.data(),y.data());
+        if ((y-d2f).cwiseAbs().maxCoeff()>1e-10*d2f.cwiseAbs().maxCoeff())
+            throw std::runtime_error("Wrong second derivative on an odd grid.");
+        std::cout << "1D, odd grid: exact derivatives" << std::endl;
+    }
+    catch(std::runtime_error& e)
+    {
+        std::cout << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,165 @@
+#include <LatticeModule.h>
+#include <GbMesoStateEnsemble.h>
+#include <numbers>
+#include <random>
+#include <string>
+
+using namespace gbLAB;
+
+// conjugate gradient iterations and failures reported through the log since the last call to resetSolverLog
+int cgIterations= 0;
+int cgFailures= 0;
+
+void resetSolverLog()
+{
+    cgIterations= 0;
+    cgFailures= 0;
+}
+
+// counts the iterations of the converged iterative solves and the solves that fell back to the dense solver
+void solverSink(const LogLevel& level, const LogSubsystem& subsystem, std::string_view message)
+{
+    if(subsystem!=LogSubsystem::continuum)
+        return;
+    const std::string_view converged("Conjugate gradients converged in ");
+    if(message.starts_with(converged))
+        cgIterations+= std::stoi(std::string(message.substr(converged.size())));
+    else if(message.find("did not converge")!=std::string_view::npos)
+        cgFailures++;
+    else if(level>=LogLevel::warning)
+        std::cout << message << std::endl;
+}
+
+void checkConvergence()
+{
+    if(cgFailures>0)
+        throw std::runtime_error("Conjugate gradients did not converge; the dense solver was used instead.");
+}
+
+// largest difference between the Fourier coefficients of the displacement jumps of two solutions
+double difference(const GbContinuum<3>& m1, const GbContinuum<3>& m2)
+{
+    double output= 0.0;
+    for(int i=0; i<3; ++i)
+    {
+        const Eigen::Tensor<double,0> d((m1.bhat[i].values-m2.bhat[i].values).abs().maximum());
+        output= std::max(output,d(0));
+    }
+    return output;
+}
+
+int main()
+{
+    try
+    {
+        const double c11= 169.9281940954852/160.2176621;
+        const double c12= 122.65063014404001/160.2176621;
+        GbMaterialTensors::lambda= c12;
+        GbMaterialTensors::mu= (c11-c12)/2;
+
+        Eigen::Matrix3d A;
+        A << 0.0, 0.5, 0.5,
+             0.5, 0.0, 0.5,
+             0.5, 0.5, 0.0;
+        A*= 3.615;
+
+        // Sigma29 [0-10](2 0 -5) symmetric tilt GB
+        const Eigen::Vector3d axis(0,-1,0);
+        const Eigen::AngleAxisd halfRotation(43.60282*std::numbers::pi/180/2,axis.normalized());
+        const Lattice<3> latticeA(A,halfRotation.matrix());
+        const Lattice<3> latticeB(A,halfRotation.matrix().transpose());
+        const BiCrystal<3> bc(latticeA,latticeB,false);
+        const Gb<3> gb(bc,latticeA.reciprocalLatticeDirection(halfRotation.matrix()*Eigen::Vector3d(2,0,5)));
+        const ReciprocalLatticeVector<3> axisA(latticeA.reciprocalLatticeDirection(axis).reciprocalLatticeVector());
+        const LatticeVector<3> axisC(bc.getLatticeDirectionInC(bc.A.latticeDirection(axis).latticeVector()).latticeVector());
+        std::vector<LatticeVector<3>> cslVectors;
+        cslVectors.push_back(bc.csl.latticeDirection(gb.nA.cartesian()).latticeVector());
+        cslVectors.push_back(gb.getPeriodVector(axisA));
+        cslVectors.push_back(axisC);
+        const GbMesoStateEnsemble<3> ensemble(gb,axisA,cslVectors,1.0);
+
+        // the admissible constraints with the most constrained pairs
+        std::vector<XTuplet> states;
+        int maxConstrained= 0;
+        for(const auto& constraints : GbMesoStateEnsemble<3>::admissibleConstraints(ensemble))
+        {
+            const int constrained= (constraints.array()==1).count();
+            if(constrained>maxConstrained)
+                states.clear();
+            if(constrained>=maxConstrained && states.size()<3)
+                states.push_back(constraints);
+            maxConstrained= std::max(maxConstrained,constrained);
+        }
+
+        // the iterative solver reports its iterations at the debug level and falls back to the dense solver with a warning
+        Log::setLevel(LogSubsystem::continuum,LogLevel::debug);
+        Log::setSink(solverSink);
+
+        auto& policy(GbContinuum<3>::solverPolicy);
+        for(const auto& constraints : states)
+        {
+            policy.method= GbContinuumSolverPolicy::dense;
+            const GbMesoState<3> dense(ensemble.constructMesoState(constraints));
+
+            // the second iterative solve starts from the solution of the first one
+            policy.method= GbContinuumSolverPolicy::iterative;
+            GbContinuum<3>::reset();
+            int iterations[2];
+            for(int pass=0; pass<2; ++pass)
+            {
+                resetSolverLog();
+                const GbMesoState<3> iterative(ensemble.constructMesoState(constraints));
+                checkConvergence();
+                iterations[pass]= cgIterations;
+                const double error(difference(dense,iterative));
+                std::cout << dense.xuPairs.size() << " constraints, pass " << pass << ": " << iterations[pass]
+                          << " iterations, difference between the dense and iterative solutions = " << error << std::endl;
+                if(error>1e-8)
+                    throw std::runtime_error("The dense and iterative solvers disagree.");
+            }
+            if(iterations[1]>=iterations[0])
+                throw std::runtime_error("The warm start does not reduce the number of iterations.");
+        }
+
+        // random constraints on atoms scattered near a 40x40 GB
+        GbContinuum<3>::reset();
+        Eigen::Matrix<double,3,2> domain;
+        domain << 40, 0,
+                   0, 0,
+                   0,40;
+        std::mt19937 generator(0);
+        std::uniform_real_distribution<double> distribution(0.0,1.0);
+        std::map<OrderedTuplet<4>,Eigen::Vector3d> atoms, xuPairs;
+        for(int i=0; i<50; ++i)
+        {
+            OrderedTuplet<4> key;
+            key << i, 0, 0, 1;
+            atoms[key]= Eigen::Vector3d(40*distribution(generator),-0.2-2*distribution(generator),40*distribution(generator));
+            xuPairs[key]= 0.1*Eigen::Vector3d(distribution(generator),distribution(generator),distribution(generator));
+        }
+        policy.method= GbContinuumSolverPolicy::dense;
+        const GbContinuum<3> dense(domain,xuPairs,{32,32},atoms);
+        policy.method= GbContinuumSolverPolicy::iterative;
+        resetSolverLog();
+        const GbContinuum<3> iterative(domain,xuPairs,{32,32},atoms);
+        checkConvergence();
+        if(cgIterations==0)
+            throw std::runtime_error("The iterative solver was not used.");
+        const double error(difference(dense,iterative));
+        std::cout << xuPairs.size() << " random constraints: difference between the dense and iterative solutions = " << error << std::endl;
+        if(error>1e-8)
+            throw std::runtime_error("The dense and iterative solvers disagree.");
+        GbContinuum<3>::reset();
+        Log::setSink(Log::Sink());
+
+        policy= GbContinuumSolverPolicy();
+        if(policy.useIterative(policy.denseThreshold) || !policy.useIterative(policy.denseThreshold+1))
+            throw std::runtime_error("Incorrect automatic solver selection.");
+    }
+    catch(std::runtime_error& e)
+    {
+        std::cout << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
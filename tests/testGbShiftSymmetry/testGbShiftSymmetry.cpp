@@ -0,0 +1,169 @@
+#include <LatticeModule.h>
+#include <GbMesoStateEnsemble.h>
+#include <numbers>
+#include <set>
+#include <algorithm>
+#include <optional>
+
+using namespace gbLAB;
+
+// Quantities of a mesostate that do not change under a rigid motion of its box
+struct Invariants
+{
+    size_t numberOfAtoms;
+    //! Sorted magnitudes of the displacements of the atoms
+    std::vector<double> displacements;
+    double surrogateEnergy;
+};
+
+Invariants invariants(const GbMesoState<3>& mesostate)
+{
+    Invariants output;
+    const auto [reference,deformed]= mesostate.configurations();
+    output.numberOfAtoms= reference.size();
+    for(size_t a=0; a<reference.size(); ++a)
+        output.displacements.push_back((deformed.positions.col(a)-reference.positions.col(a)).norm());
+    std::sort(output.displacements.begin(),output.displacements.end());
+    output.surrogateEnergy= std::get<1>(mesostate.surrogateDensityEnergy());
+    return output;
+}
+
+int main()
+{
+    try
+    {
+        const double c11= 169.9281940954852/160.2176621;
+        const double c12= 122.65063014404001/160.2176621;
+        GbMaterialTensors::lambda= c12;
+        GbMaterialTensors::mu= (c11-c12)/2;
+
+        Eigen::Matrix3d A;
+        A << 0.0, 0.5, 0.5,
+             0.5, 0.0, 0.5,
+             0.5, 0.5, 0.0;
+        A*= 3.615;
+        if(GbShiftSymmetry<3>::pointGroup(Lattice<3>(A)).size()!=48)
+            throw std::runtime_error("The FCC point group does not have 48 operations.");
+
+        // Sigma29 [0-10](2 0 -5) symmetric tilt GB
+        const Eigen::Vector3d axis(0,-1,0);
+        const Eigen::AngleAxisd halfRotation(43.60282*std::numbers::pi/180/2,axis.normalized());
+        const Lattice<3> latticeA(A,halfRotation.matrix());
+        const Lattice<3> latticeB(A,halfRotation.matrix().transpose());
+        const BiCrystal<3> bc(latticeA,latticeB,false);
+        const Gb<3> gb(bc,latticeA.reciprocalLatticeDirection(halfRotation.matrix()*Eigen::Vector3d(2,0,5)));
+        const ReciprocalLatticeVector<3> axisA(latticeA.reciprocalLatticeDirection(axis).reciprocalLatticeVector());
+        const LatticeVector<3> axisC(bc.getLatticeDirectionInC(bc.A.latticeDirection(axis).latticeVector()).latticeVector());
+        std::vector<LatticeVector<3>> cslVectors;
+        cslVectors.push_back(bc.csl.latticeDirection(gb.nA.cartesian()).latticeVector());
+        cslVectors.push_back(gb.getPeriodVector(axisA));
+        cslVectors.push_back(axisC);
+        const GbMesoStateEnsemble<3> ensemble(gb,axisA,cslVectors,1.0);
+        const auto& symmetry(ensemble.symmetry);
+
+        // the mirror normal to the tilt axis is a symmetry of the GB
+        if(symmetry.rotations.size()<2)
+            throw std::runtime_error("Missing rotations.");
+        const size_t n= ensemble.bShiftPairs.size();
+        for(size_t i=0; i<n; ++i)
+            if(symmetry.permutations[0][i]!=static_cast<int>(i))
+                throw std::runtime_error("The first operation is not the identity.");
+
+        // closure of the group of permutations
+        std::set<std::vector<int>> group(symmetry.permutations.begin(),symmetry.permutations.end());
+        for(const auto& p : symmetry.permutations)
+            for(const auto& q : symmetry.permutations)
+            {
+                std::vector<int> pq(n);
+                for(size_t i=0; i<n; ++i)
+                    pq[i]= p[q[i]];
+                if(!group.count(pq))
+                    throw std::runtime_error("The permutations do not form a group.");
+            }
+
+        // orbits partition the admissible constraints
+        const GrayCodeTuplets constraintsRange(GbMesoStateEnsemble<3>::admissibleConstraints(ensemble));
+        long long multiplicities= 0, orbits= 0;
+        for(const auto& constraints : constraintsRange)
+        {
+            const auto [canonical,multiplicity]= symmetry.canonicalForm(constraints);
+            if(canonical(0)!=1 || symmetry.canonicalForm(canonical).first!=canonical)
+                throw std::runtime_error("Incorrect canonical form.");
+            for(size_t g=0; g<symmetry.size(); ++g)
+            {
+                const XTuplet image(symmetry.apply(g,constraints));
+                if(image(0)==1 && symmetry.canonicalForm(image)!=std::make_pair(canonical,multiplicity))
+                    throw std::runtime_error("Equivalent constraints have different canonical forms.");
+            }
+            if(canonical==constraints)
+            {
+                ++orbits;
+                multiplicities+= multiplicity;
+            }
+        }
+        if(multiplicities!=static_cast<long long>(constraintsRange.size()))
+            throw std::runtime_error("The multiplicities do not add up to the number of admissible constraints.");
+        if(orbits>=multiplicities)
+            throw std::runtime_error("No reduction.");
+        std::cout << constraintsRange.size() << " admissible constraints in " << orbits << " orbits" << std::endl;
+
+        // symmetry-equivalent constraints of a Sigma5 [100](0-21) symmetric tilt GB give the same mesostate up to a rigid motion
+        {
+            const Eigen::Vector3d axis5(1,0,0);
+            const Eigen::AngleAxisd halfRotation5(36.869897645844*std::numbers::pi/180/2,axis5);
+            const Lattice<3> latticeA5(A,halfRotation5.matrix());
+            const Lattice<3> latticeB5(A,halfRotation5.matrix().transpose());
+            const BiCrystal<3> bc5(latticeA5,latticeB5,false);
+            const Gb<3> gb5(bc5,latticeA5.reciprocalLatticeDirection(halfRotation5.matrix()*Eigen::Vector3d(0,-2,1)));
+            const ReciprocalLatticeVector<3> axisA5(latticeA5.reciprocalLatticeDirection(axis5).reciprocalLatticeVector());
+            const LatticeVector<3> axisC5(bc5.getLatticeDirectionInC(bc5.A.latticeDirection(axis5).latticeVector()).latticeVector());
+            std::vector<LatticeVector<3>> cslVectors5;
+            cslVectors5.push_back(bc5.csl.latticeDirection(gb5.nA.cartesian()).latticeVector());
+            cslVectors5.push_back(gb5.getPeriodVector(axisA5));
+            cslVectors5.push_back(axisC5);
+            const GbMesoStateEnsemble<3> ensemble5(gb5,axisA5,cslVectors5,1.0);
+            const auto& symmetry5(ensemble5.symmetry);
+
+            int compared= 0;
+            for(const auto& constraints : GbMesoStateEnsemble<3>::admissibleConstraints(ensemble5))
+            {
+                std::optional<Invariants> original;
+                for(size_t g=1; g<symmetry5.size() && compared<8; ++g)
+                {
+                    const XTuplet image(symmetry5.apply(g,constraints));
+                    if(image(0)!=1 || image==constraints)
+                        continue;
+                    try
+                    {
+                        if(!original)
+                            original= invariants(ensemble5.constructMesoState(constraints));
+                    }
+                    catch(std::runtime_error&)
+                    {
+                        break;
+                    }
+                    const Invariants equivalent(invariants(ensemble5.constructMesoState(image)));
+                    if(original->numberOfAtoms==0 || equivalent.numberOfAtoms!=original->numberOfAtoms)
+                        throw std::runtime_error("Equivalent constraints give different numbers of atoms.");
+                    for(size_t a=0; a<equivalent.numberOfAtoms; ++a)
+                        if(std::abs(equivalent.displacements[a]-original->displacements[a])>1e-6)
+                            throw std::runtime_error("Equivalent constraints give different displacements.");
+                    if(std::abs(equivalent.surrogateEnergy-original->surrogateEnergy)>1e-6*std::abs(original->surrogateEnergy))
+                        throw std::runtime_error("Equivalent constraints give different energies.");
+                    ++compared;
+                }
+                if(compared==8)
+                    break;
+            }
+            if(compared==0)
+                throw std::runtime_error("No equivalent mesostates were compared.");
+            std::cout << compared << " pairs of equivalent mesostates have equal displacements and energies" << std::endl;
+        }
+    }
+    catch(std::runtime_error& e)
+    {
+        std::cout << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
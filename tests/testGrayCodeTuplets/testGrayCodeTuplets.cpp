@@ -0,0 +1,57 @@
+#include <GrayCodeTuplets.h>
+#include <set>
+
+using namespace gbLAB;
+int main()
+{
+    const int k= 12;
+    // mimic the admissible constraints of a mesostate ensemble:
+    // entry 0 fixed to 1, "CSL" entries in {1,2}, all others in {0,1}
+    XTuplet values0(k), values1(k);
+    values0.setZero();
+    values1.setOnes();
+    values0(3)= 2;
+    values0(7)= 2;
+    values0(0)= 1;
+
+    try {
+        // reference: the eager enumeration used previously
+        std::set<XTuplet> expected;
+        for (auto tuple : XTuplet::generate_tuples(2, k)) {
+            if (tuple(0) != 1) continue;
+            if (tuple(3) == 0) tuple(3)= 2;
+            if (tuple(7) == 0) tuple(7)= 2;
+            expected.insert(tuple);
+        }
+
+        GrayCodeTuplets range(values0, values1);
+        if (range.size() != expected.size())
+            throw std::runtime_error("Wrong number of Gray-code tuplets");
+
+        std::set<XTuplet> enumerated;
+        XTuplet previous(values0);
+        for (auto it = range.begin(); it != range.end(); ++it) {
+            if (it.rank() > 0 && ((*it).array() != previous.array()).count() != 1)
+                throw std::runtime_error("Consecutive tuplets differ in more than one entry");
+            if (range[it.rank()] != *it)
+                throw std::runtime_error("Random access differs from iteration");
+            enumerated.insert(*it);
+            previous= *it;
+        }
+        if (enumerated != expected)
+            throw std::runtime_error("Gray-code enumeration differs from the eager enumeration");
+
+        // iterating from the middle of the range
+        size_t count= 0;
+        for (auto it = range.begin(range.size()/2); it != range.end(); ++it)
+            count++;
+        if (count != range.size()/2)
+            throw std::runtime_error("Partial range has the wrong length");
+    }
+    catch(std::runtime_error& e)
+    {
+        std::cout << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,204 @@
+#include <LatticeModule.h>
+#include <BoxEnumerator.h>
+#include <randomInteger.h>
+#include <set>
+
+using namespace gbLAB;
+
+// Lattice points with fractional coordinates in [0,1)^dim, found by scanning the bounding box of the cell
+template<int dim>
+std::set<std::vector<long long int>> bruteForceBox(const std::vector<LatticeVector<dim>>& boxVectors)
+{
+    using IntScalarType= typename LatticeCore<dim>::IntScalarType;
+    using VectorDimI= typename LatticeCore<dim>::VectorDimI;
+    using MatrixDimI= typename LatticeCore<dim>::MatrixDimI;
+
+    MatrixDimI B;
+    for(int i=0; i<dim; ++i)
+        B.col(i)= boxVectors[i];
+    const IntScalarType detB= std::llround(B.template cast<double>().determinant());
+    const MatrixDimI G= (detB>0? 1 : -1)*MatrixDimIExt<IntScalarType,dim>::adjoint(B);
+
+    VectorDimI lower(VectorDimI::Zero()), upper(VectorDimI::Zero());
+    for(int corner=0; corner<(1<<dim); ++corner)
+    {
+        VectorDimI x(VectorDimI::Zero());
+        for(int i=0; i<dim; ++i)
+            if((corner>>i) & 1) x+= B.col(i);
+        lower= lower.cwiseMin(x);
+        upper= upper.cwiseMax(x);
+    }
+
+    std::set<std::vector<long long int>> output;
+    VectorDimI x(lower);
+    while(true)
+    {
+        const VectorDimI f= G*x;
+        if((f.array()>=0).all() && (f.array()<std::abs(detB)).all())
+            output.insert(std::vector<long long int>(x.data(),x.data()+dim));
+        int i= 0;
+        while(i<dim && x(i)==upper(i))
+        {
+            x(i)= lower(i);
+            ++i;
+        }
+        if(i==dim) break;
+        ++x(i);
+    }
+    return output;
+}
+
+template<int dim>
+void testBox(const Lattice<dim>& lattice, const std::vector<LatticeVector<dim>>& boxVectors)
+{
+    const auto points= lattice.boxPoints(boxVectors);
+    std::set<std::vector<long long int>> pointSet;
+    for(const auto& point : points)
+        pointSet.insert(std::vector<long long int>(point.data(),point.data()+dim));
+    if(pointSet.size()!=points.size())
+        throw std::runtime_error("boxPoints returned duplicate points.");
+    if(pointSet!=bruteForceBox(boxVectors))
+        throw std::runtime_error("boxPoints differs from a brute-force enumeration.");
+
+    size_t count= 0;
+    lattice.forEachBoxPoint(boxVectors,[&](const LatticeVector<dim>& point)
+    {
+        if(count>=points.size() || point!=points[count])
+            throw std::runtime_error("forEachBoxPoint and boxPoints visit points in different orders.");
+        ++count;
+    });
+    if(count!=points.size())
+        throw std::runtime_error("forEachBoxPoint visited a different number of points.");
+
+    const auto coordinates= lattice.boxCoordinates(boxVectors);
+    if(static_cast<size_t>(coordinates.cols())!=points.size())
+        throw std::runtime_error("boxCoordinates returned a different number of points.");
+    for(size_t i=0; i<points.size(); ++i)
+        if(coordinates.col(i)!=points[i])
+            throw std::runtime_error("boxCoordinates and boxPoints differ.");
+
+    // the indices of a point are invariant under box translations and increase in the visiting order
+    const BoxEnumerator<dim> boxEnumerator(boxVectors);
+    for(size_t i=0; i<points.size(); ++i)
+    {
+        const auto n(boxEnumerator.indices(points[i]));
+        const auto translated((points[i]+random<int>(-3,3)*boxVectors[0]-random<int>(-3,3)*boxVectors[dim-1]).eval());
+        if(boxEnumerator.indices(translated)!=n)
+            throw std::runtime_error("Box indices are not invariant under box translations.");
+        if(i>0)
+        {
+            const auto m(boxEnumerator.indices(points[i-1]));
+            if(!std::lexicographical_compare(m.begin(),m.end(),n.begin(),n.end()))
+                throw std::runtime_error("Box indices do not follow the visiting order.");
+        }
+    }
+}
+
+// Lattice points in a ball, compared with a scan of a box of coordinates that contains the ball
+template<int dim>
+void testBall(const Lattice<dim>& lattice, const double& radius)
+{
+    using VectorDimI= typename LatticeCore<dim>::VectorDimI;
+    const auto points= lattice.ballPoints(radius);
+    std::set<std::vector<long long int>> pointSet;
+    for(const auto& point : points)
+    {
+        if(point.cartesian().norm()>radius)
+            throw std::runtime_error("ballPoints returned a point outside the ball.");
+        pointSet.insert(std::vector<long long int>(point.data(),point.data()+dim));
+    }
+    if(pointSet.size()!=points.size())
+        throw std::runtime_error("ballPoints returned duplicate points.");
+
+    // |x_i| <= radius*|row i of the inverse basis|
+    VectorDimI bound;
+    for(int i=0; i<dim; ++i)
+        bound(i)= std::ceil(radius*lattice.reciprocalBasis.col(i).norm());
+    size_t count= 0;
+    VectorDimI x(-bound);
+    while(true)
+    {
+        if(LatticeVector<dim>(x,lattice).cartesian().norm()<=radius)
+        {
+            ++count;
+            if(!pointSet.count(std::vector<long long int>(x.data(),x.data()+dim)))
+                throw std::runtime_error("ballPoints missed a point.");
+        }
+        int i= 0;
+        while(i<dim && x(i)==bound(i))
+        {
+            x(i)= -bound(i);
+            ++i;
+        }
+        if(i==dim) break;
+        ++x(i);
+    }
+    if(count!=points.size())
+        throw std::runtime_error("ballPoints returned a wrong number of points.");
+}
+
+int main()
+{
+    try
+    {
+        seedRandom(2024);
+
+        Eigen::Matrix2d A2;
+        A2 << 1.0, 0.0,
+              0.5, 1.0;
+        Lattice<2> L2(A2);
+        Eigen::Matrix3d A3;
+        A3 << 0.0, 0.5, 0.5,
+              0.5, 0.0, 0.5,
+              0.5, 0.5, 0.0;
+        Lattice<3> L3(A3);
+
+        int tested2= 0, tested3= 0;
+        while(tested2<20)
+        {
+            LatticeVector<2> b1(L2), b2(L2);
+            b1 << random<int>(-15,15), random<int>(-15,15);
+            b2 << random<int>(-15,15), random<int>(-15,15);
+            if(b1(0)*b2(1)-b1(1)*b2(0)==0) continue;
+            testBox<2>(L2,{b1,b2});
+            L2.box(std::vector<LatticeVector<2>>{b1,b2});
+            ++tested2;
+        }
+        while(tested3<20)
+        {
+            std::vector<LatticeVector<3>> boxVectors(3,LatticeVector<3>(L3));
+            for(auto& b : boxVectors)
+                b << random<int>(-6,6), random<int>(-6,6), random<int>(-6,6);
+            Eigen::Matrix3d B;
+            for(int i=0; i<3; ++i)
+                B.col(i)= boxVectors[i].template cast<double>();
+            if(std::abs(B.determinant())<0.5) continue;
+            testBox<3>(L3,boxVectors);
+            if(L3.box(boxVectors).size()!=std::llround(std::abs(B.determinant())))
+                throw std::runtime_error("box returned a wrong number of points.");
+            ++tested3;
+        }
+
+        // skewed bases exercise the reduction in the ball enumeration
+        Eigen::Matrix2d S2;
+        S2 << 1.0, 7.3,
+              0.0, 0.9;
+        Eigen::Matrix3d S3;
+        S3 << 1.0, 4.0, 9.1,
+              0.0, 1.1, 5.0,
+              0.2, 0.0, 0.8;
+        for(const double radius : {0.0, 0.5, 1.0, 2.7, 6.0})
+        {
+            testBall<2>(L2,radius);
+            testBall<2>(Lattice<2>(S2),radius);
+            testBall<3>(L3,radius);
+            testBall<3>(Lattice<3>(S3),radius);
+        }
+    }
+    catch(std::runtime_error& e)
+    {
+        std::cout << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <Log.h>
+#include <thread>
+#include <vector>
+
+using namespace gbLAB;
+
+int main()
+{
+    try
+    {
+        std::vector<std::string> messages;
+        Log::setSink([&messages](const LogLevel&, const LogSubsystem& subsystem, std::string_view message){
+            messages.emplace_back(std::string(Log::subsystemNames[static_cast<int>(subsystem)]) + ":" + std::string(message));
+        });
+
+        // messages below the runtime level are not evaluated
+        Log::setLevel(LogLevel::warning);
+        int evaluations= 0;
+        OILAB_LOG(info,gb) << ++evaluations;
+        OILAB_LOG(warning,gb) << ++evaluations;
+        if(evaluations!=1 || messages.size()!=1 || messages[0]!="gb:1")
+            throw std::runtime_error("Incorrect level filtering.");
+
+        // per-subsystem levels
+        Log::configure("error,continuum=debug");
+        if(Log::level(LogSubsystem::math)!=LogLevel::error || Log::level(LogSubsystem::continuum)!=LogLevel::debug)
+            throw std::runtime_error("Incorrect configuration.");
+        messages.clear();
+        OILAB_LOG(warning,math) << "filtered";
+        OILAB_LOG(debug,continuum) << "emitted";
+        if(messages.size()!=1 || messages[0]!="continuum:emitted")
+            throw std::runtime_error("Incorrect per-subsystem filtering.");
+        if(OILAB_LOG_ENABLED(info,math) || !OILAB_LOG_ENABLED(error,math))
+            throw std::runtime_error("Incorrect OILAB_LOG_ENABLED.");
+
+        bool thrown= false;
+        try
+        {
+            Log::configure("verbose");
+        }
+        catch(std::invalid_argument&)
+        {
+            thrown= true;
+        }
+        if(!thrown)
+            throw std::runtime_error("An unknown level was accepted.");
+
+        // concurrent messages are neither lost nor interleaved
+        messages.clear();
+        Log::setLevel(LogLevel::info);
+        std::vector<std::thread> threads;
+        for(int t=0; t<4; ++t)
+            threads.emplace_back([t](){
+                for(int i=0; i<250; ++i)
+                    OILAB_LOG(info,monteCarlo) << "thread " << t << " message " << i;
+            });
+        for(auto& thread : threads)
+            thread.join();
+        if(messages.size()!=1000)
+            throw std::runtime_error("Lost messages.");
+        for(const auto& message : messages)
+            if(message.rfind("monteCarlo:thread ",0)!=0)
+                throw std::runtime_error("Interleaved message " + message);
+        Log::setSink(Log::Sink());
+    }
+    catch(std::runtime_error& e)
+    {
+        std::cout << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
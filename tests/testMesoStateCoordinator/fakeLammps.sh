@@ -0,0 +1,23 @@
+#!/bin/sh
+# Stands in for LAMMPS in testMesoStateCoordinator: called as "fakeLammps.sh -in <input script>",
+# it prints a deterministic function of the configuration in the data file named by the input
+# script to the output file named by it, in the format written by the real input script.
+# If FAKE_LAMMPS_CRASH is set, the first call kills the oilab-worker that made it.
+input=$2
+data=$(awk '$1=="read_data"{print $2}' "$input")
+output=$(awk '$1=="print"{print $NF}' "$input")
+
+if [ -n "$FAKE_LAMMPS_CRASH" ] && mkdir crash.lock 2>/dev/null; then
+    pid=$$
+    while [ "$pid" -gt 1 ]; do
+        pid=$(awk '{print $4}' /proc/$pid/stat)
+        if [ "$(cat /proc/$pid/comm)" = "oilab-worker" ]; then
+            kill -9 "$pid"
+            exit 1
+        fi
+    done
+fi
+
+awk 'atoms && NF>=5 {n++; e+=$3*$3+0.5*$4-0.25*$5}
+     /^Atoms/ {atoms=1}
+     END {printf "coh = 0 energy = 0 numAtoms = %d GBene = %.12g area = 1\n", n, e}' "$data" > "$output"
@@ -0,0 +1,185 @@
+#include <LatticeModule.h>
+#include <GbMesoStateEnsemble.h>
+#include <EnergyEvaluator.h>
+#include <MesoStateCoordinator.h>
+#include <cstdlib>
+#include <filesystem>
+#include <numbers>
+#include <csignal>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+using namespace gbLAB;
+
+// connects to the coordinator listening on socketPath, without spawning a worker
+int connectTo(const std::string& socketPath)
+{
+    sockaddr_un address;
+    std::memset(&address,0,sizeof(address));
+    address.sun_family= AF_UNIX;
+    std::strncpy(address.sun_path,socketPath.c_str(),sizeof(address.sun_path)-1);
+    const int fd= ::socket(AF_UNIX,SOCK_STREAM,0);
+    if(fd<0 || ::connect(fd,reinterpret_cast<const sockaddr*>(&address),sizeof(address))!=0)
+        throw std::runtime_error("Cannot connect to "+socketPath+".");
+    WorkerProtocol::disableSigPipe(fd);
+    return fd;
+}
+
+// the results of the workers have to be those of the same evaluations in this process
+void compare(const std::vector<MesoStateWorkResult>& results, const std::vector<std::pair<double,double>>& expected, const std::string& name)
+{
+    if(results.size()!=expected.size())
+        throw std::runtime_error(name+": wrong number of results.");
+    for(size_t i=0; i<results.size(); ++i)
+    {
+        if(!results[i].success)
+            throw std::runtime_error(name+": state "+std::to_string(i)+" failed: "+results[i].message);
+        if(results[i].density!=expected[i].first || results[i].energy!=expected[i].second)
+            throw std::runtime_error(name+": wrong result for state "+std::to_string(i)+".");
+    }
+    std::cout << name << ": " << results.size() << " results match the serial evaluation" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        if(argc<3)
+            throw std::runtime_error("Usage: testMesoStateCoordinator <oilab-worker> <fake LAMMPS>");
+        const std::string workerExecutable(argv[1]);
+        const std::string lmpLocation(argv[2]);
+
+        const double c11= 169.9281940954852/160.2176621;
+        const double c12= 122.65063014404001/160.2176621;
+        GbMaterialTensors::lambda= c12;
+        GbMaterialTensors::mu= (c11-c12)/2;
+
+        Eigen::Matrix3d A;
+        A << 0.0, 0.5, 0.5,
+             0.5, 0.0, 0.5,
+             0.5, 0.5, 0.0;
+        A*= 3.615;
+
+        // Sigma29 [0-10](2 0 -5) symmetric tilt GB
+        const Eigen::Vector3d axis(0,-1,0);
+        const Eigen::AngleAxisd halfRotation(43.60282*std::numbers::pi/180/2,axis.normalized());
+        const Lattice<3> latticeA(A,halfRotation.matrix());
+        const Lattice<3> latticeB(A,halfRotation.matrix().transpose());
+        const BiCrystal<3> bc(latticeA,latticeB,false);
+        const Eigen::Vector3d normal(halfRotation.matrix()*Eigen::Vector3d(2,0,5));
+        const Gb<3> gb(bc,latticeA.reciprocalLatticeDirection(normal));
+        const ReciprocalLatticeVector<3> axisA(latticeA.reciprocalLatticeDirection(axis).reciprocalLatticeVector());
+        const LatticeVector<3> axisC(bc.getLatticeDirectionInC(bc.A.latticeDirection(axis).latticeVector()).latticeVector());
+        std::vector<LatticeVector<3>> cslVectors;
+        cslVectors.push_back(bc.csl.latticeDirection(gb.nA.cartesian()).latticeVector());
+        cslVectors.push_back(gb.getPeriodVector(axisA));
+        cslVectors.push_back(axisC);
+        const GbMesoStateEnsemble<3> ensemble(gb,axisA,cslVectors,1.0);
+
+        MesoStateWorkerSetup setup;
+        setup.latticeBasis= A;
+        setup.rotationA= halfRotation.matrix();
+        setup.rotationB= halfRotation.matrix().transpose();
+        setup.gbNormal= normal;
+        setup.axis= axisA.cartesian();
+        for(int i=0; i<3; ++i)
+            setup.cslVectors.col(i)= cslVectors[i].cartesian();
+        setup.bhalfMax= 1.0;
+        setup.lambda= GbMaterialTensors::lambda;
+        setup.mu= GbMaterialTensors::mu;
+        setup.lmpLocation= lmpLocation;
+        setup.potentialName= "none";
+
+        std::vector<XTuplet> states;
+        std::vector<std::pair<double,double>> expected;
+        const LammpsEnergyEvaluator<GbMesoState<3>> evaluator{lmpLocation,setup.potentialName};
+        for(const auto& constraints : GbMesoStateEnsemble<3>::admissibleConstraints(ensemble))
+        {
+            states.push_back(constraints);
+            expected.push_back(evaluator(ensemble.constructMesoState(constraints)));
+            if(states.size()==11) break;
+        }
+
+        MesoStateCoordinator::Options options;
+        options.numberOfWorkers= 3;
+        options.workerExecutable= workerExecutable;
+        options.shardSize= 2;
+        {
+            MesoStateCoordinator coordinator(setup,options);
+            if(coordinator.numberOfWorkers()!=3)
+                throw std::runtime_error("Not all workers started.");
+            compare(coordinator.evaluate(states),expected,"3 workers");
+            // the workers are reused
+            compare(coordinator.evaluate(std::vector<XTuplet>(states.rbegin(),states.rend())),
+                    std::vector<std::pair<double,double>>(expected.rbegin(),expected.rend()),"3 workers, reversed");
+        }
+
+        // peers that claim the process id of a local worker, or announce an oversized message, are dropped
+        // without harming the local workers
+        options.socketPath= "testMesoStateCoordinator.sock";
+        {
+            MesoStateCoordinator coordinator(setup,options);
+            const std::vector<pid_t> localWorkers(coordinator.workerProcesses());
+
+            const int impostor= connectTo(options.socketPath);
+            BinaryWriter hello;
+            hello.write(WorkerProtocol::version);
+            hello.write(static_cast<std::int64_t>(localWorkers.front()));
+            WorkerProtocol::send(impostor,WorkerProtocol::MessageType::hello,hello);
+            ::close(impostor);
+
+            const int oversized= connectTo(options.socketPath);
+            BinaryWriter header;
+            header.write(WorkerProtocol::magic);
+            header.write(WorkerProtocol::MessageType::hello);
+            header.write(std::uint64_t(1) << 62);
+            WorkerProtocol::sendAll(oversized,header.data().data(),header.data().size());
+
+            compare(coordinator.evaluate(states),expected,"impostor workers");
+            ::close(oversized);
+            if(coordinator.workerProcesses()!=localWorkers)
+                throw std::runtime_error("A local worker was dropped because of another peer.");
+            for(const auto& pid : localWorkers)
+                if(::kill(pid,0)!=0)
+                    throw std::runtime_error("The local worker "+std::to_string(pid)+" was killed because of another peer.");
+        }
+        options.socketPath.clear();
+
+        // the first energy evaluation kills its worker; its shard is evaluated by another one
+        std::filesystem::remove("crash.lock");
+        ::setenv("FAKE_LAMMPS_CRASH","1",1);
+        {
+            MesoStateCoordinator coordinator(setup,options);
+            compare(coordinator.evaluate(states),expected,"worker killed");
+            if(!std::filesystem::exists("crash.lock"))
+                throw std::runtime_error("No worker was killed.");
+            if(coordinator.workerProcesses().size()!=3)
+                throw std::runtime_error("The killed worker was not replaced.");
+        }
+        ::unsetenv("FAKE_LAMMPS_CRASH");
+        std::filesystem::remove("crash.lock");
+
+        // workers that cannot start are detected
+        options.workerExecutable= "./nonexistent-worker";
+        options.startupTimeout= 10.0;
+        bool failed= false;
+        try
+        {
+            MesoStateCoordinator coordinator(setup,options);
+        }
+        catch(std::runtime_error& e)
+        {
+            std::cout << "Missing worker executable detected: " << e.what() << std::endl;
+            failed= true;
+        }
+        if(!failed)
+            throw std::runtime_error("The coordinator started without workers.");
+    }
+    catch(std::runtime_error& e)
+    {
+        std::cout << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include <LatticeModule.h>
+#include <GbMesoStateEnsemble.h>
+#include <numbers>
+
+using namespace gbLAB;
+
+// offsets m of the periodic images cell*m within cutoff of the cell
+std::vector<Eigen::Vector3d> images(const Eigen::Matrix3d& cell, const double& cutoff)
+{
+    const Eigen::Matrix3d cellInverse(cell.inverse());
+    std::array<int,3> m;
+    for(int d=0; d<3; ++d)
+        m[d]= std::ceil(cutoff*cellInverse.row(d).norm())+1;
+    std::vector<Eigen::Vector3d> output;
+    for(int i=-m[0]; i<=m[0]; ++i)
+        for(int j=-m[1]; j<=m[1]; ++j)
+            for(int k=-m[2]; k<=m[2]; ++k)
+                output.push_back(cell*Eigen::Vector3d(i,j,k));
+    return output;
+}
+
+// the fractional part of x in the cell, as a Cartesian vector
+Eigen::Vector3d wrap(const Eigen::Matrix3d& cell, const Eigen::Vector3d& x)
+{
+    Eigen::Vector3d f(cell.inverse()*x);
+    f= f.array()-f.array().floor();
+    return cell*f;
+}
+
+int main()
+{
+    try
+    {
+        const double c11= 169.9281940954852/160.2176621;
+        const double c12= 122.65063014404001/160.2176621;
+        GbMaterialTensors::lambda= c12;
+        GbMaterialTensors::mu= (c11-c12)/2;
+
+        Eigen::Matrix3d A;
+        A << 0.0, 0.5, 0.5,
+             0.5, 0.0, 0.5,
+             0.5, 0.5, 0.0;
+        A*= 3.615;
+
+        // Sigma5 [100](0-21) symmetric tilt GB
+        const Eigen::Vector3d axis(1,0,0);
+        const Eigen::AngleAxisd halfRotation(36.869897645844*std::numbers::pi/180/2,axis);
+        const Lattice<3> latticeA(A,halfRotation.matrix());
+        const Lattice<3> latticeB(A,halfRotation.matrix().transpose());
+        const BiCrystal<3> bc(latticeA,latticeB,false);
+        const Eigen::Vector3d normal(halfRotation.matrix()*Eigen::Vector3d(0,-2,1));
+        const Gb<3> gb(bc,latticeA.reciprocalLatticeDirection(normal));
+        const ReciprocalLatticeVector<3> axisA(latticeA.reciprocalLatticeDirection(axis).reciprocalLatticeVector());
+        const LatticeVector<3> axisC(bc.getLatticeDirectionInC(bc.A.latticeDirection(axis).latticeVector()).latticeVector());
+        std::vector<LatticeVector<3>> cslVectors;
+        cslVectors.push_back(bc.csl.latticeDirection(gb.nA.cartesian()).latticeVector());
+        cslVectors.push_back(gb.getPeriodVector(axisA));
+        cslVectors.push_back(axisC);
+        const GbMesoStateEnsemble<3> ensemble(gb,axisA,cslVectors,1.0);
+
+        int tested= 0;
+        for(const auto& constraints : GbMesoStateEnsemble<3>::admissibleConstraints(ensemble))
+        {
+            const auto mesostate(ensemble.constructMesoState(constraints));
+            const Configuration deformed(mesostate.configurations().second);
+            const Eigen::Matrix3d cell(deformed.box);
+            const double sigma= mesostate.densityWidth();
+            const auto n= mesostate.densityGrid();
+            const double cutoff= 2*sigma*std::sqrt(std::log(1e16));
+            const auto offsets(images(cell,cutoff));
+
+            std::vector<Eigen::Vector3d> x;
+            for(size_t a=0; a<deformed.size(); ++a)
+                x.push_back(wrap(cell,deformed.positions.col(a)));
+
+            // density at a sample of the grid points against the direct sum over the atoms and their images
+            const PeriodicFunction<double,3> rho(mesostate.density(n,sigma));
+            const double gaussianNormalization= std::pow(2*std::numbers::pi*sigma*sigma,-1.5);
+            double maxRho= 0.0, maxRhoError= 0.0;
+            for(Eigen::Index g=0; g<n[0]*n[1]*n[2]; g+=997)
+            {
+                const Eigen::Index i= g/(n[1]*n[2]), j= (g/n[2])%n[1], k= g%n[2];
+                const Eigen::Vector3d y(i*cell.col(0)/n[0]+j*cell.col(1)/n[1]+k*cell.col(2)/n[2]);
+                double direct= 0.0;
+                for(const auto& xa : x)
+                    for(const auto& offset : offsets)
+                        direct+= std::exp(-(y-xa-offset).squaredNorm()/(2*sigma*sigma));
+                direct*= gaussianNormalization;
+                maxRho= std::max(maxRho,direct);
+                maxRhoError= std::max(maxRhoError,std::abs(direct-rho.values(i,j,k)));
+            }
+
+            // pairwise Gaussian overlap against the surrogate computed from the density
+            double overlap= 0.0;
+            for(size_t a=0; a<x.size(); ++a)
+                for(size_t b=0; b<x.size(); ++b)
+                    for(const auto& offset : offsets)
+                    if(a!=b || offset.squaredNorm()>1e-12)
+                        overlap+= 0.5*std::exp(-(x[a]-x[b]-offset).squaredNorm()/(4*sigma*sigma));
+            double latticeOverlap= 0.0;
+            for(const auto& offset : images(A,cutoff))
+                if(offset.squaredNorm()>1e-12)
+                    latticeOverlap+= 0.5*std::exp(-offset.squaredNorm()/(4*sigma*sigma));
+            const double area= cell.col(1).cross(cell.col(2)).norm();
+            const double directEnergy= (overlap-x.size()*latticeOverlap)/(2*area);
+            const auto [numberOfAtoms,energy,surrogateRho]= mesostate.surrogateDensityEnergy(n,sigma);
+
+            std::cout << "state " << tested << ": " << x.size() << " atoms, grid " << n[0] << "x" << n[1] << "x" << n[2]
+                      << ", density error " << maxRhoError/maxRho
+                      << ", energy " << energy << " (direct " << directEnergy << ")" << std::endl;
+            if(maxRhoError>1e-3*maxRho)
+                throw std::runtime_error("The deposited density differs from the direct sum.");
+            if(numberOfAtoms!=x.size())
+                throw std::runtime_error("Wrong number of atoms.");
+            if(std::abs(energy-directEnergy)>1e-2*std::abs(directEnergy))
+                throw std::runtime_error("The surrogate energy differs from the direct pairwise sum.");
+            if(++tested==2) break;
+        }
+        if(tested==0)
+            throw std::runtime_error("No admissible mesostates.");
+    }
+    catch(std::runtime_error& e)
+    {
+        std::cout << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
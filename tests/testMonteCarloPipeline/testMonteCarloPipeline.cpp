@@ -0,0 +1,125 @@
+#include <LatticeModule.h>
+#include <GbMesoStateEnsemble.h>
+#include <MonteCarlo.h>
+#include <CanonicalTP.h>
+#include <LandauWangTP.h>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <numbers>
+#include <thread>
+
+using namespace gbLAB;
+
+using Canonical= CanonicalTP<XTuplet,GbMesoState<3>>;
+using LandauWang= LandauWangTP<XTuplet,GbMesoState<3>>;
+template<typename TransitionProbabilityType>
+using Walker= MonteCarlo<XTuplet,GbMesoState<3>,GbMesoStateEnsemble<3>,TransitionProbabilityType>;
+
+const std::thread::id mainThread(std::this_thread::get_id());
+std::atomic<int> workerEvaluations(0);
+
+// a cheap, deterministic stand-in for LAMMPS: the number of constraints and the squared constraint displacements
+std::pair<double,double> constraintEnergy(const GbMesoState<3>& mesoState)
+{
+    if(std::this_thread::get_id()!=mainThread)
+        workerEvaluations++;
+    double output= 0.0;
+    for(const auto& [x,u] : mesoState.xuPairs)
+        output+= u.squaredNorm();
+    return std::make_pair(mesoState.xuPairs.size(),output);
+}
+
+std::string contents(const std::string& filename)
+{
+    std::ifstream file(filename,std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(file)),std::istreambuf_iterator<char>());
+}
+
+/*
+ * Runs a serial and a pipelined walker with the same seed, one step per evolve() call and then
+ * in longer evolve() calls. The trajectories and the final checkpoints have to be identical.
+ */
+template<typename TransitionProbabilityType, typename FactoryType>
+void testPipeline(const GbMesoStateEnsemble<3>& ensemble, const FactoryType& factory, const int& n, const std::string& name)
+{
+    auto tpSerial(factory());
+    Walker<TransitionProbabilityType> serial(ensemble,*tpSerial,5,1);
+    auto tpPipelined(factory());
+    Walker<TransitionProbabilityType> pipelined(ensemble,*tpPipelined,5,1);
+    pipelined.pipeline(2,2,4);
+
+    int transitions= 0;
+    for(int i=0; i<n; ++i)
+    {
+        const XTuplet previous(serial.currentState);
+        serial.evolve(1);
+        pipelined.evolve(1);
+        if(serial.currentState!=pipelined.currentState)
+            throw std::runtime_error(name+": the pipelined chain deviates from the serial chain at step "+std::to_string(i)+".");
+        transitions+= (serial.currentState!=previous);
+    }
+    serial.evolve(3*n);
+    pipelined.evolve(3*n);
+
+    serial.save(name+"_serial.bin");
+    pipelined.save(name+"_pipelined.bin");
+    if(serial.currentState!=pipelined.currentState || contents(name+"_serial.bin")!=contents(name+"_pipelined.bin"))
+        throw std::runtime_error(name+": the pipelined run differs from the serial run.");
+    std::cout << name << ": pipelined run matches the serial run (" << transitions << " transitions in the first "
+              << n << " steps)" << std::endl;
+}
+
+int main()
+{
+    try
+    {
+        const double c11= 169.9281940954852/160.2176621;
+        const double c12= 122.65063014404001/160.2176621;
+        GbMaterialTensors::lambda= c12;
+        GbMaterialTensors::mu= (c11-c12)/2;
+
+        Eigen::Matrix3d A;
+        A << 0.0, 0.5, 0.5,
+             0.5, 0.0, 0.5,
+             0.5, 0.5, 0.0;
+        A*= 3.615;
+
+        // Sigma29 [0-10](2 0 -5) symmetric tilt GB
+        const Eigen::Vector3d axis(0,-1,0);
+        const Eigen::AngleAxisd halfRotation(43.60282*std::numbers::pi/180/2,axis.normalized());
+        const Lattice<3> latticeA(A,halfRotation.matrix());
+        const Lattice<3> latticeB(A,halfRotation.matrix().transpose());
+        const BiCrystal<3> bc(latticeA,latticeB,false);
+        const Gb<3> gb(bc,latticeA.reciprocalLatticeDirection(halfRotation.matrix()*Eigen::Vector3d(2,0,5)));
+        const ReciprocalLatticeVector<3> axisA(latticeA.reciprocalLatticeDirection(axis).reciprocalLatticeVector());
+        const LatticeVector<3> axisC(bc.getLatticeDirectionInC(bc.A.latticeDirection(axis).latticeVector()).latticeVector());
+        std::vector<LatticeVector<3>> cslVectors;
+        cslVectors.push_back(bc.csl.latticeDirection(gb.nA.cartesian()).latticeVector());
+        cslVectors.push_back(gb.getPeriodVector(axisA));
+        cslVectors.push_back(axisC);
+        const GbMesoStateEnsemble<3> ensemble(gb,axisA,cslVectors,1.0);
+
+        testPipeline<Canonical>(ensemble,[](){
+            return std::make_unique<Canonical>(EnergyEvaluator<GbMesoState<3>>(constraintEnergy),0.5,std::make_shared<StateEnergyStore<XTuplet>>());
+        },30,"canonical");
+
+        std::remove("mask.txt");
+        std::remove("theta.txt");
+        testPipeline<LandauWang>(ensemble,[](){
+            return std::make_unique<LandauWang>(std::make_tuple(0.0,2.0,8),std::make_tuple(0.0,1.0,1),EnergyEvaluator<GbMesoState<3>>(constraintEnergy),
+                                                std::make_shared<StateEnergyStore<XTuplet>>());
+        },30,"landauWang");
+
+        std::cout << workerEvaluations << " energies evaluated by the pipeline" << std::endl;
+        if(workerEvaluations==0)
+            throw std::runtime_error("The pipeline did not evaluate any energy.");
+    }
+    catch(std::runtime_error& e)
+    {
+        std::cout << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,52 @@
+#include <PackedXTuplet.h>
+#include <random>
+#include <unordered_set>
+
+using namespace gbLAB;
+int main()
+{
+    std::mt19937 gen(12345);
+    std::uniform_int_distribution<> entry(0, 2);
+    std::uniform_int_distribution<> length(1, 80);
+
+    try {
+        std::unordered_set<PackedXTuplet> visited;
+        for (int trial = 0; trial < 1000; ++trial) {
+            XTuplet x(length(gen)), y(length(gen));
+            for (auto& e : x) e = entry(gen);
+            for (auto& e : y) e = entry(gen);
+            if (trial % 3 == 0) y = x;
+            if (trial % 3 == 1 && y.size() == x.size()) y(y.size() - 1) = x(x.size() - 1);
+
+            PackedXTuplet px(x), py(y);
+            if (px.unpack() != x)
+                throw std::runtime_error("Round trip through PackedXTuplet failed");
+            if (px.density() != x.density())
+                throw std::runtime_error("Cached density differs from XTuplet::density()");
+            if ((px == py) != (x.size() == y.size() && x == y))
+                throw std::runtime_error("Packed equality differs from XTuplet equality");
+            if (px == py && px.hash() != py.hash())
+                throw std::runtime_error("Equal tuplets have different hashes");
+            if (x.size() == y.size() && (px < py) != (x < y))
+                throw std::runtime_error("Packed ordering differs from XTuplet ordering");
+
+            // incremental updates must match a fresh packing
+            const int index = std::uniform_int_distribution<>(0, x.size() - 1)(gen);
+            x(index) = entry(gen);
+            px.set(index, x(index));
+            const PackedXTuplet fresh(x);
+            if (px != fresh || px.hash() != fresh.hash() || px.density() != x.density())
+                throw std::runtime_error("Incremental update differs from a fresh packing");
+
+            visited.insert(px);
+            if (visited.find(fresh) == visited.end())
+                throw std::runtime_error("std::hash lookup failed");
+        }
+    }
+    catch(std::runtime_error& e)
+    {
+        std::cout << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include <Profiler.h>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace gbLAB;
+
+void work(const int& n)
+{
+    OILAB_PROFILE_SCOPE("work");
+    OILAB_PROFILE_COUNT("items",n);
+    std::this_thread::sleep_for(std::chrono::milliseconds(n));
+}
+
+int main()
+{
+    try
+    {
+        std::vector<std::thread> threads;
+        for(int t=0; t<4; ++t)
+            threads.emplace_back([](){
+                for(int i=1; i<=5; ++i)
+                    work(i);
+            });
+        for(auto& thread : threads)
+            thread.join();
+
+        // records of finished threads are kept and merged
+        const Profiler::Record timer(Profiler::record("work"));
+        if(timer.calls!=20)
+            throw std::runtime_error("Incorrect number of timed calls.");
+        if(timer.total<4*15*1000000ull || timer.max<5*1000000ull || timer.max>timer.total)
+            throw std::runtime_error("Incorrect timings.");
+        const Profiler::Record counter(Profiler::record("items"));
+        if(counter.calls!=20 || counter.total!=4*15)
+            throw std::runtime_error("Incorrect counter.");
+
+        std::ostringstream table, json;
+        Profiler::report(table);
+        Profiler::writeJSON(json);
+        if(table.str().find("work")==std::string::npos || table.str().find("items")==std::string::npos)
+            throw std::runtime_error("Incomplete table.");
+        if(json.str().find("\"name\": \"items\", \"calls\": 20, \"total\": 60")==std::string::npos)
+            throw std::runtime_error("Incorrect JSON:\n" + json.str());
+
+        Profiler::reset();
+        if(Profiler::record("work").calls!=0)
+            throw std::runtime_error("Reset failed.");
+        work(1);
+        if(Profiler::record("work").calls!=1)
+            throw std::runtime_error("Incorrect number of timed calls after reset.");
+    }
+    catch(std::runtime_error& e)
+    {
+        std::cout << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <randomInteger.h>
+#include <vector>
+
+using namespace gbLAB;
+int main()
+{
+    try {
+        // same seed and stream => identical sequences; different streams => different sequences
+        RandomEngine a(2024, 3), b(2024, 3), c(2024, 4);
+        int sameAC= 0;
+        for (int i = 0; i < 1000; ++i) {
+            const auto x= a(), y= b(), z= c();
+            if (x != y)
+                throw std::runtime_error("Equal seeds produced different sequences");
+            if (x == z) sameAC++;
+        }
+        if (sameAC > 0)
+            throw std::runtime_error("Different streams produced correlated sequences");
+
+        // 64x64->128 bit products
+        std::uint64_t low;
+        if (RandomEngine::multiply(~0ull, ~0ull, low) != 0xfffffffffffffffeull || low != 1)
+            throw std::runtime_error("Incorrect product of the largest 64-bit integers");
+        if (RandomEngine::multiply(0x123456789abcdef0ull, 0x0fedcba987654321ull, low) != 0x0121fa00ad77d742ull
+            || low != 0x2236d88fe5618cf0ull)
+            throw std::runtime_error("Incorrect 128-bit product");
+
+        // bounds and uniformity of integer draws
+        std::vector<int> histogram(3, 0);
+        const int n= 300000;
+        for (int i = 0; i < n; ++i) {
+            const int v= a.uniform<int>(0, 2);
+            if (v < 0 || v > 2)
+                throw std::runtime_error("Integer draw out of range");
+            histogram[v]++;
+        }
+        for (const auto& count : histogram)
+            if (std::abs(count - n/3) > 0.01*n)
+                throw std::runtime_error("Integer draws are not uniform");
+
+        // bounds and mean of real draws
+        double mean= 0.0;
+        for (int i = 0; i < n; ++i) {
+            const double u= a.uniform<double>(0.0, 1.0);
+            if (u < 0.0 || u >= 1.0)
+                throw std::runtime_error("Real draw out of range");
+            mean+= u/n;
+        }
+        if (std::abs(mean - 0.5) > 0.01)
+            throw std::runtime_error("Real draws are not uniform");
+
+        // random<T> uses the installed engine
+        RandomEngine walker(7, 1), reference(7, 1);
+        {
+            ScopedRandomEngine scope(walker);
+            for (int i = 0; i < 10; ++i)
+                if (random<int>(-100, 100) != reference.uniform<int>(-100, 100))
+                    throw std::runtime_error("random<T> does not draw from the installed engine");
+        }
+
+        // seeding the thread engine makes random<T> reproducible
+        seedRandom(11);
+        const double first= random<double>(0.0, 1.0);
+        seedRandom(11);
+        if (random<double>(0.0, 1.0) != first)
+            throw std::runtime_error("seedRandom is not reproducible");
+    }
+    catch(std::runtime_error& e)
+    {
+        std::cout << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
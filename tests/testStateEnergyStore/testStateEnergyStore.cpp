@@ -0,0 +1,74 @@
+#include <OrderedTuplet.h>
+#include <StateEnergyStore.h>
+#include <cstdio>
+#include <filesystem>
+
+using namespace gbLAB;
+
+XTuplet stateFromIndex(const int& index, const int& k)
+{
+    XTuplet state(k);
+    int n= index;
+    for (int i=0; i<k; ++i)
+    {
+        state(i)= n % 3;
+        n/= 3;
+    }
+    return state;
+}
+
+int main()
+{
+    const std::string logFile= "stateEnergyStore.bin";
+    std::remove(logFile.c_str());
+    const int k= 9;
+    const int numberOfStates= 729;
+
+    try {
+        // concurrent inserts from several threads, each state inserted twice
+        {
+            StateEnergyStore<XTuplet> store(logFile);
+#pragma omp parallel for
+            for (int n = 0; n < 2*numberOfStates; ++n) {
+                const int index= n % numberOfStates;
+                store.insert(stateFromIndex(index,k), -index, 0.5*index);
+            }
+            if (store.size() != numberOfStates)
+                throw std::runtime_error("Wrong number of states after concurrent inserts");
+        }
+
+        // replay the log
+        {
+            StateEnergyStore<XTuplet> store(logFile);
+            if (store.size() != numberOfStates)
+                throw std::runtime_error("Wrong number of states after replay");
+            for (int index = 0; index < numberOfStates; ++index) {
+                const auto value= store.find(stateFromIndex(index,k));
+                if (!value || value->first != -index || value->second != 0.5*index)
+                    throw std::runtime_error("Wrong value after replay");
+            }
+            if (store.find(stateFromIndex(0,k+1)))
+                throw std::runtime_error("Found a state that was never inserted");
+        }
+
+        // simulate a crash during the last append
+        const auto fullSize= std::filesystem::file_size(logFile);
+        std::filesystem::resize_file(logFile,fullSize-5);
+        {
+            StateEnergyStore<XTuplet> store(logFile);
+            if (store.size() != numberOfStates-1)
+                throw std::runtime_error("Torn record was not discarded");
+            // the store must remain appendable after recovery
+            StateEnergyStore<XTuplet> other(logFile);
+            other.insert(stateFromIndex(0,k+1), 1.0, 2.0);
+            if (store.refresh() != 1 || !store.find(stateFromIndex(0,k+1)))
+                throw std::runtime_error("Records appended by another store were not refreshed");
+        }
+    }
+    catch(std::runtime_error& e)
+    {
+        std::cout << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
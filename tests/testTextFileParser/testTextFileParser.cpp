@@ -0,0 +1,91 @@
+#include <TextFileParser.h>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+using namespace gbLAB;
+
+int main()
+{
+    try
+    {
+        {
+            std::ofstream file("deck.txt");
+            file << "# a parameter deck\n";
+            file << "#A = 0 0 0;\n";
+            file << "A = 1.0 0.5 0.0\n";
+            file << "    0.5 1.0 0.0\n";
+            file << "    0.0 0.0 +2.5e0; # multi-line matrix\n";
+            file << "n = 12; # an integer\n";
+            file << "m = 3.0; # an integer written as a floating point value\n";
+            file << "ids = 3 1 2 3;\n";
+            file << "name = bicrystal_3d;\n";
+            file << "x = 0.1;\n";
+            file << "x = 0.2;\n";
+        }
+
+        TextFileParser parser("deck.txt");
+        Eigen::Matrix3d A;
+        A << 1.0, 0.5, 0.0,
+             0.5, 1.0, 0.0,
+             0.0, 0.0, 2.5;
+        if(parser.readMatrix<double,3,3>("A")!=A)
+            throw std::runtime_error("Incorrect multi-line matrix.");
+        if(parser.readScalar<long long int>("n")!=12 || parser.readScalar<int>("n")!=12)
+            throw std::runtime_error("Incorrect integer.");
+        if(parser.readScalar<int>("m")!=3 || parser.readArray<long>("m")!=std::vector<long>{3})
+            throw std::runtime_error("Incorrect integer written as a floating point value.");
+        if(parser.readSet<int>("ids")!=std::set<int>{1,2,3})
+            throw std::runtime_error("Incorrect set.");
+        if(TextFileParser::removeSpaces(parser.readString("name"))!="bicrystal_3d")
+            throw std::runtime_error("Incorrect string.");
+        const auto entries(parser.readStringVector("x"));
+        if(entries.size()!=2 || parser.readScalar<double>("x")!=0.1)
+            throw std::runtime_error("Incorrect repeated key.");
+        if(parser.readStringVector("n")[0].second!="# an integer")
+            throw std::runtime_error("Incorrect comment.");
+
+        bool thrown= false;
+        try
+        {
+            parser.readScalar<double>("missing");
+        }
+        catch(const std::runtime_error&)
+        {
+            thrown= true;
+        }
+        if(!thrown)
+            throw std::runtime_error("Reading a missing key should throw.");
+
+        // parsers of the same unchanged file share the index, also when they are created one after the other;
+        // the index is rebuilt when the file changes
+        const std::weak_ptr<const TextFileIndex> cachedIndex(TextFileParser("deck.txt").fileIndex());
+        if(cachedIndex.expired() || TextFileParser("deck.txt").fileIndex()!=cachedIndex.lock())
+            throw std::runtime_error("Consecutive parsers of the same file do not share the index.");
+        if(TextFileParser("deck.txt").readScalar<int>("n")!=12)
+            throw std::runtime_error("Incorrect integer from the cached index.");
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        {
+            std::ofstream file("deck.txt");
+            file << "n = 7;\n";
+        }
+        if(TextFileParser("deck.txt").readScalar<int>("n")!=7)
+            throw std::runtime_error("The index of a modified file was not rebuilt.");
+        if(TextFileParser("deck.txt").fileIndex()==cachedIndex.lock())
+            throw std::runtime_error("The index of a modified file was not replaced in the cache.");
+        // touching the file, without changing its content, rebuilds the index too
+        const std::shared_ptr<const TextFileIndex> modifiedIndex(TextFileParser("deck.txt").fileIndex());
+        std::filesystem::last_write_time("deck.txt",std::filesystem::last_write_time("deck.txt")+std::chrono::seconds(1));
+        if(TextFileParser("deck.txt").fileIndex()==modifiedIndex)
+            throw std::runtime_error("The index of a touched file was not rebuilt.");
+        // the first parser keeps its own (old) index alive
+        if(parser.readScalar<int>("n")!=12)
+            throw std::runtime_error("Incorrect integer from the old index.");
+    }
+    catch(std::runtime_error& e)
+    {
+        std::cout << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
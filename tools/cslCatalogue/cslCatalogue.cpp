@@ -0,0 +1,65 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+/*
+ * oilab-csl-catalogue: generates the catalogue of coincidence rotations of a lattice.
+ *
+ * Usage: oilab-csl-catalogue --lattice <sc|bcc|fcc|hcp> --output <file>
+ *                            [--a <lattice constant>] [--c <hcp c>] [--max-sigma <n>]
+ *                            [--max-index <n>] [--max-den <n>]
+ *
+ * The rotation axes are all the primitive reciprocal lattice directions of the lattice with
+ * Miller indices in [-max-index,max-index]. The catalogue is read back with CslCatalogue(filename).
+ */
+
+#include <CslCatalogue.h>
+#include <iostream>
+
+using namespace gbLAB;
+
+int main(int argc, char** argv)
+{
+    std::string lattice, output;
+    double a= 1.0;
+    double c= std::sqrt(8.0/3.0);
+    int maxSigma= 50;
+    int maxIndex= 1;
+    double maxDen= 100;
+    bool valid= argc%2==1;
+    for (int i=1; i+1<argc; i+=2)
+    {
+        const std::string option(argv[i]);
+        const std::string value(argv[i+1]);
+        if (option=="--lattice") lattice= value;
+        else if (option=="--output") output= value;
+        else if (option=="--a") a= std::stod(value);
+        else if (option=="--c") c= std::stod(value);
+        else if (option=="--max-sigma") maxSigma= std::stoi(value);
+        else if (option=="--max-index") maxIndex= std::stoi(value);
+        else if (option=="--max-den") maxDen= std::stod(value);
+        else valid= false;
+    }
+    if (!valid || lattice.empty() || output.empty())
+    {
+        std::cerr << "Usage: " << argv[0] << " --lattice <sc|bcc|fcc|hcp> --output <file>"
+                  << " [--a <a>] [--c <c>] [--max-sigma <n>] [--max-index <n>] [--max-den <n>]" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        const CslCatalogue catalogue(lattice,CslCatalogue::standardBasis(lattice,a,c),
+                                     CslCatalogue::axes(maxIndex),maxSigma,maxDen);
+        catalogue.write(output);
+        std::cout << "Wrote " << catalogue.entries.size() << " entries with sigma <= " << maxSigma
+                  << " to " << output << std::endl;
+    }
+    catch (std::runtime_error& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,173 @@
+/* This file is part of gbLAB.
+ *
+ * gbLAB is distributed without any warranty under the MIT License.
+ */
+
+/*
+ * oilab-worker: builds mesostates and evaluates their energies for a MesoStateCoordinator.
+ *
+ * Usage: oilab-worker --socket <path>
+ *
+ * The worker connects to the coordinator listening on the Unix domain socket <path>, rebuilds
+ * the ensemble from the setup it receives, and answers tasks until it is told to shut down or
+ * the connection is closed. See WorkerProtocol.h for the messages.
+ */
+
+#include <LatticeModule.h>
+#include <GbMesoStateEnsemble.h>
+#include <EnergyEvaluator.h>
+#include <MesoStateCoordinator.h>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <sys/un.h>
+
+using namespace gbLAB;
+
+int connectTo(const std::string& socketPath)
+{
+    sockaddr_un address;
+    std::memset(&address,0,sizeof(address));
+    address.sun_family= AF_UNIX;
+    if (socketPath.size()>=sizeof(address.sun_path))
+        throw std::runtime_error("oilab-worker: the socket path "+socketPath+" is too long.");
+    std::strncpy(address.sun_path,socketPath.c_str(),sizeof(address.sun_path)-1);
+
+    // the coordinator may still be setting up its socket
+    for (int attempt=0; attempt<100; ++attempt)
+    {
+        const int fd= ::socket(AF_UNIX,SOCK_STREAM,0);
+        if (fd<0)
+            throw std::runtime_error("oilab-worker: cannot create a socket.");
+        if (::connect(fd,reinterpret_cast<const sockaddr*>(&address),sizeof(address))==0)
+        {
+            WorkerProtocol::disableSigPipe(fd);
+            return fd;
+        }
+        ::close(fd);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    throw std::runtime_error("oilab-worker: cannot connect to "+socketPath+".");
+}
+
+std::unique_ptr<GbMesoStateEnsemble<3>> buildEnsemble(const MesoStateWorkerSetup& setup,
+                                                      std::unique_ptr<Lattice<3>>& latticeA,
+                                                      std::unique_ptr<Lattice<3>>& latticeB,
+                                                      std::unique_ptr<BiCrystal<3>>& bc,
+                                                      std::unique_ptr<Gb<3>>& gb)
+{
+    GbMaterialTensors::lambda= setup.lambda;
+    GbMaterialTensors::mu= setup.mu;
+    latticeA= std::make_unique<Lattice<3>>(setup.latticeBasis,setup.rotationA);
+    latticeB= std::make_unique<Lattice<3>>(setup.latticeBasis,setup.rotationB);
+    bc= std::make_unique<BiCrystal<3>>(*latticeA,*latticeB,setup.useRLLL);
+    gb= std::make_unique<Gb<3>>(*bc,latticeA->reciprocalLatticeDirection(setup.gbNormal));
+    const ReciprocalLatticeVector<3> axis(latticeA->reciprocalLatticeVector(setup.axis));
+    std::vector<LatticeVector<3>> cslVectors;
+    for (int i=0; i<3; ++i)
+        cslVectors.push_back(bc->csl.latticeVector(setup.cslVectors.col(i)));
+    return std::make_unique<GbMesoStateEnsemble<3>>(*gb,axis,cslVectors,setup.bhalfMax);
+}
+
+int main(int argc, char** argv)
+{
+    std::string socketPath;
+    for (int i=1; i<argc; ++i)
+        if (std::string(argv[i])=="--socket" && i+1<argc)
+            socketPath= argv[++i];
+    if (socketPath.empty())
+    {
+        std::cerr << "Usage: " << argv[0] << " --socket <path>" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        using namespace WorkerProtocol;
+        const int fd= connectTo(socketPath);
+        BinaryWriter hello;
+        hello.write(WorkerProtocol::version);
+        hello.write(static_cast<std::int64_t>(::getpid()));
+        WorkerProtocol::send(fd,MessageType::hello,hello);
+
+        MesoStateWorkerSetup setup;
+        std::unique_ptr<Lattice<3>> latticeA, latticeB;
+        std::unique_ptr<BiCrystal<3>> bc;
+        std::unique_ptr<Gb<3>> gb;
+        std::unique_ptr<GbMesoStateEnsemble<3>> ensemble;
+        std::unique_ptr<LammpsEnergyEvaluator<GbMesoState<3>>> evaluator;
+
+        MessageType type;
+        BinaryReader payload;
+        while (WorkerProtocol::receive(fd,type,payload))
+        {
+            switch (type)
+            {
+                case MessageType::setup:
+                {
+                    try
+                    {
+                        setup.read(payload);
+                        ensemble= buildEnsemble(setup,latticeA,latticeB,bc,gb);
+                        evaluator= std::make_unique<LammpsEnergyEvaluator<GbMesoState<3>>>(
+                                LammpsEnergyEvaluator<GbMesoState<3>>{setup.lmpLocation,setup.potentialName});
+                    }
+                    catch (std::runtime_error& e)
+                    {
+                        BinaryWriter failure;
+                        failure.write(std::string(e.what()));
+                        WorkerProtocol::send(fd,MessageType::failure,failure);
+                        return 1;
+                    }
+                    BinaryWriter ready;
+                    ready.write(static_cast<std::uint64_t>(ensemble->bShiftPairs.size()));
+                    WorkerProtocol::send(fd,MessageType::ready,ready);
+                    break;
+                }
+                case MessageType::task:
+                {
+                    if (!ensemble)
+                        throw std::runtime_error("oilab-worker: task received before the setup.");
+                    const auto taskId= payload.read<std::uint64_t>();
+                    const auto n= payload.read<std::uint64_t>();
+                    BinaryWriter result;
+                    result.write(taskId);
+                    result.write(n);
+                    for (std::uint64_t i=0; i<n; ++i)
+                    {
+                        XTuplet state(0);
+                        payload.read(state);
+                        MesoStateWorkResult output;
+                        try
+                        {
+                            const auto densityEnergy((*evaluator)(ensemble->constructMesoState(state)));
+                            output= MesoStateWorkResult{true,densityEnergy.first,densityEnergy.second,""};
+                        }
+                        catch (std::runtime_error& e)
+                        {
+                            output.message= e.what();
+                        }
+                        result.write(output.success);
+                        result.write(output.density);
+                        result.write(output.energy);
+                        result.write(output.message);
+                    }
+                    WorkerProtocol::send(fd,MessageType::result,result);
+                    break;
+                }
+                case MessageType::shutdown:
+                    ::close(fd);
+                    return 0;
+                default:
+                    throw std::runtime_error("oilab-worker: unexpected message.");
+            }
+        }
+        ::close(fd);
+    }
+    catch (std::runtime_error& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}